@@ -0,0 +1,449 @@
+/**
+ * @file bench.cpp
+ * @brief Benchmark harness, JSON results and baseline comparison
+ */
+
+#include "bench.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedNanos(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+double timeIterations(const Benchmark& benchmark, size_t iterations) {
+    auto start = Clock::now();
+    benchmark.body(iterations);
+    return elapsedNanos(start, Clock::now());
+}
+
+// Smallest iteration count whose run lasts at least min_time
+size_t calibrate(const Benchmark& benchmark, double min_time) {
+    const double target = min_time * 1e9;
+    size_t iterations = 1;
+    for (;;) {
+        double ns = timeIterations(benchmark, iterations);
+        if (ns >= target || iterations >= (size_t{1} << 40)) return iterations;
+        // Aim 20% past the target from the observed rate, at most 10x per round
+        double scale = ns > 0.0 ? target * 1.2 / ns : 10.0;
+        scale = std::min(std::max(scale, 2.0), 10.0);
+        iterations = static_cast<size_t>(std::ceil(static_cast<double>(iterations) * scale));
+    }
+}
+
+void writeString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default: out << c;
+        }
+    }
+    out << '"';
+}
+
+std::string formatNumber(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6g", value);
+    return buf;
+}
+
+std::string formatTime(double ns) {
+    char buf[32];
+    if (ns < 1e3) std::snprintf(buf, sizeof(buf), "%.1f ns", ns);
+    else if (ns < 1e6) std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+    else if (ns < 1e9) std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+    else std::snprintf(buf, sizeof(buf), "%.2f s", ns / 1e9);
+    return buf;
+}
+
+// ----------------------------------------------------------------------------
+// Minimal JSON reader for results files
+// ----------------------------------------------------------------------------
+
+struct Value {
+    enum class Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+    Type type = Type::NUL;
+    double number = 0.0;
+    std::string string;
+    std::vector<Value> array;
+    std::vector<std::pair<std::string, Value>> object;
+
+    const Value* find(const std::string& key) const {
+        for (const auto& entry : object) {
+            if (entry.first == key) return &entry.second;
+        }
+        return nullptr;
+    }
+};
+
+class Parser {
+public:
+    explicit Parser(const std::string& text) : text_(text) {}
+
+    Value parseDocument() {
+        Value v = parseValue();
+        skipSpace();
+        if (pos_ != text_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("Malformed results JSON at offset " +
+                                 std::to_string(pos_) + ": " + what);
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+
+    bool consumeWord(const char* word) {
+        size_t n = std::char_traits<char>::length(word);
+        if (text_.compare(pos_, n, word) == 0) {
+            pos_ += n;
+            return true;
+        }
+        return false;
+    }
+
+    Value parseValue() {
+        skipSpace();
+        if (pos_ >= text_.size()) fail("unexpected end");
+        Value v;
+        char c = text_[pos_];
+        if (c == '{') {
+            v.type = Value::Type::OBJECT;
+            ++pos_;
+            if (consume('}')) return v;
+            do {
+                skipSpace();
+                std::string key = parseString();
+                expect(':');
+                v.object.emplace_back(std::move(key), parseValue());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            v.type = Value::Type::ARRAY;
+            ++pos_;
+            if (consume(']')) return v;
+            do {
+                v.array.push_back(parseValue());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = Value::Type::STRING;
+            v.string = parseString();
+        } else if (consumeWord("true") || consumeWord("false")) {
+            v.type = Value::Type::BOOL;
+        } else if (consumeWord("null")) {
+            v.type = Value::Type::NUL;
+        } else {
+            v.type = Value::Type::NUMBER;
+            const char* begin = text_.c_str() + pos_;
+            char* end = nullptr;
+            v.number = std::strtod(begin, &end);
+            if (end == begin) fail("expected a value");
+            pos_ += static_cast<size_t>(end - begin);
+        }
+        return v;
+    }
+
+    std::string parseString() {
+        if (pos_ >= text_.size() || text_[pos_] != '"') fail("expected a string");
+        ++pos_;
+        std::string out;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            char c = text_[pos_++];
+            if (c == '\\') {
+                if (pos_ >= text_.size()) break;
+                char e = text_[pos_++];
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        if (pos_ + 4 > text_.size()) fail("bad escape");
+                        unsigned code = static_cast<unsigned>(std::stoul(text_.substr(pos_, 4), nullptr, 16));
+                        pos_ += 4;
+                        out += code < 0x80 ? static_cast<char>(code) : '?';
+                        break;
+                    }
+                    default: out += e;
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (pos_ >= text_.size()) fail("unterminated string");
+        ++pos_;
+        return out;
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+double numberField(const Value& object, const char* key) {
+    const Value* v = object.find(key);
+    if (!v || v->type != Value::Type::NUMBER) {
+        throw std::runtime_error(std::string("Results JSON: missing number '") + key + "'");
+    }
+    return v->number;
+}
+
+std::string stringField(const Value& object, const char* key) {
+    const Value* v = object.find(key);
+    if (!v || v->type != Value::Type::STRING) {
+        throw std::runtime_error(std::string("Results JSON: missing string '") + key + "'");
+    }
+    return v->string;
+}
+
+} // namespace
+
+// ============================================================================
+// Suite
+// ============================================================================
+
+void Suite::add(const std::string& name, const std::string& group, Body body) {
+    benchmarks_.push_back({name, group, std::move(body)});
+}
+
+std::vector<Result> Suite::run(const Options& options, std::ostream* progress) const {
+    std::vector<Result> results;
+    for (const auto& benchmark : benchmarks_) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        Result r = measure(benchmark, options);
+        if (progress) {
+            char line[160];
+            std::snprintf(line, sizeof(line), "%-44s %12s  ±%5.1f%%  (%zu x %zu)\n",
+                          r.name.c_str(), formatTime(r.median_ns).c_str(), 100.0 * r.cv(),
+                          r.repetitions, r.iterations);
+            *progress << line << std::flush;
+        }
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+Result measure(const Benchmark& benchmark, const Options& options) {
+    size_t iterations = calibrate(benchmark, options.min_time);
+    for (size_t i = 0; i < options.warmup; ++i) {
+        timeIterations(benchmark, iterations);
+    }
+    size_t repetitions = std::max<size_t>(options.repetitions, 1);
+    std::vector<double> per_iteration;
+    per_iteration.reserve(repetitions);
+    for (size_t i = 0; i < repetitions; ++i) {
+        per_iteration.push_back(timeIterations(benchmark, iterations) / static_cast<double>(iterations));
+    }
+    return summarize(benchmark.name, benchmark.group, iterations, std::move(per_iteration));
+}
+
+Result summarize(const std::string& name, const std::string& group, size_t iterations,
+                 std::vector<double> per_iteration_ns) {
+    Result r;
+    r.name = name;
+    r.group = group;
+    r.iterations = iterations;
+    r.repetitions = per_iteration_ns.size();
+    if (per_iteration_ns.empty()) return r;
+
+    std::sort(per_iteration_ns.begin(), per_iteration_ns.end());
+    size_t n = per_iteration_ns.size();
+    double sum = 0.0;
+    for (double t : per_iteration_ns) sum += t;
+    r.mean_ns = sum / static_cast<double>(n);
+    r.median_ns = n % 2 ? per_iteration_ns[n / 2]
+                        : 0.5 * (per_iteration_ns[n / 2 - 1] + per_iteration_ns[n / 2]);
+    double squares = 0.0;
+    for (double t : per_iteration_ns) squares += (t - r.mean_ns) * (t - r.mean_ns);
+    r.stddev_ns = n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.0;
+    r.min_ns = per_iteration_ns.front();
+    r.max_ns = per_iteration_ns.back();
+    return r;
+}
+
+// ============================================================================
+// JSON Results
+// ============================================================================
+
+void writeJSON(std::ostream& out, const Report& report) {
+    out << "{\n  \"context\": {";
+    bool first = true;
+    for (const auto& entry : report.context) {
+        out << (first ? "\n    " : ",\n    ");
+        writeString(out, entry.first);
+        out << ": ";
+        writeString(out, entry.second);
+        first = false;
+    }
+    out << (first ? "},\n" : "\n  },\n");
+    out << "  \"benchmarks\": [";
+    first = true;
+    for (const auto& r : report.results) {
+        out << (first ? "\n    {" : ",\n    {");
+        out << "\"name\": ";
+        writeString(out, r.name);
+        out << ", \"group\": ";
+        writeString(out, r.group);
+        out << ", \"iterations\": " << r.iterations
+            << ", \"repetitions\": " << r.repetitions
+            << ", \"mean_ns\": " << formatNumber(r.mean_ns)
+            << ", \"median_ns\": " << formatNumber(r.median_ns)
+            << ", \"stddev_ns\": " << formatNumber(r.stddev_ns)
+            << ", \"min_ns\": " << formatNumber(r.min_ns)
+            << ", \"max_ns\": " << formatNumber(r.max_ns)
+            << ", \"cv\": " << formatNumber(r.cv()) << "}";
+        first = false;
+    }
+    out << (first ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+Report readJSON(const std::string& text) {
+    Value root = Parser(text).parseDocument();
+    if (root.type != Value::Type::OBJECT) {
+        throw std::runtime_error("Results JSON: expected an object");
+    }
+    Report report;
+    if (const Value* context = root.find("context")) {
+        for (const auto& entry : context->object) {
+            if (entry.second.type == Value::Type::STRING) {
+                report.context[entry.first] = entry.second.string;
+            }
+        }
+    }
+    const Value* list = root.find("benchmarks");
+    if (!list || list->type != Value::Type::ARRAY) {
+        throw std::runtime_error("Results JSON: missing 'benchmarks' array");
+    }
+    for (const auto& item : list->array) {
+        Result r;
+        r.name = stringField(item, "name");
+        r.group = item.find("group") ? stringField(item, "group") : std::string();
+        r.iterations = static_cast<size_t>(numberField(item, "iterations"));
+        r.repetitions = static_cast<size_t>(numberField(item, "repetitions"));
+        r.mean_ns = numberField(item, "mean_ns");
+        r.median_ns = numberField(item, "median_ns");
+        r.stddev_ns = numberField(item, "stddev_ns");
+        r.min_ns = numberField(item, "min_ns");
+        r.max_ns = numberField(item, "max_ns");
+        report.results.push_back(std::move(r));
+    }
+    return report;
+}
+
+Report loadJSON(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open results file: " + path);
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return readJSON(ss.str());
+}
+
+// ============================================================================
+// Baseline Comparison
+// ============================================================================
+
+std::vector<Comparison> compare(const std::vector<Result>& baseline,
+                                const std::vector<Result>& current,
+                                double threshold) {
+    std::map<std::string, const Result*> before;
+    for (const auto& r : baseline) before[r.name] = &r;
+
+    std::vector<Comparison> out;
+    for (const auto& r : current) {
+        Comparison c;
+        c.name = r.name;
+        c.current_ns = r.median_ns;
+        auto it = before.find(r.name);
+        if (it == before.end()) {
+            c.status = Comparison::Status::ADDED;
+            out.push_back(c);
+            continue;
+        }
+        const Result& b = *it->second;
+        before.erase(it);
+        c.baseline_ns = b.median_ns;
+        c.change = b.median_ns > 0.0 ? (r.median_ns - b.median_ns) / b.median_ns : 0.0;
+        if (c.change > threshold && r.min_ns > b.median_ns) {
+            c.status = Comparison::Status::REGRESSED;
+        } else if (c.change < -threshold && r.max_ns < b.median_ns) {
+            c.status = Comparison::Status::IMPROVED;
+        }
+        out.push_back(c);
+    }
+    for (const auto& r : baseline) {
+        if (before.count(r.name)) {
+            Comparison c;
+            c.name = r.name;
+            c.baseline_ns = r.median_ns;
+            c.status = Comparison::Status::REMOVED;
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+size_t writeComparison(std::ostream& out, const std::vector<Comparison>& comparisons) {
+    size_t regressions = 0;
+    char line[200];
+    std::snprintf(line, sizeof(line), "%-44s %12s %12s %9s  %s\n",
+                  "benchmark", "baseline", "current", "change", "status");
+    out << line;
+    for (const auto& c : comparisons) {
+        const char* status = "ok";
+        switch (c.status) {
+            case Comparison::Status::OK: status = "ok"; break;
+            case Comparison::Status::IMPROVED: status = "improved"; break;
+            case Comparison::Status::REGRESSED: status = "REGRESSION"; ++regressions; break;
+            case Comparison::Status::ADDED: status = "new"; break;
+            case Comparison::Status::REMOVED: status = "missing"; break;
+        }
+        std::string base = c.status == Comparison::Status::ADDED ? "-" : formatTime(c.baseline_ns);
+        std::string cur = c.status == Comparison::Status::REMOVED ? "-" : formatTime(c.current_ns);
+        char change[32] = "-";
+        if (c.status != Comparison::Status::ADDED && c.status != Comparison::Status::REMOVED) {
+            std::snprintf(change, sizeof(change), "%+.1f%%", 100.0 * c.change);
+        }
+        std::snprintf(line, sizeof(line), "%-44s %12s %12s %9s  %s\n",
+                      c.name.c_str(), base.c_str(), cur.c_str(), change, status);
+        out << line;
+    }
+    return regressions;
+}
+
+} // namespace bench
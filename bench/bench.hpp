@@ -0,0 +1,172 @@
+/**
+ * @file bench.hpp
+ * @brief Self-contained benchmark harness for cosmic_bench
+ *
+ * Benchmarks are registered with a name and a body that runs a given number
+ * of iterations. For each benchmark the harness calibrates the iteration
+ * count so that one repetition lasts at least the minimum time, runs warmup
+ * repetitions, then times the measured repetitions with the steady clock.
+ * It reports per-iteration statistics (mean, median, standard deviation,
+ * min, max, coefficient of variation) without hardware counters.
+ *
+ * Results are written as JSON and can be compared against a stored
+ * baseline file, flagging benchmarks whose median slowed down beyond a
+ * threshold.
+ */
+
+#ifndef COSMIC_BENCH_HPP
+#define COSMIC_BENCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * @brief Keep a value (and the computation producing it) from being optimized away
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/// Body of a benchmark: run the measured work @p iterations times
+using Body = std::function<void(size_t iterations)>;
+
+/**
+ * @brief A registered benchmark
+ */
+struct Benchmark {
+    std::string name;    ///< e.g. "trees/generate/n=8"
+    std::string group;   ///< e.g. "trees"
+    Body body;
+};
+
+/**
+ * @brief Harness settings
+ */
+struct Options {
+    double min_time = 0.05;      ///< Minimum seconds per repetition
+    size_t warmup = 1;           ///< Unmeasured repetitions
+    size_t repetitions = 5;      ///< Measured repetitions
+    std::string filter;          ///< Run benchmarks whose name contains this
+};
+
+/**
+ * @brief Statistics of one benchmark, per iteration
+ */
+struct Result {
+    std::string name;
+    std::string group;
+    size_t iterations = 0;       ///< Iterations per repetition
+    size_t repetitions = 0;
+    double mean_ns = 0.0;
+    double median_ns = 0.0;
+    double stddev_ns = 0.0;
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+
+    /// Coefficient of variation (stddev / mean)
+    double cv() const { return mean_ns > 0.0 ? stddev_ns / mean_ns : 0.0; }
+};
+
+/**
+ * @brief Benchmark registry and runner
+ */
+class Suite {
+public:
+    /// Register a benchmark
+    void add(const std::string& name, const std::string& group, Body body);
+
+    /// Get the registered benchmarks
+    const std::vector<Benchmark>& benchmarks() const { return benchmarks_; }
+
+    /**
+     * @brief Run the benchmarks selected by the filter
+     * @param progress Receives one line per finished benchmark (may be null)
+     */
+    std::vector<Result> run(const Options& options, std::ostream* progress = nullptr) const;
+
+private:
+    std::vector<Benchmark> benchmarks_;
+};
+
+/// Measure one benchmark
+Result measure(const Benchmark& benchmark, const Options& options);
+
+/// Compute statistics from per-iteration repetition times
+Result summarize(const std::string& name, const std::string& group, size_t iterations,
+                 std::vector<double> per_iteration_ns);
+
+// ============================================================================
+// JSON Results
+// ============================================================================
+
+/**
+ * @brief A results file: run context plus results
+ */
+struct Report {
+    std::map<std::string, std::string> context;
+    std::vector<Result> results;
+};
+
+/// Write a report as JSON
+void writeJSON(std::ostream& out, const Report& report);
+
+/**
+ * @brief Read a report written by writeJSON
+ * @throws std::runtime_error on malformed input
+ */
+Report readJSON(const std::string& text);
+
+/// Read a report from a file
+Report loadJSON(const std::string& path);
+
+// ============================================================================
+// Baseline Comparison
+// ============================================================================
+
+/**
+ * @brief Comparison of one benchmark against its baseline
+ */
+struct Comparison {
+    enum class Status { OK, IMPROVED, REGRESSED, ADDED, REMOVED };
+
+    std::string name;
+    double baseline_ns = 0.0;    ///< Baseline median
+    double current_ns = 0.0;     ///< Current median
+    double change = 0.0;         ///< Relative change of the median
+    Status status = Status::OK;
+};
+
+/**
+ * @brief Compare current results against a baseline
+ *
+ * A benchmark regresses when its median grew by more than @p threshold
+ * (relative) and its fastest repetition is slower than the baseline
+ * median, so a single noisy repetition does not trip the check.
+ * Improvements are the mirror image.
+ */
+std::vector<Comparison> compare(const std::vector<Result>& baseline,
+                                const std::vector<Result>& current,
+                                double threshold = 0.10);
+
+/// Write a comparison table; returns the number of regressions
+size_t writeComparison(std::ostream& out, const std::vector<Comparison>& comparisons);
+
+/// Register the library's benchmarks
+void registerBenchmarks(Suite& suite);
+
+} // namespace bench
+
+#endif // COSMIC_BENCH_HPP
@@ -0,0 +1,256 @@
+/**
+ * @file benchmarks.cpp
+ * @brief Benchmarks of tree generation, clustering, hierarchy building,
+ *        navigation, enneagram layouts, serialization, geometry and the simulations
+ */
+
+#include "bench.hpp"
+#include "cosmic/cosmic.hpp"
+
+namespace bench {
+
+using namespace cosmic;
+
+namespace {
+
+void treeBenchmarks(Suite& suite) {
+    for (int n : {6, 8, 9}) {
+        // terms:: regenerates on every call; trees:: serves repeats from its cache
+        suite.add("trees/generate/n=" + std::to_string(n), "trees", [n](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                auto trees = terms::RootedTreeGenerator::generate(n);
+                doNotOptimize(trees);
+            }
+        });
+    }
+    suite.add("trees/generate-cached/n=10", "trees", [](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            auto trees = trees::RootedTreeGenerator::generate(10);
+            doNotOptimize(trees);
+        }
+    });
+    for (int n : {6, 8, 9}) {
+        auto input = trees::RootedTreeGenerator::generate(n);
+        suite.add("trees/cluster/n=" + std::to_string(n), "trees", [input](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                auto clusters = trees::FlipTransform::groupIntoClusters(input);
+                doNotOptimize(clusters);
+            }
+        });
+    }
+}
+
+void hierarchyBenchmarks(Suite& suite) {
+    suite.add("hierarchy/create", "hierarchy", [](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            auto root = System::createHierarchy();
+            doNotOptimize(root);
+        }
+    });
+
+    // Build System 5 and count its Idea terms: runtime structure vs FixedSystem
+    suite.add("hierarchy/system5-dynamic", "hierarchy", [](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            System system(5);
+            system.build();
+            size_t ideas = 0;
+            for (const auto& term : system.allTerms()) {
+                ideas += term->triadicType() == TriadicTerm::Idea;
+            }
+            doNotOptimize(ideas);
+        }
+    });
+    suite.add("hierarchy/system5-fixed", "hierarchy", [](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            FixedSystem<5> system;
+            doNotOptimize(system);
+            size_t ideas = 0;
+            for (const auto* term : system.allTerms()) {
+                ideas += term->triadicType() == TriadicTerm::Idea;
+            }
+            doNotOptimize(ideas);
+        }
+    });
+
+    auto root = System::createHierarchy();
+    suite.add("navigation/system-levels", "navigation", [root](size_t iterations) {
+        ops::SystemNavigator nav(root);
+        for (size_t i = 0; i < iterations; ++i) {
+            for (int level = 1; level <= 10; ++level) {
+                bool ok = nav.goToLevel(level);
+                doNotOptimize(ok);
+            }
+        }
+    });
+    auto system4 = System::getSystem(root, 4);
+    auto terms = system4->allTerms();
+    suite.add("navigation/find-by-type", "navigation", [terms](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            for (const auto& term : terms) {
+                ops::TermNavigator nav(term);
+                auto found = nav.findByType(TriadicTerm::Idea);
+                doNotOptimize(found);
+            }
+        }
+    });
+
+    suite.add("serialize/hierarchy-json", "serialize", [root](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            auto json = ops::Serializer::hierarchyToJSON(root);
+            doNotOptimize(json);
+        }
+    });
+    suite.add("serialize/hierarchy-dot", "serialize", [root](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            auto dot = ops::Serializer::hierarchyToDOT(root);
+            doNotOptimize(dot);
+        }
+    });
+}
+
+/// Fully populated pointer nesting with a term at every position
+Enneagram::EnneagramPtr pointerNesting(int depth, const Term::TermPtr& term) {
+    auto e = Enneagram::create("Enneagram");
+    for (int p = 1; p <= 9; ++p) {
+        auto pos = static_cast<EnneagramPosition>(p);
+        e->setTermAt(pos, term);
+        if (depth > 0) e->setNestedEnneagram(pos, pointerNesting(depth - 1, term));
+    }
+    return e;
+}
+
+void layoutBenchmarks(Suite& suite) {
+    constexpr int DEPTH = 5;
+    struct Nestings {
+        Enneagram::EnneagramPtr pointers;
+        layout::EnneagramArray implicit;
+        std::vector<EnneagramPosition> paths;   // DEPTH positions per lookup
+    };
+    // Built on first use so that filtered runs do not pay for it
+    auto nestings = [] {
+        static std::shared_ptr<Nestings> shared = [] {
+            auto n = std::make_shared<Nestings>();
+            n->pointers = pointerNesting(DEPTH, Term::create("Term"));
+            n->implicit = layout::EnneagramArray::fromEnneagram(*n->pointers);
+            uint64_t state = 92;
+            for (int i = 0; i < 4096 * DEPTH; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                n->paths.push_back(static_cast<EnneagramPosition>((state >> 33) % 9 + 1));
+            }
+            return n;
+        }();
+        return shared;
+    };
+
+    suite.add("layout/lookup-pointers/depth=5", "layout", [nestings](size_t iterations) {
+        auto n = nestings();
+        for (size_t i = 0; i < iterations; ++i) {
+            for (size_t k = 0; k < n->paths.size(); k += DEPTH) {
+                const Enneagram* e = n->pointers.get();
+                for (int d = 0; d < DEPTH; ++d) e = e->nestedEnneagramAt(n->paths[k + d]).get();
+                doNotOptimize(e);
+            }
+        }
+    });
+    suite.add("layout/lookup-implicit/depth=5", "layout", [nestings](size_t iterations) {
+        auto n = nestings();
+        for (size_t i = 0; i < iterations; ++i) {
+            for (size_t k = 0; k < n->paths.size(); k += DEPTH) {
+                size_t a = 0;
+                for (int d = 0; d < DEPTH; ++d) {
+                    a = layout::EnneagramArray::child(a, static_cast<int>(n->paths[k + d]));
+                }
+                doNotOptimize(a);
+            }
+        }
+    });
+    suite.add("layout/sweep-pointers/depth=5", "layout", [nestings](size_t iterations) {
+        auto n = nestings();
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t found = 0;
+            std::vector<const Enneagram*> stack{n->pointers.get()};
+            while (!stack.empty()) {
+                const Enneagram* e = stack.back();
+                stack.pop_back();
+                for (const auto& term : e->terms()) found += term != nullptr;
+                for (int p = 1; p <= 9; ++p) {
+                    if (auto nested = e->nestedEnneagramAt(static_cast<EnneagramPosition>(p))) {
+                        stack.push_back(nested.get());
+                    }
+                }
+            }
+            doNotOptimize(found);
+        }
+    });
+    suite.add("layout/sweep-implicit/depth=5", "layout", [nestings](size_t iterations) {
+        auto n = nestings();
+        for (size_t i = 0; i < iterations; ++i) {
+            size_t found = 0;
+            for (size_t a = 0; a < n->implicit.size(); ++a) {
+                for (int p = 1; p <= 9; ++p) found += n->implicit.termAt(a, p) != nullptr;
+            }
+            doNotOptimize(found);
+        }
+    });
+}
+
+void geometryBenchmarks(Suite& suite) {
+    suite.add("geometry/enneagram-svg", "geometry", [](size_t iterations) {
+        geometry::EnneagramGeometry ennea;
+        for (size_t i = 0; i < iterations; ++i) {
+            auto svg = geometry::svg::enneagramSVG(ennea);
+            doNotOptimize(svg);
+        }
+    });
+    suite.add("geometry/nested-enneagram-svg", "geometry", [](size_t iterations) {
+        geometry::NestedEnneagramGeometry nested(1);
+        for (size_t i = 0; i < iterations; ++i) {
+            auto svg = geometry::svg::nestedEnneagramSVG(nested);
+            doNotOptimize(svg);
+        }
+    });
+    suite.add("geometry/hierarchy-svg", "geometry", [](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            auto svg = geometry::svg::systemHierarchySVG();
+            doNotOptimize(svg);
+        }
+    });
+}
+
+void simulationBenchmarks(Suite& suite) {
+    suite.add("simulation/system1-1000-steps", "simulation", [](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            system1::System1 s;
+            for (int k = 0; k < 1000; ++k) s.step(0.01);
+            doNotOptimize(s);
+        }
+    });
+    suite.add("simulation/system2-1000-steps", "simulation", [](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            system2::System2 s;
+            for (int k = 0; k < 1000; ++k) s.step(0.01);
+            doNotOptimize(s);
+        }
+    });
+    suite.add("simulation/loon-population-64k", "simulation", [](size_t iterations) {
+        population::LoonPopulation lake(65536);
+        lake.setCoupling(0.5);
+        lake.setDissipation(0.1);
+        for (size_t i = 0; i < iterations; ++i) {
+            lake.communicate(0.01);
+        }
+        doNotOptimize(lake);
+    });
+}
+
+} // namespace
+
+void registerBenchmarks(Suite& suite) {
+    treeBenchmarks(suite);
+    hierarchyBenchmarks(suite);
+    layoutBenchmarks(suite);
+    geometryBenchmarks(suite);
+    simulationBenchmarks(suite);
+}
+
+} // namespace bench
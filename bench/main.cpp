@@ -0,0 +1,139 @@
+/**
+ * @file main.cpp
+ * @brief cosmic_bench: run the benchmark suite or compare results files
+ *
+ * Usage:
+ *   cosmic_bench [--filter TEXT] [--min-time SECONDS] [--warmup N]
+ *                [--repetitions N] [--json FILE] [--baseline FILE]
+ *                [--threshold FRACTION] [--list]
+ *   cosmic_bench compare BASELINE.json CURRENT.json [--threshold FRACTION]
+ *
+ * Exits with status 1 when a comparison finds a regression.
+ */
+
+#include "bench.hpp"
+#include "cosmic/cosmic.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void usage(std::ostream& out) {
+    out << "usage: cosmic_bench [--filter TEXT] [--min-time SECONDS] [--warmup N]\n"
+           "                    [--repetitions N] [--json FILE] [--baseline FILE]\n"
+           "                    [--threshold FRACTION] [--list]\n"
+           "       cosmic_bench compare BASELINE.json CURRENT.json [--threshold FRACTION]\n";
+}
+
+std::string isoTime() {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buf;
+}
+
+int runCompare(int argc, char** argv) {
+    std::string paths[2];
+    int found = 0;
+    double threshold = 0.10;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::stod(argv[++i]);
+        } else if (found < 2) {
+            paths[found++] = arg;
+        } else {
+            usage(std::cerr);
+            return 2;
+        }
+    }
+    if (found != 2) {
+        usage(std::cerr);
+        return 2;
+    }
+    auto baseline = bench::loadJSON(paths[0]);
+    auto current = bench::loadJSON(paths[1]);
+    size_t regressions = bench::writeComparison(
+        std::cout, bench::compare(baseline.results, current.results, threshold));
+    return regressions > 0 ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc > 1 && std::string(argv[1]) == "compare") {
+            return runCompare(argc, argv);
+        }
+
+        bench::Options options;
+        std::string json_path;
+        std::string baseline_path;
+        double threshold = 0.10;
+        bool list = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--filter" && has_value) options.filter = argv[++i];
+            else if (arg == "--min-time" && has_value) options.min_time = std::stod(argv[++i]);
+            else if (arg == "--warmup" && has_value) options.warmup = std::stoul(argv[++i]);
+            else if (arg == "--repetitions" && has_value) options.repetitions = std::stoul(argv[++i]);
+            else if (arg == "--json" && has_value) json_path = argv[++i];
+            else if (arg == "--baseline" && has_value) baseline_path = argv[++i];
+            else if (arg == "--threshold" && has_value) threshold = std::stod(argv[++i]);
+            else if (arg == "--list") list = true;
+            else {
+                usage(arg == "--help" ? std::cout : std::cerr);
+                return arg == "--help" ? 0 : 2;
+            }
+        }
+
+        bench::Suite suite;
+        bench::registerBenchmarks(suite);
+        if (list) {
+            for (const auto& b : suite.benchmarks()) std::cout << b.name << "\n";
+            return 0;
+        }
+
+        bench::Report report;
+        report.context["library_version"] = cosmic::Version::string();
+#ifdef NDEBUG
+        report.context["assertions"] = "off";
+#else
+        report.context["assertions"] = "on";
+#endif
+        report.context["date"] = isoTime();
+        report.context["min_time"] = std::to_string(options.min_time);
+        report.results = suite.run(options, &std::cout);
+
+        if (!json_path.empty()) {
+            std::ofstream out(json_path);
+            if (!out) throw std::runtime_error("Cannot open output file: " + json_path);
+            bench::writeJSON(out, report);
+        }
+        if (!baseline_path.empty()) {
+            auto baseline = bench::loadJSON(baseline_path);
+            // Benchmarks excluded by the filter are not missing
+            auto& expected = baseline.results;
+            expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                          [&](const bench::Result& r) {
+                                              return r.name.find(options.filter) == std::string::npos;
+                                          }),
+                           expected.end());
+            std::cout << "\n";
+            size_t regressions = bench::writeComparison(
+                std::cout, bench::compare(baseline.results, report.results, threshold));
+            return regressions > 0 ? 1 : 0;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "cosmic_bench: " << e.what() << "\n";
+        return 2;
+    }
+}
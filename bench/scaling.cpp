@@ -0,0 +1,325 @@
+/**
+ * @file scaling.cpp
+ * @brief cosmic_scaling: thread-count and problem-size scaling study
+ *
+ * Sweeps thread count and problem size for the library's parallel paths:
+ * tree enumeration (nodes n), clustering (nodes n), hierarchy building
+ * (levels), fractal enneagram geometry (nesting depth) and loon population
+ * ensembles (loons). Each run is timed with the cosmic_bench harness and
+ * reports throughput, speedup and parallel efficiency against the serial
+ * run of the same size, and the peak resident set size.
+ *
+ * Usage:
+ *   cosmic_scaling [--threads MAX] [--workload NAME] [--quick]
+ *                  [--min-time SECONDS] [--repetitions N]
+ *                  [--csv FILE] [--svg PREFIX]
+ *
+ * Writes FILE (default scaling.csv) and one speedup plot per workload,
+ * PREFIX-<workload>.svg (default prefix "scaling").
+ */
+
+#include "bench.hpp"
+#include "cosmic/cosmic.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace cosmic;
+
+namespace {
+
+// ============================================================================
+// Peak RSS
+// ============================================================================
+
+/// Reset the peak RSS counter where the OS allows it (Linux >= 4.0)
+void resetPeakRSS() {
+#ifdef __linux__
+    std::ofstream clear("/proc/self/clear_refs");
+    if (clear) clear << "5";
+#endif
+}
+
+/// Peak resident set size in KiB (since the last reset where supported)
+long peakRSSKiB() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::stol(line.substr(6));
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+// ============================================================================
+// Workloads
+// ============================================================================
+
+/**
+ * A workload prepares a run for (size, pool) and reports how many items
+ * one iteration processes.
+ */
+struct Workload {
+    std::string name;
+    std::string size_label;
+    std::vector<int> sizes;
+    std::vector<int> quick_sizes;
+    std::function<bench::Body(int size, parallel::ThreadPool* pool, double& items)> prepare;
+};
+
+std::vector<Workload> workloads() {
+    std::vector<Workload> list;
+
+    list.push_back({"trees", "nodes", {8, 9, 10}, {6, 7},
+        [](int n, parallel::ThreadPool* pool, double& items) -> bench::Body {
+            items = static_cast<double>(trees::a000081(n));
+            return [n, pool](size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    auto result = trees::RootedTreeGenerator::enumerate(n, pool);
+                    bench::doNotOptimize(result);
+                }
+            };
+        }});
+
+    list.push_back({"clustering", "nodes", {8, 9, 10}, {6, 7},
+        [](int n, parallel::ThreadPool* pool, double& items) -> bench::Body {
+            auto input = std::make_shared<std::vector<trees::RootedTree>>(
+                trees::RootedTreeGenerator::generate(n));
+            items = static_cast<double>(input->size());
+            return [input, pool](size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    auto clusters = trees::FlipTransform::groupIntoClusters(*input, pool);
+                    bench::doNotOptimize(clusters);
+                }
+            };
+        }});
+
+    list.push_back({"hierarchy", "levels", {4, 7, 10}, {3, 5},
+        [](int levels, parallel::ThreadPool* pool, double& items) -> bench::Body {
+            items = levels;
+            return [levels, pool](size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    auto root = System::createHierarchy(pool, levels);
+                    bench::doNotOptimize(root);
+                }
+            };
+        }});
+
+    list.push_back({"geometry", "depth", {3, 4, 5}, {2, 3},
+        [](int depth, parallel::ThreadPool* pool, double& items) -> bench::Body {
+            double count = 0.0;
+            for (double level = 1.0, k = 0; k <= depth; ++k, level *= 9.0) count += level;
+            items = count;
+            return [depth, pool](size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    auto all = geometry::fractalEnneagrams(depth, geometry::Circle({0, 0}, 1.0),
+                                                           0.25, pool);
+                    bench::doNotOptimize(all);
+                }
+            };
+        }});
+
+    list.push_back({"population", "loons", {1 << 14, 1 << 16, 1 << 18}, {1 << 12, 1 << 14},
+        [](int loons, parallel::ThreadPool* pool, double& items) -> bench::Body {
+            constexpr int STEPS = 10;
+            items = static_cast<double>(loons) * STEPS;
+            auto lake = std::make_shared<population::LoonPopulation>(static_cast<size_t>(loons));
+            lake->setCoupling(0.5);
+            lake->setDissipation(0.1);
+            lake->setThreadPool(pool);
+            return [lake](size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    for (int s = 0; s < STEPS; ++s) lake->communicate(0.01);
+                }
+                bench::doNotOptimize(*lake);
+            };
+        }});
+
+    return list;
+}
+
+// ============================================================================
+// Study
+// ============================================================================
+
+struct Row {
+    std::string workload;
+    int size;
+    size_t threads;
+    double median_ns;
+    double throughput;
+    double speedup;
+    double efficiency;
+    long peak_rss_kib;
+};
+
+std::vector<size_t> threadCounts(size_t max_threads) {
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+    return counts;
+}
+
+void writeCSV(std::ostream& out, const std::vector<Row>& rows) {
+    out << "workload,size,threads,median_ns,throughput_per_s,speedup,efficiency,peak_rss_kib\n";
+    char line[256];
+    for (const auto& r : rows) {
+        std::snprintf(line, sizeof(line), "%s,%d,%zu,%.6g,%.6g,%.4f,%.4f,%ld\n",
+                      r.workload.c_str(), r.size, r.threads, r.median_ns, r.throughput,
+                      r.speedup, r.efficiency, r.peak_rss_kib);
+        out << line;
+    }
+}
+
+std::string speedupPlot(const Workload& workload, const std::vector<Row>& rows,
+                        const std::vector<size_t>& threads) {
+    static const char* COLORS[] = {"#1f77b4", "#d62728", "#2ca02c", "#9467bd", "#ff7f0e"};
+    std::vector<geometry::svg::PlotSeries> series;
+
+    geometry::svg::PlotSeries ideal;
+    ideal.label = "ideal";
+    ideal.color = "#999";
+    ideal.dashed = true;
+    for (size_t t : threads) {
+        ideal.points.emplace_back(static_cast<double>(t), static_cast<double>(t));
+    }
+    series.push_back(ideal);
+
+    size_t color = 0;
+    for (const auto& row : rows) {
+        if (row.workload != workload.name) continue;
+        if (series.size() == 1 || series.back().label != workload.size_label + " " +
+                                                          std::to_string(row.size)) {
+            geometry::svg::PlotSeries s;
+            s.label = workload.size_label + " " + std::to_string(row.size);
+            s.color = COLORS[color++ % 5];
+            series.push_back(s);
+        }
+        series.back().points.emplace_back(static_cast<double>(row.threads), row.speedup);
+    }
+    return geometry::svg::linePlot(series, "Speedup: " + workload.name, "threads",
+                                   "speedup over 1 thread");
+}
+
+void usage(std::ostream& out) {
+    out << "usage: cosmic_scaling [--threads MAX] [--workload NAME] [--quick]\n"
+           "                      [--min-time SECONDS] [--repetitions N]\n"
+           "                      [--csv FILE] [--svg PREFIX]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        std::string only;
+        std::string csv_path = "scaling.csv";
+        std::string svg_prefix = "scaling";
+        bool quick = false;
+        bench::Options options;
+        options.min_time = 0.1;
+        options.repetitions = 3;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--threads" && has_value) max_threads = std::max<size_t>(std::stoul(argv[++i]), 1);
+            else if (arg == "--workload" && has_value) only = argv[++i];
+            else if (arg == "--quick") quick = true;
+            else if (arg == "--min-time" && has_value) options.min_time = std::stod(argv[++i]);
+            else if (arg == "--repetitions" && has_value) options.repetitions = std::stoul(argv[++i]);
+            else if (arg == "--csv" && has_value) csv_path = argv[++i];
+            else if (arg == "--svg" && has_value) svg_prefix = argv[++i];
+            else {
+                usage(arg == "--help" ? std::cout : std::cerr);
+                return arg == "--help" ? 0 : 2;
+            }
+        }
+
+        auto threads = threadCounts(max_threads);
+        std::vector<Row> rows;
+        std::vector<Workload> studied;
+
+        for (const auto& workload : workloads()) {
+            if (!only.empty() && workload.name != only) continue;
+            studied.push_back(workload);
+            for (int size : quick ? workload.quick_sizes : workload.sizes) {
+                double serial_ns = 0.0;
+                for (size_t t : threads) {
+                    // The calling thread works alongside the pool's workers
+                    std::unique_ptr<parallel::ThreadPool> pool;
+                    if (t > 1) pool = std::make_unique<parallel::ThreadPool>(t - 1);
+
+                    double items = 0.0;
+                    resetPeakRSS();
+                    bench::Benchmark b{workload.name, workload.name,
+                                       workload.prepare(size, pool.get(), items)};
+                    bench::Result r = bench::measure(b, options);
+
+                    Row row;
+                    row.workload = workload.name;
+                    row.size = size;
+                    row.threads = t;
+                    row.median_ns = r.median_ns;
+                    row.throughput = r.median_ns > 0.0 ? items * 1e9 / r.median_ns : 0.0;
+                    if (t == threads.front()) serial_ns = r.median_ns;
+                    row.speedup = r.median_ns > 0.0 ? serial_ns / r.median_ns : 0.0;
+                    row.efficiency = row.speedup / static_cast<double>(t);
+                    row.peak_rss_kib = peakRSSKiB();
+                    rows.push_back(row);
+
+                    std::printf("%-11s %s=%-7d threads=%-3zu %12.0f items/s  speedup %5.2f  "
+                                "efficiency %5.1f%%  rss %ld KiB\n",
+                                row.workload.c_str(), workload.size_label.c_str(), size, t,
+                                row.throughput, row.speedup, 100.0 * row.efficiency,
+                                row.peak_rss_kib);
+                    std::fflush(stdout);
+                }
+            }
+        }
+        if (studied.empty()) {
+            std::cerr << "cosmic_scaling: unknown workload '" << only << "'\n";
+            return 2;
+        }
+
+        std::ofstream csv(csv_path);
+        if (!csv) throw std::runtime_error("Cannot open output file: " + csv_path);
+        writeCSV(csv, rows);
+        std::cout << "wrote " << csv_path << "\n";
+
+        for (const auto& workload : studied) {
+            std::string path = svg_prefix + "-" + workload.name + ".svg";
+            std::ofstream svg(path);
+            if (!svg) throw std::runtime_error("Cannot open output file: " + path);
+            svg << speedupPlot(workload, rows, threads);
+            std::cout << "wrote " << path << "\n";
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "cosmic_scaling: " << e.what() << "\n";
+        return 2;
+    }
+}
@@ -149,6 +149,39 @@ void demonstrateVerification() {
     std::cout << "\n" << (allPassed ? "All verifications PASSED!" : "Some verifications FAILED!") << "\n";
 }
 
+void demonstrateStreamingEnumeration() {
+    printHeader("STREAMING ENUMERATION (larger n)");
+
+    std::cout << "\nRootedSequence and FreeSequence step through the trees in place,\n";
+    std::cout << "so counts can be checked well beyond the in-memory generator.\n\n";
+
+    std::cout << std::setw(8) << "Nodes"
+              << std::setw(15) << "Rooted"
+              << std::setw(15) << "A000081"
+              << std::setw(15) << "Free"
+              << std::setw(15) << "A000055" << "\n";
+    std::cout << std::string(68, '-') << "\n";
+
+    for (int n = 7; n <= 16; ++n) {
+        uint64_t rooted = 1;
+        enumeration::RootedSequence rootedTrees(n);
+        while (rootedTrees.next()) ++rooted;
+        uint64_t free = 1;
+        enumeration::FreeSequence freeTrees(n);
+        while (freeTrees.next()) ++free;
+
+        std::cout << std::setw(8) << n
+                  << std::setw(15) << rooted
+                  << std::setw(15) << enumeration::rootedTreeCount(n)
+                  << std::setw(15) << free
+                  << std::setw(15) << enumeration::freeTreeCount(n) << "\n";
+    }
+
+    std::cout << "\nFull catalogs, e.g. for n = 22 (" << enumeration::rootedTreeCount(22)
+              << " rooted trees):\n";
+    std::cout << "  cosmic_gen -n 22 --engine parallel --format binary -o trees22.bin\n";
+}
+
 void demonstrateSystem3Terms() {
     printHeader("SYSTEM 3 - FOUR FUNDAMENTAL TERMS");
     
@@ -231,6 +264,7 @@ int main() {
     demonstrateOEISSequences();
     demonstrateSystemHierarchy();
     demonstrateVerification();
+    demonstrateStreamingEnumeration();
     demonstrateTreeGeneration();
     demonstrateFlipTransform();
     demonstrateSystem3Terms();
@@ -0,0 +1,208 @@
+/**
+ * @file animation.hpp
+ * @brief Streaming SVG animation of simulation state
+ *
+ * System1::toSVG() and System2::toSVG() render one instant as a complete
+ * document. For long runs this module writes the static scene once and then
+ * streams only the animated attributes to an output stream:
+ *
+ * - SmilWriter produces a single animated SVG. Each channel (one attribute
+ *   of one element) becomes a chain of SMIL <animate> segments between
+ *   keyframes.
+ * - DeltaStreamWriter produces a compact line-oriented stream: the scene
+ *   once, then per frame only the channels whose value moved visibly.
+ *
+ * Both writers decimate adaptively. SmilWriter keeps a keyframe only when
+ * linear interpolation would drift more than a channel's threshold from
+ * the sampled values (swinging-door compression). DeltaStreamWriter skips
+ * values within the threshold of the last one written. Memory use is
+ * constant in the number of frames.
+ */
+
+#ifndef COSMIC_ANIMATION_HPP
+#define COSMIC_ANIMATION_HPP
+
+#include "system1.hpp"
+#include "system2.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cosmic {
+namespace animation {
+
+// ============================================================================
+// Scenes
+// ============================================================================
+
+/**
+ * @brief One animated attribute of one scene element
+ */
+struct Channel {
+    std::string target;     ///< Element id
+    std::string attribute;  ///< Attribute name (e.g. "r", "fill-opacity")
+    double threshold;       ///< Smallest visible change, in attribute units
+};
+
+/**
+ * @brief Static part of an animation plus its animated channels
+ */
+struct Scene {
+    int width = 0;
+    int height = 0;
+    std::string header;              ///< Document from <?xml ...> through the static elements
+    std::string footer = "</svg>\n";
+    std::vector<Channel> channels;
+};
+
+/// Scene for System 1: center intensity, interface activity, communicative balance
+Scene system1Scene(int width = 600, int height = 300);
+
+/// Scene for System 2: center intensities, mode balance, coalescence, transposition phase
+Scene system2Scene(int width = 800, int height = 400);
+
+/// Channel values of a System 1 for a scene from system1Scene()
+void values(const system1::System1& system, const Scene& scene, std::vector<double>& out);
+
+/// Channel values of a System 2 for a scene from system2Scene()
+void values(const system2::System2& system, const Scene& scene, std::vector<double>& out);
+
+// ============================================================================
+// Decimation
+// ============================================================================
+
+/**
+ * @brief Streaming piecewise-linear compression (swinging door)
+ *
+ * Keyframes are chosen so that linear interpolation between consecutive
+ * keyframes stays within the tolerance of every sample. Uses O(1) memory.
+ */
+class LinearDecimator {
+public:
+    struct Keyframe {
+        double time;
+        double value;
+    };
+
+    explicit LinearDecimator(double tolerance);
+
+    /**
+     * @brief Add a sample (times must increase)
+     * @return true if a keyframe was finalized and written to @p out
+     */
+    bool add(double time, double value, Keyframe& out);
+
+    /// Finalize the last keyframe, if any samples are pending
+    bool finish(Keyframe& out);
+
+private:
+    double tolerance_;
+    bool has_anchor_ = false;
+    bool has_pending_ = false;
+    Keyframe anchor_{0.0, 0.0};
+    Keyframe last_{0.0, 0.0};
+    double slope_lo_ = 0.0;
+    double slope_hi_ = 0.0;
+};
+
+// ============================================================================
+// Writers
+// ============================================================================
+
+/**
+ * @brief Streams an animated SVG (SMIL) document
+ *
+ * The scene header is written on construction; finish() (or the
+ * destructor) writes the remaining keyframes and closes the document.
+ */
+class SmilWriter {
+public:
+    /**
+     * @param out Sink for the document
+     * @param scene Scene to animate
+     * @param seconds_per_time_unit Animation seconds per unit of simulation time
+     */
+    SmilWriter(std::ostream& out, Scene scene, double seconds_per_time_unit = 1.0);
+    ~SmilWriter();
+
+    SmilWriter(const SmilWriter&) = delete;
+    SmilWriter& operator=(const SmilWriter&) = delete;
+
+    /// Add a frame of channel values at simulation time @p time
+    void frame(double time, const std::vector<double>& values);
+
+    /// Add a frame sampled from a system
+    void frame(const system1::System1& system);
+    void frame(const system2::System2& system);
+
+    /// Flush pending keyframes and close the document
+    void finish();
+
+    size_t frameCount() const { return frames_; }
+    size_t keyframeCount() const { return keyframes_; }
+
+private:
+    void emit(size_t channel, const LinearDecimator::Keyframe& key);
+
+    std::ostream& out_;
+    Scene scene_;
+    double scale_;
+    double start_time_ = 0.0;
+    std::vector<LinearDecimator> decimators_;
+    std::vector<LinearDecimator::Keyframe> previous_;
+    std::vector<bool> has_previous_;
+    std::vector<double> scratch_;
+    size_t frames_ = 0;
+    size_t keyframes_ = 0;
+    bool finished_ = false;
+};
+
+/**
+ * @brief Streams a compact per-frame delta animation
+ *
+ * Format (text, one record per line):
+ * @code
+ * COSMIC-ANIM 1
+ * scene <width> <height> <channels>
+ * channel <index> <target> <attribute> <threshold>
+ * svg <bytes>
+ * <static SVG document of exactly <bytes> bytes>
+ * f <time> <index>=<value> ...
+ * end <frames> <written frames>
+ * @endcode
+ * A frame line lists only channels that moved beyond their threshold since
+ * their last written value; frames with no visible change are omitted.
+ */
+class DeltaStreamWriter {
+public:
+    DeltaStreamWriter(std::ostream& out, Scene scene);
+    ~DeltaStreamWriter();
+
+    DeltaStreamWriter(const DeltaStreamWriter&) = delete;
+    DeltaStreamWriter& operator=(const DeltaStreamWriter&) = delete;
+
+    void frame(double time, const std::vector<double>& values);
+    void frame(const system1::System1& system);
+    void frame(const system2::System2& system);
+
+    /// Write the trailer
+    void finish();
+
+    size_t frameCount() const { return frames_; }
+    size_t writtenFrameCount() const { return written_; }
+
+private:
+    std::ostream& out_;
+    Scene scene_;
+    std::vector<double> last_;
+    std::vector<double> scratch_;
+    size_t frames_ = 0;
+    size_t written_ = 0;
+    bool finished_ = false;
+};
+
+} // namespace animation
+} // namespace cosmic
+
+#endif // COSMIC_ANIMATION_HPP
@@ -0,0 +1,558 @@
+/**
+ * @file async.hpp
+ * @brief C++20 coroutine API for long-running generation and export
+ *
+ * Calls like RootedTreeGenerator::generate(), System::createHierarchy() and
+ * Serializer::hierarchyToJSON() block until they finish. The coroutines
+ * here do the same work as awaitable tasks and async generators:
+ *
+ *   Task<T>            a lazily started computation; co_await it for the result
+ *   AsyncGenerator<T>  a stream of items; co_await next() for each
+ *   Context            the executor to run on, a cancellation token and a
+ *                      progress callback
+ *
+ * Work runs on the context's executor (nullptr: on the awaiting thread), so
+ * a request thread that starts a job is not tied up until it finishes.
+ * Cancellation is cooperative. Each job checks its token between steps (a
+ * batch of trees, a System, a piece of output) and throws Cancelled.
+ * Progress callbacks may be called from executor threads, and for
+ * createHierarchy() from several at once.
+ *
+ * The layer needs C++20. It is built when the library is configured with
+ * COSMIC_ENABLE_COROUTINES=ON (which compiles the library as C++20), and
+ * cosmic.hpp includes it only then.
+ *
+ * Example:
+ * @code
+ * async::CancellationSource cancel;
+ * async::Context context{&pool, cancel.token(),
+ *                        [](uint64_t done, uint64_t total) { report(done, total); }};
+ *
+ * async::Task<> export_all = [&]() -> async::Task<> {
+ *     auto root = co_await async::createHierarchy(context);
+ *     auto chunks = async::hierarchyJSON(root, context);
+ *     while (auto chunk = co_await chunks.next()) socket.write(*chunk);
+ * }();
+ * async::syncWait(std::move(export_all));   // or co_await it from another task
+ * @endcode
+ */
+
+#ifndef COSMIC_ASYNC_HPP
+#define COSMIC_ASYNC_HPP
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "cosmic/async.hpp needs C++20 coroutines (configure with COSMIC_ENABLE_COROUTINES=ON)"
+#endif
+
+#include "geometry.hpp"
+#include "parallel.hpp"
+#include "system.hpp"
+#include "trees.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cosmic {
+namespace async {
+
+// ============================================================================
+// Cancellation and Progress
+// ============================================================================
+
+/// Thrown by a job whose token was cancelled
+class Cancelled : public std::runtime_error {
+public:
+    Cancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+/// Read side of a cancellation flag; a default token is never cancelled
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    bool cancelled() const { return state_ && state_->load(std::memory_order_relaxed); }
+
+    /// @throws Cancelled if cancellation was requested
+    void throwIfCancelled() const {
+        if (cancelled()) throw Cancelled();
+    }
+
+private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<const std::atomic<bool>> state_;
+};
+
+/// Write side of a cancellation flag
+class CancellationSource {
+public:
+    CancellationSource() : state_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    /// Ask every job holding a token of this source to stop
+    void cancel() { state_->store(true, std::memory_order_relaxed); }
+
+    bool cancelled() const { return state_->load(std::memory_order_relaxed); }
+
+    CancellationToken token() const { return CancellationToken(state_); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> state_;
+};
+
+/// Called with the units of work done so far and the total
+using ProgressCallback = std::function<void(uint64_t done, uint64_t total)>;
+
+/// Where and how a job runs
+struct Context {
+    parallel::Executor* executor = nullptr;   ///< nullptr: on the awaiting thread
+    CancellationToken cancel;
+    ProgressCallback progress;
+
+    void report(uint64_t done, uint64_t total) const {
+        if (progress) progress(done, total);
+    }
+};
+
+// ============================================================================
+// Task
+// ============================================================================
+
+template<typename T = void>
+class Task;
+
+namespace detail {
+
+/// Resumes whoever awaited the finished coroutine
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+        auto continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    void rethrow() const {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+template<typename T>
+struct TaskPromise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+    void return_value(T result) { value.emplace(std::move(result)); }
+
+    T result() {
+        rethrow();
+        return std::move(*value);
+    }
+};
+
+template<>
+struct TaskPromise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void result() const { rethrow(); }
+};
+
+} // namespace detail
+
+/**
+ * @brief A lazily started coroutine producing a T
+ *
+ * Nothing runs until the task is awaited; the awaiting coroutine is resumed
+ * where the task finishes. Exceptions propagate to the awaiter.
+ */
+template<typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() const { return handle.promise().result(); }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    friend struct detail::TaskPromise<T>;
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/// A coroutine that starts at once and frees itself when done
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+struct Latch {
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+
+    void set() {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        done_cv.notify_all();   // Under the lock: the waiter may destroy the latch once it sees done
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [this] { return done; });
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Run @p task to completion from ordinary code and return its result
+ *
+ * Blocks the calling thread; meant for main() and tests, not for threads
+ * of the executor the task runs on.
+ */
+template<typename T>
+T syncWait(Task<T> task) {
+    detail::Latch latch;
+    std::exception_ptr error;
+    if constexpr (std::is_void_v<T>) {
+        [](Task<T>& task, detail::Latch& latch, std::exception_ptr& error) -> detail::Detached {
+            try {
+                co_await task;
+            } catch (...) {
+                error = std::current_exception();
+            }
+            latch.set();
+        }(task, latch, error);
+        latch.wait();
+        if (error) std::rethrow_exception(error);
+    } else {
+        std::optional<T> value;
+        [](Task<T>& task, detail::Latch& latch, std::optional<T>& value,
+           std::exception_ptr& error) -> detail::Detached {
+            try {
+                value.emplace(co_await task);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            latch.set();
+        }(task, latch, value, error);
+        latch.wait();
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+/**
+ * @brief Continue the awaiting coroutine as a task on @p executor
+ *
+ * With nullptr the coroutine simply continues.
+ */
+inline auto resumeOn(parallel::Executor* executor) {
+    struct Awaiter {
+        parallel::Executor* executor;
+
+        bool await_ready() const noexcept { return executor == nullptr; }
+
+        void await_suspend(std::coroutine_handle<> handle) const {
+            executor->submit([handle] { handle.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{executor};
+}
+
+/**
+ * @brief Run fn(i) for every i in [0, count) as separate tasks on @p executor
+ *
+ * The awaiting coroutine continues on whichever thread finishes last. The
+ * first exception thrown by fn is rethrown. With nullptr the calls run in
+ * order on the awaiting thread.
+ */
+template<typename Fn>
+auto runAll(parallel::Executor* executor, size_t count, Fn fn) {
+    struct Awaiter {
+        Awaiter(parallel::Executor* executor, size_t count, Fn fn)
+            : executor(executor), count(count), fn(std::move(fn)) {}
+
+        parallel::Executor* executor;
+        size_t count;
+        Fn fn;
+        std::atomic<size_t> remaining{0};
+        std::mutex mutex;
+        std::exception_ptr error;
+
+        bool await_ready() {
+            if (executor && count > 0) return false;
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return true;
+        }
+
+        void runOne(size_t i) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            // One extra count for this function, so the coroutine is only
+            // resumed by a task once await_suspend has stopped using *this
+            remaining.store(count + 1, std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i) {
+                try {
+                    executor->submit([this, i, handle] {
+                        runOne(i);
+                        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) handle.resume();
+                    });
+                } catch (...) {
+                    runOne(i);   // The executor refused the task: run it here
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                }
+            }
+            return remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+        void await_resume() const {
+            if (error) std::rethrow_exception(error);
+        }
+    };
+    return Awaiter(executor, count, std::move(fn));
+}
+
+// ============================================================================
+// AsyncGenerator
+// ============================================================================
+
+/**
+ * @brief A coroutine producing a sequence of T, one co_await at a time
+ *
+ * The generator may itself co_await (for instance resumeOn()), so items
+ * can be produced on an executor. Exceptions, including Cancelled, come
+ * out of next(). Destroying the generator abandons the rest.
+ */
+template<typename T>
+class [[nodiscard]] AsyncGenerator {
+public:
+    struct promise_type {
+        /// Switches back to the coroutine waiting in next()
+        struct ToConsumer {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                return handle.promise().consumer;
+            }
+            void await_resume() const noexcept {}
+        };
+
+        std::optional<T> value;
+        std::coroutine_handle<> consumer;
+        std::exception_ptr error;
+
+        AsyncGenerator get_return_object() noexcept {
+            return AsyncGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        /// Hand the item to the consumer and wait for the next request
+        ToConsumer yield_value(T item) {
+            value.emplace(std::move(item));
+            return {};
+        }
+
+        ToConsumer final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    AsyncGenerator(AsyncGenerator&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    AsyncGenerator& operator=(AsyncGenerator&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~AsyncGenerator() {
+        if (handle_) handle_.destroy();
+    }
+
+    /// Awaitable for the next item, or std::nullopt after the last one
+    auto next() {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) const noexcept {
+                handle.promise().consumer = consumer;
+                handle.promise().value.reset();
+                return handle;
+            }
+
+            std::optional<T> await_resume() const {
+                auto& promise = handle.promise();
+                if (promise.error) std::rethrow_exception(std::exchange(promise.error, nullptr));
+                if (handle.done()) return std::nullopt;
+                return std::move(promise.value);
+            }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    explicit AsyncGenerator(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/// Gather every item of a generator
+template<typename T>
+Task<std::vector<T>> collect(AsyncGenerator<T> items) {
+    std::vector<T> result;
+    while (auto item = co_await items.next()) result.push_back(std::move(*item));
+    co_return result;
+}
+
+/// Concatenate the chunks of a generator
+inline Task<std::string> concat(AsyncGenerator<std::string> chunks) {
+    std::string result;
+    while (auto chunk = co_await chunks.next()) result += *chunk;
+    co_return result;
+}
+
+// ============================================================================
+// Operations
+// ============================================================================
+
+/**
+ * @brief Every rooted tree with @p nodes nodes (1-32), in STATIC_TREES order
+ *
+ * Trees are enumerated in batches of @p batch on the executor, with a
+ * cancellation check and a progress report (trees of A000081(n)) per batch.
+ * The order is canonical-string order, not RootedTreeGenerator's.
+ */
+AsyncGenerator<trees::RootedTree> rootedTrees(int nodes, Context context, size_t batch = 4096);
+
+/**
+ * @brief RootedTreeGenerator::generate(@p n) on the executor
+ *
+ * Same result and order as generate(n). Cancellation is checked before the
+ * generation starts; use rootedTrees() to be able to stop part way.
+ */
+Task<std::vector<trees::RootedTree>> generateTrees(int n, Context context);
+
+/**
+ * @brief System::createHierarchy(executor, @p levels), one task per System
+ *
+ * Each System is built as its own task on the executor, with a
+ * cancellation check before it and a progress report after it.
+ * @throws std::invalid_argument (from the task) if levels is not in [1, 10]
+ */
+Task<System::SystemPtr> createHierarchy(Context context, int levels = 10);
+
+/**
+ * @brief Serializer::hierarchyToJSON(@p root) in pieces, one per System
+ *
+ * Concatenated, the pieces are exactly hierarchyToJSON(root). Each System
+ * is serialised as its own executor task, after a cancellation check.
+ */
+AsyncGenerator<std::string> hierarchyJSON(System::SystemPtr root, Context context);
+
+/// Serializer::hierarchyToJSON(@p root) as a task (the pieces of hierarchyJSON(), joined)
+Task<std::string> hierarchyToJSON(System::SystemPtr root, Context context);
+
+/// svg::nestedEnneagramSVG() rendered on the executor
+Task<std::string> nestedEnneagramSVG(geometry::NestedEnneagramGeometry nested, double width, double height,
+                                     Context context);
+
+/**
+ * @brief svg::nestedEnneagramSVG() in chunks of at most @p chunk_size bytes
+ *
+ * The document is rendered on the executor, then handed out a chunk at a
+ * time with a cancellation check before each, for writing to a socket or
+ * file without holding a request thread.
+ */
+AsyncGenerator<std::string> nestedEnneagramSVGChunks(geometry::NestedEnneagramGeometry nested, double width,
+                                                     double height, Context context,
+                                                     size_t chunk_size = 1 << 16);
+
+} // namespace async
+} // namespace cosmic
+
+#endif // COSMIC_ASYNC_HPP
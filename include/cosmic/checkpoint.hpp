@@ -0,0 +1,163 @@
+/**
+ * @file checkpoint.hpp
+ * @brief Binary snapshots of simulation state for checkpoint/restore
+ *
+ * A snapshot is a small versioned header followed by a payload holding one
+ * or more records of the same kind (a single system or an ensemble):
+ *
+ *     "CSNP" | version u16 | kind u16 | count u32 | payload size u64 |
+ *     CRC-32 u32 | payload
+ *
+ * Records store every field of a system's State exactly, including the
+ * state of its random generator, so a restored simulation replays the
+ * original trajectory bit for bit. Multi-byte values are written in host
+ * byte order.
+ *
+ * Capturing a snapshot only copies state into a buffer; AsyncWriter moves
+ * the file I/O onto a background thread so long runs pause only for the
+ * copy.
+ */
+
+#ifndef COSMIC_CHECKPOINT_HPP
+#define COSMIC_CHECKPOINT_HPP
+
+#include "system1.hpp"
+#include "system2.hpp"
+#include "network.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cosmic {
+namespace checkpoint {
+
+/// Current snapshot format version
+constexpr uint16_t FORMAT_VERSION = 1;
+
+/**
+ * @brief Type of the records held in a snapshot
+ */
+enum class Kind : uint16_t {
+    SYSTEM1 = 1,
+    SYSTEM2 = 2,
+    LOON = 3,
+    FLASHLIGHT = 4,
+    NETWORK = 5
+};
+
+/**
+ * @brief Decoded snapshot header
+ */
+struct Header {
+    uint16_t version = FORMAT_VERSION;
+    Kind kind = Kind::SYSTEM1;
+    uint32_t count = 0;          ///< Number of records (1 for a single system)
+    uint64_t payload_size = 0;
+    uint32_t checksum = 0;       ///< CRC-32 of the payload
+};
+
+/// Size of the encoded header in bytes
+constexpr size_t HEADER_SIZE = 24;
+
+// ============================================================================
+// Snapshot and Restore
+// ============================================================================
+
+std::vector<uint8_t> snapshot(const system1::System1& system);
+std::vector<uint8_t> snapshot(const std::vector<system1::System1>& ensemble);
+std::vector<uint8_t> snapshot(const system1::LoonAnalogy& loon);
+std::vector<uint8_t> snapshot(const std::vector<system1::LoonAnalogy>& ensemble);
+std::vector<uint8_t> snapshot(const system2::System2& system);
+std::vector<uint8_t> snapshot(const std::vector<system2::System2>& ensemble);
+std::vector<uint8_t> snapshot(const system2::FlashlightAnalogy& flashlights);
+std::vector<uint8_t> snapshot(const network::System2Network& network);
+
+/**
+ * @brief Restore state from a snapshot
+ *
+ * Throws std::runtime_error if the snapshot is truncated, corrupt, of a
+ * different kind, or written by a newer format version. Ensemble overloads
+ * resize the vector to the number of records.
+ */
+void restore(const std::vector<uint8_t>& bytes, system1::System1& system);
+void restore(const std::vector<uint8_t>& bytes, std::vector<system1::System1>& ensemble);
+void restore(const std::vector<uint8_t>& bytes, system1::LoonAnalogy& loon);
+void restore(const std::vector<uint8_t>& bytes, std::vector<system1::LoonAnalogy>& ensemble);
+void restore(const std::vector<uint8_t>& bytes, system2::System2& system);
+void restore(const std::vector<uint8_t>& bytes, std::vector<system2::System2>& ensemble);
+void restore(const std::vector<uint8_t>& bytes, system2::FlashlightAnalogy& flashlights);
+void restore(const std::vector<uint8_t>& bytes, network::System2Network& network);
+
+/// Validate a snapshot and return its header
+Header inspect(const std::vector<uint8_t>& bytes);
+
+/// Compute the CRC-32 (IEEE) of a byte range
+uint32_t crc32(const uint8_t* data, size_t size);
+
+// ============================================================================
+// Files
+// ============================================================================
+
+/**
+ * @brief Write a snapshot to a file
+ *
+ * The data is written to a temporary file that is then renamed over
+ * @p path, so a crash mid-write never leaves a truncated checkpoint.
+ */
+void save(const std::string& path, const std::vector<uint8_t>& bytes);
+
+/// Read a snapshot file (validated)
+std::vector<uint8_t> load(const std::string& path);
+
+/**
+ * @brief Background checkpoint writer
+ *
+ * write() queues a snapshot and returns immediately; a dedicated thread
+ * saves queued snapshots in order. flush() waits for the queue to drain and
+ * rethrows the first write error. The destructor drains the queue.
+ */
+class AsyncWriter {
+public:
+    AsyncWriter();
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /// Queue a snapshot to be saved to @p path
+    void write(std::string path, std::vector<uint8_t> bytes);
+
+    /// Wait until all queued snapshots are written
+    void flush();
+
+    /// Get the number of snapshots not yet written
+    size_t pending() const;
+
+    /// Get the number of snapshots written so far
+    size_t written() const;
+
+private:
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::pair<std::string, std::vector<uint8_t>>> queue_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    size_t written_ = 0;
+    std::exception_ptr error_;
+    std::thread thread_;         ///< Declared last: starts once the state above exists
+};
+
+} // namespace checkpoint
+} // namespace cosmic
+
+#endif // COSMIC_CHECKPOINT_HPP
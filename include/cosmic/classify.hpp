@@ -0,0 +1,93 @@
+/**
+ * @file classify.hpp
+ * @brief Fast classification of parenthesis tree strings
+ *
+ * Classifies a tree written as a RootedTree::canonical()-style parenthesis
+ * string without building RootedTree or UnrootedTree objects. For each
+ * string it reports:
+ *
+ *   nodes     the number of nodes
+ *   id        the rooted tree's index among all rooted trees with that many
+ *             nodes, sorted by canonical string (STATIC_TREES order)
+ *   cluster   its unrooted class, numbered as FlipTransform orders them
+ *
+ * The children of a node may be written in any order. Trees of up to 16
+ * nodes are supported (the packed level sequence limit). The catalog for a
+ * size is built on first use and shared by all threads.
+ *
+ * Example:
+ * @code
+ * auto r = classify::classifyTree("(()(()))");
+ * // r.status == classify::Status::Ok, r.nodes == 4, r.id == 2, r.cluster == 0
+ * @endcode
+ */
+
+#ifndef COSMIC_CLASSIFY_HPP
+#define COSMIC_CLASSIFY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace cosmic {
+namespace classify {
+
+/// Largest tree that can be classified
+constexpr int MAX_NODES = 16;
+
+/// Outcome of classifying one string
+enum class Status {
+    Ok,
+    Empty,              ///< No characters
+    InvalidCharacter,   ///< Something other than '(' and ')'
+    Unbalanced,         ///< Not exactly one balanced tree
+    TooLarge            ///< More than MAX_NODES nodes
+};
+
+/// Short name of a status ("ok", "empty", "invalid-character", ...)
+const char* toString(Status status);
+
+/// Classification of one tree string
+struct Result {
+    Status status = Status::Empty;
+    int nodes = 0;
+    uint32_t id = 0;
+    uint32_t cluster = 0;
+};
+
+/**
+ * @brief Check the characters of a string and count its nodes
+ *
+ * Checks eight bytes at a time that every character is a parenthesis and
+ * that there are as many opens as closes. Balance is checked while
+ * parsing.
+ */
+Status validate(std::string_view text, int& nodes);
+
+/// Classify one tree string
+Result classifyTree(std::string_view text);
+
+/**
+ * @brief All rooted trees of one size, for lookups
+ */
+struct Catalog {
+    int nodes = 0;
+    std::vector<uint64_t> keys;        ///< Canonical key of each tree, descending
+    std::vector<uint32_t> clusters;    ///< Cluster of each tree
+    size_t cluster_count = 0;
+};
+
+/**
+ * @brief Catalog of the trees with @p nodes nodes (1-MAX_NODES)
+ *
+ * Built on first use (under a second for 16 nodes in a release build) and
+ * kept for the process.
+ * @throws std::out_of_range for other sizes
+ */
+const Catalog& catalog(int nodes);
+
+} // namespace classify
+} // namespace cosmic
+
+#endif // COSMIC_CLASSIFY_HPP
@@ -58,6 +58,74 @@
 // Operations and transformations
 #include "operations.hpp"
 
+// Simulation trace recording
+#include "recorder.hpp"
+
+// Batched math kernels, parallel loops and coupled System 2 networks
+#include "fastmath.hpp"
+#include "parallel.hpp"
+#include "network.hpp"
+
+// Checkpoint/restore of simulation state
+#include "random.hpp"
+#include "checkpoint.hpp"
+
+// Parameter sweeps
+#include "sweep.hpp"
+
+// Streaming SVG animation
+#include "animation.hpp"
+
+// Spectral analysis
+#include "spectral.hpp"
+
+// Adaptive time stepping
+#include "integrator.hpp"
+
+// Loon populations sharing one sky
+#include "population.hpp"
+
+// Tracing spans and Chrome trace export
+#include "tracing.hpp"
+
+// Counters, latency histograms and the metrics registry
+#include "metrics.hpp"
+
+// Allocation accounting and memory resources
+#include "memory.hpp"
+
+// Succinct balanced-parentheses tree catalogs
+#include "succinct.hpp"
+
+// Implicit array layout for enneagram nestings
+#include "layout.hpp"
+
+// Rooted tree tables generated at build time
+#include "tree_tables.hpp"
+
+// Compile-time specialised Systems 0-5
+#include "fixed_system.hpp"
+
+// constexpr rooted tree enumeration
+#include "static_trees.hpp"
+
+// Bulk classification of parenthesis tree strings
+#include "classify.hpp"
+
+// Streaming enumeration of rooted and free trees
+#include "enumeration.hpp"
+
+// Term lookup service over a Unix domain socket
+#include "service.hpp"
+
+// Sharded enumeration and the k-way catalog merge
+#include "sharding.hpp"
+
+// C++20 coroutine API (with COSMIC_ENABLE_COROUTINES)
+#ifdef COSMIC_ENABLE_COROUTINES
+#include "async.hpp"
+#endif
+
 /**
  * @namespace cosmic
  * @brief The Cosmic System Library namespace
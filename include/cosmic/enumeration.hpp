@@ -0,0 +1,188 @@
+/**
+ * @file enumeration.hpp
+ * @brief Streaming enumeration of rooted and free trees up to 32 nodes
+ *
+ * RootedTreeGenerator and the tree tables hold every tree in memory, which
+ * stops being practical in the high teens. The sequences here step from one
+ * tree to the next in place, so any n up to MAX_NODES can be walked in
+ * constant memory and the work split into rank ranges:
+ *
+ *   RootedSequence   canonical level sequences in Beyer-Hedetniemi order,
+ *                    the STATIC_TREES and classify id order (A000081)
+ *   FreeSequence     free trees rooted at their center, in Wright-Richmond-
+ *                    Odlyzko-McKay order (A000055)
+ *
+ * Trees are identified by 64-bit balanced-parentheses keys: open bits are
+ * 1, close bits 0, most significant bit first, zero padded. This is the
+ * RootedTree::canonical() string with '(' as 1, and comparing keys compares
+ * level sequences, so 2n bits hold any tree of up to 32 nodes. The cluster
+ * of a rooted tree is named by the key of its free tree rooted at the
+ * center (the larger key for bicentral trees), which is what FreeSequence
+ * reports for each free tree.
+ *
+ * Catalogs written by cosmic_gen are sections of fixed-size records after
+ * a CatalogHeader; multi-byte values are in host byte order.
+ *
+ * Example:
+ * @code
+ * enumeration::RootedSequence trees(20);
+ * do {
+ *     uint64_t cluster = enumeration::centerKey(trees.levels());
+ * } while (trees.next());
+ * @endcode
+ */
+
+#ifndef COSMIC_ENUMERATION_HPP
+#define COSMIC_ENUMERATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cosmic {
+namespace enumeration {
+
+/// Largest tree a 64-bit balanced-parentheses key can hold
+constexpr int MAX_NODES = 32;
+
+/// Number of rooted trees with n nodes (A000081), for 0-MAX_NODES
+uint64_t rootedTreeCount(int nodes);
+
+/// Number of free trees with n nodes (A000055), for 0-MAX_NODES
+uint64_t freeTreeCount(int nodes);
+
+/**
+ * @brief A level sequence: node depths in preorder
+ */
+struct Levels {
+    int8_t depth[MAX_NODES] = {};
+    int size = 0;
+};
+
+/// Balanced-parentheses key of a level sequence, children in the order given
+uint64_t parenthesesKey(const Levels& levels);
+
+/**
+ * @brief Key of the free tree rooted at its center, children in canonical order
+ *
+ * @p levels must be canonical, as both sequences produce them.
+ */
+uint64_t centerKey(const Levels& levels);
+
+/// Parenthesis string of a key with @p nodes nodes
+std::string toParentheses(uint64_t key, int nodes);
+
+// ============================================================================
+// Sequences
+// ============================================================================
+
+/**
+ * @brief Rooted trees with n nodes, from the path to the star
+ *
+ * Rank r is the r-th tree, in decreasing key order (increasing canonical
+ * string order). next() takes amortised constant time.
+ */
+class RootedSequence {
+public:
+    /// Start at rank 0 (the path)
+    /// @throws std::invalid_argument unless 1 <= nodes <= MAX_NODES
+    explicit RootedSequence(int nodes);
+
+    /// Move to the next tree; false (and unchanged) after the last one
+    bool next();
+
+    /// Move forward @p count trees; returns how many were actually skipped
+    uint64_t skip(uint64_t count);
+
+    const Levels& levels() const { return levels_; }
+    int nodes() const { return levels_.size; }
+    uint64_t rank() const { return rank_; }
+    uint64_t key() const { return parenthesesKey(levels_); }
+
+private:
+    Levels levels_;
+    uint64_t rank_ = 0;
+};
+
+/**
+ * @brief Free trees with n nodes, each rooted at a center
+ *
+ * Rank r is the r-th free tree in generation order (not key order).
+ */
+class FreeSequence {
+public:
+    /// Start at rank 0 (the path)
+    /// @throws std::invalid_argument unless 1 <= nodes <= MAX_NODES
+    explicit FreeSequence(int nodes);
+
+    /// Move to the next free tree; false (and unchanged) after the last one
+    bool next();
+
+    /// Move forward @p count trees; returns how many were actually skipped
+    uint64_t skip(uint64_t count);
+
+    const Levels& levels() const { return levels_; }
+    int nodes() const { return levels_.size; }
+    uint64_t rank() const { return rank_; }
+
+    /// Canonical center key, the same as centerKey() of any rooting
+    uint64_t key() const { return centerKey(levels_); }
+
+private:
+    Levels levels_;
+    uint64_t rank_ = 0;
+};
+
+// ============================================================================
+// Catalog Files
+// ============================================================================
+
+/// Current catalog format version
+constexpr uint16_t CATALOG_VERSION = 1;
+
+/// What the records of a catalog section hold
+enum class CatalogKind : uint8_t {
+    ROOTED = 0,   ///< Rooted tree key, then its cluster key or cluster id if flagged
+    FREE = 1      ///< Free tree center key
+};
+
+/// Header flag: rooted records carry their cluster key
+constexpr uint8_t CLUSTER_KEYS = 1;
+
+/// Header flag: rooted records carry the index of their cluster in a FREE section
+constexpr uint8_t CLUSTER_IDS = 2;
+
+/**
+ * @brief Header of a catalog section
+ *
+ *     "CGEN" | version u16 | kind u8 | flags u8 | nodes u32 | reserved u32 |
+ *     first rank u64 | record count u64
+ */
+struct CatalogHeader {
+    uint16_t version = CATALOG_VERSION;
+    CatalogKind kind = CatalogKind::ROOTED;
+    uint8_t flags = 0;
+    uint32_t nodes = 0;
+    uint64_t first_rank = 0;
+    uint64_t count = 0;
+
+    /// Bytes per record: 8, or 16 with cluster keys or ids
+    size_t recordSize() const;
+};
+
+/// Size of an encoded header
+constexpr size_t CATALOG_HEADER_SIZE = 32;
+
+/// Append an encoded header
+void appendHeader(std::string& out, const CatalogHeader& header);
+
+/**
+ * @brief Decode a header
+ * @throws std::runtime_error on a bad magic or version, or short data
+ */
+CatalogHeader parseHeader(const uint8_t* data, size_t size);
+
+} // namespace enumeration
+} // namespace cosmic
+
+#endif // COSMIC_ENUMERATION_HPP
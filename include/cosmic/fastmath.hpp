@@ -0,0 +1,64 @@
+/**
+ * @file fastmath.hpp
+ * @brief Batched transcendental kernels with selectable accuracy
+ *
+ * Ensemble simulations evaluate the same few functions (the cosine behind
+ * the objective weight, the square root behind coalescence) for thousands
+ * of systems per step. These kernels work on whole arrays so the loops can
+ * be vectorised by the compiler.
+ *
+ * - Accuracy::EXACT calls the standard library for every element and gives
+ *   results identical to the scalar code paths.
+ * - Accuracy::FAST uses Cody–Waite range reduction and short polynomials,
+ *   with absolute error below FAST_TOLERANCE for |x| ≤ FAST_RANGE. Larger
+ *   arguments fall back to the exact functions.
+ *
+ * The square root is correctly rounded in hardware, so both settings give
+ * exact results for sqrt.
+ *
+ * Every kernel may be called in place: an output array may be the input.
+ */
+
+#ifndef COSMIC_FASTMATH_HPP
+#define COSMIC_FASTMATH_HPP
+
+#include <cstddef>
+
+namespace cosmic {
+namespace fastmath {
+
+/**
+ * @brief Accuracy of batched kernels
+ */
+enum class Accuracy {
+    EXACT,  ///< Standard library results, bit-identical to scalar code
+    FAST    ///< Polynomial approximation, absolute error < FAST_TOLERANCE
+};
+
+/// Maximum absolute error of the FAST sine and cosine
+constexpr double FAST_TOLERANCE = 1e-7;
+
+/// Largest |x| handled by the FAST polynomial path
+constexpr double FAST_RANGE = 1e6;
+
+/// out[i] = cos(x[i])
+void cos(const double* x, double* out, size_t n, Accuracy accuracy = Accuracy::FAST);
+
+/// out[i] = sin(x[i])
+void sin(const double* x, double* out, size_t n, Accuracy accuracy = Accuracy::FAST);
+
+/// s[i] = sin(x[i]), c[i] = cos(x[i]) with a single range reduction
+void sincos(const double* x, double* s, double* c, size_t n,
+            Accuracy accuracy = Accuracy::FAST);
+
+/// out[i] = sqrt(x[i]) (exact for either setting)
+void sqrt(const double* x, double* out, size_t n, Accuracy accuracy = Accuracy::FAST);
+
+/// out[i] = 0.5 (1 + cos(phase[i])), the System 2 objective weight
+void objectiveWeight(const double* phase, double* out, size_t n,
+                     Accuracy accuracy = Accuracy::FAST);
+
+} // namespace fastmath
+} // namespace cosmic
+
+#endif // COSMIC_FASTMATH_HPP
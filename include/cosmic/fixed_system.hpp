@@ -0,0 +1,308 @@
+/**
+ * @file fixed_system.hpp
+ * @brief Compile-time specialised Systems 0-5 with no heap allocation
+ *
+ * System(level) builds its structure at runtime with shared terms, strings
+ * and a switch on the level. The small systems have fixed shapes, so
+ * FixedSystem<N> builds the same structure at compile time. Terms and
+ * enneagrams are stored inline in std::arrays, names are string views into
+ * static data, and the counts are constants.
+ *
+ * The accessors mirror System. Parts a level does not have are compile-time
+ * errors rather than empty optionals or null pointers: FixedSystem<2> has
+ * no triad(), and FixedSystem<4> has no complementaryEnneagram(). A fixed
+ * system is a value and is not linked into a hierarchy.
+ *
+ * Example:
+ * @code
+ * constexpr FixedSystem<5> system;
+ * static_assert(system.termCount() == 20);
+ * for (const auto* term : system.allTerms()) {
+ *     std::cout << term->name() << "\n";
+ * }
+ * @endcode
+ */
+
+#ifndef COSMIC_FIXED_SYSTEM_HPP
+#define COSMIC_FIXED_SYSTEM_HPP
+
+#include "system.hpp"
+#include "trees.hpp"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace cosmic {
+
+/// Highest level with a FixedSystem
+constexpr int MAX_FIXED_LEVEL = 5;
+
+// ============================================================================
+// Fixed Terms
+// ============================================================================
+
+/**
+ * @brief A leaf term (Idea, Routine or Form) below a FixedTerm
+ */
+class FixedSubTerm {
+public:
+    constexpr FixedSubTerm() = default;
+    constexpr FixedSubTerm(std::string_view name, TriadicTerm type, std::string_view description = {})
+        : name_(name), type_(type), description_(description) {}
+
+    constexpr std::string_view name() const { return name_; }
+    constexpr std::optional<TriadicTerm> triadicType() const { return type_; }
+    constexpr std::string_view description() const { return description_; }
+    constexpr bool hasSubTerms() const { return false; }
+    constexpr size_t depth() const { return 1; }
+    constexpr size_t totalTermCount() const { return 1; }
+
+private:
+    std::string_view name_;
+    TriadicTerm type_ = TriadicTerm::Idea;
+    std::string_view description_;
+};
+
+/**
+ * @brief A term with its Idea, Routine and Form sub-terms, as System builds them
+ */
+class FixedTerm {
+public:
+    constexpr FixedTerm() = default;
+    constexpr FixedTerm(std::string_view name, std::optional<TriadicTerm> type,
+                        const std::array<FixedSubTerm, 3>& subTerms)
+        : name_(name), type_(type), sub_terms_(subTerms) {}
+
+    constexpr std::string_view name() const { return name_; }
+    constexpr std::optional<TriadicTerm> triadicType() const { return type_; }
+    constexpr std::string_view description() const { return {}; }
+    constexpr const std::array<FixedSubTerm, 3>& subTerms() const { return sub_terms_; }
+    constexpr bool hasSubTerms() const { return true; }
+    constexpr size_t depth() const { return 2; }
+    constexpr size_t totalTermCount() const { return 4; }
+
+private:
+    std::string_view name_;
+    std::optional<TriadicTerm> type_;
+    std::array<FixedSubTerm, 3> sub_terms_{};
+};
+
+// ============================================================================
+// Fixed Interface and Enneagram
+// ============================================================================
+
+/**
+ * @brief Interface with a static name
+ */
+class FixedInterface {
+public:
+    constexpr FixedInterface() = default;
+    constexpr FixedInterface(std::string_view name, Orientation orient, bool active = true)
+        : name_(name), orientation_(orient), active_(active) {}
+
+    constexpr std::string_view name() const { return name_; }
+    constexpr Orientation orientation() const { return orientation_; }
+
+    /// Switch between objective and subjective orientation
+    constexpr void transform() {
+        orientation_ = orientation_ == Orientation::Objective ? Orientation::Subjective
+                                                              : Orientation::Objective;
+    }
+
+    constexpr bool isActive() const { return active_; }
+    constexpr void setActive(bool active) { active_ = active; }
+
+private:
+    std::string_view name_;
+    Orientation orientation_ = Orientation::Objective;
+    bool active_ = true;
+};
+
+/**
+ * @brief An unnested enneagram with its nine terms stored inline
+ */
+class FixedEnneagram {
+public:
+    constexpr FixedEnneagram() = default;
+
+    /// Enneagram with the terms System::build() gives every enneagram
+    explicit constexpr FixedEnneagram(std::string_view name) : name_(name) {
+        constexpr std::array<FixedSubTerm, 3> SUB_TERMS = {
+            FixedSubTerm("Sub-Idea", TriadicTerm::Idea),
+            FixedSubTerm("Sub-Routine", TriadicTerm::Routine),
+            FixedSubTerm("Sub-Form", TriadicTerm::Form)
+        };
+        constexpr std::string_view NAMES[9] = {
+            "Term 1", "Term 2", "Idea", "Term 4", "Term 5", "Routine", "Term 7", "Term 8", "Form"
+        };
+        for (int i = 0; i < 9; ++i) {
+            std::optional<TriadicTerm> type;
+            if (i == 2) type = TriadicTerm::Idea;
+            if (i == 5) type = TriadicTerm::Routine;
+            if (i == 8) type = TriadicTerm::Form;
+            terms_[static_cast<size_t>(i)] = FixedTerm(NAMES[i], type, SUB_TERMS);
+        }
+    }
+
+    constexpr std::string_view name() const { return name_; }
+
+    /**
+     * @brief Get the term at a position
+     * @throws std::out_of_range if the position is not 1-9
+     */
+    constexpr const FixedTerm& termAt(EnneagramPosition pos) const {
+        int idx = static_cast<int>(pos) - 1;
+        if (idx < 0 || idx >= 9) {
+            throw std::out_of_range("Enneagram position must be 1-9");
+        }
+        return terms_[static_cast<size_t>(idx)];
+    }
+
+    /// Get the three triadic terms (positions 3, 6, 9)
+    constexpr std::array<const FixedTerm*, 3> triad() const {
+        return {&terms_[2], &terms_[5], &terms_[8]};
+    }
+
+    /// Get the six process terms (positions 1, 2, 4, 5, 7, 8)
+    constexpr std::array<const FixedTerm*, 6> process() const {
+        return {&terms_[0], &terms_[1], &terms_[3], &terms_[4], &terms_[6], &terms_[7]};
+    }
+
+    constexpr const std::array<FixedTerm, 9>& terms() const { return terms_; }
+
+    constexpr bool isNested() const { return false; }
+    constexpr size_t nestedLevel() const { return 0; }
+
+private:
+    std::string_view name_;
+    std::array<FixedTerm, 9> terms_{};
+};
+
+// ============================================================================
+// Fixed System
+// ============================================================================
+
+/**
+ * @brief System @p N (0-5) with its structure built at compile time
+ *
+ * Holds the same names, terms and descriptions as System(N) after build().
+ */
+template<int N>
+class FixedSystem {
+    static_assert(N >= 0 && N <= MAX_FIXED_LEVEL, "FixedSystem covers Systems 0-5");
+
+public:
+    static constexpr int LEVEL = N;
+    static constexpr size_t TERM_COUNT = trees::A000081[N + 1];
+    static constexpr size_t CLUSTER_COUNT = trees::A000055[N + 1];
+    static constexpr size_t NODE_COUNT = N;
+
+    /// Number of triadic terms (System 3+)
+    static constexpr size_t TRIAD_SIZE = N >= 3 ? 3 : 0;
+
+    /// Number of enneagrams: primary (System 4+) and complementary (System 5+)
+    static constexpr size_t ENNEAGRAM_COUNT = N >= 5 ? 2 : N >= 4 ? 1 : 0;
+
+    /// Number of terms allTerms() returns: the triad and the primary enneagram
+    static constexpr size_t LISTED_TERM_COUNT = TRIAD_SIZE + (ENNEAGRAM_COUNT > 0 ? 9 : 0);
+
+    constexpr FixedSystem() {
+        if constexpr (N == 0) {
+            interfaces_[0] = FixedInterface("Void Interface", Orientation::Objective, false);
+        } else {
+            interfaces_[0] = FixedInterface("Universal Interface", Orientation::Objective);
+        }
+        if constexpr (N >= 2) {
+            interfaces_[1] = FixedInterface("Particular Interface", Orientation::Subjective);
+        }
+        if constexpr (N >= 3) {
+            constexpr std::string_view NAMES[3] = {"Galaxy - Idea", "Sun - Routine", "Planet - Form"};
+            constexpr TriadicTerm TYPES[3] = {TriadicTerm::Idea, TriadicTerm::Routine, TriadicTerm::Form};
+            for (size_t i = 0; i < 3; ++i) {
+                triad_[i] = FixedTerm(NAMES[i], TYPES[i], {
+                    FixedSubTerm("Idea", TriadicTerm::Idea, util::COSMIC_MOVIE[3 * i]),
+                    FixedSubTerm("Routine", TriadicTerm::Routine, util::COSMIC_MOVIE[3 * i + 1]),
+                    FixedSubTerm("Form", TriadicTerm::Form, util::COSMIC_MOVIE[3 * i + 2])
+                });
+            }
+        }
+        if constexpr (N >= 4) {
+            enneagrams_[0] = FixedEnneagram("Primary Enneagram");
+        }
+        if constexpr (N >= 5) {
+            enneagrams_[1] = FixedEnneagram("Complementary Enneagram");
+        }
+    }
+
+    static constexpr int level() { return N; }
+    static constexpr std::string_view name() { return util::SYSTEM_NAMES[N]; }
+    static constexpr std::string_view description() { return util::SYSTEM_DESCRIPTIONS[N]; }
+
+    constexpr const FixedInterface& primaryInterface() const { return interfaces_[0]; }
+    constexpr FixedInterface& primaryInterface() { return interfaces_[0]; }
+
+    /// Get the secondary interface (System 2+)
+    constexpr const FixedInterface& secondaryInterface() const {
+        static_assert(N >= 2, "Only System 2 and above have a secondary interface");
+        return interfaces_[1];
+    }
+    constexpr FixedInterface& secondaryInterface() {
+        static_assert(N >= 2, "Only System 2 and above have a secondary interface");
+        return interfaces_[1];
+    }
+
+    /// Get the triadic terms (System 3+)
+    constexpr const std::array<FixedTerm, TRIAD_SIZE>& triad() const {
+        static_assert(N >= 3, "Only System 3 and above have a triad");
+        return triad_;
+    }
+
+    /// Get the enneagram (System 4+)
+    constexpr const FixedEnneagram& enneagram() const {
+        static_assert(N >= 4, "Only System 4 and above have an enneagram");
+        return enneagrams_[0];
+    }
+
+    /// Get the complementary enneagram (System 5+)
+    constexpr const FixedEnneagram& complementaryEnneagram() const {
+        static_assert(N >= 5, "Only System 5 has a complementary enneagram");
+        return enneagrams_[1];
+    }
+
+    static constexpr size_t termCount() { return TERM_COUNT; }
+    static constexpr size_t clusterCount() { return CLUSTER_COUNT; }
+    static constexpr size_t nodeCount() { return NODE_COUNT; }
+
+    /// Get the same terms as System::allTerms(): the triad, then the enneagram's terms
+    constexpr std::array<const FixedTerm*, LISTED_TERM_COUNT> allTerms() const {
+        std::array<const FixedTerm*, LISTED_TERM_COUNT> result{};
+        size_t k = 0;
+        for (const auto& term : triad_) result[k++] = &term;
+        if constexpr (ENNEAGRAM_COUNT > 0) {
+            for (const auto& term : enneagrams_[0].terms()) result[k++] = &term;
+        }
+        return result;
+    }
+
+    /// Check if this system transcends another
+    template<int M>
+    constexpr bool transcends(const FixedSystem<M>&) const { return N < M; }
+    bool transcends(const System& other) const { return N < other.level(); }
+
+    /// Check if this system subsumes another
+    template<int M>
+    constexpr bool subsumes(const FixedSystem<M>&) const { return N < M; }
+    bool subsumes(const System& other) const { return N < other.level(); }
+
+private:
+    std::array<FixedInterface, N >= 2 ? 2 : 1> interfaces_{};
+    std::array<FixedTerm, TRIAD_SIZE> triad_{};
+    std::array<FixedEnneagram, ENNEAGRAM_COUNT> enneagrams_{};
+};
+
+} // namespace cosmic
+
+#endif // COSMIC_FIXED_SYSTEM_HPP
@@ -15,6 +15,11 @@
 #include <string>
 
 namespace cosmic {
+
+namespace parallel {
+class Executor;
+}
+
 namespace geometry {
 
 /// Mathematical constants
@@ -292,11 +297,36 @@ private:
     void buildNested(int current_depth, double scale_factor);
 };
 
+/**
+ * @brief Get every enneagram of a @p depth-level nesting, level by level
+ *
+ * Level 0 is the outer enneagram; each enneagram of level k carries one
+ * enneagram of level k+1 at each of its nine points, so the result holds
+ * (9^(depth+1) - 1) / 8 enneagrams. The children of enneagram i of level
+ * k are at positions 9i..9i+8 of level k+1. Each level is computed in
+ * parallel on @p pool (nullptr = serial).
+ * @throws std::invalid_argument if depth is negative or above 8
+ */
+std::vector<EnneagramGeometry> fractalEnneagrams(int depth,
+                                                 const Circle& outer_circle = Circle({0, 0}, 1.0),
+                                                 double scale_factor = 0.25,
+                                                 parallel::Executor* pool = nullptr);
+
 /**
  * @brief SVG export utilities
  */
 namespace svg {
 
+/**
+ * @brief One line of a line plot
+ */
+struct PlotSeries {
+    std::string label;
+    std::vector<Point2D> points;
+    std::string color = "#333";
+    bool dashed = false;
+};
+
 /// Generate SVG path for a circle
 std::string circlePath(const Circle& circle);
 
@@ -319,6 +349,15 @@ std::string nestedEnneagramSVG(const NestedEnneagramGeometry& nested,
 /// Generate SVG for the complete System 1-10 diagram
 std::string systemHierarchySVG(double width = 400, double height = 1200);
 
+/**
+ * @brief Generate an SVG line plot with axes, ticks and a legend
+ *
+ * Axes span the data range (the y axis always includes 0).
+ */
+std::string linePlot(const std::vector<PlotSeries>& series, const std::string& title,
+                     const std::string& x_label, const std::string& y_label,
+                     double width = 640, double height = 420);
+
 } // namespace svg
 
 } // namespace geometry
@@ -0,0 +1,154 @@
+/**
+ * @file integrator.hpp
+ * @brief Adaptive time stepping for System 1 energy dynamics
+ *
+ * System1::step() is explicit Euler with a fixed step, so accuracy over long
+ * horizons needs a small dt everywhere. This module integrates the same
+ * dynamics,
+ *
+ *     dI/dt = System1::intensityRate(efflux(t), reflux(t))
+ *     dE/dt = efflux(t),  dR/dt = reflux(t)
+ *
+ * with the Dormand–Prince 5(4) embedded Runge–Kutta pair and local error
+ * control. Steps shrink where the interface rates change quickly and grow
+ * geometrically when it is near equilibrium. Interface rates may follow
+ * time-dependent schedules. Each accepted step stores a continuous
+ * extension, so the center intensity can be evaluated at any time in the
+ * integrated interval (dense output).
+ *
+ * Example:
+ * @code
+ * integrator::Schedules rates;
+ * rates.efflux = [](double t) { return 1.0 + 0.5 * std::exp(-t / 5.0) * std::sin(t); };
+ * integrator::AdaptiveIntegrator rk;
+ * auto result = rk.integrate(sys, 200.0, rates);
+ * double mid = result.dense.intensity(50.0);
+ * @endcode
+ */
+
+#ifndef COSMIC_INTEGRATOR_HPP
+#define COSMIC_INTEGRATOR_HPP
+
+#include "parallel.hpp"
+#include "system1.hpp"
+
+#include <array>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace cosmic {
+namespace integrator {
+
+/// Interface rate as a function of simulation time
+using RateSchedule = std::function<double(double time)>;
+
+/**
+ * @brief Time-dependent interface rates
+ *
+ * An empty schedule keeps the system's current rate constant. Schedules
+ * are called concurrently by the ensemble form and must be thread-safe.
+ */
+struct Schedules {
+    RateSchedule efflux;
+    RateSchedule reflux;
+};
+
+/**
+ * @brief Error control and step limits
+ */
+struct Options {
+    double relative_tolerance = 1e-6;
+    double absolute_tolerance = 1e-9;
+    double initial_step = 0.0;     ///< 0 = estimate from the initial derivative
+    double min_step = 1e-12;
+    double max_step = std::numeric_limits<double>::infinity();
+    size_t max_steps = 1000000;    ///< Accepted plus rejected steps
+    bool dense = true;             ///< Record the continuous extension
+};
+
+/**
+ * @brief Continuous center intensity over the integrated interval
+ */
+class DenseOutput {
+public:
+    /// Get the number of recorded steps
+    size_t size() const { return steps_.size(); }
+
+    /// Get the start of the integrated interval
+    double startTime() const;
+
+    /// Get the end of the integrated interval
+    double endTime() const;
+
+    /// Get the start time and size of step i
+    double stepStart(size_t i) const { return steps_.at(i).t; }
+    double stepSize(size_t i) const { return steps_.at(i).h; }
+
+    /**
+     * @brief Get the center intensity at time @p t (4th-order interpolant)
+     * @throws std::out_of_range if t is outside the integrated interval
+     */
+    double intensity(double t) const;
+
+    /// Append a step (used by the integrator)
+    void append(double t, double h, const std::array<double, 5>& coefficients);
+
+private:
+    struct Step {
+        double t;
+        double h;
+        std::array<double, 5> c;
+    };
+    std::vector<Step> steps_;
+};
+
+/**
+ * @brief Outcome of one integration
+ */
+struct Result {
+    size_t accepted = 0;
+    size_t rejected = 0;
+    size_t evaluations = 0;  ///< Right-hand-side evaluations
+    double last_step = 0.0;  ///< Size of the last accepted step
+    DenseOutput dense;
+};
+
+/**
+ * @brief Dormand–Prince 5(4) integrator for System 1
+ */
+class AdaptiveIntegrator {
+public:
+    explicit AdaptiveIntegrator(const Options& options = Options());
+
+    /// Get the options
+    const Options& options() const { return options_; }
+
+    /**
+     * @brief Advance @p system from its current time to @p t_end
+     *
+     * The center intensity, accumulated efflux/reflux and time are updated;
+     * scheduled rates are set to their values at @p t_end.
+     * @throws std::runtime_error if the step size underflows or max_steps is exceeded
+     */
+    Result integrate(system1::System1& system, double t_end,
+                     const Schedules& schedules = Schedules()) const;
+
+    /**
+     * @brief Advance every system of an ensemble to @p t_end
+     *
+     * Each system keeps its own step-size control; systems are distributed
+     * over @p pool (nullptr = serial) and results do not depend on it.
+     */
+    std::vector<Result> integrate(std::vector<system1::System1>& ensemble, double t_end,
+                                  const Schedules& schedules = Schedules(),
+                                  parallel::Executor* pool = nullptr) const;
+
+private:
+    Options options_;
+};
+
+} // namespace integrator
+} // namespace cosmic
+
+#endif // COSMIC_INTEGRATOR_HPP
@@ -0,0 +1,217 @@
+/**
+ * @file layout.hpp
+ * @brief Implicit 9-ary array layout for fully populated enneagram nestings
+ *
+ * A nesting in which every enneagram above the deepest level holds all nine
+ * nested enneagrams needs no child pointers. Here the enneagrams are
+ * numbered level by level (Eytzinger order for a 9-ary tree):
+ *
+ *   root             address 0
+ *   child p of a     address 9a + p          (p = 1..9)
+ *   parent of a      address (a - 1) / 9
+ *   level d          addresses [(9^d - 1) / 8, (9^(d+1) - 1) / 8)
+ *
+ * Term slot p of enneagram a is stored at index 9a + p - 1, using the same
+ * arithmetic. The nine children of an enneagram and their term slots are
+ * therefore contiguous, and a whole level is one contiguous range. Lookups
+ * by path are pure arithmetic, and traversals stream through memory with a
+ * predictable stride.
+ *
+ * EnneagramView exposes the usual Enneagram accessors on an address.
+ *
+ * Example:
+ * @code
+ * layout::EnneagramArray nesting(6, "Octave");
+ * auto deep = nesting.root().nestedEnneagramAt(EnneagramPosition::Three)
+ *                           .nestedEnneagramAt(EnneagramPosition::Seven);
+ * deep.setTermAt(EnneagramPosition::One, Term::create("Idea"));
+ * @endcode
+ */
+
+#ifndef COSMIC_LAYOUT_HPP
+#define COSMIC_LAYOUT_HPP
+
+#include "system.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cosmic {
+namespace layout {
+
+class EnneagramView;
+
+/**
+ * @brief A fully populated enneagram nesting stored as implicit arrays
+ *
+ * Only term slots and names that are actually set take memory. Both are
+ * allocated for the whole nesting on first use, so that they keep the
+ * layout's addressing.
+ */
+class EnneagramArray {
+public:
+    /// Deepest supported nesting (about 435 million enneagrams)
+    static constexpr size_t MAX_DEPTH = 9;
+
+    /**
+     * @brief Create a nesting with @p depth levels below the root
+     * @throws std::invalid_argument if depth > MAX_DEPTH
+     */
+    explicit EnneagramArray(size_t depth = 0, const std::string& name = "Enneagram");
+
+    /**
+     * @brief Copy a pointer-based nesting into the implicit layout
+     * @throws std::invalid_argument unless every enneagram above the deepest
+     *         level has all nine nested enneagrams and none below it has any
+     */
+    static EnneagramArray fromEnneagram(const Enneagram& root);
+
+    /// Build the equivalent pointer-based nesting
+    Enneagram::EnneagramPtr toEnneagram() const;
+
+    /// Get the number of levels below the root
+    size_t depth() const { return depth_; }
+
+    /// Get the number of enneagrams
+    size_t size() const { return size_; }
+
+    // ------------------------------------------------------------------------
+    // Address arithmetic
+    // ------------------------------------------------------------------------
+
+    /// First address of level d
+    static size_t levelBegin(size_t d) { return (power9(d) - 1) / 8; }
+
+    /// Number of enneagrams on level d
+    static size_t levelSize(size_t d) { return power9(d); }
+
+    /// Address of nested enneagram p (1-9) of a
+    static size_t child(size_t a, int p) { return 9 * a + static_cast<size_t>(p); }
+
+    /// Address of the enneagram holding a (a > 0)
+    static size_t parent(size_t a) { return (a - 1) / 9; }
+
+    /// Position (1-9) a occupies in its parent (a > 0)
+    static int position(size_t a) { return static_cast<int>((a - 1) % 9) + 1; }
+
+    /// Level of address a (the root is level 0)
+    static size_t level(size_t a);
+
+    /**
+     * @brief Address reached by following nested positions from the root
+     * @throws std::out_of_range if the path is longer than the depth
+     */
+    size_t address(const std::vector<EnneagramPosition>& path) const;
+
+    // ------------------------------------------------------------------------
+    // Contents
+    // ------------------------------------------------------------------------
+
+    /// Get the name of enneagram a (default: root name and positions, "Octave.3.7")
+    std::string name(size_t a) const;
+
+    /// Set the name of enneagram a
+    void setName(size_t a, const std::string& name);
+
+    /// Get term p (1-9) of enneagram a
+    const Term::TermPtr& termAt(size_t a, int p) const {
+        static const Term::TermPtr none;
+        return terms_.empty() ? none : terms_[9 * a + static_cast<size_t>(p) - 1];
+    }
+
+    /// Set term p (1-9) of enneagram a
+    void setTermAt(size_t a, int p, Term::TermPtr term);
+
+    /// Hint that enneagram a's term slots will be read soon
+    void prefetchTerms(size_t a) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (!terms_.empty()) __builtin_prefetch(&terms_[9 * a]);
+#else
+        (void)a;
+#endif
+    }
+
+    /**
+     * @brief View of enneagram a
+     * @throws std::out_of_range if a >= size()
+     */
+    EnneagramView view(size_t a);
+
+    /// View of the root
+    EnneagramView root();
+
+private:
+    static size_t power9(size_t d) {
+        size_t p = 1;
+        while (d--) p *= 9;
+        return p;
+    }
+
+    void checkAddress(size_t a) const;
+
+    size_t depth_ = 0;
+    size_t size_ = 1;
+    std::string root_name_;
+    std::vector<Term::TermPtr> terms_;   ///< 9 slots per enneagram, empty until a term is set
+    std::vector<std::string> names_;     ///< Empty until a name is set
+};
+
+/**
+ * @brief Enneagram-like view of one address of an EnneagramArray
+ *
+ * A view is cheap to copy. It refers to the array, which must outlive it;
+ * a default-constructed view is invalid (as a null EnneagramPtr would be).
+ * Position arguments follow Enneagram and throw std::out_of_range outside 1-9.
+ */
+class EnneagramView {
+public:
+    EnneagramView() = default;
+    EnneagramView(EnneagramArray* array, size_t address) : array_(array), address_(address) {}
+
+    explicit operator bool() const { return array_ != nullptr; }
+
+    size_t address() const { return address_; }
+
+    std::string name() const { return array_->name(address_); }
+
+    Term::TermPtr termAt(EnneagramPosition pos) const {
+        return array_->termAt(address_, index(pos));
+    }
+    void setTermAt(EnneagramPosition pos, Term::TermPtr term) const {
+        array_->setTermAt(address_, index(pos), std::move(term));
+    }
+
+    /// Get the three triadic terms (positions 3, 6, 9)
+    std::array<Term::TermPtr, 3> triad() const;
+
+    /// Get the six process terms (positions 1, 2, 4, 5, 7, 8)
+    std::array<Term::TermPtr, 6> process() const;
+
+    /// Get all nine terms
+    std::array<Term::TermPtr, 9> terms() const;
+
+    bool isNested() const { return nestedLevel() > 0; }
+
+    /// Levels of nesting below this enneagram
+    size_t nestedLevel() const { return array_->depth() - EnneagramArray::level(address_); }
+
+    /// Nested enneagram at a position, or an invalid view at the deepest level
+    EnneagramView nestedEnneagramAt(EnneagramPosition pos) const;
+
+    /// Enclosing enneagram, or an invalid view for the root
+    EnneagramView parent() const;
+
+private:
+    static int index(EnneagramPosition pos);
+
+    EnneagramArray* array_ = nullptr;
+    size_t address_ = 0;
+};
+
+} // namespace layout
+} // namespace cosmic
+
+#endif // COSMIC_LAYOUT_HPP
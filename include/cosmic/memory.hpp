@@ -0,0 +1,244 @@
+/**
+ * @file memory.hpp
+ * @brief Allocation accounting and polymorphic memory resources
+ *
+ * Terms, enneagrams, tree nodes and the Serializer/svg string builders
+ * allocate through std::pmr memory resources, one per subsystem. Each
+ * subsystem's resource is a CountingResource that records bytes and
+ * allocation counts (and can enforce a cap on live bytes) before passing
+ * the request on to the global heap.
+ *
+ * A ResourceScope redirects one subsystem on the calling thread to a
+ * caller-supplied resource, such as a std::pmr::monotonic_buffer_resource
+ * or pool resource serving a single request. Objects allocated inside a
+ * scope must be destroyed before it ends.
+ *
+ * Example:
+ * @code
+ * std::pmr::monotonic_buffer_resource arena(1 << 20);
+ * {
+ *     memory::ResourceScope scope(memory::Subsystem::SERIALIZER, &arena);
+ *     std::string json = ops::Serializer::hierarchyToJSON(root);
+ * }
+ * auto used = memory::stats(memory::Subsystem::SERIALIZER);
+ * @endcode
+ */
+
+#ifndef COSMIC_MEMORY_HPP
+#define COSMIC_MEMORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace cosmic {
+namespace memory {
+
+/**
+ * @brief Library subsystems that allocate through their own resource
+ */
+enum class Subsystem {
+    TERMS,          ///< Term nodes and their sub-term lists
+    ENNEAGRAMS,     ///< Enneagram nodes
+    TREES,          ///< trees::TreeNode nodes and their child lists
+    SERIALIZER,     ///< Serializer string builders
+    SVG             ///< svg:: string builders
+};
+
+/// Number of subsystems
+constexpr size_t SUBSYSTEM_COUNT = 5;
+
+/// Get a subsystem's name ("terms", "enneagrams", ...)
+const char* toString(Subsystem subsystem);
+
+/**
+ * @brief Allocation counts of a resource
+ */
+struct AllocationStats {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_deallocated = 0;
+    uint64_t live_bytes = 0;        ///< Allocated and not yet freed
+    uint64_t peak_bytes = 0;        ///< Highest live_bytes seen
+};
+
+// ============================================================================
+// CountingResource
+// ============================================================================
+
+/**
+ * @brief Memory resource that counts what passes through it
+ *
+ * Forwards to an upstream resource and records every allocation, also in
+ * an optional parent (which only counts). A limit on live bytes makes
+ * allocations that would exceed it throw std::bad_alloc; the limit is
+ * checked here and in the parent chain. Thread-safe if the upstream is.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+                              CountingResource* parent = nullptr);
+
+    CountingResource(const CountingResource&) = delete;
+    CountingResource& operator=(const CountingResource&) = delete;
+
+    /// Get the resource allocations are forwarded to
+    std::pmr::memory_resource* upstream() const { return upstream_; }
+
+    /// Get the current counts
+    AllocationStats stats() const;
+
+    /// Reset the counts (live bytes are kept)
+    void resetStats();
+
+    /// Get/set the live-byte limit (0 = unlimited)
+    uint64_t limit() const { return limit_.load(std::memory_order_relaxed); }
+    void setLimit(uint64_t bytes) { limit_.store(bytes, std::memory_order_relaxed); }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    void charge(uint64_t bytes);
+    void release(uint64_t bytes) noexcept;
+
+    std::pmr::memory_resource* upstream_;
+    CountingResource* parent_;
+    std::atomic<uint64_t> limit_{0};
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> deallocations_{0};
+    std::atomic<uint64_t> bytes_allocated_{0};
+    std::atomic<uint64_t> bytes_deallocated_{0};
+    std::atomic<uint64_t> live_{0};
+    std::atomic<uint64_t> peak_{0};
+};
+
+// ============================================================================
+// Subsystem Resources
+// ============================================================================
+
+/**
+ * @brief Get the resource a subsystem allocates from on this thread
+ *
+ * The innermost ResourceScope for the subsystem, if any, else the
+ * subsystem's process-wide counting resource over the global heap.
+ */
+std::pmr::memory_resource* resource(Subsystem subsystem);
+
+/// Get a subsystem's totals (including allocations made inside scopes)
+AllocationStats stats(Subsystem subsystem);
+
+/// Reset every subsystem's counts
+void resetStats();
+
+/// Cap a subsystem's live bytes (0 = unlimited); excess allocations throw std::bad_alloc
+void setLimit(Subsystem subsystem, uint64_t bytes);
+
+/// Write a per-subsystem allocation table
+void writeReport(std::ostream& out);
+
+/**
+ * @brief Redirect a subsystem's allocations on this thread
+ *
+ * Allocations are counted for the scope (stats()) and the subsystem, then
+ * served by @p upstream. A null @p upstream restores the process-wide
+ * resource for the scope's duration (used for long-lived caches built
+ * inside a caller's scope). Scopes nest and must be destroyed in reverse
+ * order of construction, after every object allocated inside them.
+ */
+class ResourceScope {
+public:
+    ResourceScope(Subsystem subsystem, std::pmr::memory_resource* upstream);
+    ~ResourceScope();
+
+    ResourceScope(const ResourceScope&) = delete;
+    ResourceScope& operator=(const ResourceScope&) = delete;
+
+    /// Get the allocations made inside this scope
+    AllocationStats stats() const { return counter_.stats(); }
+
+private:
+    Subsystem subsystem_;
+    CountingResource counter_;
+    std::pmr::memory_resource* previous_;
+};
+
+// ============================================================================
+// OutputStream
+// ============================================================================
+
+/**
+ * @brief std::ostream that builds its text in a subsystem's resource
+ *
+ * Drop-in replacement for std::ostringstream in the string builders (whose
+ * C++17 buffer cannot take an allocator).
+ */
+class OutputStream : public std::ostream {
+public:
+    explicit OutputStream(Subsystem subsystem);
+
+    /// Get a copy of the text
+    std::string str() const {
+        std::string out;
+        out.reserve(buffer_.text.size() + buffer_.pending());
+        out.append(buffer_.text.data(), buffer_.text.size());
+        out.append(buffer_.base(), buffer_.pending());
+        return out;
+    }
+
+    /// View the text (valid until the next write)
+    std::string_view view() {
+        buffer_.flush();
+        return buffer_.text;
+    }
+
+private:
+    // Writes go to a small put area that is moved into the text when full,
+    // so formatted output does not take a virtual call per character
+    struct Buffer : std::streambuf {
+        explicit Buffer(std::pmr::memory_resource* resource) : text(resource) {
+            setp(chunk, chunk + sizeof(chunk));
+        }
+
+        const char* base() const { return pbase(); }
+        size_t pending() const { return static_cast<size_t>(pptr() - pbase()); }
+
+        void flush() {
+            text.append(pbase(), pending());
+            setp(chunk, chunk + sizeof(chunk));
+        }
+
+        int_type overflow(int_type c) override {
+            flush();
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                text.push_back(traits_type::to_char_type(c));
+            }
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            if (n <= epptr() - pptr()) return std::streambuf::xsputn(s, n);
+            flush();
+            text.append(s, static_cast<size_t>(n));
+            return n;
+        }
+
+        std::pmr::string text;
+        char chunk[256];
+    };
+
+    Buffer buffer_;
+};
+
+} // namespace memory
+} // namespace cosmic
+
+#endif // COSMIC_MEMORY_HPP
@@ -0,0 +1,337 @@
+/**
+ * @file metrics.hpp
+ * @brief Counters, latency histograms and a metrics registry
+ *
+ * The library counts what it does (trees generated, generation cache hits
+ * and misses, terms built per level, bytes serialized, SVG elements
+ * emitted) and records the latency of its API calls into a process-wide
+ * Registry. The instrumentation is compiled in when the library is
+ * configured with -DCOSMIC_ENABLE_METRICS=ON (the default), which defines
+ * COSMIC_ENABLE_METRICS for the library and its users; otherwise the
+ * COSMIC_METRIC_* macros expand to nothing.
+ *
+ * Counters are sharded across cache lines so threads rarely touch the same
+ * atomic; a hot-path increment is one relaxed fetch_add. Histograms are
+ * HDR-style: log-linear buckets with 16 sub-buckets per power of two cover
+ * the whole uint64_t range with at most 6.25% relative error, in a fixed
+ * array of atomics that never allocates on record.
+ *
+ * Example:
+ * @code
+ * auto hierarchy = System::createHierarchy();
+ * auto snap = metrics::registry().snapshot();
+ * std::cout << snap.counter("cosmic_terms_built_total", "level=\"4\"");
+ * metrics::registry().writeText(std::cout);   // Prometheus text format
+ * @endcode
+ */
+
+#ifndef COSMIC_METRICS_HPP
+#define COSMIC_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cosmic {
+namespace metrics {
+
+/// Check whether the library's instrumentation is compiled into this build
+constexpr bool compiledIn() {
+#ifdef COSMIC_ENABLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Number of shards per counter
+constexpr size_t SHARDS = 16;
+
+namespace detail {
+
+/// Get the calling thread's shard (assigned round-robin on first use)
+inline size_t shardIndex() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+} // namespace detail
+
+// ============================================================================
+// Counter
+// ============================================================================
+
+/**
+ * @brief Monotonic counter sharded across threads
+ */
+class Counter {
+public:
+    /// Add @p n to the counter
+    void add(uint64_t n = 1) noexcept {
+        shards_[detail::shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /// Get the current total (sum over shards)
+    uint64_t value() const noexcept;
+
+    /// Reset to zero
+    void reset() noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, SHARDS> shards_;
+};
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+/**
+ * @brief Point-in-time copy of a histogram
+ */
+struct HistogramSnapshot {
+    struct Bucket {
+        uint64_t lower;   ///< Smallest value in the bucket
+        uint64_t upper;   ///< Largest value in the bucket
+        uint64_t count;
+    };
+
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    std::vector<Bucket> buckets;   ///< Non-empty buckets in increasing order
+
+    /// Get the mean recorded value (0 when empty)
+    double mean() const;
+
+    /**
+     * @brief Get the value at quantile @p q in [0, 1]
+     *
+     * Returns the largest value of the bucket holding the quantile, clamped
+     * to the recorded range (0 when empty).
+     */
+    uint64_t quantile(double q) const;
+};
+
+/**
+ * @brief Log-linear (HDR-style) histogram of non-negative integer values
+ */
+class Histogram {
+public:
+    /// Sub-buckets per power of two, as a bit count
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+    /// Total number of buckets covering [0, 2^64)
+    static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS;
+
+    Histogram();
+
+    /// Record one value
+    void record(uint64_t value) noexcept {
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t lo = min_.load(std::memory_order_relaxed);
+        while (value < lo && !min_.compare_exchange_weak(lo, value, std::memory_order_relaxed)) {}
+        uint64_t hi = max_.load(std::memory_order_relaxed);
+        while (value > hi && !max_.compare_exchange_weak(hi, value, std::memory_order_relaxed)) {}
+    }
+
+    /// Get the bucket holding @p value
+    static size_t bucketIndex(uint64_t value) noexcept {
+        if (value < 2 * SUB_BUCKETS) return static_cast<size_t>(value);
+        unsigned shift = highestBit(value) - SUB_BUCKET_BITS;
+        return static_cast<size_t>(shift * SUB_BUCKETS + (value >> shift));
+    }
+
+    /// Get the smallest value of bucket @p index
+    static uint64_t bucketLower(size_t index) noexcept;
+
+    /// Get the largest value of bucket @p index
+    static uint64_t bucketUpper(size_t index) noexcept;
+
+    /// Copy the current contents
+    HistogramSnapshot snapshot() const;
+
+    /// Discard all recorded values
+    void reset() noexcept;
+
+private:
+    static unsigned highestBit(uint64_t value) noexcept {
+        unsigned bit = 0;
+        while (value >>= 1) ++bit;
+        return bit;
+    }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief RAII timer recording its lifetime in nanoseconds
+ */
+class Timer {
+public:
+    explicit Timer(Histogram& histogram) noexcept
+        : histogram_(histogram)
+        , start_(std::chrono::steady_clock::now()) {}
+
+    ~Timer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        histogram_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+private:
+    Histogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+/**
+ * @brief Point-in-time copy of every registered metric
+ */
+struct Snapshot {
+    struct CounterSample {
+        std::string name;
+        std::string labels;   ///< e.g. level="3" (empty when unlabeled)
+        std::string help;
+        uint64_t value;
+    };
+
+    struct HistogramSample {
+        std::string name;
+        std::string labels;
+        std::string help;
+        HistogramSnapshot data;
+    };
+
+    std::vector<CounterSample> counters;       ///< Sorted by name, then labels
+    std::vector<HistogramSample> histograms;   ///< Sorted by name, then labels
+
+    /// Get a counter's value (0 if it is not registered)
+    uint64_t counter(const std::string& name, const std::string& labels = "") const;
+
+    /// Get a histogram (nullptr if it is not registered)
+    const HistogramSnapshot* histogram(const std::string& name,
+                                       const std::string& labels = "") const;
+};
+
+/**
+ * @brief Named counters and histograms
+ *
+ * Metrics are identified by a Prometheus-style name and an optional label
+ * set in exposition syntax (`call="svg::enneagramSVG"`). Registration
+ * takes a lock; the returned references stay valid for the registry's
+ * lifetime, so hot paths look a metric up once and keep the reference.
+ */
+class Registry {
+public:
+    Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    /**
+     * @brief Get or register a counter
+     * @throws std::invalid_argument if the name is not a valid metric name
+     * @throws std::logic_error if the name is registered as a histogram
+     */
+    Counter& counter(const std::string& name, const std::string& help = "",
+                     const std::string& labels = "");
+
+    /**
+     * @brief Get or register a histogram
+     * @throws std::invalid_argument if the name is not a valid metric name
+     * @throws std::logic_error if the name is registered as a counter
+     */
+    Histogram& histogram(const std::string& name, const std::string& help = "",
+                         const std::string& labels = "");
+
+    /// Copy every metric
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Write every metric in the Prometheus text exposition format
+     *
+     * Histograms are written as cumulative `_bucket{le="..."}` series over
+     * their non-empty buckets, followed by `_sum` and `_count`.
+     */
+    void writeText(std::ostream& out) const;
+
+    /// Get the text exposition as a string
+    std::string text() const;
+
+    /// Zero every metric (registrations and references stay valid)
+    void reset();
+
+private:
+    enum class Kind { COUNTER, HISTOGRAM };
+
+    struct Family {
+        Kind kind;
+        std::string help;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const std::string& name, const std::string& help, Kind kind);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+/// Get the process-wide registry the library reports into
+Registry& registry();
+
+} // namespace metrics
+} // namespace cosmic
+
+#define COSMIC_METRIC_CONCAT_(a, b) a##b
+#define COSMIC_METRIC_CONCAT(a, b) COSMIC_METRIC_CONCAT_(a, b)
+
+#ifdef COSMIC_ENABLE_METRICS
+/// Add @p n to the counter @p name (looked up once per call site)
+#define COSMIC_METRIC_COUNT(name, help, n)                                          \
+    do {                                                                            \
+        static ::cosmic::metrics::Counter& cosmic_metric_counter_ =                 \
+            ::cosmic::metrics::registry().counter(name, help);                      \
+        cosmic_metric_counter_.add(n);                                              \
+    } while (0)
+/// Add @p n to the counter @p name with a run-time label set (looked up per call)
+#define COSMIC_METRIC_COUNT_LABELED(name, help, labels, n) \
+    ::cosmic::metrics::registry().counter(name, help, labels).add(n)
+/// Record the latency of the rest of the enclosing block as call=@p call (a string literal)
+#define COSMIC_METRIC_TIMER(call)                                                   \
+    static ::cosmic::metrics::Histogram& COSMIC_METRIC_CONCAT(cosmic_metric_hist_, __LINE__) = \
+        ::cosmic::metrics::registry().histogram(                                   \
+            "cosmic_call_duration_ns", "Latency of library calls in nanoseconds",   \
+            "call=\"" call "\"");                                                   \
+    ::cosmic::metrics::Timer COSMIC_METRIC_CONCAT(cosmic_metric_timer_, __LINE__)(  \
+        COSMIC_METRIC_CONCAT(cosmic_metric_hist_, __LINE__))
+#else
+#define COSMIC_METRIC_COUNT(name, help, n) static_cast<void>(0)
+#define COSMIC_METRIC_COUNT_LABELED(name, help, labels, n) static_cast<void>(0)
+#define COSMIC_METRIC_TIMER(call) static_cast<void>(0)
+#endif
+
+#endif // COSMIC_METRICS_HPP
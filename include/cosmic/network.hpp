@@ -0,0 +1,241 @@
+/**
+ * @file network.hpp
+ * @brief Coupled networks of System 2 dyads
+ *
+ * A System2Network holds a large population of System 2 dyads whose
+ * perceptual transpositions interact across a sparse coupling graph.
+ * The phase of each transposition is pulled by its neighbours in the
+ * manner of the Kuramoto model:
+ *
+ *     dθᵢ/dt = ωᵢ + K Σⱼ wᵢⱼ sin(θⱼ − θᵢ)
+ *
+ * where ωᵢ is the transposition rate of dyad i and wᵢⱼ the coupling weight.
+ * With K = 0 every dyad evolves exactly as an isolated system2::System2.
+ *
+ * State is kept in structure-of-arrays form (phases, rates, centre
+ * intensities) and the coupling is applied with CSR sparse-matrix kernels.
+ * Since sin(θⱼ − θᵢ) = sin θⱼ cos θᵢ − cos θⱼ sin θᵢ, one step needs two
+ * sparse products over cached sine and cosine arrays rather than one sine
+ * per edge. Steps run in parallel over fixed-size row chunks; reductions
+ * combine per-chunk partials in order, so results do not depend on the
+ * number of threads.
+ */
+
+#ifndef COSMIC_NETWORK_HPP
+#define COSMIC_NETWORK_HPP
+
+#include "system2.hpp"
+#include "parallel.hpp"
+#include "fastmath.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cosmic {
+namespace network {
+
+// ============================================================================
+// Sparse Coupling (CSR)
+// ============================================================================
+
+/**
+ * @brief Sparse coupling matrix in compressed sparse row form
+ *
+ * Row i lists the neighbours j that pull on node i, with weight wᵢⱼ.
+ */
+class SparseCoupling {
+public:
+    /// A weighted directed edge: @p to is pulled by @p from
+    struct Edge {
+        size_t to;
+        size_t from;
+        double weight = 1.0;
+    };
+
+    SparseCoupling() = default;
+
+    /// Construct from raw CSR arrays (validated)
+    SparseCoupling(size_t nodes, std::vector<uint64_t> row_offsets,
+                   std::vector<uint32_t> columns, std::vector<double> weights);
+
+    /**
+     * @brief Build from an edge list
+     * @param symmetric If true, every edge is also added in reverse
+     *
+     * Duplicate edges are merged by summing their weights.
+     */
+    static SparseCoupling fromEdges(size_t nodes, const std::vector<Edge>& edges,
+                                    bool symmetric = true);
+
+    /// Ring lattice where each node couples to @p neighbors nodes on each side
+    static SparseCoupling ring(size_t nodes, size_t neighbors = 1, double weight = 1.0);
+
+    /// Random symmetric graph with the given mean degree (deterministic for a seed)
+    static SparseCoupling random(size_t nodes, double mean_degree, uint64_t seed,
+                                 double weight = 1.0);
+
+    /// Get the number of nodes
+    size_t size() const { return nodes_; }
+
+    /// Get the number of stored entries
+    size_t nonZeros() const { return columns_.size(); }
+
+    /// Get the number of neighbours of node i
+    size_t degree(size_t i) const {
+        return static_cast<size_t>(row_offsets_[i + 1] - row_offsets_[i]);
+    }
+
+    const std::vector<uint64_t>& rowOffsets() const { return row_offsets_; }
+    const std::vector<uint32_t>& columns() const { return columns_; }
+    const std::vector<double>& weights() const { return weights_; }
+
+    /// Divide each row by its degree (mean-field coupling)
+    void normalizeRows();
+
+    /// Compute y = A x
+    void multiply(const double* x, double* y, parallel::Executor* pool = nullptr) const;
+
+    /// Compute y1 = A x1 and y2 = A x2 in one pass over the matrix
+    void multiply2(const double* x1, const double* x2, double* y1, double* y2,
+                   parallel::Executor* pool = nullptr) const;
+
+private:
+    size_t nodes_ = 0;
+    std::vector<uint64_t> row_offsets_ = {0};
+    std::vector<uint32_t> columns_;
+    std::vector<double> weights_;
+};
+
+// ============================================================================
+// System 2 Network
+// ============================================================================
+
+/**
+ * @brief Population-level order parameters
+ */
+struct OrderParameters {
+    double coherence = 0.0;              ///< Kuramoto r = |⟨e^{iθ}⟩| (0 incoherent, 1 locked)
+    double mean_phase = 0.0;             ///< Kuramoto ψ = arg⟨e^{iθ}⟩
+    double mode_synchrony = 0.0;         ///< Fraction of dyads in the majority mode
+    double objective_fraction = 0.0;     ///< Fraction of dyads in objective mode
+    double mean_objective_weight = 0.0;  ///< Population mean of the objective weight
+    double mean_coalescence = 0.0;       ///< Population mean of coalescence strength
+};
+
+/**
+ * @brief A population of System 2 dyads with coupled transpositions
+ */
+class System2Network {
+public:
+    /// Chunk size for parallel kernels and reductions
+    static constexpr size_t GRAIN = 4096;
+
+    /**
+     * @brief Create a network of default dyads (intensities 0.5/0.5, rate 0.1)
+     * @param coupling Coupling graph; its size sets the number of dyads
+     * @param strength Global coupling strength K
+     */
+    explicit System2Network(SparseCoupling coupling, double strength = 0.0);
+
+    /// Create a network whose dyads start in the state of the given systems
+    static System2Network fromSystems(const std::vector<system2::System2>& systems,
+                                      SparseCoupling coupling, double strength = 0.0);
+
+    /// Get the number of dyads
+    size_t size() const { return phase_.size(); }
+
+    /// Get the coupling graph
+    const SparseCoupling& coupling() const { return coupling_; }
+
+    /// Get/set the global coupling strength K
+    double couplingStrength() const { return strength_; }
+    void setCouplingStrength(double strength) { strength_ = strength; }
+
+    /// Run kernels on an executor (nullptr = serial)
+    void setExecutor(parallel::Executor* executor) { pool_ = executor; }
+    /// Same as setExecutor()
+    void setThreadPool(parallel::Executor* pool) { setExecutor(pool); }
+
+    /// Get/set the accuracy of sine and cosine evaluation (kept across restore())
+    fastmath::Accuracy accuracy() const { return accuracy_; }
+    void setAccuracy(fastmath::Accuracy accuracy) { accuracy_ = accuracy; }
+
+    // Per-dyad state
+    double phase(size_t i) const { return phase_[i]; }
+    double rate(size_t i) const { return rate_[i]; }
+    double universalIntensity(size_t i) const { return universal_[i]; }
+    double particularIntensity(size_t i) const { return particular_[i]; }
+    int cycleCount(size_t i) const { return cycles_[i]; }
+
+    void setPhase(size_t i, double phase);
+    void setRate(size_t i, double rate) { rate_[i] = rate; }
+
+    /// Set the centre intensities of dyad i (normalized to sum to 1)
+    void setIntensities(size_t i, double universal, double particular);
+
+    /// Get the objective weight of dyad i, 0.5 (1 + cos θᵢ)
+    double objectiveWeight(size_t i) const { return 0.5 * (1.0 + cos_[i]); }
+
+    /// Get the dominant mode of dyad i
+    system2::Mode mode(size_t i) const {
+        return objectiveWeight(i) > 0.5 ? system2::Mode::OBJECTIVE : system2::Mode::SUBJECTIVE;
+    }
+
+    /// Get the coalescence strength of dyad i (non-zero in subjective mode)
+    double coalescence(size_t i) const;
+
+    // Raw arrays
+    const std::vector<double>& phases() const { return phase_; }
+    const std::vector<double>& rates() const { return rate_; }
+    std::vector<double>& rates() { return rate_; }
+
+    /// Advance all dyads by one explicit Euler step
+    void step(double dt = 1.0);
+
+    /// Get the current simulation time
+    double time() const { return time_; }
+
+    /// Compute order parameters over the whole population
+    OrderParameters orderParameters() const;
+
+    /// Complete dynamic state of the network, including the coupling graph
+    struct State {
+        SparseCoupling coupling;
+        double strength = 0.0;
+        std::vector<double> phase;
+        std::vector<double> rate;
+        std::vector<double> universal;
+        std::vector<double> particular;
+        std::vector<int> cycles;
+        double time = 0.0;
+    };
+
+    /// Capture the current state
+    State state() const;
+
+    /// Restore a previously captured state (the network is resized to match)
+    void restore(State s);
+
+private:
+    void refreshTrig(size_t lo, size_t hi);
+
+    SparseCoupling coupling_;
+    double strength_;
+    std::vector<double> phase_;
+    std::vector<double> rate_;
+    std::vector<double> universal_;
+    std::vector<double> particular_;
+    std::vector<int> cycles_;
+    std::vector<double> sin_;
+    std::vector<double> cos_;
+    std::vector<double> sum_sin_;   // Scratch: A sin θ
+    std::vector<double> sum_cos_;   // Scratch: A cos θ
+    double time_ = 0.0;
+    parallel::Executor* pool_ = nullptr;
+    fastmath::Accuracy accuracy_ = fastmath::Accuracy::EXACT;
+};
+
+} // namespace network
+} // namespace cosmic
+
+#endif // COSMIC_NETWORK_HPP
@@ -0,0 +1,218 @@
+/**
+ * @file parallel.hpp
+ * @brief Executors, thread pool and deterministic parallel loops
+ *
+ * Every parallel entry point in the library takes an optional Executor*.
+ * A null executor runs serially on the calling thread; otherwise the work
+ * runs on the given executor, which may be the library's ThreadPool, the
+ * shared defaultExecutor(), or an adapter over a pool the application
+ * already owns. No part of the library starts threads of its own.
+ *
+ * Parallel loops split an index range into fixed-size chunks ("grains").
+ * The chunk boundaries depend only on the range and the grain size, never on
+ * the number of threads, and reductions combine per-chunk partial results in
+ * chunk order. Results are therefore bit-identical for any pool size,
+ * including the serial case (no pool).
+ */
+
+#ifndef COSMIC_PARALLEL_HPP
+#define COSMIC_PARALLEL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cosmic {
+namespace parallel {
+
+/**
+ * @brief Where parallel work runs
+ *
+ * An implementation only has to provide submit() and concurrency(); run()
+ * is built on submit() with the calling thread taking part, so it works on
+ * any executor. Implementations that can execute a queued task on the
+ * calling thread override runPendingTask(), which lets TaskGroup::wait()
+ * help instead of blocking.
+ */
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    /// Queue a task for asynchronous execution
+    virtual void submit(std::function<void()> task) = 0;
+
+    /// Get the number of threads executing submitted tasks
+    virtual size_t concurrency() const = 0;
+
+    /**
+     * @brief Run task(i) for every i in [0, count) and wait for completion
+     *
+     * The calling thread participates, so nested calls from inside a task
+     * cannot deadlock. The first exception thrown by a task is rethrown.
+     */
+    virtual void run(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief Run one queued task on the calling thread
+     * @return false if nothing was queued (the default)
+     */
+    virtual bool runPendingTask() { return false; }
+};
+
+/**
+ * @brief A fixed-size work-stealing pool of worker threads
+ *
+ * Each worker owns a task deque. Tasks submitted from a worker go to the
+ * back of its own deque and are taken LIFO (cache-warm); tasks submitted
+ * from outside are spread round-robin. An idle worker steals from the
+ * front of the other workers' deques, so uneven task costs (e.g. sweep
+ * points of very different size) still keep every core busy.
+ */
+class ThreadPool : public Executor {
+public:
+    /**
+     * @brief Start the worker threads
+     * @param threads Number of workers (0 = hardware concurrency)
+     */
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Get the number of worker threads
+    size_t size() const { return workers_.size(); }
+
+    void submit(std::function<void()> task) override;
+    size_t concurrency() const override { return workers_.size(); }
+    bool runPendingTask() override;
+
+    /// Get the number of tasks taken from another worker's deque
+    size_t stealCount() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool take(size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<int64_t> pending_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<size_t> steals_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+/**
+ * @brief A set of tasks submitted to an executor and awaited together
+ *
+ * With a null executor, run() executes the task immediately. wait() runs
+ * queued tasks on the calling thread while the group is unfinished, so on
+ * executors that support runPendingTask() (ThreadPool does) groups may be
+ * nested inside tasks of the same executor. On others a waiting task holds
+ * its thread, and nesting can deadlock once every thread waits. The first
+ * exception thrown by a task is rethrown by wait(). The destructor waits
+ * but swallows errors; call wait() to observe them.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(Executor* executor);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Add a task to the group
+    void run(std::function<void()> task);
+
+    /// Wait for every task added so far
+    void wait();
+
+private:
+    struct State;
+
+    Executor* executor_;
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief The executor shared across the library and the application
+ *
+ * A ThreadPool with one worker per hardware thread, started on first use,
+ * unless the application installed its own with setDefaultExecutor().
+ */
+Executor& defaultExecutor();
+
+/**
+ * @brief Replace the shared executor
+ * @param executor Executor to hand out, or nullptr to restore the built-in
+ *        pool; must outlive every use through defaultExecutor()
+ */
+void setDefaultExecutor(Executor* executor);
+
+/// Number of chunks a range of @p n items is split into for a given grain
+inline size_t chunkCount(size_t n, size_t grain) {
+    if (grain == 0) grain = 1;
+    return (n + grain - 1) / grain;
+}
+
+/**
+ * @brief Apply fn(lo, hi) to consecutive chunks of [begin, end)
+ * @param pool Executor to run on; nullptr runs serially on the calling thread
+ * @param grain Chunk size
+ */
+template<typename Fn>
+void parallelFor(Executor* pool, size_t begin, size_t end, size_t grain, Fn&& fn) {
+    if (end <= begin) return;
+    if (grain == 0) grain = 1;
+    size_t chunks = chunkCount(end - begin, grain);
+    auto body = [&](size_t c) {
+        size_t lo = begin + c * grain;
+        size_t hi = lo + grain < end ? lo + grain : end;
+        fn(lo, hi);
+    };
+    if (!pool || chunks == 1) {
+        for (size_t c = 0; c < chunks; ++c) body(c);
+        return;
+    }
+    pool->run(chunks, body);
+}
+
+/**
+ * @brief Deterministic reduction over [begin, end)
+ * @param map Computes the partial result T(lo, hi) of one chunk
+ * @param combine Combines two partial results; applied in chunk order
+ */
+template<typename T, typename Map, typename Combine>
+T parallelReduce(Executor* pool, size_t begin, size_t end, size_t grain,
+                 T identity, Map&& map, Combine&& combine) {
+    if (end <= begin) return identity;
+    if (grain == 0) grain = 1;
+    std::vector<T> partials(chunkCount(end - begin, grain), identity);
+    parallelFor(pool, begin, end, grain, [&](size_t lo, size_t hi) {
+        partials[(lo - begin) / grain] = map(lo, hi);
+    });
+    T result = identity;
+    for (const auto& p : partials) {
+        result = combine(result, p);
+    }
+    return result;
+}
+
+} // namespace parallel
+} // namespace cosmic
+
+#endif // COSMIC_PARALLEL_HPP
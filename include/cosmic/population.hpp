@@ -0,0 +1,140 @@
+/**
+ * @file population.hpp
+ * @brief Batched loon populations sharing one sky
+ *
+ * system1::LoonAnalogy models one loon communicating with an unbounded sky.
+ * LoonPopulation steps many loons at once: per-loon state lives in
+ * structure-of-arrays form, the absorb/enhance/project update is a
+ * branch-free loop over contiguous arrays that the compiler vectorizes, and
+ * chunks of loons run in parallel on an Executor.
+ *
+ * The loons are coupled through a shared sky reservoir. Every step each
+ * loon absorbs at its own reflux rate plus a share of the sky,
+ *
+ *     reflux_i(t) = base_reflux_i + coupling · sky(t) / N
+ *
+ * and the sky collects the net projection of the whole lake,
+ *
+ *     sky(t + dt) = sky(t) + Σ_i (efflux_i − reflux_i)·dt − dissipation · sky(t) · dt
+ *
+ * where the sums are deterministic chunk-ordered parallel reductions. With
+ * zero coupling every loon follows exactly (bit for bit) the trajectory of
+ * an independent LoonAnalogy.
+ */
+
+#ifndef COSMIC_POPULATION_HPP
+#define COSMIC_POPULATION_HPP
+
+#include "parallel.hpp"
+#include "system1.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace cosmic {
+namespace population {
+
+/**
+ * @brief Population-level totals
+ */
+struct Totals {
+    double intensity = 0.0;           ///< Sum of center intensities
+    double efflux = 0.0;              ///< Sum of efflux rates
+    double reflux = 0.0;              ///< Sum of effective reflux rates
+    double mean_balance = 0.0;        ///< Mean communicative balance
+};
+
+/**
+ * @brief A lake of loons coupled through a shared sky
+ */
+class LoonPopulation {
+public:
+    /// Chunk size for parallel kernels and reductions
+    static constexpr size_t GRAIN = 4096;
+
+    /**
+     * @brief Create @p count loons in the default LoonAnalogy state
+     * @param enhancement_factor Enhancement factor of every loon
+     */
+    explicit LoonPopulation(size_t count = 0, double enhancement_factor = 1.1);
+
+    /// Create a population whose loons start in the state of the given analogies
+    static LoonPopulation fromLoons(const std::vector<system1::LoonAnalogy>& loons);
+
+    /// Get the number of loons
+    size_t size() const { return intensity_.size(); }
+
+    /// Get/set the sky coupling strength
+    double coupling() const { return coupling_; }
+    void setCoupling(double coupling) { coupling_ = coupling; }
+
+    /// Get/set the rate at which the sky dissipates its content
+    double dissipation() const { return dissipation_; }
+    void setDissipation(double rate) { dissipation_ = rate; }
+
+    /// Run kernels on an executor (nullptr = serial)
+    void setExecutor(parallel::Executor* executor) { pool_ = executor; }
+    /// Same as setExecutor()
+    void setThreadPool(parallel::Executor* pool) { setExecutor(pool); }
+
+    /**
+     * @brief Advance every loon and the sky by one step
+     *
+     * Equivalent to LoonAnalogy::communicate(dt) per loon, with the
+     * reflux rate raised by the loon's share of the sky.
+     */
+    void communicate(double dt = 1.0);
+
+    // Per-loon state
+    double intensity(size_t i) const { return intensity_[i]; }
+    double effluxRate(size_t i) const { return efflux_[i]; }
+    double baseRefluxRate(size_t i) const { return reflux_[i]; }
+    double refluxRate(size_t i) const { return reflux_[i] + skyFeed(); }
+    double enhancementFactor(size_t i) const { return factor_[i]; }
+    double accumulatedEfflux(size_t i) const { return accumulated_efflux_[i]; }
+    double accumulatedReflux(size_t i) const { return accumulated_reflux_[i]; }
+
+    void setBaseRefluxRate(size_t i, double rate);
+    void setEnhancementFactor(size_t i, double factor);
+
+    /// Get the communicative balance of loon i
+    double communicativeBalance(size_t i) const;
+
+    /// Get loon i as a standalone analogy (its reflux rate is the base rate)
+    system1::LoonAnalogy loon(size_t i) const;
+
+    /// Get all center intensities
+    const std::vector<double>& intensities() const { return intensity_; }
+
+    /// Get the sky reservoir content
+    double sky() const { return sky_; }
+    void setSky(double sky) { sky_ = sky; }
+
+    /// Get the extra reflux rate every loon currently receives from the sky
+    double skyFeed() const;
+
+    /// Get the simulation time
+    double time() const { return time_; }
+
+    /// Compute population totals (parallel reduction)
+    Totals totals() const;
+
+private:
+    std::vector<double> intensity_;
+    std::vector<double> efflux_;
+    std::vector<double> reflux_;
+    std::vector<double> factor_;
+    std::vector<double> accumulated_efflux_;
+    std::vector<double> accumulated_reflux_;
+
+    double coupling_ = 0.0;
+    double dissipation_ = 0.0;
+    double sky_ = 0.0;
+    double time_ = 0.0;
+    parallel::Executor* pool_ = nullptr;
+};
+
+} // namespace population
+} // namespace cosmic
+
+#endif // COSMIC_POPULATION_HPP
@@ -0,0 +1,443 @@
+/**
+ * @file recorder.hpp
+ * @brief Columnar time-series recorder for System 1 / System 2 simulation traces
+ *
+ * The recorder stores simulation traces column by column in row groups
+ * ("chunks") of a fixed number of rows. Each column is compressed with one
+ * of two encodings:
+ * - XOR (Gorilla-style): each value is XORed with its predecessor and only
+ *   the meaningful bits are stored. Slowly varying doubles compress to a
+ *   few bits per sample.
+ * - Delta-of-delta: the 64-bit pattern of each value is differenced twice
+ *   and stored in variable-width buckets. Regularly spaced values (time at
+ *   a fixed dt, mode flags, cycle counters) compress to one bit per sample.
+ *
+ * Sealed row groups are either kept in memory or appended to a memory-mapped
+ * trace file. Range scans skip whole row groups by their time bounds and only
+ * decode the requested column, and downsampling reduces a range to a fixed
+ * number of min/max/mean buckets for plotting.
+ *
+ * The first column of every trace is the simulation time.
+ *
+ * @example
+ * @code
+ * auto rec = cosmic::recorder::TraceRecorder::forSystem2();
+ * rec.open("run.ctrace");
+ * cosmic::system2::System2 sys(0.6, 0.4, 0.1);
+ * for (int i = 0; i < 100000; ++i) {
+ *     sys.step(0.1);
+ *     rec.record(sys);
+ * }
+ * rec.close();
+ *
+ * cosmic::recorder::TraceReader reader("run.ctrace");
+ * auto buckets = reader.downsample("mode_polarity", 0.0, 10000.0, 200);
+ * @endcode
+ */
+
+#ifndef COSMIC_RECORDER_HPP
+#define COSMIC_RECORDER_HPP
+
+#include "system1.hpp"
+#include "system2.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+
+namespace cosmic {
+namespace recorder {
+
+// ============================================================================
+// Column Schema
+// ============================================================================
+
+/**
+ * @brief Compression scheme of a column
+ */
+enum class Encoding : uint8_t {
+    Xor = 0,          ///< Gorilla XOR of consecutive values (smooth doubles)
+    DeltaOfDelta = 1  ///< Second difference of the bit patterns (regular series)
+};
+
+/**
+ * @brief Name and encoding of one recorded field
+ */
+struct ColumnSpec {
+    std::string name;
+    Encoding encoding = Encoding::Xor;
+};
+
+/**
+ * @brief A decoded (time, value) pair
+ */
+struct Sample {
+    double time;
+    double value;
+};
+
+/**
+ * @brief Aggregate of the samples falling into one downsampling bucket
+ */
+struct Bucket {
+    double begin;   ///< Start of the bucket's time interval
+    double end;     ///< End of the bucket's time interval
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double mean = 0.0;
+    size_t count = 0;
+};
+
+// ============================================================================
+// Bit-level Encoders
+// ============================================================================
+
+/**
+ * @brief Appends bit fields (most significant bit first) to a byte buffer
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    /// Write the low @p count bits of @p value (count <= 64)
+    void write(uint64_t value, int count);
+
+    /// Write a single bit
+    void writeBit(bool bit) { write(bit ? 1 : 0, 1); }
+
+private:
+    std::vector<uint8_t>& out_;
+    int free_bits_ = 0;
+};
+
+/**
+ * @brief Reads bit fields written by BitWriter
+ */
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    /// Read @p count bits (count <= 64); throws std::out_of_range past the end
+    uint64_t read(int count);
+
+    /// Read a single bit
+    bool readBit() { return read(1) != 0; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t bit_pos_ = 0;
+};
+
+/**
+ * @brief Gorilla XOR encoder for double columns
+ */
+class XorEncoder {
+public:
+    explicit XorEncoder(std::vector<uint8_t>& out) : bits_(out) {}
+    void append(double value);
+
+private:
+    BitWriter bits_;
+    uint64_t prev_ = 0;
+    int prev_leading_ = -1;
+    int prev_trailing_ = 0;
+    bool first_ = true;
+};
+
+/**
+ * @brief Decoder matching XorEncoder
+ */
+class XorDecoder {
+public:
+    XorDecoder(const uint8_t* data, size_t size) : bits_(data, size) {}
+    double next();
+
+private:
+    BitReader bits_;
+    uint64_t prev_ = 0;
+    int prev_leading_ = 0;
+    int prev_trailing_ = 0;
+    bool first_ = true;
+};
+
+/**
+ * @brief Delta-of-delta encoder operating on the 64-bit pattern of each value
+ *
+ * Working on the bit pattern keeps the encoding lossless for doubles while
+ * still collapsing evenly spaced series to a single '0' bit per sample.
+ */
+class DeltaEncoder {
+public:
+    explicit DeltaEncoder(std::vector<uint8_t>& out) : bits_(out) {}
+    void append(double value);
+
+private:
+    BitWriter bits_;
+    uint64_t prev_ = 0;
+    uint64_t prev_delta_ = 0;
+    size_t count_ = 0;
+};
+
+/**
+ * @brief Decoder matching DeltaEncoder
+ */
+class DeltaDecoder {
+public:
+    DeltaDecoder(const uint8_t* data, size_t size) : bits_(data, size) {}
+    double next();
+
+private:
+    BitReader bits_;
+    uint64_t prev_ = 0;
+    uint64_t prev_delta_ = 0;
+    size_t count_ = 0;
+};
+
+// ============================================================================
+// Row Groups
+// ============================================================================
+
+/**
+ * @brief Read-only view of one sealed row group
+ *
+ * Column payloads point either into recorder-owned memory or into a
+ * memory-mapped trace file.
+ */
+struct ChunkView {
+    size_t rows = 0;
+    double t_min = 0.0;
+    double t_max = 0.0;
+    std::vector<const uint8_t*> columns;
+    std::vector<size_t> sizes;
+};
+
+class TraceFileWriter;
+
+// ============================================================================
+// Trace Recorder
+// ============================================================================
+
+/**
+ * @brief Records rows of simulation state into compressed columns
+ *
+ * Rows are buffered into the active row group; once it reaches
+ * rowsPerChunk() rows it is sealed and compressed. When a trace file is
+ * open, sealed row groups are appended to it and released from memory.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Construct a recorder for the given columns
+     * @param columns Column schema; the first column must be named "time"
+     * @param rows_per_chunk Number of rows per sealed row group
+     */
+    explicit TraceRecorder(std::vector<ColumnSpec> columns, size_t rows_per_chunk = 1024);
+    ~TraceRecorder();
+
+    TraceRecorder(TraceRecorder&&) noexcept;
+    TraceRecorder& operator=(TraceRecorder&&) noexcept;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /// Schema for System 1 traces (time, intensity, net flow, accumulated flows, balance)
+    static std::vector<ColumnSpec> system1Columns();
+
+    /// Schema for System 2 traces (time, intensities, polarities, coalescence, mode)
+    static std::vector<ColumnSpec> system2Columns();
+
+    /// Create a recorder with the System 1 schema
+    static TraceRecorder forSystem1(size_t rows_per_chunk = 1024);
+
+    /// Create a recorder with the System 2 schema
+    static TraceRecorder forSystem2(size_t rows_per_chunk = 1024);
+
+    /// Get the column schema
+    const std::vector<ColumnSpec>& columns() const { return columns_; }
+
+    /// Get the index of a column by name (throws std::out_of_range if unknown)
+    size_t columnIndex(const std::string& name) const;
+
+    /// Get the number of rows per row group
+    size_t rowsPerChunk() const { return rows_per_chunk_; }
+
+    /**
+     * @brief Append one row
+     * @param values One value per column, time first
+     */
+    void append(const double* values);
+    void append(const std::vector<double>& values);
+
+    /// Record the current state of a System 1 (requires the System 1 schema)
+    void record(const system1::System1& system);
+
+    /// Record the current state of a System 2 (requires the System 2 schema)
+    void record(const system2::System2& system);
+
+    /// Seal the active row group, even if it is not full
+    void flush();
+
+    /**
+     * @brief Stream sealed row groups to a memory-mapped trace file
+     *
+     * Row groups already sealed in memory are written immediately.
+     */
+    void open(const std::string& path);
+
+    /// Flush and close the trace file (no-op if none is open)
+    void close();
+
+    /// Check whether a trace file is open
+    bool isFileBacked() const { return file_ != nullptr; }
+
+    /// Get the total number of recorded rows
+    size_t rowCount() const { return row_count_; }
+
+    /// Get the number of sealed row groups
+    size_t chunkCount() const;
+
+    /// Get the number of compressed bytes held by sealed row groups
+    size_t compressedBytes() const { return compressed_bytes_; }
+
+    /// Get all samples of a column in [t0, t1], including the active row group
+    std::vector<Sample> scan(const std::string& column, double t0, double t1) const;
+
+    /// Reduce a column over [t0, t1] to @p buckets equal-width time buckets
+    std::vector<Bucket> downsample(const std::string& column, double t0, double t1,
+                                   size_t buckets) const;
+
+private:
+    struct MemoryChunk {
+        size_t rows;
+        double t_min;
+        double t_max;
+        std::vector<std::vector<uint8_t>> columns;
+    };
+
+    enum class Schema { Custom, System1, System2 };
+
+    std::vector<ChunkView> sealedViews() const;
+    std::vector<Sample> pendingSamples(size_t column, double t0, double t1) const;
+    void seal();
+
+    std::vector<ColumnSpec> columns_;
+    Schema schema_ = Schema::Custom;
+    size_t rows_per_chunk_;
+    std::vector<std::vector<double>> pending_;
+    std::vector<MemoryChunk> chunks_;
+    std::unique_ptr<TraceFileWriter> file_;
+    size_t row_count_ = 0;
+    size_t compressed_bytes_ = 0;
+};
+
+// ============================================================================
+// Trace Files
+// ============================================================================
+
+/**
+ * @brief Appends row groups to a memory-mapped trace file
+ *
+ * The mapping grows geometrically, so appending a row group is a memcpy
+ * into already mapped pages. The file is truncated to its logical size on
+ * close.
+ */
+class TraceFileWriter {
+public:
+    TraceFileWriter(const std::string& path, const std::vector<ColumnSpec>& columns,
+                    size_t rows_per_chunk);
+    ~TraceFileWriter();
+
+    TraceFileWriter(const TraceFileWriter&) = delete;
+    TraceFileWriter& operator=(const TraceFileWriter&) = delete;
+
+    /// Append a row group
+    void writeChunk(size_t rows, double t_min, double t_max,
+                    const std::vector<std::vector<uint8_t>>& columns);
+
+    /// Get views of all row groups written so far
+    std::vector<ChunkView> views() const;
+
+    /// Get the logical file size in bytes
+    size_t size() const { return size_; }
+
+    /// Truncate to the logical size and unmap
+    void close();
+
+private:
+    void reserve(size_t bytes);
+
+    std::string path_;
+    int fd_ = -1;
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    size_t column_count_;
+    std::vector<size_t> chunk_offsets_;
+};
+
+/**
+ * @brief Read-only access to a trace file written by TraceRecorder
+ */
+class TraceReader {
+public:
+    explicit TraceReader(const std::string& path);
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    /// Get the column schema stored in the file
+    const std::vector<ColumnSpec>& columns() const { return columns_; }
+
+    /// Get the index of a column by name (throws std::out_of_range if unknown)
+    size_t columnIndex(const std::string& name) const;
+
+    /// Get the total number of rows
+    size_t rowCount() const { return row_count_; }
+
+    /// Get the number of row groups
+    size_t chunkCount() const { return chunks_.size(); }
+
+    /// Get all samples of a column in [t0, t1]
+    std::vector<Sample> scan(const std::string& column, double t0, double t1) const;
+
+    /// Reduce a column over [t0, t1] to @p buckets equal-width time buckets
+    std::vector<Bucket> downsample(const std::string& column, double t0, double t1,
+                                   size_t buckets) const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<uint8_t> fallback_;
+    std::vector<ColumnSpec> columns_;
+    std::vector<ChunkView> chunks_;
+    size_t row_count_ = 0;
+};
+
+/**
+ * @brief Utility functions shared by recorders and readers
+ */
+namespace util {
+
+/// Decode every value of one column payload
+std::vector<double> decodeColumn(const uint8_t* data, size_t size, size_t rows,
+                                 Encoding encoding);
+
+/// Collect samples of @p column in [t0, t1] from a sequence of row groups
+std::vector<Sample> scanChunks(const std::vector<ChunkView>& chunks,
+                               const std::vector<ColumnSpec>& columns,
+                               size_t column, double t0, double t1);
+
+/// Reduce samples to equal-width time buckets over [t0, t1]
+std::vector<Bucket> bucketize(const std::vector<Sample>& samples,
+                              double t0, double t1, size_t buckets);
+
+} // namespace util
+
+} // namespace recorder
+} // namespace cosmic
+
+#endif // COSMIC_RECORDER_HPP
@@ -0,0 +1,357 @@
+/**
+ * @file service.hpp
+ * @brief Term lookup service over a Unix domain socket
+ *
+ * Building the System hierarchy and the tree catalogs takes time and
+ * memory. A process can instead load them once into an Index and serve
+ * it to other local processes. cosmic_daemon does this, and Client is the
+ * other end:
+ *
+ *   TERM             term at an address: name, type, sub-term count, depth
+ *   TERM_BY_RANK     tree, cluster and cluster size of term r of System n
+ *   CLUSTER_OF_TREE  System, rank and cluster of a parenthesis tree
+ *   RELATIONS        Relationships::getRelations() of two Systems, as a bit mask
+ *   CONNECTION       Relationships::connectionType() of two enneagram positions
+ *   SUBTREE          Serializer::toJSON() of the term at an address (or of
+ *                    the System, for an empty path)
+ *
+ * The protocol is framed binary in host byte order (both ends are on the
+ * same host):
+ *
+ *     request:   size u32 | id u32 | op u8     | payload
+ *     response:  size u32 | id u32 | status u8 | payload
+ *
+ * where size counts the bytes after itself. Strings are a u32 length and the
+ * bytes. Responses come back in request order, and a client may send any
+ * number of requests before reading. The server runs one epoll loop. It
+ * reads up to 256 KB from a connection at a time, handles every complete
+ * request in that input as a batch, and sends the batch's responses in a
+ * single write. Further input waits for the connection's next turn. A
+ * client may shut down its writing side after its last request; the
+ * server still sends every response before it closes the connection.
+ *
+ * Example:
+ * @code
+ * service::Index index;                       // in the daemon
+ * service::Server server(index, "/tmp/cosmic.sock");
+ * server.run();
+ *
+ * service::Client client("/tmp/cosmic.sock"); // in any other process
+ * auto term = client.term({4, {2}});          // System 4, third term
+ * auto tree = client.clusterOfTree("(()(()))");
+ * @endcode
+ */
+
+#ifndef COSMIC_SERVICE_HPP
+#define COSMIC_SERVICE_HPP
+
+#include "operations.hpp"
+#include "parallel.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cosmic {
+namespace service {
+
+/// Protocol version, reported by PING
+constexpr uint32_t PROTOCOL_VERSION = 1;
+
+/// Largest request or response body accepted
+constexpr uint32_t MAX_FRAME_SIZE = 1 << 24;
+
+/// Size of the frame header: size, id, and op or status
+constexpr size_t FRAME_HEADER_SIZE = 9;
+
+/// Request operations
+enum class Op : uint8_t {
+    PING = 0,
+    TERM = 1,
+    TERM_BY_RANK = 2,
+    CLUSTER_OF_TREE = 3,
+    RELATIONS = 4,
+    CONNECTION = 5,
+    SUBTREE = 6
+};
+
+/// Response status
+enum class Status : uint8_t {
+    OK = 0,
+    BAD_REQUEST = 1,   ///< Payload could not be decoded
+    NOT_FOUND = 2,     ///< No such system, term, rank or tree
+    UNKNOWN_OP = 3
+};
+
+/// Short name of a status
+const char* toString(Status status);
+
+/**
+ * @brief Address of a term: a System, then child indices
+ *
+ * The first index selects from System::allTerms(), the rest from
+ * Term::subTerms(). An empty path addresses the System itself.
+ */
+struct Address {
+    int level = 1;
+    std::vector<uint8_t> path;
+};
+
+/// A term, as returned by TERM
+struct TermInfo {
+    std::string name;
+    std::string description;
+    std::optional<TriadicTerm> type;
+    uint32_t sub_terms = 0;
+    uint32_t depth = 0;
+    uint32_t total_terms = 0;
+};
+
+/// A system tree, as returned by TERM_BY_RANK and CLUSTER_OF_TREE
+struct TreeInfo {
+    int level = 0;
+    uint32_t rank = 0;          ///< Index in SystemTreeMapping::getSystemTrees()
+    std::string tree;           ///< Canonical parenthesis string
+    uint32_t cluster = 0;       ///< Index in SystemTreeMapping::getSystemClusters()
+    uint32_t cluster_size = 0;
+};
+
+/// A request or response body, before framing
+struct Message {
+    uint32_t id = 0;
+    uint8_t code = 0;           ///< Op for requests, Status for responses
+    std::string payload;
+};
+
+// ============================================================================
+// Payload Encoding
+// ============================================================================
+
+/// Appends values to a payload
+class Writer {
+public:
+    explicit Writer(std::string& out) : out_(out) {}
+
+    void u8(uint8_t value) { out_.push_back(static_cast<char>(value)); }
+    void u32(uint32_t value) { out_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void string(std::string_view value) {
+        u32(static_cast<uint32_t>(value.size()));
+        out_.append(value.data(), value.size());
+    }
+    void address(const Address& address);
+
+private:
+    std::string& out_;
+};
+
+/// Reads values from a payload; throws std::runtime_error past the end
+class Reader {
+public:
+    Reader(const char* data, size_t size) : data_(data), size_(size) {}
+    explicit Reader(std::string_view data) : Reader(data.data(), data.size()) {}
+
+    uint8_t u8();
+    uint32_t u32();
+    std::string string();
+    Address address();
+
+    bool done() const { return offset_ == size_; }
+
+private:
+    void need(size_t bytes) const;
+
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+/// Append a framed message to @p out
+void appendFrame(std::string& out, const Message& message);
+
+/**
+ * @brief Take one complete frame from the front of @p buffer
+ * @return false if the buffer does not yet hold a whole frame
+ * @throws std::runtime_error if the frame is larger than MAX_FRAME_SIZE
+ */
+bool takeFrame(std::string& buffer, size_t& offset, Message& message);
+
+// ============================================================================
+// Index
+// ============================================================================
+
+/**
+ * @brief The hierarchy and tree catalogs, loaded once and read-only after
+ *
+ * handle() is const and may be called from any thread.
+ */
+class Index {
+public:
+    /// Build Systems 1..@p levels and the trees of Systems 0-10 (on @p pool, if given)
+    explicit Index(parallel::Executor* pool = nullptr, int levels = 10);
+
+    /// Answer one request: append the response payload and return its status
+    Status handle(Op op, Reader& payload, std::string& out) const;
+
+    /// Answer a request body (op code and payload)
+    Message handle(const Message& request) const;
+
+    System::SystemPtr root() const { return root_; }
+
+    /// Get a System by level, or nullptr
+    System::SystemPtr system(int level) const;
+
+    /// Get the term at an address, or nullptr (also for an empty path)
+    System::TermPtr term(const Address& address) const;
+
+    std::optional<TreeInfo> treeByRank(int level, uint32_t rank) const;
+    std::optional<TreeInfo> treeOf(std::string_view parens) const;
+
+private:
+    struct Level {
+        std::vector<std::string> trees;
+        std::vector<uint32_t> cluster;
+        std::vector<uint32_t> cluster_size;
+        std::vector<uint32_t> rank_of_id;    ///< classify id -> rank
+        std::vector<System::TermPtr> terms;  ///< System::allTerms()
+    };
+
+    System::SystemPtr root_;
+    std::vector<System::SystemPtr> systems_;   ///< By level; [0] is null
+    std::vector<Level> levels_;
+};
+
+// ============================================================================
+// Server
+// ============================================================================
+
+/**
+ * @brief Serves an Index on a Unix domain socket with an epoll event loop
+ *
+ * Linux only; elsewhere the constructor throws std::runtime_error.
+ */
+class Server {
+public:
+    /**
+     * @brief Bind and listen on @p path
+     *
+     * A socket file left at @p path by a server that has exited is
+     * replaced. Any other file, or a socket a running server still
+     * answers on, is left alone.
+     *
+     * @throws std::runtime_error if @p path is another kind of file, a
+     *         server is already listening on it, or the socket cannot be
+     *         set up
+     */
+    Server(const Index& index, const std::string& path);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /// Serve until stop() is called
+    void run();
+
+    /// Make run() return; safe from other threads and signal handlers
+    void stop();
+
+    const std::string& path() const { return path_; }
+
+    /// Number of requests answered so far
+    uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+
+    /// Number of batches (reads with at least one request) handled so far
+    uint64_t batches() const { return batches_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        std::string in;
+        size_t in_offset = 0;
+        std::string out;
+        size_t out_offset = 0;
+        uint32_t events = 0;      ///< Currently registered epoll events
+        bool eof = false;         ///< Peer shut down its side; close once out is sent
+    };
+
+    void accept();
+    bool readFrom(int fd, Connection& connection);
+    bool writeTo(int fd, Connection& connection);
+    void watch(int fd, Connection& connection);
+    void close(int fd);
+    void resumeAccepting();
+
+    const Index& index_;
+    std::string path_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    bool accepting_ = true;   ///< listen_fd_ is watched; false while out of descriptors
+    std::map<int, Connection> connections_;
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> batches_{0};
+};
+
+// ============================================================================
+// Client
+// ============================================================================
+
+/**
+ * @brief Connection to a Server
+ *
+ * The typed calls each make one round trip and throw std::runtime_error
+ * for a non-OK status. pipeline() sends many requests in one write and
+ * reads all the responses, which is much faster for bulk lookups.
+ */
+class Client {
+public:
+    /// @throws std::runtime_error if the server cannot be reached
+    explicit Client(const std::string& path);
+    ~Client();
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    /// Server protocol version
+    uint32_t ping();
+
+    TermInfo term(const Address& address);
+    TreeInfo termByRank(int level, uint32_t rank);
+    TreeInfo clusterOfTree(std::string_view parens);
+
+    /// Bit mask of ops::Relationships::RelationType values (bit = enum value)
+    uint32_t relations(int level_a, int level_b);
+
+    std::optional<ops::Relationships::RelationType> connection(int pos1, int pos2);
+
+    /// JSON of the term at an address, or of the System for an empty path
+    std::string subtree(const Address& address);
+
+    /// Send requests (op and payload; ids are assigned) and return their responses in order
+    std::vector<Message> pipeline(const std::vector<Message>& requests);
+
+    // Request payloads and response decoders, for pipeline()
+    static Message termRequest(const Address& address);
+    static Message termByRankRequest(int level, uint32_t rank);
+    static Message clusterOfTreeRequest(std::string_view parens);
+    static TermInfo decodeTerm(const Message& response);
+    static TreeInfo decodeTree(const Message& response);
+
+private:
+    Message call(const Message& request);
+    void sendAll(const std::string& bytes);
+    Message receive();
+
+    int fd_ = -1;
+    uint32_t next_id_ = 1;
+    std::string buffer_;
+    size_t offset_ = 0;
+};
+
+} // namespace service
+} // namespace cosmic
+
+#endif // COSMIC_SERVICE_HPP
@@ -0,0 +1,105 @@
+/**
+ * @file sharding.hpp
+ * @brief Sharded enumeration: rank-range shard files and their k-way merge
+ *
+ * A catalog with cluster ids needs every cluster of size n at once, which
+ * a single process cannot hold for large n. Sharding splits the work:
+ *
+ *   plan()        cut the RootedSequence ranks of n into contiguous ranges
+ *   writeShard()  enumerate one range into a shard file; run by a worker
+ *                 process per shard (cosmic_shard starts them)
+ *   merge()       k-way merge the shards into the global catalog, checking
+ *                 the totals against A000081 and A000055
+ *
+ * A shard file is two catalog sections (enumeration.hpp): the range's
+ * rooted trees with their cluster keys (CLUSTER_KEYS), in decreasing key
+ * order, then the distinct cluster keys of the range, also decreasing.
+ * Shards are written under a temporary name and renamed when complete, so
+ * an interrupted run can be restarted and only redo the missing shards.
+ *
+ * The global catalog is a FREE section holding every cluster key in
+ * decreasing order, followed by a ROOTED section (CLUSTER_IDS) holding
+ * every rooted tree key with the index of its cluster in the FREE
+ * section. The merge streams the rooted records. Only the cluster keys
+ * are kept in memory: 8 bytes per free tree, about 1/n of the rooted
+ * count.
+ *
+ * Example:
+ * @code
+ * auto shards = sharding::plan(20, 8);
+ * std::vector<std::string> paths;
+ * for (const auto& shard : shards) {
+ *     paths.push_back(sharding::shardPath("work", shard));
+ *     if (!sharding::shardComplete(paths.back(), shard)) sharding::writeShard(shard, paths.back());
+ * }
+ * sharding::merge(20, paths, "trees20.bin");
+ * @endcode
+ */
+
+#ifndef COSMIC_SHARDING_HPP
+#define COSMIC_SHARDING_HPP
+
+#include "enumeration.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cosmic {
+namespace sharding {
+
+/// A contiguous range of RootedSequence ranks
+struct Shard {
+    int nodes = 0;
+    int index = 0;              ///< Position in the plan
+    int total = 0;              ///< Number of shards in the plan
+    uint64_t first_rank = 0;
+    uint64_t count = 0;
+};
+
+/**
+ * @brief Split the rooted trees with @p nodes nodes into @p shards ranges
+ *
+ * Ranges differ in size by at most one tree, and there are never more
+ * shards than trees.
+ * @throws std::invalid_argument unless 1 <= nodes <= enumeration::MAX_NODES
+ *         and shards >= 1
+ */
+std::vector<Shard> plan(int nodes, int shards);
+
+/// Path of a shard's file in @p directory
+std::string shardPath(const std::string& directory, const Shard& shard);
+
+/// Whether @p path holds the complete output of @p shard
+bool shardComplete(const std::string& path, const Shard& shard);
+
+/// What a shard or merge produced
+struct Stats {
+    uint64_t trees = 0;
+    uint64_t clusters = 0;
+};
+
+/**
+ * @brief Enumerate @p shard into @p path
+ *
+ * Writes to path + ".tmp" and renames it when done.
+ * @throws std::runtime_error on I/O errors
+ */
+Stats writeShard(const Shard& shard, const std::string& path);
+
+/**
+ * @brief Merge shard files into the global catalog of @p nodes at @p output
+ *
+ * Shards may be given in any order and may come from any partition of
+ * the ranks, as long as together they hold every tree exactly once.
+ * Writes to output + ".tmp" and renames it when done.
+ * @throws std::runtime_error on I/O errors, if a shard is not a shard of
+ *         @p nodes, or if the trees or clusters do not add up to
+ *         A000081(n) and A000055(n)
+ */
+Stats merge(int nodes, const std::vector<std::string>& shards, const std::string& output);
+
+} // namespace sharding
+} // namespace cosmic
+
+#endif // COSMIC_SHARDING_HPP
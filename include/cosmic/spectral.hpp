@@ -0,0 +1,279 @@
+/**
+ * @file spectral.hpp
+ * @brief Spectral analysis of simulation signals
+ *
+ * Provides mixed-radix complex and real FFTs, the usual analysis windows
+ * and a streaming Welch power-spectral-density estimator. Signals are read
+ * through strided views, so columns of SoA state arrays or decoded trace
+ * columns are analysed without copying, and a System2Probe feeds the
+ * estimators directly from a running System 2 so no trace is needed at
+ * all. Batches of signals are estimated in parallel on an Executor; the
+ * result for each signal does not depend on the pool.
+ *
+ * Example:
+ * @code
+ * spectral::WelchOptions opt;
+ * opt.segment = 512;
+ * opt.sample_rate = 1.0 / dt;
+ * spectral::System2Probe probe(opt);
+ * for (size_t i = 0; i < steps; ++i) {
+ *     sys.step(dt);
+ *     probe.record(sys);
+ * }
+ * double f = probe.spectrum(spectral::System2Probe::MODE_POLARITY).peakFrequency();
+ * @endcode
+ */
+
+#ifndef COSMIC_SPECTRAL_HPP
+#define COSMIC_SPECTRAL_HPP
+
+#include "parallel.hpp"
+#include "system2.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace cosmic {
+namespace spectral {
+
+using Complex = std::complex<double>;
+
+// ============================================================================
+// FFT
+// ============================================================================
+
+/**
+ * @brief Precomputed complex FFT of a fixed length
+ *
+ * Any length is supported. The length is factored into radix-4 and radix-2
+ * stages first, then the remaining (odd) factors; lengths with large prime
+ * factors are correct but slower. Transforms are const and may run
+ * concurrently on one plan.
+ */
+class FFT {
+public:
+    explicit FFT(size_t n);
+
+    /// Get the transform length
+    size_t size() const { return n_; }
+
+    /// Forward transform, X[k] = Σ x[j]·e^(−2πijk/n); @p in and @p out must not overlap
+    void forward(const Complex* in, Complex* out) const;
+
+    /// Inverse transform including the 1/n factor; @p in and @p out must not overlap
+    void inverse(const Complex* in, Complex* out) const;
+
+    std::vector<Complex> forward(const std::vector<Complex>& in) const;
+    std::vector<Complex> inverse(const std::vector<Complex>& in) const;
+
+private:
+    struct Stage {
+        size_t radix;
+        size_t span;  ///< Transform length below this stage
+    };
+
+    void transform(const Complex* in, Complex* out, bool inverse) const;
+    void work(Complex* out, const Complex* in, size_t fstride, size_t stage, bool inverse) const;
+    void butterfly(Complex* out, size_t fstride, size_t stage, bool inverse) const;
+
+    size_t n_;
+    std::vector<Stage> stages_;
+    std::vector<Complex> twiddles_;  ///< e^(−2πik/n)
+};
+
+/**
+ * @brief FFT of a real signal of fixed length
+ *
+ * Produces the n/2 + 1 non-negative frequency bins. Even lengths run as a
+ * complex FFT of half the length. Holds a work buffer, so use one plan per
+ * thread.
+ */
+class RealFFT {
+public:
+    explicit RealFFT(size_t n);
+
+    /// Get the signal length
+    size_t size() const { return n_; }
+
+    /// Get the number of output bins (n/2 + 1)
+    size_t bins() const { return n_ / 2 + 1; }
+
+    /// Transform @p n real samples into bins() complex bins
+    void forward(const double* in, Complex* out);
+
+    /// Recover @p n real samples from bins() bins (includes the 1/n factor)
+    void inverse(const Complex* in, double* out);
+
+private:
+    size_t n_;
+    FFT half_;
+    std::vector<Complex> twiddles_;  ///< e^(−2πik/n) for k ≤ n/2
+    std::vector<Complex> work_in_;
+    std::vector<Complex> work_out_;
+};
+
+// ============================================================================
+// Windows
+// ============================================================================
+
+/**
+ * @brief Analysis windows
+ */
+enum class Window {
+    RECTANGULAR,
+    HANN,
+    HAMMING,
+    BLACKMAN
+};
+
+/// Periodic (DFT-even) window of length @p n
+std::vector<double> window(Window type, size_t n);
+
+// ============================================================================
+// Welch PSD
+// ============================================================================
+
+/**
+ * @brief Strided read-only view of a signal
+ */
+struct SignalView {
+    const double* data = nullptr;
+    size_t size = 0;
+    size_t stride = 1;
+
+    SignalView() = default;
+    SignalView(const double* d, size_t n, size_t s = 1) : data(d), size(n), stride(s) {}
+    SignalView(const std::vector<double>& v) : data(v.data()), size(v.size()) {}
+
+    double operator[](size_t i) const { return data[i * stride]; }
+};
+
+/**
+ * @brief Parameters of a Welch estimate
+ */
+struct WelchOptions {
+    size_t segment = 256;          ///< Samples per segment
+    size_t overlap = 128;          ///< Samples shared by consecutive segments
+    Window window = Window::HANN;
+    double sample_rate = 1.0;      ///< Samples per unit of time
+    bool detrend = true;           ///< Subtract each segment's mean
+};
+
+/**
+ * @brief One-sided power spectral density
+ */
+struct Spectrum {
+    std::vector<double> frequencies;
+    std::vector<double> power;     ///< Density per unit frequency
+    size_t segments = 0;           ///< Segments averaged
+
+    /// Get the frequency of the largest non-DC bin (0 if empty)
+    double peakFrequency() const;
+
+    /// Get the total power (integral of the density)
+    double totalPower() const;
+};
+
+/**
+ * @brief Streaming Welch estimator
+ *
+ * Samples are pushed as they are produced. Each complete segment is
+ * detrended, windowed and transformed, and its periodogram is added to a
+ * running sum, so memory is O(segment) however long the signal.
+ */
+class WelchEstimator {
+public:
+    explicit WelchEstimator(const WelchOptions& options = WelchOptions());
+
+    /// Get the options
+    const WelchOptions& options() const { return options_; }
+
+    /// Add one sample
+    void add(double sample);
+
+    /// Add a block of samples
+    void add(const SignalView& signal);
+
+    /// Get the number of samples added
+    size_t sampleCount() const { return samples_; }
+
+    /// Get the number of complete segments averaged so far
+    size_t segmentCount() const { return segments_; }
+
+    /// Get the current estimate (all-zero power before the first segment)
+    Spectrum spectrum() const;
+
+    /// Discard all samples and segments
+    void reset();
+
+private:
+    void processSegment();
+
+    WelchOptions options_;
+    RealFFT fft_;
+    std::vector<double> window_;
+    double scale_;
+    std::vector<double> buffer_;
+    size_t filled_ = 0;
+    std::vector<double> segment_;
+    std::vector<Complex> bins_;
+    std::vector<double> sum_;
+    size_t samples_ = 0;
+    size_t segments_ = 0;
+};
+
+/// Welch estimate of one signal
+Spectrum welch(const SignalView& signal, const WelchOptions& options = WelchOptions());
+
+/**
+ * @brief Welch estimates of many signals, one task per signal
+ * @param pool Pool to run on (nullptr = serial)
+ */
+std::vector<Spectrum> welch(const std::vector<SignalView>& signals,
+                            const WelchOptions& options = WelchOptions(),
+                            parallel::Executor* pool = nullptr);
+
+/**
+ * @brief Segment-weighted mean of spectra with identical bins
+ *
+ * Spectra are combined in order, so the ensemble spectrum of a batch is
+ * the same for any pool size.
+ */
+Spectrum mean(const std::vector<Spectrum>& spectra);
+
+// ============================================================================
+// System 2 Probe
+// ============================================================================
+
+/**
+ * @brief Streams the oscillating System 2 observables into Welch estimators
+ */
+class System2Probe {
+public:
+    enum Signal {
+        MODE_POLARITY,  ///< System2::modePolarity()
+        POLARITY,       ///< System2::polarity()
+        FREQUENCY,      ///< System2::electromagneticFrequency()
+        SIGNAL_COUNT
+    };
+
+    explicit System2Probe(const WelchOptions& options = WelchOptions());
+
+    /// Add one sample of every signal
+    void record(const system2::System2& system);
+
+    /// Get the estimate of one signal
+    Spectrum spectrum(Signal signal) const;
+
+    /// Get the estimator of one signal
+    const WelchEstimator& estimator(Signal signal) const;
+
+private:
+    std::vector<WelchEstimator> estimators_;
+};
+
+} // namespace spectral
+} // namespace cosmic
+
+#endif // COSMIC_SPECTRAL_HPP
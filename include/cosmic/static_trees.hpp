@@ -0,0 +1,445 @@
+/**
+ * @file static_trees.hpp
+ * @brief constexpr enumeration of rooted trees and their clusters
+ *
+ * RootedTreeGenerator builds trees as linked nodes at runtime. For small n
+ * the whole set is tiny, and this header computes it during compilation
+ * instead: STATIC_TREES<n> is a constant with every rooted tree on n nodes
+ * as a packed level sequence, and the cluster (unrooted tree) of each.
+ *
+ * Trees are enumerated with the Beyer-Hedetniemi successor rule over
+ * canonical level sequences. A canonical level sequence lists the depths of
+ * the nodes in preorder, with every node's subtrees in decreasing
+ * lexicographic order. This is the same tree as RootedTree::canonical(), and
+ * the trees come out sorted by that string. Cluster ids match the cluster
+ * order of FlipTransform::groupIntoClusters().
+ *
+ * Level sequences are packed as in tree_tables.hpp: four bits per node,
+ * root in the lowest nibble, so n is at most 16. Compile-time evaluation is
+ * intended for n up to about 10; beyond that, use the build-time tables.
+ *
+ * Example:
+ * @code
+ * static_assert(trees::STATIC_TREES<6>.count() == 20);
+ * static_assert(trees::STATIC_TREES<6>.clusterCount() == 6);
+ * static_assert(trees::STATIC_TREES<6>.find(trees::packParentheses("(()()()()())")) == 19);
+ * @endcode
+ */
+
+#ifndef COSMIC_STATIC_TREES_HPP
+#define COSMIC_STATIC_TREES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace cosmic {
+namespace trees {
+
+/// Largest tree a packed level sequence can hold
+constexpr int MAX_STATIC_NODES = 16;
+
+namespace detail {
+
+/// A level sequence of up to MAX_STATIC_NODES nodes
+struct Levels {
+    int depth[MAX_STATIC_NODES]{};
+    int size = 0;
+};
+
+constexpr uint64_t pack(const Levels& levels) {
+    uint64_t packed = 0;
+    for (int k = 0; k < levels.size; ++k) {
+        packed |= static_cast<uint64_t>(levels.depth[k]) << (4 * k);
+    }
+    return packed;
+}
+
+/**
+ * @brief Move to the next canonical level sequence; false after the last one
+ *
+ * The Beyer-Hedetniemi successor, changing position @p p onwards (p < 0:
+ * the last depth above 1). Works on any sequence with depth[] and size,
+ * such as enumeration::Levels.
+ */
+template<typename LevelSequence>
+constexpr bool nextLevels(LevelSequence& levels, int p = -1) {
+    if (p < 0) {
+        p = levels.size - 1;
+        while (p > 0 && levels.depth[p] <= 1) --p;
+    }
+    if (p <= 0) return false;
+    int q = p - 1;
+    while (levels.depth[q] != levels.depth[p] - 1) --q;
+    for (int i = p; i < levels.size; ++i) {
+        levels.depth[i] = levels.depth[i - (p - q)];
+    }
+    return true;
+}
+
+/// The path, the first canonical level sequence
+constexpr Levels firstLevels(int nodes) {
+    Levels levels;
+    levels.size = nodes;
+    for (int k = 0; k < nodes; ++k) levels.depth[k] = k;
+    return levels;
+}
+
+/// A tree as parent, first child and next sibling links (-1 for none)
+struct Links {
+    int parent[MAX_STATIC_NODES]{};
+    int first_child[MAX_STATIC_NODES]{};
+    int next_sibling[MAX_STATIC_NODES]{};
+    int size = 0;
+};
+
+constexpr Links links(const Levels& levels) {
+    Links tree;
+    tree.size = levels.size;
+    for (int k = 0; k < levels.size; ++k) {
+        tree.first_child[k] = -1;
+        tree.next_sibling[k] = -1;
+    }
+    for (int k = levels.size - 1; k >= 0; --k) {
+        // Walking backwards, prepend each node to its parent's children
+        int d = levels.depth[k];
+        int parent = -1;
+        for (int j = k - 1; j >= 0; --j) {
+            if (levels.depth[j] == d - 1) {
+                parent = j;
+                break;
+            }
+        }
+        tree.parent[k] = parent;
+        if (parent >= 0) {
+            tree.next_sibling[k] = tree.first_child[parent];
+            tree.first_child[parent] = k;
+        }
+    }
+    return tree;
+}
+
+/// First neighbour of v: its parent, else its first child (-1 for none)
+constexpr int firstNeighbour(const Links& tree, int v) {
+    return tree.parent[v] >= 0 ? tree.parent[v] : tree.first_child[v];
+}
+
+/// Neighbour of v after u
+constexpr int nextNeighbour(const Links& tree, int v, int u) {
+    return u == tree.parent[v] ? tree.first_child[v] : tree.next_sibling[u];
+}
+
+/// Breadth-first order from a root, and each node's parent in that rooting
+struct Rooting {
+    int order[MAX_STATIC_NODES]{};
+    int parent[MAX_STATIC_NODES]{};
+};
+
+constexpr Rooting reroot(const Links& tree, int root) {
+    Rooting rooting;
+    rooting.order[0] = root;
+    rooting.parent[root] = -1;
+    int tail = 1;
+    for (int head = 0; head < tail; ++head) {
+        int v = rooting.order[head];
+        for (int u = firstNeighbour(tree, v); u != -1; u = nextNeighbour(tree, v, u)) {
+            if (u != rooting.parent[v]) {
+                rooting.parent[u] = v;
+                rooting.order[tail++] = u;
+            }
+        }
+    }
+    return rooting;
+}
+
+/**
+ * @brief Canonical form of a tree rooted at a node, as a key
+ *
+ * The depths of the nodes in canonical preorder, one nibble each, starting
+ * from the most significant. Below the root every depth is nonzero, so the
+ * zero padding makes comparing keys of subtrees equal to comparing their
+ * sequences lexicographically, with a prefix first.
+ */
+constexpr uint64_t canonicalKey(const Links& tree, int root) {
+    Rooting rooting = reroot(tree, root);
+    uint64_t key[MAX_STATIC_NODES]{};
+    int size[MAX_STATIC_NODES]{};
+    // Children before parents: assemble each subtree from its children's
+    // keys in decreasing order, each one level deeper
+    for (int i = tree.size - 1; i >= 0; --i) {
+        int v = rooting.order[i];
+        uint64_t result = 0;
+        int length = 1;
+        bool first = true;
+        uint64_t previous = 0;
+        while (true) {
+            uint64_t best = 0;
+            int best_size = 0;
+            int copies = 0;
+            for (int u = firstNeighbour(tree, v); u != -1; u = nextNeighbour(tree, v, u)) {
+                if (u == rooting.parent[v] || (!first && key[u] >= previous)) continue;
+                if (copies == 0 || key[u] > best) {
+                    best = key[u];
+                    best_size = size[u];
+                    copies = 1;
+                } else if (key[u] == best) {
+                    ++copies;
+                }
+            }
+            if (copies == 0) break;
+            uint64_t deeper = best;
+            for (int k = 0; k < best_size; ++k) deeper += uint64_t(1) << (60 - 4 * k);
+            for (int c = 0; c < copies; ++c) {
+                result |= deeper >> (4 * length);
+                length += best_size;
+            }
+            previous = best;
+            first = false;
+        }
+        key[v] = result;
+        size[v] = length;
+    }
+    return key[root];
+}
+
+/// Unpack a canonical key of a tree with @p nodes nodes into a level sequence
+constexpr Levels keyLevels(uint64_t key, int nodes) {
+    Levels levels;
+    levels.size = nodes;
+    for (int k = 0; k < nodes; ++k) {
+        levels.depth[k] = static_cast<int>((key >> (60 - 4 * k)) & 0xf);
+    }
+    return levels;
+}
+
+/// The center of a tree, and the second center if there are two (else -1)
+struct Centers {
+    int first = 0;
+    int second = -1;
+};
+
+/**
+ * @brief Find the center(s) of a tree given by parent links in preorder
+ *
+ * Every parent must come before its children, as in a level sequence.
+ * @tparam Capacity Largest number of nodes
+ */
+template<int Capacity>
+constexpr Centers findCenters(const int* parent, int nodes) {
+    // Heights of the two deepest branches below each node; a longest path
+    // bends at the node where they sum highest
+    int down1[Capacity]{};
+    int down2[Capacity]{};
+    int deepest[Capacity]{};
+    for (int k = nodes - 1; k > 0; --k) {
+        int p = parent[k];
+        int h = down1[k] + 1;
+        if (h > down1[p]) {
+            down2[p] = down1[p];
+            down1[p] = h;
+            deepest[p] = k;
+        } else if (h > down2[p]) {
+            down2[p] = h;
+        }
+    }
+    int bend = 0;
+    for (int k = 1; k < nodes; ++k) {
+        if (down1[k] + down2[k] > down1[bend] + down2[bend]) bend = k;
+    }
+
+    // The middle of that path lies (down1 - down2) / 2 steps down its deeper side
+    Centers centers;
+    centers.first = bend;
+    for (int step = (down1[bend] - down2[bend]) / 2; step > 0; --step) {
+        centers.first = deepest[centers.first];
+    }
+    if ((down1[bend] + down2[bend]) % 2 == 1) centers.second = deepest[centers.first];
+    return centers;
+}
+
+/// Canonical key rooted at the tree's center (the larger one if there are two)
+constexpr uint64_t centerKey(const Links& tree) {
+    Centers centers = findCenters<MAX_STATIC_NODES>(tree.parent, tree.size);
+    uint64_t key = canonicalKey(tree, centers.first);
+    if (centers.second >= 0) {
+        uint64_t other = canonicalKey(tree, centers.second);
+        if (other > key) key = other;
+    }
+    return key;
+}
+
+/// Largest canonical key over all rootings
+constexpr uint64_t largestKey(const Links& tree) {
+    uint64_t best = 0;
+    for (int r = 0; r < tree.size; ++r) {
+        uint64_t key = canonicalKey(tree, r);
+        if (key > best) best = key;
+    }
+    return best;
+}
+
+constexpr size_t countTrees(int nodes) {
+    if (nodes < 1 || nodes > MAX_STATIC_NODES) return 0;
+    Levels levels = firstLevels(nodes);
+    size_t count = 1;
+    while (nextLevels(levels)) ++count;
+    return count;
+}
+
+} // namespace detail
+
+/**
+ * @brief Number of nodes in a parenthesis tree such as RootedTree::canonical() returns
+ * @throws std::invalid_argument unless the string is one balanced tree
+ */
+constexpr int parenthesesSize(std::string_view parens) {
+    int depth = 0;
+    int nodes = 0;
+    for (size_t i = 0; i < parens.size(); ++i) {
+        if (parens[i] == '(') {
+            ++nodes;
+            ++depth;
+        } else if (parens[i] == ')' && depth > 0) {
+            --depth;
+        } else {
+            throw std::invalid_argument("Not a parenthesis tree");
+        }
+        if (depth == 0 && i + 1 != parens.size()) {
+            throw std::invalid_argument("Not a parenthesis tree");
+        }
+    }
+    if (nodes == 0 || depth != 0 || nodes > MAX_STATIC_NODES) {
+        throw std::invalid_argument("Not a parenthesis tree of 1-16 nodes");
+    }
+    return nodes;
+}
+
+namespace detail {
+
+/// Level sequence of a parenthesis tree, children in the order written
+constexpr Levels parseParentheses(std::string_view parens) {
+    Levels levels;
+    levels.size = parenthesesSize(parens);
+    int depth = 0;
+    int k = 0;
+    for (char c : parens) {
+        if (c == '(') levels.depth[k++] = depth++;
+        else --depth;
+    }
+    return levels;
+}
+
+} // namespace detail
+
+/// Number of rooted trees with n nodes (A000081), counted by enumeration
+constexpr size_t rootedTreeCount(int nodes) {
+    return detail::countTrees(nodes);
+}
+
+/**
+ * @brief Canonical packed level sequence of a parenthesis tree
+ *
+ * The children may be in any order; the result is the canonical form.
+ * @throws std::invalid_argument unless the string is one balanced tree of 1-16 nodes
+ */
+constexpr uint64_t packParentheses(std::string_view parens) {
+    detail::Levels levels = detail::parseParentheses(parens);
+    uint64_t key = detail::canonicalKey(detail::links(levels), 0);
+    return detail::pack(detail::keyLevels(key, levels.size));
+}
+
+/**
+ * @brief Whether a parenthesis tree is already in canonical form
+ *
+ * Canonical strings are the ones RootedTree::canonical() returns: every
+ * node's subtrees in ascending string order.
+ * @throws std::invalid_argument unless the string is one balanced tree of 1-16 nodes
+ */
+constexpr bool isCanonicalParentheses(std::string_view parens) {
+    return detail::pack(detail::parseParentheses(parens)) == packParentheses(parens);
+}
+
+/**
+ * @brief All rooted trees with N nodes and their clusters, computed by constexpr code
+ */
+template<int N>
+class StaticTrees {
+    static_assert(N >= 1 && N <= MAX_STATIC_NODES, "StaticTrees covers 1-16 nodes");
+
+public:
+    /// A000081(N)
+    static constexpr size_t COUNT = detail::countTrees(N);
+
+    constexpr StaticTrees() {
+        // Trees of one cluster share the key rooted at their center
+        detail::Levels levels = detail::firstLevels(N);
+        uint64_t distinct[COUNT]{};
+        uint64_t order[COUNT]{};
+        size_t first[COUNT]{};
+        for (size_t i = 0; i < COUNT; ++i) {
+            sequences_[i] = detail::pack(levels);
+            detail::Links tree = detail::links(levels);
+            uint64_t center = detail::centerKey(tree);
+            size_t c = 0;
+            while (c < cluster_count_ && distinct[c] != center) ++c;
+            if (c == cluster_count_) {
+                distinct[c] = center;
+                // FlipTransform orders clusters by their smallest canonical
+                // string over rootings, i.e. their largest level sequence
+                order[c] = detail::largestKey(tree);
+                ++cluster_count_;
+            }
+            first[i] = c;
+            detail::nextLevels(levels);
+        }
+        for (size_t i = 0; i < COUNT; ++i) {
+            uint32_t rank = 0;
+            for (size_t c = 0; c < cluster_count_; ++c) {
+                if (order[c] > order[first[i]]) ++rank;
+            }
+            cluster_[i] = rank;
+        }
+    }
+
+    static constexpr int nodes() { return N; }
+    static constexpr size_t count() { return COUNT; }
+    constexpr size_t clusterCount() const { return cluster_count_; }
+
+    /// Packed level sequence of tree i (root in the lowest nibble)
+    constexpr uint64_t sequence(size_t i) const { return sequences_[i]; }
+
+    /// Depth of node k (preorder) of tree i
+    constexpr int depthAt(size_t i, int k) const {
+        return static_cast<int>((sequences_[i] >> (4 * k)) & 0xf);
+    }
+
+    /// Cluster of tree i
+    constexpr uint32_t cluster(size_t i) const { return cluster_[i]; }
+
+    constexpr const std::array<uint64_t, COUNT>& sequences() const { return sequences_; }
+    constexpr const std::array<uint32_t, COUNT>& clusters() const { return cluster_; }
+
+    /// Index of a canonical packed sequence, or COUNT if it is not one of the trees
+    constexpr size_t find(uint64_t sequence) const {
+        for (size_t i = 0; i < COUNT; ++i) {
+            if (sequences_[i] == sequence) return i;
+        }
+        return COUNT;
+    }
+
+private:
+    std::array<uint64_t, COUNT> sequences_{};
+    std::array<uint32_t, COUNT> cluster_{};
+    size_t cluster_count_ = 0;
+};
+
+/// All rooted trees with N nodes, evaluated at compile time
+template<int N>
+inline constexpr StaticTrees<N> STATIC_TREES{};
+
+} // namespace trees
+} // namespace cosmic
+
+#endif // COSMIC_STATIC_TREES_HPP
@@ -0,0 +1,281 @@
+/**
+ * @file succinct.hpp
+ * @brief Succinct balanced-parentheses storage for rooted tree catalogs
+ *
+ * A rooted tree with n nodes is stored in 2n bits as balanced parentheses:
+ * a node is an open bit (1), its subtrees in order, then a close bit (0).
+ * This is exactly the string RootedTree::canonical() produces, with '(' as 1
+ * and ')' as 0. A catalog concatenates many trees into one bit vector.
+ *
+ * On top of the bits sit a rank/select directory and a range-min tree over
+ * the prefix excess, about a tenth extra in total. They answer findClose,
+ * findOpen and enclose in O(log n) time. Parent, first child, next sibling, depth and subtree size
+ * are then navigated on the bits themselves, with no node objects.
+ *
+ * A node is identified by the position of its open bit.
+ *
+ * Example:
+ * @code
+ * succinct::TreeCatalog catalog(trees::RootedTreeGenerator::generate(10));
+ * auto root = catalog.root(17);
+ * for (auto c = catalog.firstChild(root); c != succinct::NONE; c = catalog.nextSibling(c)) {
+ *     std::cout << catalog.subtreeSize(c) << "\n";
+ * }
+ * @endcode
+ */
+
+#ifndef COSMIC_SUCCINCT_HPP
+#define COSMIC_SUCCINCT_HPP
+
+#include "trees.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cosmic {
+namespace succinct {
+
+/// Position that does not exist (no parent, no child, not found)
+constexpr size_t NONE = static_cast<size_t>(-1);
+
+// ============================================================================
+// Bit Vector
+// ============================================================================
+
+/**
+ * @brief Append-only bit vector packed into 64-bit words (bit i is bit i%64 of word i/64)
+ */
+class BitVector {
+public:
+    BitVector() = default;
+
+    /// Append one bit
+    void push_back(bool bit) {
+        if (size_ % 64 == 0) words_.push_back(0);
+        if (bit) words_.back() |= uint64_t(1) << (size_ % 64);
+        ++size_;
+    }
+
+    /**
+     * @brief Append a parenthesis string, '(' as 1 and ')' as 0
+     * @throws std::invalid_argument on any other character
+     */
+    void appendParentheses(const std::string& parens);
+
+    /// Get bit i
+    bool operator[](size_t i) const { return (words_[i / 64] >> (i % 64)) & 1; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const std::vector<uint64_t>& words() const { return words_; }
+
+    /// Reserve room for a number of bits
+    void reserve(size_t bits) { words_.reserve((bits + 63) / 64); }
+
+    /// Release unused capacity
+    void shrinkToFit() { words_.shrink_to_fit(); }
+
+    size_t memoryBytes() const { return words_.capacity() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// Rank / Select
+// ============================================================================
+
+/**
+ * @brief Rank and select over a BitVector
+ *
+ * Keeps the number of ones before every 4096-bit superblock (64 bits) and,
+ * relative to it, before every 512-bit block (16 bits). rank is O(1);
+ * select binary-searches the superblocks and scans at most eight blocks
+ * and eight words.
+ * The bit vector must outlive the directory and stay unchanged.
+ */
+class RankSelect {
+public:
+    RankSelect() = default;
+    explicit RankSelect(const BitVector& bits);
+
+    /// Number of ones in [0, i)
+    size_t rank1(size_t i) const;
+
+    /// Number of zeros in [0, i)
+    size_t rank0(size_t i) const { return i - rank1(i); }
+
+    /// Position of the k-th one (0-based), or NONE
+    size_t select1(size_t k) const;
+
+    /// Position of the k-th zero (0-based), or NONE
+    size_t select0(size_t k) const;
+
+    size_t memoryBytes() const {
+        return super_.capacity() * sizeof(uint64_t) + blocks_.capacity() * sizeof(uint16_t);
+    }
+
+private:
+    friend class BalancedParentheses;
+
+    const BitVector* bits_ = nullptr;
+    std::vector<uint64_t> super_;    ///< Ones before each superblock, plus the total
+    std::vector<uint16_t> blocks_;   ///< Ones before each block within its superblock
+};
+
+// ============================================================================
+// Balanced Parentheses
+// ============================================================================
+
+/**
+ * @brief Balanced-parentheses sequence with excess search
+ *
+ * The excess before position i is (opens - closes) in [0, i). The sequence
+ * may be a forest: several balanced trees back to back.
+ */
+class BalancedParentheses {
+public:
+    /// Empty sequence
+    BalancedParentheses();
+
+    /**
+     * @brief Index a parenthesis sequence
+     * @throws std::invalid_argument if the sequence is not balanced
+     */
+    explicit BalancedParentheses(BitVector bits);
+
+    // The rank/select directory points into bits_
+    BalancedParentheses(const BalancedParentheses& other);
+    BalancedParentheses& operator=(const BalancedParentheses& other);
+    BalancedParentheses(BalancedParentheses&& other) noexcept;
+    BalancedParentheses& operator=(BalancedParentheses&& other) noexcept;
+
+    size_t size() const { return bits_.size(); }
+    bool isOpen(size_t i) const { return bits_[i]; }
+    const BitVector& bits() const { return bits_; }
+    const RankSelect& rankSelect() const { return rank_; }
+
+    /// Excess before position i (0 <= i <= size())
+    int64_t excess(size_t i) const {
+        return 2 * static_cast<int64_t>(rank_.rank1(i)) - static_cast<int64_t>(i);
+    }
+
+    /// Matching close of the open at i
+    size_t findClose(size_t i) const;
+
+    /// Matching open of the close at i
+    size_t findOpen(size_t i) const;
+
+    /// Open of the pair tightly enclosing the open at i, or NONE at depth 0
+    size_t enclose(size_t i) const;
+
+    /// Smallest k >= from with excess(k) <= target, or NONE
+    size_t forwardSearch(size_t from, int64_t target) const;
+
+    /// Largest k <= from with excess(k) <= target, or NONE
+    size_t backwardSearch(size_t from, int64_t target) const;
+
+    size_t memoryBytes() const;
+
+private:
+    size_t firstBlockAtMost(size_t node, size_t lo, size_t hi, size_t from, int64_t target) const;
+    size_t lastBlockAtMost(size_t node, size_t lo, size_t hi, size_t to, int64_t target) const;
+
+    BitVector bits_;
+    RankSelect rank_;
+    size_t leaves_ = 0;               ///< Range-min tree leaves (power of two)
+    std::vector<int64_t> min_tree_;   ///< Min excess after each bit of a 4096-bit block, heap order
+};
+
+// ============================================================================
+// Tree Catalog
+// ============================================================================
+
+/**
+ * @brief A catalog of rooted trees stored as one balanced-parentheses forest
+ *
+ * Trees keep the order they were added in. Every 64th tree start is
+ * sampled; root(i) walks at most 63 trees from the nearest sample.
+ */
+class TreeCatalog {
+public:
+    TreeCatalog() = default;
+
+    /// Store the given trees in their canonical form
+    explicit TreeCatalog(const std::vector<trees::RootedTree>& trees);
+
+    /**
+     * @brief Index trees already encoded back to back
+     *
+     * Build large catalogs by streaming canonical forms into a BitVector
+     * with appendParentheses() instead of keeping the trees.
+     *
+     * @throws std::invalid_argument if the bits are not a balanced forest
+     */
+    explicit TreeCatalog(BitVector parens);
+
+    /// Get the number of trees
+    size_t treeCount() const { return tree_count_; }
+
+    /// Get the total number of nodes
+    size_t nodeCount() const { return bp_.size() / 2; }
+
+    /**
+     * @brief Get the root of tree i
+     * @throws std::out_of_range if i >= treeCount()
+     */
+    size_t root(size_t i) const;
+
+    /// Parent of v, or NONE for a root
+    size_t parent(size_t v) const { return bp_.enclose(v); }
+
+    /// First child of v, or NONE for a leaf
+    size_t firstChild(size_t v) const { return bp_.isOpen(v + 1) ? v + 1 : NONE; }
+
+    /// Next sibling of v, or NONE for a last child or a root
+    size_t nextSibling(size_t v) const;
+
+    /// Depth of v (a root has depth 0)
+    size_t depth(size_t v) const { return static_cast<size_t>(bp_.excess(v)); }
+
+    /// Number of nodes in the subtree of v, v included
+    size_t subtreeSize(size_t v) const { return (bp_.findClose(v) - v + 1) / 2; }
+
+    bool isLeaf(size_t v) const { return !bp_.isOpen(v + 1); }
+
+    /// Number of children of v
+    size_t degree(size_t v) const;
+
+    /// Position of v among all nodes of the catalog in preorder
+    size_t preorder(size_t v) const { return bp_.rankSelect().rank1(v); }
+
+    /// Node at a catalog-wide preorder position, or NONE
+    size_t nodeAt(size_t preorder) const { return bp_.rankSelect().select1(preorder); }
+
+    /// Canonical form of tree i
+    std::string canonical(size_t i) const;
+
+    /// Rebuild tree i as a pointer-based RootedTree
+    trees::RootedTree tree(size_t i) const;
+
+    const BalancedParentheses& parentheses() const { return bp_; }
+
+    /// Bytes used by the bits and all directories
+    size_t memoryBytes() const;
+
+private:
+    void index();
+
+    BalancedParentheses bp_;
+    size_t tree_count_ = 0;
+    std::vector<uint64_t> samples_;   ///< Root of every 64th tree
+};
+
+} // namespace succinct
+} // namespace cosmic
+
+#endif // COSMIC_SUCCINCT_HPP
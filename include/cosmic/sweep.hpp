@@ -0,0 +1,237 @@
+/**
+ * @file sweep.hpp
+ * @brief In-process parameter sweeps over simulations
+ *
+ * A sweep evaluates a simulation task at every point of a design (a full
+ * grid or a random sample of a parameter box). Points run as tasks on a
+ * work-stealing ThreadPool; each point gets a seed derived only from the
+ * sweep seed and the point index, so results do not depend on scheduling
+ * or thread count. Task results stream into a thread-safe Aggregator that
+ * collects rows as points finish and produces per-metric statistics and a
+ * single result table.
+ *
+ * Example:
+ * @code
+ * auto design = sweep::Design::grid({{"rate", {0.05, 0.1, 0.2}},
+ *                                    {"universal", {0.3, 0.5, 0.7}}});
+ * parallel::ThreadPool pool;
+ * auto results = sweep::run(design, sweep::tasks::system2(1000, 0.1), &pool);
+ * results.writeCSV(std::cout);
+ * @endcode
+ */
+
+#ifndef COSMIC_SWEEP_HPP
+#define COSMIC_SWEEP_HPP
+
+#include "parallel.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace cosmic {
+namespace sweep {
+
+// ============================================================================
+// Designs
+// ============================================================================
+
+/// A parameter with an explicit list of values (grid axis)
+struct Parameter {
+    std::string name;
+    std::vector<double> values;
+};
+
+/// A parameter sampled uniformly from [lo, hi] (random designs)
+struct Range {
+    std::string name;
+    double lo;
+    double hi;
+};
+
+/**
+ * @brief A set of sweep points over named parameters
+ */
+class Design {
+public:
+    /// Cartesian product of the parameter values (last parameter varies fastest)
+    static Design grid(const std::vector<Parameter>& parameters);
+
+    /// @p count points drawn uniformly from the parameter box
+    static Design random(const std::vector<Range>& ranges, size_t count, uint64_t seed);
+
+    /// Explicit list of points
+    Design(std::vector<std::string> names, std::vector<std::vector<double>> points);
+
+    /// Get the parameter names
+    const std::vector<std::string>& names() const { return names_; }
+
+    /// Get the number of points
+    size_t size() const { return points_.size(); }
+
+    /// Get the parameter values of point i
+    const std::vector<double>& point(size_t i) const { return points_.at(i); }
+
+private:
+    std::vector<std::string> names_;
+    std::vector<std::vector<double>> points_;
+};
+
+/**
+ * @brief A single sweep point as seen by a task
+ */
+struct Point {
+    size_t index;                          ///< Position in the design
+    uint64_t seed;                         ///< Deterministic per-point seed
+    const std::vector<std::string>* names;
+    const std::vector<double>* values;
+
+    /// Get a parameter value by name (throws std::out_of_range if unknown)
+    double get(const std::string& name) const;
+
+    /// Get a parameter value by position
+    double operator[](size_t i) const { return (*values)[i]; }
+};
+
+/// Named scalar results produced by one task
+using Metrics = std::map<std::string, double>;
+
+/// A simulation task evaluated at one sweep point
+using Task = std::function<Metrics(const Point&)>;
+
+/// Seed for point @p index of a sweep with seed @p sweep_seed
+uint64_t pointSeed(uint64_t sweep_seed, size_t index);
+
+// ============================================================================
+// Aggregation
+// ============================================================================
+
+/**
+ * @brief Running mean/variance/min/max (Welford)
+ */
+class RunningStats {
+public:
+    void add(double value);
+    void merge(const RunningStats& other);
+
+    size_t count() const { return count_; }
+    double mean() const { return mean_; }
+    double variance() const { return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0; }
+    double stddev() const;
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+private:
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Thread-safe collector of sweep results
+ */
+class Aggregator {
+public:
+    struct Row {
+        size_t index;
+        uint64_t seed;
+        std::vector<double> parameters;
+        Metrics metrics;
+    };
+
+    explicit Aggregator(std::vector<std::string> parameter_names = {});
+    Aggregator(Aggregator&& other);
+    Aggregator& operator=(Aggregator&& other);
+
+    /// Record the metrics of one point (safe to call concurrently)
+    void add(const Point& point, Metrics metrics);
+
+    /// Get the number of recorded points
+    size_t size() const;
+
+    /**
+     * @brief Get summary statistics of a metric over all points
+     *
+     * Statistics are accumulated in point order, so they are identical for
+     * any pool size and completion order.
+     */
+    RunningStats summary(const std::string& metric) const;
+
+    /// Get summary statistics of a metric grouped by the value of a parameter
+    std::map<double, RunningStats> summaryBy(const std::string& metric,
+                                             const std::string& parameter) const;
+
+    /// Get all rows ordered by point index
+    std::vector<Row> rows() const;
+
+    /// Get the sorted union of metric names
+    std::vector<std::string> metricNames() const;
+
+    /// Write the result table as CSV (index, seed, parameters..., metrics...)
+    void writeCSV(std::ostream& out) const;
+
+    /// Write the result table to a CSV file
+    void saveCSV(const std::string& path) const;
+
+private:
+    std::vector<std::string> parameter_names_;
+    mutable std::mutex mutex_;
+    std::vector<Row> rows_;
+    std::set<std::string> metric_names_;
+};
+
+// ============================================================================
+// Running
+// ============================================================================
+
+/**
+ * @brief Evaluate @p task at every point of @p design
+ * @param pool Pool to run on (nullptr = serial on the calling thread)
+ * @param seed Sweep seed from which the per-point seeds are derived
+ */
+Aggregator run(const Design& design, const Task& task, parallel::Executor* pool = nullptr,
+               uint64_t seed = 0);
+
+/**
+ * @brief Ready-made tasks for the library's simulations
+ */
+namespace tasks {
+
+/**
+ * @brief Run a System 2 for @p steps steps
+ *
+ * Parameters (optional): "rate", "universal", "particular".
+ * Metrics: mean_mode_polarity, mean_coalescence, subjective_fraction, cycles.
+ */
+Task system2(size_t steps, double dt = 0.1);
+
+/**
+ * @brief Run the loon analogy for @p steps steps
+ *
+ * Parameters: "enhancement_factor".
+ * Metrics: final_intensity, mean_balance, accumulated_efflux.
+ */
+Task loon(size_t steps, double dt = 0.1);
+
+/**
+ * @brief Run the flashlight analogy seeded with the point seed
+ *
+ * Parameters: "count" (number of flashlights).
+ * Metrics: mean_output, output_stddev, min_output, max_output.
+ */
+Task flashlight(size_t steps, double dt = 1.0);
+
+} // namespace tasks
+
+} // namespace sweep
+} // namespace cosmic
+
+#endif // COSMIC_SWEEP_HPP
@@ -15,10 +15,13 @@
 #ifndef COSMIC_SYSTEM_HPP
 #define COSMIC_SYSTEM_HPP
 
+#include "memory.hpp"
+
 #include <memory>
 #include <vector>
 #include <array>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <optional>
 #include <variant>
@@ -26,6 +29,10 @@
 
 namespace cosmic {
 
+namespace parallel {
+class Executor;
+}
+
 // Forward declarations
 class System;
 class Term;
@@ -107,11 +114,31 @@ private:
 class Term {
 public:
     using TermPtr = std::shared_ptr<Term>;
-    using TermList = std::vector<TermPtr>;
+    /**
+     * @brief Sub-term list, allocated from the terms memory resource
+     *
+     * This was std::vector<TermPtr> before the memory resources were added,
+     * and the type change breaks code that names that type. Use TermList
+     * or auto, or copy into a std::vector. Copying a TermList on its own
+     * allocates from the default resource, as for any std::pmr container;
+     * copying a Term keeps its list in the terms resource.
+     */
+    using TermList = std::pmr::vector<TermPtr>;
     
     Term() = default;
     explicit Term(const std::string& name);
     Term(const std::string& name, TriadicTerm type);
+    Term(const Term& other);
+    Term(Term&&) = default;
+    Term& operator=(const Term&) = default;
+    Term& operator=(Term&&) = default;
+    
+    /// Create a term (and its sub-term list) in the terms memory resource
+    template<typename... Args>
+    static TermPtr create(Args&&... args) {
+        std::pmr::polymorphic_allocator<Term> alloc(memory::resource(memory::Subsystem::TERMS));
+        return std::allocate_shared<Term>(alloc, std::forward<Args>(args)...);
+    }
     
     /// Get the term name
     const std::string& name() const { return name_; }
@@ -155,7 +182,7 @@ private:
     std::string name_;
     std::string description_;
     std::optional<TriadicTerm> triadic_type_;
-    TermList sub_terms_;
+    TermList sub_terms_{memory::resource(memory::Subsystem::TERMS)};
     Term* parent_ = nullptr;
 };
 
@@ -175,6 +202,12 @@ public:
     Enneagram() = default;
     explicit Enneagram(const std::string& name);
     
+    /// Create an enneagram in the enneagrams memory resource
+    static EnneagramPtr create(const std::string& name) {
+        std::pmr::polymorphic_allocator<Enneagram> alloc(memory::resource(memory::Subsystem::ENNEAGRAMS));
+        return std::allocate_shared<Enneagram>(alloc, name);
+    }
+    
     /// Get the enneagram name
     const std::string& name() const { return name_; }
     
@@ -306,6 +339,24 @@ public:
     /// Factory method to create the complete System 0-10 hierarchy
     static SystemPtr createHierarchy();
     
+    /**
+     * @brief Create Systems 1..@p levels, building the systems in parallel
+     *
+     * Systems are independent until linked, so each is built as its own
+     * task on @p pool (nullptr = serial). Allocation scopes of the calling
+     * thread do not apply to the pool's workers.
+     * @throws std::invalid_argument if levels is not in [1, 10]
+     */
+    static SystemPtr createHierarchy(parallel::Executor* pool, int levels = 10);
+    
+    /**
+     * @brief Link built systems, in increasing level order, into a hierarchy
+     *
+     * Each system becomes the child of the one before it.
+     * @return The first system (the root), or nullptr if there are none
+     */
+    static SystemPtr linkHierarchy(const std::vector<SystemPtr>& systems);
+    
     /// Get system by level from hierarchy
     static SystemPtr getSystem(SystemPtr root, int level);
     
@@ -349,6 +400,84 @@ private:
  */
 namespace util {
 
+/// Names of Systems 0-10
+constexpr std::array<std::string_view, 11> SYSTEM_NAMES = {
+    "System 0",
+    "System 1",
+    "System 2",
+    "System 3",
+    "System 4",
+    "System 5",
+    "System 6",
+    "System 7",
+    "System 8",
+    "System 9",
+    "System 10"
+};
+
+/// Descriptions of Systems 0-10
+constexpr std::array<std::string_view, 11> SYSTEM_DESCRIPTIONS = {
+    "The Void - root only, primordial unity before differentiation (1 term, 1 cluster)",
+    "Universal Wholeness - active interface between inside and outside (1 term, 1 cluster)",
+    "The Fundamental Dyad - objective and subjective modes (2 terms, 1 cluster)",
+    "The Primary Activity - four terms in two clusters (4 terms, 2 clusters)",
+    "The Enneagram - nine terms in three clusters (9 terms, 3 clusters)",
+    "Complementary Structures - twenty terms in six clusters (20 terms, 6 clusters)",
+    "Primary Activity of Enneagrams - 48 terms in 11 clusters",
+    "Enneagram of Enneagrams - 115 terms in 23 clusters",
+    "Nested Complementarity - 286 terms in 47 clusters",
+    "Deep Nesting - 719 terms in 106 clusters",
+    "Full Recursive Elaboration - 1842 terms in 235 clusters"
+};
+
+/// System 3 cosmic movie descriptions: galaxy, sun and planet, each as idea, routine and form
+constexpr std::array<std::string_view, 9> COSMIC_MOVIE = {
+    "The integrating idea of a galaxy must retain synchronicity with the "
+    "universal projection of hydrogen. This is done via black holes in their "
+    "centers. This singular condition common to all galaxies links them by "
+    "quantum forces. Integration regulates relative angular and linear motions.",
+
+    "Routine cyclic motions in galaxies cause dissynchronicity with the primary "
+    "projection of hydrogen. This space-time contraction in galactic interiors is "
+    "partly offset by spatial contraction of hydrogen into heavy atoms by nuclear "
+    "fusion in centers of stars. Space frame skipping leaves a central black hole.",
+
+    "Galactic integration, via angular momentum, winds up nuclear fusion in "
+    "stars, as gravitational unit forms synchronous with the whole. Stars contract "
+    "in clouds ejected from galactic centers, move out, then recycle back to the "
+    "center, drawn by spatial contraction through maturing into heavy atoms.",
+
+    "The integrating idea of stars retains synchronicity with the universal "
+    "projection of hydrogen by contracting space into heavier elements. This "
+    "partly offsets the skipping of space frames due to galactic rotation. Solar "
+    "system momentum is likewise directed by quantum forces through reflux.",
+
+    "Routines altering momentum in stars and planets adjust for spatial gaps due "
+    "to atomic fusion in suns, radioactive decay in planets, & galactic motions. "
+    "This maintains synchronous integrity in solar systems, always monitored by "
+    "electromagnetic factors linked direct to the primary projection of hydrogen.",
+
+    "The patterned form of cyclic motions and electromagnetic order in suns and "
+    "planets introduces less pronounced contractions in space & time. The "
+    "cascading focus shifts to exploring many synchronous forms of molecular "
+    "chemistry in widely varied planets and moons. Atoms marry up.",
+
+    "The electromagnetic and gravitational form of the sun relates via cyclic "
+    "routines to events in planets and moons, all linked to galactic order. This "
+    "directs the chemical integration of planets as synchronous ideas consistent "
+    "with the primary projection of hydrogen in the cosmic movie.",
+
+    "Planets are bathed in solar electromagnetic energy, modulated in patterns by "
+    "cyclic routines of rotation & lunar and solar revolutions. Cyclic routines, "
+    "electromagnetic fields, core currents, and plate tectonics, are adjusted by "
+    "reflux on a planetary scale to maintain synchronicity via quantum forces.",
+
+    "The diverse chemical integration of planets, via galactic, solar & planet "
+    "routines, fosters biospheric evolution of life if possible. It is probably "
+    "seeded by spores from an interstellar gene pool, eternally linked to the "
+    "galaxy. Life evolves to transcending awareness of the eternal cosmic order."
+};
+
 /// Convert TriadicTerm to string
 std::string toString(TriadicTerm term);
 
@@ -134,6 +134,9 @@ public:
         finite_extent_ = value;
     }
     
+    /// Get the finite extent used when bounded (retained while unbounded)
+    double finiteExtent() const { return finite_extent_; }
+    
     /// Make periphery unbounded
     void makeUnbounded() {
         bounded_ = false;
@@ -237,6 +240,12 @@ public:
         accumulated_reflux_ = 0.0;
     }
     
+    /// Set accumulated values (used when restoring a checkpoint)
+    void setAccumulated(double efflux, double reflux) {
+        accumulated_efflux_ = efflux;
+        accumulated_reflux_ = reflux;
+    }
+    
     /// Get the canonical representation
     std::string canonical() const { return "I"; }
     
@@ -368,6 +377,21 @@ public:
         return center_.intensity() - periphery_.intensity();
     }
     
+    /// Fraction of the net interface flow drawn from the center
+    static constexpr double TRANSFER_COEFFICIENT = 0.01;
+    
+    /**
+     * @brief Rate of change of the center intensity for given interface rates
+     * 
+     * This is the continuous form of step(); the adaptive integrator in
+     * integrator.hpp solves it with error control.
+     */
+    static double intensityRate(double efflux_rate, double reflux_rate) {
+        double net = efflux_rate - reflux_rate;
+        if (std::abs(net) < 1e-10) return 0.0;
+        return -net * TRANSFER_COEFFICIENT;
+    }
+    
     /**
      * @brief Advance the system by one time step
      * @param dt Time step duration
@@ -382,7 +406,7 @@ public:
         // but total energy is conserved (efflux returns as reflux)
         if (!interface_.isEquilibrium()) {
             // Non-equilibrium: center loses/gains based on net flow
-            center_.setIntensity(center_.intensity() - net_transfer * 0.01);
+            center_.setIntensity(center_.intensity() - net_transfer * TRANSFER_COEFFICIENT);
         }
         
         time_ += dt;
@@ -398,6 +422,51 @@ public:
         time_ = 0.0;
     }
     
+    /**
+     * @brief Complete dynamic state of System 1
+     * 
+     * Captured by state() and applied by restore(); restoring a state and
+     * stepping reproduces the original trajectory bit for bit.
+     */
+    struct State {
+        double center_intensity = LightLevel::L0;
+        bool periphery_bounded = false;
+        double periphery_extent = 1.0;
+        double efflux_rate = 1.0;
+        double reflux_rate = 1.0;
+        double accumulated_efflux = 0.0;
+        double accumulated_reflux = 0.0;
+        Perspective perspective = Perspective::ACTIVE;
+        double time = 0.0;
+    };
+    
+    /// Capture the current state
+    State state() const {
+        State s;
+        s.center_intensity = center_.intensity();
+        s.periphery_bounded = periphery_.isBounded();
+        s.periphery_extent = periphery_.finiteExtent();
+        s.efflux_rate = interface_.effluxRate();
+        s.reflux_rate = interface_.refluxRate();
+        s.accumulated_efflux = interface_.accumulatedEfflux();
+        s.accumulated_reflux = interface_.accumulatedReflux();
+        s.perspective = perspective_;
+        s.time = time_;
+        return s;
+    }
+    
+    /// Restore a previously captured state
+    void restore(const State& s) {
+        center_.setIntensity(s.center_intensity);
+        periphery_.setExtent(s.periphery_extent);
+        if (!s.periphery_bounded) periphery_.makeUnbounded();
+        interface_.setEffluxRate(s.efflux_rate);
+        interface_.setRefluxRate(s.reflux_rate);
+        interface_.setAccumulated(s.accumulated_efflux, s.accumulated_reflux);
+        perspective_ = s.perspective;
+        time_ = s.time;
+    }
+    
     /**
      * @brief Get the canonical tree representation
      * 
@@ -577,9 +646,27 @@ public:
     /// Set enhancement factor (how much the loon enhances absorbed energy)
     void setEnhancementFactor(double factor) { enhancement_factor_ = factor; }
     
+    /// Get the enhancement factor
+    double enhancementFactor() const { return enhancement_factor_; }
+    
     /// Get the underlying System 1
     const System1& system() const { return system_; }
     
+    /// Complete dynamic state of the analogy
+    struct State {
+        System1::State system;
+        double enhancement_factor = 1.1;
+    };
+    
+    /// Capture the current state
+    State state() const { return State{system_.state(), enhancement_factor_}; }
+    
+    /// Restore a previously captured state
+    void restore(const State& s) {
+        system_.restore(s.system);
+        enhancement_factor_ = s.enhancement_factor;
+    }
+    
     /**
      * @brief Get description from Fisherman's Guide
      */
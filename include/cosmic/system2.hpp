@@ -37,6 +37,10 @@
 #include <array>
 #include <stdexcept>
 #include <sstream>
+#include <cstdint>
+
+#include "fastmath.hpp"
+#include "random.hpp"
 
 namespace cosmic {
 namespace system2 {
@@ -221,6 +225,21 @@ public:
         }
     }
     
+    /**
+     * @brief Update coalescence with a precomputed mutual intensity
+     * @param mutual_intensity sqrt(center1_intensity * center2_intensity)
+     */
+    void updateWithMutual(Mode mode, double mutual_intensity) {
+        active_ = (mode == Mode::SUBJECTIVE);
+        strength_ = active_ ? mutual_intensity : 0.0;
+    }
+    
+    /// Set strength and activity directly (used when restoring a checkpoint)
+    void restore(double strength, bool active) {
+        strength_ = strength;
+        active_ = active;
+    }
+    
     /// Get the Z arrow symbol
     std::string symbol() const { return "Z"; }
     
@@ -257,7 +276,8 @@ public:
     explicit PerceptualTransposition(double rate = 0.1)
         : rate_(rate)
         , phase_(0.0)
-        , cycle_count_(0) {}
+        , cycle_count_(0)
+        , objective_weight_(1.0) {}
     
     /// Get the transposition rate
     double rate() const { return rate_; }
@@ -277,21 +297,41 @@ public:
      * @return The new phase
      */
     double step(double dt = 1.0) {
+        advancePhase(dt);
+        applyObjectiveWeight(weightForPhase(phase_));
+        return phase_;
+    }
+    
+    /**
+     * @brief Advance the phase only, leaving the objective weight stale
+     * 
+     * Batch kernels advance many transpositions, evaluate the cosines
+     * together, then call applyObjectiveWeight() on each.
+     */
+    void advancePhase(double dt) {
         phase_ += rate_ * dt;
         while (phase_ >= 2.0 * M_PI) {
             phase_ -= 2.0 * M_PI;
             cycle_count_++;
         }
-        return phase_;
+    }
+    
+    /// Set the objective weight computed for the current phase
+    void applyObjectiveWeight(double weight) { objective_weight_ = weight; }
+    
+    /// Objective weight for a phase: 0.5 (1 + cos phase)
+    static double weightForPhase(double phase) {
+        return 0.5 * (1.0 + std::cos(phase));
     }
     
     /**
      * @brief Get the objective weight based on current phase
      * 
-     * Uses sinusoidal oscillation between objective and subjective
+     * Uses sinusoidal oscillation between objective and subjective.
+     * The cosine is evaluated once per step and cached.
      */
     double objectiveWeight() const {
-        return 0.5 * (1.0 + std::cos(phase_));
+        return objective_weight_;
     }
     
     /**
@@ -312,6 +352,14 @@ public:
     void reset() {
         phase_ = 0.0;
         cycle_count_ = 0;
+        objective_weight_ = 1.0;
+    }
+    
+    /// Set phase and cycle count directly (used when restoring a checkpoint)
+    void restore(double phase, int cycle_count) {
+        phase_ = phase;
+        cycle_count_ = cycle_count;
+        objective_weight_ = weightForPhase(phase_);
     }
     
     /**
@@ -328,6 +376,7 @@ private:
     double rate_;
     double phase_;
     int cycle_count_;
+    double objective_weight_;
 };
 
 /**
@@ -534,19 +583,35 @@ public:
         // Advance the perceptual transposition
         transposition_.step(dt);
         
-        // Update mode balance on both centers
+        // Coalescence needs the mutual intensity only in subjective mode
         double obj_weight = transposition_.objectiveWeight();
+        double mutual = obj_weight > 0.5 ? 0.0 : std::sqrt(
+            universal_center_.intensity() * particular_center_.intensity());
+        completeStep(obj_weight, mutual, dt);
+    }
+    
+    /**
+     * @brief Finish a step whose transposition has already been advanced
+     * @param obj_weight Objective weight for the new phase
+     * @param mutual_intensity sqrt(universal × particular intensity)
+     * @param dt Time step duration
+     * 
+     * Used by batch stepping, which evaluates the transcendental functions
+     * for a whole ensemble at once. step() is advancePhase() followed by
+     * this call with the exact values.
+     */
+    void completeStep(double obj_weight, double mutual_intensity, double dt) {
+        transposition_.applyObjectiveWeight(obj_weight);
+        
+        // Update mode balance on both centers
         universal_center_.setModeBalance(obj_weight);
         particular_center_.setModeBalance(1.0 - obj_weight);  // Complementary
         
         // Update current dominant mode
-        Mode old_mode = current_mode_;
         current_mode_ = obj_weight > 0.5 ? Mode::OBJECTIVE : Mode::SUBJECTIVE;
         
         // Update coalescence based on mode
-        coalescence_.update(current_mode_, 
-                          universal_center_.intensity(), 
-                          particular_center_.intensity());
+        coalescence_.updateWithMutual(current_mode_, mutual_intensity);
         
         // Update relational whole identity strengths
         if (current_mode_ == Mode::SUBJECTIVE) {
@@ -596,6 +661,64 @@ public:
         time_ = 0.0;
     }
     
+    /**
+     * @brief Complete dynamic state of System 2
+     * 
+     * Captured by state() and applied by restore(); restoring a state and
+     * stepping reproduces the original trajectory bit for bit.
+     */
+    struct State {
+        struct CenterState {
+            double intensity = 0.5;
+            double objective_weight = 0.5;
+            double identity_strength = 0.5;
+        };
+        CenterState universal;
+        CenterState particular;
+        double transposition_rate = 0.1;
+        double phase = 0.0;
+        int cycle_count = 0;
+        double coalescence_strength = 0.0;
+        bool coalescence_active = false;
+        Mode mode = Mode::OBJECTIVE;
+        double time = 0.0;
+    };
+    
+    /// Capture the current state
+    State state() const {
+        auto capture = [](const Center& c) {
+            return State::CenterState{c.intensity(), c.objectiveWeight(),
+                                      c.relationalWhole().identityStrength()};
+        };
+        State s;
+        s.universal = capture(universal_center_);
+        s.particular = capture(particular_center_);
+        s.transposition_rate = transposition_.rate();
+        s.phase = transposition_.phase();
+        s.cycle_count = transposition_.cycleCount();
+        s.coalescence_strength = coalescence_.strength();
+        s.coalescence_active = coalescence_.isActive();
+        s.mode = current_mode_;
+        s.time = time_;
+        return s;
+    }
+    
+    /// Restore a previously captured state
+    void restore(const State& s) {
+        auto apply = [](Center& c, const State::CenterState& cs) {
+            c.setIntensity(cs.intensity);
+            c.setModeBalance(cs.objective_weight);
+            c.relationalWhole().setIdentityStrength(cs.identity_strength);
+        };
+        apply(universal_center_, s.universal);
+        apply(particular_center_, s.particular);
+        transposition_.setRate(s.transposition_rate);
+        transposition_.restore(s.phase, s.cycle_count);
+        coalescence_.restore(s.coalescence_strength, s.coalescence_active);
+        current_mode_ = s.mode;
+        time_ = s.time;
+    }
+    
     /**
      * @brief Get the canonical tree representations for System 2 terms
      * 
@@ -802,15 +925,47 @@ public:
             : brightness(brightness), battery_level(1.0), recharge_rate(recharge), is_on(true) {}
     };
     
-    FlashlightAnalogy(int count = 100) {
+    /**
+     * @brief Create a field of flashlights with randomized initial states
+     * @param count Number of flashlights
+     */
+    FlashlightAnalogy(int count = 100) : FlashlightAnalogy(count, random::Rng::DEFAULT_SEED) {}
+
+    /**
+     * @brief Create a field of flashlights from a given seed
+     * @param count Number of flashlights
+     * @param seed Seed for the analogy's own generator (runs are reproducible)
+     */
+    FlashlightAnalogy(int count, uint64_t seed) : rng_(seed) {
         flashlights_.resize(count);
         // Randomize initial states
         for (auto& f : flashlights_) {
-            f.brightness = 0.1 + 0.9 * (rand() % 100) / 100.0;
-            f.recharge_rate = 0.05 + 0.1 * (rand() % 100) / 100.0;
+            f.brightness = 0.1 + 0.9 * static_cast<double>(rng_.below(100)) / 100.0;
+            f.recharge_rate = 0.05 + 0.1 * static_cast<double>(rng_.below(100)) / 100.0;
         }
     }
     
+    /// Get the flashlights
+    const std::vector<Flashlight>& flashlights() const { return flashlights_; }
+    
+    /// Get the random generator driving the analogy
+    random::Rng& rng() { return rng_; }
+    
+    /// Complete dynamic state of the analogy, including the generator
+    struct State {
+        std::vector<Flashlight> flashlights;
+        random::Rng::State rng{};
+    };
+    
+    /// Capture the current state
+    State state() const { return State{flashlights_, rng_.state()}; }
+    
+    /// Restore a previously captured state
+    void restore(const State& s) {
+        flashlights_ = s.flashlights;
+        rng_.setState(s.rng);
+    }
+    
     /**
      * @brief Simulate one time step
      * 
@@ -864,6 +1019,56 @@ public:
 
 private:
     std::vector<Flashlight> flashlights_;
+    random::Rng rng_;
+};
+
+/**
+ * @brief Batch stepping for ensembles of System 2 instances
+ * 
+ * Advances every transposition, evaluates all objective weights and mutual
+ * intensities with the batched fastmath kernels, then completes each step.
+ * With Accuracy::EXACT the result is bit-identical to calling step() on
+ * each system; Accuracy::FAST trades ~1e-7 error in the objective weight
+ * for cheaper cosines.
+ */
+class EnsembleStepper {
+public:
+    explicit EnsembleStepper(fastmath::Accuracy accuracy = fastmath::Accuracy::EXACT)
+        : accuracy_(accuracy) {}
+    
+    /// Get the kernel accuracy
+    fastmath::Accuracy accuracy() const { return accuracy_; }
+    
+    /// Set the kernel accuracy
+    void setAccuracy(fastmath::Accuracy accuracy) { accuracy_ = accuracy; }
+    
+    /// Advance every system in the ensemble by one time step
+    void step(std::vector<System2>& systems, double dt = 1.0) {
+        const size_t n = systems.size();
+        phase_.resize(n);
+        weight_.resize(n);
+        mutual_.resize(n);
+        
+        for (size_t i = 0; i < n; ++i) {
+            System2& sys = systems[i];
+            sys.transposition().advancePhase(dt);
+            phase_[i] = sys.transposition().phase();
+            mutual_[i] = sys.universalCenter().intensity() * sys.particularCenter().intensity();
+        }
+        
+        fastmath::objectiveWeight(phase_.data(), weight_.data(), n, accuracy_);
+        fastmath::sqrt(mutual_.data(), mutual_.data(), n, accuracy_);
+        
+        for (size_t i = 0; i < n; ++i) {
+            systems[i].completeStep(weight_[i], mutual_[i], dt);
+        }
+    }
+
+private:
+    fastmath::Accuracy accuracy_;
+    std::vector<double> phase_;
+    std::vector<double> weight_;
+    std::vector<double> mutual_;
 };
 
 /**
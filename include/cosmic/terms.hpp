@@ -15,7 +15,11 @@
 #ifndef COSMIC_TERMS_HPP
 #define COSMIC_TERMS_HPP
 
+#include "metrics.hpp"
+#include "tracing.hpp"
+
 #include <string>
+#include <string_view>
 #include <vector>
 #include <array>
 #include <map>
@@ -267,8 +271,12 @@ public:
      * @return Vector of all distinct rooted trees
      */
     static std::vector<RootedTree> generate(int n) {
+        COSMIC_TRACE_SCOPE_CAT("RootedTreeGenerator::generate", "trees");
+        COSMIC_METRIC_TIMER("terms::RootedTreeGenerator::generate");
         if (n <= 0) return {};
         if (n == 1) {
+            COSMIC_METRIC_COUNT("cosmic_trees_generated_total",
+                                "Rooted trees built by the tree generators", 1);
             return {RootedTree()};  // Single root node
         }
         
@@ -277,6 +285,8 @@ public:
         std::vector<int> partition;
         generatePartitions(n - 1, n - 1, partition, result);
         
+        COSMIC_METRIC_COUNT("cosmic_trees_generated_total",
+                            "Rooted trees built by the tree generators", result.size());
         return result;
     }
     
@@ -299,6 +309,7 @@ private:
     
     static void buildTreesFromPartition(const std::vector<int>& partition,
                                         std::vector<RootedTree>& result) {
+        COSMIC_TRACE_SCOPE_CAT("RootedTreeGenerator::buildTreesFromPartition", "trees");
         // For each partition, we need to select subtrees for each part
         // This is a recursive process using previously generated trees
         
@@ -470,6 +481,8 @@ public:
      */
     static std::vector<std::vector<RootedTree>> groupIntoClusters(
         const std::vector<RootedTree>& trees) {
+        COSMIC_TRACE_SCOPE_CAT("FlipTransform::groupIntoClusters", "trees");
+        COSMIC_METRIC_TIMER("terms::FlipTransform::groupIntoClusters");
         
         std::vector<std::vector<RootedTree>> clusters;
         std::vector<bool> assigned(trees.size(), false);
@@ -636,45 +649,70 @@ struct System5Term {
     std::string description;
 };
 
+/**
+ * @brief Static definition of a System 5 term
+ */
+struct System5TermSpec {
+    int id;
+    std::string_view name;
+    int cluster;
+    std::string_view treeStructure;
+    std::string_view description;
+};
+
+/**
+ * @brief The 20 rooted trees with 6 nodes, grouped into their 6 unrooted classes
+ *
+ * Trees are RootedTree::canonical() strings and clusters are numbered as
+ * FlipTransform::groupIntoClusters() orders them. terms.cpp checks both
+ * against trees::STATIC_TREES<6> at compile time.
+ */
+constexpr std::array<System5TermSpec, 20> SYSTEM5_TERMS = {{
+    // Cluster 0: Path (linear chain)
+    {1, "Linear Descent", 0, "(((((())))))", "Pure sequential elaboration"},
+    {2, "Linear Ascent", 0, "((((())))())", "Reverse sequential return"},
+    {3, "Linear Balance", 0, "(((()))(()))", "Sequence held from its middle"},
+    
+    // Cluster 1: Caterpillar (branch next to an end)
+    {4, "Caterpillar A", 1, "((((()()))))", "Linear with single branch"},
+    {5, "Caterpillar B", 1, "((((()))()))", "Linear with double branch"},
+    {6, "Caterpillar C", 1, "(((()()))())", "Nested caterpillar"},
+    {7, "Caterpillar D", 1, "(((()))()())", "Extended caterpillar"},
+    {8, "Caterpillar E", 1, "((()())(()))", "Complex caterpillar"},
+    
+    // Cluster 2: Fork (branch in the middle)
+    {9, "Double Fork", 2, "((((())())))", "Nested bifurcation"},
+    {10, "Fork Return", 2, "(((())(())))", "Bifurcation return"},
+    {11, "Extended Fork", 2, "(((())())())", "Extended branching"},
+    {12, "Compressed Fork", 2, "((())(())())", "Compressed structure"},
+    
+    // Cluster 3: Complex (four-way hub with one long arm)
+    {13, "Complex A", 3, "(((()()())))", "Multi-branch structure"},
+    {14, "Complex B", 3, "(((())()()))", "Deep with siblings"},
+    {15, "Complex C", 3, "((()()())())", "Shallow with many siblings"},
+    {16, "Complex D", 3, "((())()()())", "Maximum breadth on a stem"},
+    
+    // Cluster 4: Triadic (two adjacent three-way hubs)
+    {17, "Triadic Branch", 4, "(((()())()))", "Three-way split"},
+    {18, "Triadic Merge", 4, "((()())()())", "Three-way convergence"},
+    
+    // Cluster 5: Star (central hub)
+    {19, "Central Hub", 5, "((()()()()))", "Five-fold radiation from center"},
+    {20, "Peripheral Return", 5, "(()()()()())", "Convergence to center"}
+}};
+
 /**
  * @brief Get descriptions for System 5's 20 terms
  * These correspond to A000081(6) = 20 rooted trees with 6 nodes
  */
 inline std::vector<System5Term> getSystem5Terms() {
-    // The 20 rooted trees with 6 nodes, grouped into 6 unrooted classes
-    return {
-        // Cluster 0: Linear chain variants (path graph)
-        {1, "Linear Descent", 0, "((((()))))", "Pure sequential elaboration"},
-        {2, "Linear Ascent", 0, "((((()))))", "Reverse sequential return"},
-        
-        // Cluster 1: Star variants (central hub)
-        {3, "Central Hub", 1, "(()()()(()))", "Five-fold radiation from center"},
-        {4, "Peripheral Return", 1, "(()()()(()))", "Convergence to center"},
-        
-        // Cluster 2: Y-shaped variants
-        {5, "Triadic Branch", 2, "((())(())())", "Three-way split"},
-        {6, "Triadic Merge", 2, "((())(())())", "Three-way convergence"},
-        {7, "Asymmetric Y", 2, "((()())(()))", "Unbalanced branching"},
-        
-        // Cluster 3: Fork variants
-        {8, "Double Fork", 3, "(((()))(()))", "Nested bifurcation"},
-        {9, "Fork Return", 3, "(((()))(()))", "Bifurcation return"},
-        {10, "Extended Fork", 3, "((())(()()))", "Extended branching"},
-        {11, "Compressed Fork", 3, "((()()())())", "Compressed structure"},
-        
-        // Cluster 4: Caterpillar variants
-        {12, "Caterpillar A", 4, "((()(()))())", "Linear with single branch"},
-        {13, "Caterpillar B", 4, "((()())(()))", "Linear with double branch"},
-        {14, "Caterpillar C", 4, "(((())())())", "Nested caterpillar"},
-        {15, "Caterpillar D", 4, "((())(()()))", "Extended caterpillar"},
-        {16, "Caterpillar E", 4, "((()(())()))", "Complex caterpillar"},
-        
-        // Cluster 5: Complex variants
-        {17, "Complex A", 5, "((()())()())", "Multi-branch structure"},
-        {18, "Complex B", 5, "(((()))()())", "Deep with siblings"},
-        {19, "Complex C", 5, "((())()()())", "Shallow with many siblings"},
-        {20, "Complex D", 5, "(()()()()())", "Maximum breadth"}
-    };
+    std::vector<System5Term> terms;
+    terms.reserve(SYSTEM5_TERMS.size());
+    for (const auto& spec : SYSTEM5_TERMS) {
+        terms.push_back({spec.id, std::string(spec.name), spec.cluster,
+                         std::string(spec.treeStructure), std::string(spec.description)});
+    }
+    return terms;
 }
 
 // ============================================================================
@@ -0,0 +1,147 @@
+/**
+ * @file tracing.hpp
+ * @brief Hierarchical tracing spans with Chrome trace-event export
+ *
+ * COSMIC_TRACE_SCOPE("name") marks the rest of the enclosing block as a
+ * span. Spans are only compiled in when the library is configured with
+ * -DCOSMIC_ENABLE_TRACING=ON (which defines COSMIC_ENABLE_TRACING for the
+ * library and its users); otherwise the macros expand to nothing and cost
+ * nothing.
+ *
+ * When compiled in, spans are recorded only while a session is active
+ * (tracing::start() ... tracing::stop()); an inactive span costs one
+ * relaxed atomic load. Each thread appends to its own chunked buffer
+ * without locks; the buffer is registered once per thread. Recorded spans
+ * are exported in the Chrome/Perfetto trace-event JSON format (load the
+ * file in chrome://tracing or ui.perfetto.dev), where nesting is shown per
+ * thread.
+ *
+ * Example:
+ * @code
+ * tracing::start();
+ * auto hierarchy = System::createHierarchy();
+ * tracing::stop();
+ * tracing::saveChromeJSON("hierarchy.trace.json");
+ * @endcode
+ */
+
+#ifndef COSMIC_TRACING_HPP
+#define COSMIC_TRACING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cosmic {
+namespace tracing {
+
+/**
+ * @brief One completed span
+ */
+struct Event {
+    const char* name;       ///< Static string
+    const char* category;   ///< Static string
+    uint64_t start_ns;      ///< Since the session start
+    uint64_t duration_ns;
+    uint32_t thread;        ///< Small sequential thread id
+    uint32_t depth;         ///< Nesting depth on its thread
+};
+
+/// Check whether spans are compiled into this build
+constexpr bool compiledIn() {
+#ifdef COSMIC_ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+namespace detail {
+extern std::atomic<bool> recording;
+uint64_t now();
+uint32_t enter();
+void leave(const char* name, const char* category, uint64_t start, uint32_t depth);
+} // namespace detail
+
+/// Check whether a session is recording
+inline bool active() {
+    return detail::recording.load(std::memory_order_relaxed);
+}
+
+/// Start recording (clears spans from any previous session)
+void start();
+
+/// Stop recording; recorded spans are kept until the next start() or clear()
+void stop();
+
+/// Discard all recorded spans (safe while spans are open)
+void clear();
+
+/// Name the calling thread in exported traces
+void setThreadName(const std::string& name);
+
+/**
+ * @brief Get all recorded spans, ordered by thread and start time
+ *
+ * Call after stop(): threads drop their old spans lazily when a new
+ * session starts, which must not overlap with reading them.
+ */
+std::vector<Event> events();
+
+/// Write the recorded spans as Chrome trace-event JSON
+void writeChromeJSON(std::ostream& out);
+
+/// Write the recorded spans to a Chrome trace-event JSON file
+void saveChromeJSON(const std::string& path);
+
+/**
+ * @brief RAII span; use through COSMIC_TRACE_SCOPE
+ */
+class Scope {
+public:
+    explicit Scope(const char* name, const char* category = "cosmic") noexcept
+        : name_(name)
+        , category_(category)
+        , armed_(active()) {
+        if (armed_) {
+            depth_ = detail::enter();
+            start_ = detail::now();
+        }
+    }
+
+    ~Scope() {
+        if (armed_) detail::leave(name_, category_, start_, depth_);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    bool armed_;
+    uint32_t depth_ = 0;
+    uint64_t start_ = 0;
+};
+
+} // namespace tracing
+} // namespace cosmic
+
+#define COSMIC_TRACE_CONCAT_(a, b) a##b
+#define COSMIC_TRACE_CONCAT(a, b) COSMIC_TRACE_CONCAT_(a, b)
+
+#ifdef COSMIC_ENABLE_TRACING
+/// Trace the rest of the enclosing block as a span named @p name (a string literal)
+#define COSMIC_TRACE_SCOPE(name) \
+    ::cosmic::tracing::Scope COSMIC_TRACE_CONCAT(cosmic_trace_scope_, __LINE__)(name)
+/// As COSMIC_TRACE_SCOPE with an explicit category
+#define COSMIC_TRACE_SCOPE_CAT(name, category) \
+    ::cosmic::tracing::Scope COSMIC_TRACE_CONCAT(cosmic_trace_scope_, __LINE__)(name, category)
+#else
+#define COSMIC_TRACE_SCOPE(name) static_cast<void>(0)
+#define COSMIC_TRACE_SCOPE_CAT(name, category) static_cast<void>(0)
+#endif
+
+#endif // COSMIC_TRACING_HPP
@@ -0,0 +1,62 @@
+/**
+ * @file tree_tables.hpp
+ * @brief Precomputed rooted tree tables embedded at build time
+ *
+ * With -DCOSMIC_EMBED_TREE_TABLES=ON the build runs cosmic_tree_tables,
+ * which enumerates every rooted tree up to COSMIC_TREE_TABLES_MAX_NODES
+ * nodes with RootedTreeGenerator and clusters them with FlipTransform. It
+ * writes the results as constexpr arrays into a generated source file of
+ * the library. SystemTreeMapping then answers from this read-only data
+ * instead of enumerating at runtime. Without the option, find() returns
+ * nullptr and everything is computed on demand as before.
+ *
+ * Each tree is stored as its level sequence: the depth of every node in
+ * preorder, four bits per node with the root in the lowest nibble. This
+ * limits the tables to 16 nodes.
+ */
+
+#ifndef COSMIC_TREE_TABLES_HPP
+#define COSMIC_TREE_TABLES_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cosmic {
+namespace trees {
+namespace tables {
+
+/// Largest tree size a packed level sequence can hold
+constexpr int MAX_PACKED_NODES = 16;
+
+/**
+ * @brief All rooted trees with a given number of nodes
+ *
+ * Trees are in RootedTreeGenerator::generate() order. Clusters are
+ * numbered in FlipTransform::groupIntoClusters() order, and rank is
+ * the position of the tree within its cluster.
+ */
+struct Table {
+    int nodes;
+    size_t tree_count;
+    size_t cluster_count;
+    const uint64_t* sequences;   ///< Packed level sequence per tree
+    const uint32_t* cluster;     ///< Cluster of each tree
+    const uint8_t* rank;         ///< Position of each tree within its cluster
+};
+
+/// Depth of node k (preorder) of tree i
+inline int depthAt(const Table& table, size_t i, int k) {
+    return static_cast<int>((table.sequences[i] >> (4 * k)) & 0xf);
+}
+
+/// Table for trees with @p nodes nodes, or nullptr if it is not embedded
+const Table* find(int nodes);
+
+/// Largest embedded tree size (0 when no tables are embedded)
+int maxNodes();
+
+} // namespace tables
+} // namespace trees
+} // namespace cosmic
+
+#endif // COSMIC_TREE_TABLES_HPP
@@ -14,6 +14,12 @@
 #ifndef COSMIC_TREES_HPP
 #define COSMIC_TREES_HPP
 
+#include "memory.hpp"
+#include "metrics.hpp"
+#include "parallel.hpp"
+#include "tracing.hpp"
+#include "tree_tables.hpp"
+
 #include <string>
 #include <vector>
 #include <array>
@@ -21,7 +27,9 @@
 #include <algorithm>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <set>
+#include <stdexcept>
 
 namespace cosmic {
 namespace trees {
@@ -71,9 +79,31 @@ class TreeNode {
 public:
     using Ptr = std::shared_ptr<TreeNode>;
     using WeakPtr = std::weak_ptr<TreeNode>;
+    /**
+     * @brief Child list, allocated from the trees memory resource
+     *
+     * This was std::vector<Ptr> before the memory resources were added, and
+     * the type change breaks code that names that type. A ChildList copied
+     * on its own allocates from the default resource; copying a TreeNode
+     * keeps its list in the trees resource.
+     */
+    using ChildList = std::pmr::vector<Ptr>;
     
     TreeNode() = default;
     explicit TreeNode(int id) : id_(id) {}
+    TreeNode(const TreeNode& other)
+        : id_(other.id_), label_(other.label_),
+          children_(other.children_, memory::resource(memory::Subsystem::TREES)),
+          parent_(other.parent_) {}
+    TreeNode(TreeNode&&) = default;
+    TreeNode& operator=(const TreeNode&) = default;
+    TreeNode& operator=(TreeNode&&) = default;
+    
+    /// Create a node (and its child list) in the trees memory resource
+    static Ptr create(int id = 0) {
+        std::pmr::polymorphic_allocator<TreeNode> alloc(memory::resource(memory::Subsystem::TREES));
+        return std::allocate_shared<TreeNode>(alloc, id);
+    }
     
     int id() const { return id_; }
     void setId(int id) { id_ = id; }
@@ -81,8 +111,8 @@ public:
     const std::string& label() const { return label_; }
     void setLabel(const std::string& label) { label_ = label; }
     
-    const std::vector<Ptr>& children() const { return children_; }
-    std::vector<Ptr>& children() { return children_; }
+    const ChildList& children() const { return children_; }
+    ChildList& children() { return children_; }
     
     Ptr parent() const { return parent_.lock(); }
     void setParent(Ptr p) { parent_ = p; }
@@ -117,7 +147,7 @@ public:
 private:
     int id_ = 0;
     std::string label_;
-    std::vector<Ptr> children_;
+    ChildList children_{memory::resource(memory::Subsystem::TREES)};
     WeakPtr parent_;
 };
 
@@ -132,7 +162,7 @@ class RootedTree {
 public:
     using NodePtr = TreeNode::Ptr;
     
-    RootedTree() : root_(std::make_shared<TreeNode>(0)) {}
+    RootedTree() : root_(TreeNode::create(0)) {}
     explicit RootedTree(NodePtr root) : root_(root) {}
     
     NodePtr root() const { return root_; }
@@ -187,6 +217,36 @@ public:
         return RootedTree(root);
     }
     
+    /**
+     * @brief Create tree from its level sequence
+     *
+     * The level sequence lists the depth of every node in preorder, e.g.
+     * {0, 1, 2, 1} for a root with a path of two and a leaf. Node ids are
+     * assigned in preorder, as the generator does.
+     *
+     * @throws std::invalid_argument unless the sequence starts with the only 0
+     *         and never steps more than one level down
+     */
+    static RootedTree fromLevelSequence(const std::vector<int>& levels) {
+        if (levels.empty() || levels[0] != 0) {
+            throw std::invalid_argument("Level sequence must start at the root");
+        }
+        auto root = TreeNode::create(0);
+        std::vector<NodePtr> path{root};
+        for (size_t i = 1; i < levels.size(); ++i) {
+            int depth = levels[i];
+            if (depth < 1 || depth > static_cast<int>(path.size())) {
+                throw std::invalid_argument("Invalid level sequence");
+            }
+            path.resize(static_cast<size_t>(depth));
+            auto node = TreeNode::create(static_cast<int>(i));
+            node->setParent(path.back());
+            path.back()->addChild(node);
+            path.push_back(node);
+        }
+        return RootedTree(root);
+    }
+    
 private:
     NodePtr root_;
     
@@ -220,7 +280,7 @@ private:
     static NodePtr copyNode(NodePtr node, int& nextId) {
         if (!node) return nullptr;
         
-        auto copy = std::make_shared<TreeNode>(nextId++);
+        auto copy = TreeNode::create(nextId++);
         copy->setLabel(node->label());
         
         for (const auto& child : node->children()) {
@@ -237,7 +297,7 @@ private:
             return nullptr;
         }
         
-        auto node = std::make_shared<TreeNode>(nextId++);
+        auto node = TreeNode::create(nextId++);
         ++pos;  // Skip '('
         
         while (pos < static_cast<int>(s.length()) && s[pos] == '(') {
@@ -274,27 +334,76 @@ public:
      * @return Vector of all distinct rooted trees (should have A000081(n) elements)
      */
     static std::vector<RootedTree> generate(int n) {
+        return generate(n, nullptr);
+    }
+    
+    /**
+     * @brief Generate all rooted trees with n nodes, enumerating on an executor
+     *
+     * Same result (and order) as generate(n); on a cache miss the trees
+     * are built by enumerate(n, pool). Thread-safe: the cache is locked
+     * for lookups and inserts, and threads that miss on the same n at once
+     * each enumerate it, keeping the first result.
+     */
+    static std::vector<RootedTree> generate(int n, parallel::Executor* pool) {
+        COSMIC_TRACE_SCOPE_CAT("RootedTreeGenerator::generate", "trees");
+        COSMIC_METRIC_TIMER("trees::RootedTreeGenerator::generate");
         if (n <= 0) return {};
         
-        // Use memoization for efficiency
-        static std::map<int, std::vector<RootedTree>> cache;
-        
-        auto it = cache.find(n);
-        if (it != cache.end()) {
-            return it->second;
+        // Use memoization for efficiency; entries are never changed or
+        // removed once inserted, so they can be copied outside the lock
+        auto& memo = cache();
+        if (const auto* cached = memo.find(n)) {
+            COSMIC_METRIC_COUNT("cosmic_tree_cache_hits_total",
+                                "Tree generations served from the generation cache", 1);
+            return *cached;
         }
+        COSMIC_METRIC_COUNT("cosmic_tree_cache_misses_total",
+                            "Tree generations missing the generation cache", 1);
+        // Cached trees live for the whole process, outside any caller's scope
+        memory::ResourceScope cached(memory::Subsystem::TREES, nullptr);
         
+        return memo.insert(n, enumerate(n, pool));
+    }
+    
+    /**
+     * @brief Build all rooted trees with n nodes, bypassing the cache for n
+     *
+     * Smaller trees come from (and fill) the cache. Each partition of the
+     * root's n-1 descendants into subtree sizes is built as a separate task
+     * (on the pool, if given); trees from different partitions never
+     * coincide, so duplicates are only checked within a partition and the
+     * per-partition results are concatenated in partition order.
+     */
+    static std::vector<RootedTree> enumerate(int n, parallel::Executor* pool = nullptr) {
+        COSMIC_TRACE_SCOPE_CAT("RootedTreeGenerator::enumerate", "trees");
         std::vector<RootedTree> result;
+        if (n <= 0) return result;
         
         if (n == 1) {
             result.push_back(RootedTree());
         } else {
-            // Generate all partitions of (n-1) and build trees
+            // Fill the cache for every subtree size first, so tasks only hit it
+            for (int k = 1; k < n; ++k) generate(k);
+            
+            std::vector<std::vector<int>> partitions;
             std::vector<int> partition;
-            generateFromPartitions(n - 1, n - 1, partition, result);
+            collectPartitions(n - 1, n - 1, partition, partitions);
+            
+            std::vector<std::vector<RootedTree>> parts(partitions.size());
+            parallel::parallelFor(pool, 0, partitions.size(), 1, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    buildTreesFromPartition(partitions[i], parts[i]);
+                }
+            });
+            for (auto& part : parts) {
+                result.insert(result.end(), std::make_move_iterator(part.begin()),
+                              std::make_move_iterator(part.end()));
+            }
         }
         
-        cache[n] = result;
+        COSMIC_METRIC_COUNT("cosmic_trees_generated_total",
+                            "Rooted trees built by the tree generators", result.size());
         return result;
     }
     
@@ -306,23 +415,49 @@ public:
     }
     
 private:
-    static void generateFromPartitions(int remaining, int maxPart,
-                                       std::vector<int>& partition,
-                                       std::vector<RootedTree>& result) {
+    /// Generated trees by size, shared by all threads
+    class Cache {
+    public:
+        /// The trees with n nodes, or nullptr if not generated yet
+        const std::vector<RootedTree>* find(int n) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = trees_.find(n);
+            return it != trees_.end() ? &it->second : nullptr;
+        }
+        
+        /// Store the trees with n nodes unless another thread did first; returns the stored trees
+        std::vector<RootedTree> insert(int n, std::vector<RootedTree> trees) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return trees_.emplace(n, std::move(trees)).first->second;
+        }
+        
+    private:
+        std::mutex mutex_;
+        std::map<int, std::vector<RootedTree>> trees_;
+    };
+    
+    static Cache& cache() {
+        static Cache memo;
+        return memo;
+    }
+    
+    static void collectPartitions(int remaining, int maxPart, std::vector<int>& partition,
+                                  std::vector<std::vector<int>>& out) {
         if (remaining == 0) {
-            buildTreesFromPartition(partition, result);
+            out.push_back(partition);
             return;
         }
         
         for (int part = std::min(remaining, maxPart); part >= 1; --part) {
             partition.push_back(part);
-            generateFromPartitions(remaining - part, part, partition, result);
+            collectPartitions(remaining - part, part, partition, out);
             partition.pop_back();
         }
     }
     
     static void buildTreesFromPartition(const std::vector<int>& partition,
                                         std::vector<RootedTree>& result) {
+        COSMIC_TRACE_SCOPE_CAT("RootedTreeGenerator::buildTreesFromPartition", "trees");
         if (partition.empty()) {
             result.push_back(RootedTree());
             return;
@@ -348,7 +483,7 @@ private:
         
         if (pos == sets.size()) {
             // Build tree from this combination
-            auto root = std::make_shared<TreeNode>(0);
+            auto root = TreeNode::create(0);
             int nodeId = 1;
             
             for (size_t i = 0; i < indices.size(); ++i) {
@@ -473,7 +608,7 @@ private:
         
         // Create new tree with reversed parent-child relationships along path
         int nextId = 0;
-        auto newRootCopy = std::make_shared<TreeNode>(nextId++);
+        auto newRootCopy = TreeNode::create(nextId++);
         
         // Copy subtrees of newRoot (excluding path to old root)
         TreeNode::Ptr pathNext = (path.size() > 1) ? path[1] : nullptr;
@@ -500,7 +635,7 @@ private:
     static TreeNode::Ptr copySubtree(TreeNode::Ptr node, int& nextId) {
         if (!node) return nullptr;
         
-        auto copy = std::make_shared<TreeNode>(nextId++);
+        auto copy = TreeNode::create(nextId++);
         for (const auto& child : node->children()) {
             auto childCopy = copySubtree(child, nextId);
             childCopy->setParent(copy);
@@ -514,7 +649,7 @@ private:
                                            size_t idx, int& nextId) {
         if (idx >= path.size()) return nullptr;
         
-        auto node = std::make_shared<TreeNode>(nextId++);
+        auto node = TreeNode::create(nextId++);
         
         // Add children of path[idx] except path[idx-1] and path[idx+1]
         TreeNode::Ptr prev = (idx > 0) ? path[idx - 1] : nullptr;
@@ -551,12 +686,30 @@ public:
      */
     static std::vector<std::vector<RootedTree>> groupIntoClusters(
         const std::vector<RootedTree>& trees) {
+        return groupIntoClusters(trees, nullptr);
+    }
+    
+    /**
+     * @brief Group rooted trees by unrooted class, computing canonical forms on a pool
+     *
+     * Same result as groupIntoClusters(trees).
+     */
+    static std::vector<std::vector<RootedTree>> groupIntoClusters(
+        const std::vector<RootedTree>& trees, parallel::Executor* pool) {
+        COSMIC_TRACE_SCOPE_CAT("FlipTransform::groupIntoClusters", "trees");
+        COSMIC_METRIC_TIMER("trees::FlipTransform::groupIntoClusters");
+        
+        std::vector<std::string> canonical(trees.size());
+        parallel::parallelFor(pool, 0, trees.size(), 8, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                canonical[i] = UnrootedTree(trees[i]).canonical();
+            }
+        });
         
         std::map<std::string, std::vector<RootedTree>> clusterMap;
         
-        for (const auto& tree : trees) {
-            UnrootedTree unrooted(tree);
-            clusterMap[unrooted.canonical()].push_back(tree);
+        for (size_t i = 0; i < trees.size(); ++i) {
+            clusterMap[canonical[i]].push_back(trees[i]);
         }
         
         std::vector<std::vector<RootedTree>> clusters;
@@ -602,6 +755,10 @@ public:
 
 /**
  * @brief Maps system levels to their rooted tree representations
+ *
+ * Answers from the build-time tables (tree_tables.hpp) when they cover the
+ * level, and generates the trees otherwise. Both give the same trees, node
+ * ids and cluster order.
  */
 class SystemTreeMapping {
 public:
@@ -611,6 +768,9 @@ public:
      */
     static std::vector<RootedTree> getSystemTrees(int systemLevel) {
         if (systemLevel < 0 || systemLevel > 10) return {};
+        if (const auto* table = tables::find(systemLevel + 1)) {
+            return treesFromTable(*table);
+        }
         return RootedTreeGenerator::generate(systemLevel + 1);
     }
     
@@ -619,6 +779,18 @@ public:
      * System n has A000055(n+1) clusters
      */
     static std::vector<std::vector<RootedTree>> getSystemClusters(int systemLevel) {
+        if (systemLevel >= 0 && systemLevel <= 10) {
+            if (const auto* table = tables::find(systemLevel + 1)) {
+                auto trees = treesFromTable(*table);
+                std::vector<std::vector<RootedTree>> clusters(table->cluster_count);
+                for (size_t i = 0; i < trees.size(); ++i) {
+                    auto& cluster = clusters[table->cluster[i]];
+                    if (cluster.size() <= table->rank[i]) cluster.resize(table->rank[i] + 1u);
+                    cluster[table->rank[i]] = std::move(trees[i]);
+                }
+                return clusters;
+            }
+        }
         auto trees = getSystemTrees(systemLevel);
         return FlipTransform::groupIntoClusters(trees);
     }
@@ -647,6 +819,16 @@ public:
             summary.treeCanonicals.push_back(tree.canonical());
         }
         
+        const auto* table = systemLevel >= 0 && systemLevel <= 10 ? tables::find(systemLevel + 1) : nullptr;
+        if (table) {
+            summary.clusterCount = table->cluster_count;
+            summary.clusterSizes.assign(table->cluster_count, 0);
+            for (size_t i = 0; i < table->tree_count; ++i) {
+                ++summary.clusterSizes[table->cluster[i]];
+            }
+            return summary;
+        }
+        
         auto clusters = FlipTransform::groupIntoClusters(trees);
         summary.clusterCount = clusters.size();
         
@@ -656,6 +838,20 @@ public:
         
         return summary;
     }
+    
+private:
+    static std::vector<RootedTree> treesFromTable(const tables::Table& table) {
+        std::vector<RootedTree> trees;
+        trees.reserve(table.tree_count);
+        std::vector<int> levels(static_cast<size_t>(table.nodes));
+        for (size_t i = 0; i < table.tree_count; ++i) {
+            for (int k = 0; k < table.nodes; ++k) {
+                levels[static_cast<size_t>(k)] = tables::depthAt(table, i, k);
+            }
+            trees.push_back(RootedTree::fromLevelSequence(levels));
+        }
+        return trees;
+    }
 };
 
 } // namespace trees
@@ -0,0 +1,392 @@
+/**
+ * @file animation.cpp
+ * @brief Implementation of streaming SVG animation
+ */
+
+#include "cosmic/animation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+namespace cosmic {
+namespace animation {
+
+namespace {
+
+constexpr size_t SYSTEM1_CHANNELS = 3;
+constexpr size_t SYSTEM2_CHANNELS = 7;
+
+std::string num(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6g", value);
+    return buf;
+}
+
+/// A time in seconds as a SMIL clock value: fixed point (clock values have
+/// no exponent form) to the microsecond, trailing zeros trimmed
+std::string seconds(double value) {
+    char buf[512];
+    std::snprintf(buf, sizeof(buf), "%.6f", value);
+    std::string text = buf;
+    text.erase(text.find_last_not_of('0') + 1);
+    if (text.back() == '.') text.pop_back();
+    return text == "-0" ? "0" : text;
+}
+
+std::string svgOpen(int width, int height, const std::string& title) {
+    std::ostringstream svg;
+    svg << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    svg << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+        << "xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"" << width
+        << "\" height=\"" << height << "\">\n";
+    svg << "  <rect width=\"100%\" height=\"100%\" fill=\"#1a1a2e\"/>\n";
+    svg << "  <text x=\"" << width / 2 << "\" y=\"25\" text-anchor=\"middle\" "
+        << "fill=\"white\" font-size=\"14\" font-weight=\"bold\">" << title << "</text>\n";
+    return svg.str();
+}
+
+// System 1 layout
+struct Layout1 {
+    double cx, cy, radius, balance_y, balance_span;
+    explicit Layout1(const Scene& s)
+        : cx(s.width / 2.0)
+        , cy(s.height / 2.0 + 10.0)
+        , radius(std::min(s.width, s.height) / 2.0 - 40.0)
+        , balance_y(s.height - 20.0)
+        , balance_span(s.width / 3.0) {}
+};
+
+// System 2 layout
+struct Layout2 {
+    double vx, vy, offset, ax, ay, hand;
+    explicit Layout2(const Scene& s)
+        : vx(s.width / 4.0)
+        , vy(s.height / 2.0)
+        , offset(20.0)
+        , ax(3.0 * s.width / 4.0)
+        , ay(s.height / 2.0)
+        , hand(60.0) {}
+};
+
+void checkScene(const Scene& scene, size_t expected, const char* prefix) {
+    if (scene.channels.size() != expected || scene.channels.front().target.rfind(prefix, 0) != 0) {
+        throw std::invalid_argument(std::string("Scene was not built for ") + prefix);
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Scenes
+// ============================================================================
+
+Scene system1Scene(int width, int height) {
+    Scene scene;
+    scene.width = width;
+    scene.height = height;
+    Layout1 l(scene);
+
+    std::ostringstream svg;
+    svg << svgOpen(width, height, "System 1: Universal Wholeness");
+    svg << "  <circle cx=\"" << num(l.cx) << "\" cy=\"" << num(l.cy) << "\" r=\"" << num(l.radius)
+        << "\" fill=\"none\" stroke=\"#444\" stroke-dasharray=\"4 4\"/>\n";
+    svg << "  <circle id=\"s1-interface\" cx=\"" << num(l.cx) << "\" cy=\"" << num(l.cy)
+        << "\" r=\"" << num(0.7 * l.radius) << "\" fill=\"none\" stroke=\"#FFD700\" stroke-width=\"3\"/>\n";
+    svg << "  <circle id=\"s1-center\" cx=\"" << num(l.cx) << "\" cy=\"" << num(l.cy)
+        << "\" r=\"" << num(0.4 * l.radius) << "\" fill=\"#FFD700\" fill-opacity=\"0.8\"/>\n";
+    svg << "  <text x=\"" << num(l.cx) << "\" y=\"" << num(l.cy + 5) << "\" text-anchor=\"middle\" "
+        << "fill=\"#1a1a2e\" font-size=\"16\" font-weight=\"bold\">L</text>\n";
+    svg << "  <line id=\"s1-balance\" x1=\"" << num(l.cx) << "\" y1=\"" << num(l.balance_y)
+        << "\" x2=\"" << num(l.cx) << "\" y2=\"" << num(l.balance_y)
+        << "\" stroke=\"#00FF00\" stroke-width=\"4\"/>\n";
+    scene.header = svg.str();
+
+    scene.channels = {
+        {"s1-center", "r", 0.5},
+        {"s1-interface", "stroke-width", 0.1},
+        {"s1-balance", "x2", 0.5}
+    };
+    return scene;
+}
+
+Scene system2Scene(int width, int height) {
+    Scene scene;
+    scene.width = width;
+    scene.height = height;
+    Layout2 l(scene);
+
+    std::ostringstream svg;
+    svg << svgOpen(width, height, "System 2: Perceptive Wholeness");
+    svg << "  <circle id=\"s2-universal\" cx=\"" << num(l.vx - l.offset) << "\" cy=\"" << num(l.vy)
+        << "\" r=\"70\" fill=\"#FFD700\" fill-opacity=\"0.7\" stroke=\"#FFD700\" stroke-width=\"2\"/>\n";
+    svg << "  <circle id=\"s2-particular\" cx=\"" << num(l.vx + l.offset) << "\" cy=\"" << num(l.vy)
+        << "\" r=\"70\" fill=\"#FFA500\" fill-opacity=\"0.7\" stroke=\"#FFA500\" stroke-width=\"2\"/>\n";
+    svg << "  <path id=\"s2-coalescence\" d=\"M " << num(l.ax - 20) << " " << num(l.ay - 40)
+        << " L " << num(l.ax + 20) << " " << num(l.ay - 40) << " L " << num(l.ax - 20) << " "
+        << num(l.ay + 40) << " L " << num(l.ax + 20) << " " << num(l.ay + 40)
+        << "\" stroke=\"#00FF00\" stroke-width=\"3\" fill=\"none\" stroke-opacity=\"0\"/>\n";
+    svg << "  <circle cx=\"" << num(l.ax) << "\" cy=\"" << num(l.ay) << "\" r=\"" << num(l.hand)
+        << "\" fill=\"none\" stroke=\"#444\"/>\n";
+    svg << "  <line id=\"s2-phase\" x1=\"" << num(l.ax) << "\" y1=\"" << num(l.ay)
+        << "\" x2=\"" << num(l.ax + l.hand) << "\" y2=\"" << num(l.ay)
+        << "\" stroke=\"white\" stroke-width=\"2\"/>\n";
+    scene.header = svg.str();
+
+    scene.channels = {
+        {"s2-universal", "r", 0.5},
+        {"s2-particular", "r", 0.5},
+        {"s2-universal", "fill-opacity", 0.01},
+        {"s2-particular", "fill-opacity", 0.01},
+        {"s2-coalescence", "stroke-opacity", 0.01},
+        {"s2-phase", "x2", 0.5},
+        {"s2-phase", "y2", 0.5}
+    };
+    return scene;
+}
+
+void values(const system1::System1& system, const Scene& scene, std::vector<double>& out) {
+    checkScene(scene, SYSTEM1_CHANNELS, "s1-");
+    Layout1 l(scene);
+    out.resize(SYSTEM1_CHANNELS);
+    out[0] = std::clamp(0.4 * l.radius * system.center().intensity(), 1.0, l.radius);
+    out[1] = std::clamp(1.0 + 2.0 * system.interface().effluxRate(), 0.5, 12.0);
+    out[2] = l.cx + l.balance_span * system.interface().communicativeBalance();
+}
+
+void values(const system2::System2& system, const Scene& scene, std::vector<double>& out) {
+    checkScene(scene, SYSTEM2_CHANNELS, "s2-");
+    Layout2 l(scene);
+    const auto& u = system.universalCenter();
+    const auto& p = system.particularCenter();
+    double phase = system.transposition().phase();
+    out.resize(SYSTEM2_CHANNELS);
+    out[0] = 30.0 + 80.0 * u.intensity();
+    out[1] = 30.0 + 80.0 * p.intensity();
+    out[2] = 0.2 + 0.8 * u.objectiveWeight();
+    out[3] = 0.2 + 0.8 * p.objectiveWeight();
+    out[4] = std::min(1.0, 2.0 * system.coalescence().strength());
+    out[5] = l.ax + l.hand * std::cos(phase);
+    out[6] = l.ay - l.hand * std::sin(phase);
+}
+
+// ============================================================================
+// LinearDecimator Implementation
+// ============================================================================
+
+LinearDecimator::LinearDecimator(double tolerance) : tolerance_(tolerance) {
+    if (!(tolerance >= 0.0)) {
+        throw std::invalid_argument("LinearDecimator: tolerance must be non-negative");
+    }
+}
+
+bool LinearDecimator::add(double time, double value, Keyframe& out) {
+    if (!has_anchor_) {
+        anchor_ = {time, value};
+        has_anchor_ = true;
+        out = anchor_;
+        return true;
+    }
+    double span = time - anchor_.time;
+    if (!(span > 0.0)) return false;  // ignore non-increasing times
+
+    double hi = (value + tolerance_ - anchor_.value) / span;
+    double lo = (value - tolerance_ - anchor_.value) / span;
+    if (!has_pending_) {
+        slope_hi_ = hi;
+        slope_lo_ = lo;
+        last_ = {time, value};
+        has_pending_ = true;
+        return false;
+    }
+
+    double new_hi = std::min(slope_hi_, hi);
+    double new_lo = std::max(slope_lo_, lo);
+    if (new_lo <= new_hi) {
+        slope_hi_ = new_hi;
+        slope_lo_ = new_lo;
+        last_ = {time, value};
+        return false;
+    }
+
+    // The door closed: end the segment at the previous sample on a slope
+    // that keeps every sample since the anchor within tolerance
+    finish(out);
+    anchor_ = out;
+    span = time - anchor_.time;
+    slope_hi_ = (value + tolerance_ - anchor_.value) / span;
+    slope_lo_ = (value - tolerance_ - anchor_.value) / span;
+    last_ = {time, value};
+    has_pending_ = true;
+    return true;
+}
+
+bool LinearDecimator::finish(Keyframe& out) {
+    if (!has_pending_) return false;
+    double span = last_.time - anchor_.time;
+    double slope = std::clamp((last_.value - anchor_.value) / span, slope_lo_, slope_hi_);
+    out = {last_.time, anchor_.value + slope * span};
+    anchor_ = out;
+    has_pending_ = false;
+    return true;
+}
+
+// ============================================================================
+// SmilWriter Implementation
+// ============================================================================
+
+SmilWriter::SmilWriter(std::ostream& out, Scene scene, double seconds_per_time_unit)
+    : out_(out)
+    , scene_(std::move(scene))
+    , scale_(seconds_per_time_unit)
+    , previous_(scene_.channels.size(), LinearDecimator::Keyframe{0.0, 0.0})
+    , has_previous_(scene_.channels.size(), false) {
+    if (!(scale_ > 0.0)) {
+        throw std::invalid_argument("SmilWriter: time scale must be positive");
+    }
+    decimators_.reserve(scene_.channels.size());
+    for (const auto& c : scene_.channels) {
+        decimators_.emplace_back(c.threshold);
+    }
+    out_ << scene_.header;
+}
+
+SmilWriter::~SmilWriter() {
+    try {
+        finish();
+    } catch (...) {
+        // Destructors must not throw; call finish() to observe errors
+    }
+}
+
+void SmilWriter::frame(double time, const std::vector<double>& values) {
+    if (finished_) {
+        throw std::logic_error("SmilWriter: frame after finish");
+    }
+    if (values.size() != scene_.channels.size()) {
+        throw std::invalid_argument("SmilWriter: value count does not match scene channels");
+    }
+    if (frames_ == 0) start_time_ = time;
+    LinearDecimator::Keyframe key;
+    for (size_t c = 0; c < values.size(); ++c) {
+        if (decimators_[c].add(time, values[c], key)) emit(c, key);
+    }
+    ++frames_;
+}
+
+void SmilWriter::frame(const system1::System1& system) {
+    values(system, scene_, scratch_);
+    frame(system.time(), scratch_);
+}
+
+void SmilWriter::frame(const system2::System2& system) {
+    values(system, scene_, scratch_);
+    frame(system.time(), scratch_);
+}
+
+void SmilWriter::emit(size_t channel, const LinearDecimator::Keyframe& key) {
+    const Channel& c = scene_.channels[channel];
+    double begin = (key.time - start_time_) * scale_;
+    if (!has_previous_[channel]) {
+        out_ << "  <set xlink:href=\"#" << c.target << "\" attributeName=\"" << c.attribute
+             << "\" to=\"" << num(key.value) << "\" begin=\"" << seconds(begin)
+             << "s\" fill=\"freeze\"/>\n";
+    } else {
+        const auto& prev = previous_[channel];
+        double prev_begin = (prev.time - start_time_) * scale_;
+        out_ << "  <animate xlink:href=\"#" << c.target << "\" attributeName=\"" << c.attribute
+             << "\" from=\"" << num(prev.value) << "\" to=\"" << num(key.value)
+             << "\" begin=\"" << seconds(prev_begin) << "s\" dur=\"" << seconds(begin - prev_begin)
+             << "s\" fill=\"freeze\"/>\n";
+    }
+    previous_[channel] = key;
+    has_previous_[channel] = true;
+    ++keyframes_;
+}
+
+void SmilWriter::finish() {
+    if (finished_) return;
+    finished_ = true;
+    LinearDecimator::Keyframe key;
+    for (size_t c = 0; c < decimators_.size(); ++c) {
+        if (decimators_[c].finish(key)) emit(c, key);
+    }
+    out_ << scene_.footer;
+    out_.flush();
+}
+
+// ============================================================================
+// DeltaStreamWriter Implementation
+// ============================================================================
+
+DeltaStreamWriter::DeltaStreamWriter(std::ostream& out, Scene scene)
+    : out_(out)
+    , scene_(std::move(scene)) {
+    out_ << "COSMIC-ANIM 1\n";
+    out_ << "scene " << scene_.width << " " << scene_.height << " " << scene_.channels.size() << "\n";
+    for (size_t i = 0; i < scene_.channels.size(); ++i) {
+        const auto& c = scene_.channels[i];
+        out_ << "channel " << i << " " << c.target << " " << c.attribute << " "
+             << num(c.threshold) << "\n";
+    }
+    std::string document = scene_.header + scene_.footer;
+    out_ << "svg " << document.size() << "\n" << document;
+}
+
+DeltaStreamWriter::~DeltaStreamWriter() {
+    try {
+        finish();
+    } catch (...) {
+        // Destructors must not throw; call finish() to observe errors
+    }
+}
+
+void DeltaStreamWriter::frame(double time, const std::vector<double>& values) {
+    if (finished_) {
+        throw std::logic_error("DeltaStreamWriter: frame after finish");
+    }
+    if (values.size() != scene_.channels.size()) {
+        throw std::invalid_argument("DeltaStreamWriter: value count does not match scene channels");
+    }
+    bool first = frames_ == 0;
+    bool started = false;
+    for (size_t c = 0; c < values.size(); ++c) {
+        if (!first && std::abs(values[c] - last_[c]) <= scene_.channels[c].threshold) continue;
+        if (!started) {
+            out_ << "f " << num(time);
+            started = true;
+        }
+        out_ << " " << c << "=" << num(values[c]);
+        if (first) {
+            last_.push_back(values[c]);
+        } else {
+            last_[c] = values[c];
+        }
+    }
+    if (started) {
+        out_ << "\n";
+        ++written_;
+    }
+    ++frames_;
+}
+
+void DeltaStreamWriter::frame(const system1::System1& system) {
+    values(system, scene_, scratch_);
+    frame(system.time(), scratch_);
+}
+
+void DeltaStreamWriter::frame(const system2::System2& system) {
+    values(system, scene_, scratch_);
+    frame(system.time(), scratch_);
+}
+
+void DeltaStreamWriter::finish() {
+    if (finished_) return;
+    finished_ = true;
+    out_ << "end " << frames_ << " " << written_ << "\n";
+    out_.flush();
+}
+
+} // namespace animation
+} // namespace cosmic
@@ -0,0 +1,146 @@
+/**
+ * @file async.cpp
+ * @brief Coroutine versions of the long-running generation and export calls
+ */
+
+#include "cosmic/async.hpp"
+#include "cosmic/enumeration.hpp"
+#include "cosmic/operations.hpp"
+
+#include <algorithm>
+
+namespace cosmic {
+namespace async {
+
+AsyncGenerator<trees::RootedTree> rootedTrees(int nodes, Context context, size_t batch) {
+    enumeration::RootedSequence sequence(nodes);
+    uint64_t total = enumeration::rootedTreeCount(nodes);
+    uint64_t done = 0;
+    batch = std::max<size_t>(batch, 1);
+    bool more = true;
+    std::vector<trees::RootedTree> trees;
+    while (more) {
+        // Each batch is a fresh task on the executor
+        co_await resumeOn(context.executor);
+        context.cancel.throwIfCancelled();
+        trees.clear();
+        while (more && trees.size() < batch) {
+            trees.push_back(trees::RootedTree::fromCanonical(enumeration::toParentheses(sequence.key(), nodes)));
+            more = sequence.next();
+        }
+        done += trees.size();
+        context.report(done, total);
+
+        for (auto& tree : trees) {
+            context.cancel.throwIfCancelled();
+            co_yield std::move(tree);
+        }
+    }
+}
+
+Task<std::vector<trees::RootedTree>> generateTrees(int n, Context context) {
+    co_await resumeOn(context.executor);
+    context.cancel.throwIfCancelled();
+    auto result = trees::RootedTreeGenerator::generate(n, context.executor);
+    context.report(result.size(), result.size());
+    co_return result;
+}
+
+Task<System::SystemPtr> createHierarchy(Context context, int levels) {
+    if (levels < 1 || levels > 10) {
+        throw std::invalid_argument("Hierarchy levels must be 1-10");
+    }
+
+    // Systems are independent until linked, so each is its own task
+    std::vector<System::SystemPtr> systems(static_cast<size_t>(levels));
+    std::atomic<uint64_t> built{0};
+    co_await runAll(context.executor, systems.size(), [&](size_t i) {
+        context.cancel.throwIfCancelled();
+        auto system = std::make_shared<System>(static_cast<int>(i) + 1);
+        system->build();
+        systems[i] = std::move(system);
+        context.report(built.fetch_add(1, std::memory_order_relaxed) + 1, systems.size());
+    });
+    context.cancel.throwIfCancelled();
+    co_return System::linkHierarchy(systems);
+}
+
+AsyncGenerator<std::string> hierarchyJSON(System::SystemPtr root, Context context) {
+    if (!root) {
+        co_yield std::string("null");
+        co_return;
+    }
+    uint64_t total = 0;
+    root->accept([&total](const System&) { ++total; });
+
+    // The same text as Serializer::hierarchyToJSON, walked with an explicit
+    // stack: a System's piece is emitted when it is opened, and the closing
+    // brackets travel with the next piece
+    struct Frame {
+        const System* system;
+        size_t next_child;
+    };
+    std::vector<Frame> stack;
+    std::string out;
+    uint64_t done = 0;
+    const System* open = root.get();
+    while (open || !stack.empty()) {
+        if (open) {
+            co_await resumeOn(context.executor);
+            context.cancel.throwIfCancelled();
+            out += "{\n";
+            out += "  \"system\": " + ops::Serializer::toJSON(*open);
+            if (!open->children().empty()) out += ",\n  \"children\": [\n";
+            stack.push_back({open, 0});
+            open = nullptr;
+            context.report(++done, total);
+            co_yield std::exchange(out, std::string());
+            continue;
+        }
+
+        Frame& top = stack.back();
+        const auto& children = top.system->children();
+        if (top.next_child < children.size()) {
+            open = children[top.next_child++].get();
+            continue;
+        }
+        if (!children.empty()) out += "  ]";
+        out += "\n}";
+        stack.pop_back();
+        if (!stack.empty()) {
+            const Frame& parent = stack.back();
+            if (parent.next_child < parent.system->children().size()) out += ",";
+            out += "\n";
+        }
+    }
+    co_yield std::move(out);
+}
+
+Task<std::string> hierarchyToJSON(System::SystemPtr root, Context context) {
+    co_return co_await concat(hierarchyJSON(std::move(root), std::move(context)));
+}
+
+Task<std::string> nestedEnneagramSVG(geometry::NestedEnneagramGeometry nested, double width, double height,
+                                     Context context) {
+    co_await resumeOn(context.executor);
+    context.cancel.throwIfCancelled();
+    std::string svg = geometry::svg::nestedEnneagramSVG(nested, width, height);
+    context.report(1, 1);
+    co_return svg;
+}
+
+AsyncGenerator<std::string> nestedEnneagramSVGChunks(geometry::NestedEnneagramGeometry nested, double width,
+                                                     double height, Context context, size_t chunk_size) {
+    co_await resumeOn(context.executor);
+    context.cancel.throwIfCancelled();
+    std::string svg = geometry::svg::nestedEnneagramSVG(nested, width, height);
+    chunk_size = std::max<size_t>(chunk_size, 1);
+    for (size_t at = 0; at < svg.size(); at += chunk_size) {
+        context.cancel.throwIfCancelled();
+        context.report(std::min(at + chunk_size, svg.size()), svg.size());
+        co_yield svg.substr(at, chunk_size);
+    }
+}
+
+} // namespace async
+} // namespace cosmic
@@ -0,0 +1,531 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Implementation of simulation snapshots and the async writer
+ */
+
+#include "cosmic/checkpoint.hpp"
+#include "cosmic/tracing.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace cosmic {
+namespace checkpoint {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[4] = {'C', 'S', 'N', 'P'};
+
+// ----------------------------------------------------------------------------
+// Byte encoding
+// ----------------------------------------------------------------------------
+
+class Encoder {
+public:
+    template<typename T>
+    void put(T value) {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out_.insert(out_.end(), bytes, bytes + sizeof(T));
+    }
+
+    void putBool(bool value) { put<uint8_t>(value ? 1 : 0); }
+
+    template<typename T>
+    void putArray(const std::vector<T>& values) {
+        put<uint64_t>(values.size());
+        if (values.empty()) return;
+        const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+        out_.insert(out_.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    std::vector<uint8_t>& bytes() { return out_; }
+
+private:
+    std::vector<uint8_t> out_;
+};
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template<typename T>
+    T get() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    bool getBool() { return get<uint8_t>() != 0; }
+
+    template<typename T>
+    std::vector<T> getArray() {
+        uint64_t count = get<uint64_t>();
+        if (count > (size_ - pos_) / sizeof(T)) {
+            throw std::runtime_error("Snapshot is truncated");
+        }
+        std::vector<T> values(static_cast<size_t>(count));
+        if (count > 0) {
+            std::memcpy(values.data(), data_ + pos_, values.size() * sizeof(T));
+            pos_ += values.size() * sizeof(T);
+        }
+        return values;
+    }
+
+    bool atEnd() const { return pos_ == size_; }
+
+private:
+    void require(size_t n) const {
+        if (pos_ + n > size_) {
+            throw std::runtime_error("Snapshot is truncated");
+        }
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Records
+// ----------------------------------------------------------------------------
+
+void encode(Encoder& e, const system1::System1::State& s) {
+    e.put(s.center_intensity);
+    e.putBool(s.periphery_bounded);
+    e.put(s.periphery_extent);
+    e.put(s.efflux_rate);
+    e.put(s.reflux_rate);
+    e.put(s.accumulated_efflux);
+    e.put(s.accumulated_reflux);
+    e.put<uint8_t>(static_cast<uint8_t>(s.perspective));
+    e.put(s.time);
+}
+
+void decode(Decoder& d, system1::System1::State& s) {
+    s.center_intensity = d.get<double>();
+    s.periphery_bounded = d.getBool();
+    s.periphery_extent = d.get<double>();
+    s.efflux_rate = d.get<double>();
+    s.reflux_rate = d.get<double>();
+    s.accumulated_efflux = d.get<double>();
+    s.accumulated_reflux = d.get<double>();
+    s.perspective = static_cast<system1::Perspective>(d.get<uint8_t>());
+    s.time = d.get<double>();
+}
+
+void encode(Encoder& e, const system1::LoonAnalogy::State& s) {
+    encode(e, s.system);
+    e.put(s.enhancement_factor);
+}
+
+void decode(Decoder& d, system1::LoonAnalogy::State& s) {
+    decode(d, s.system);
+    s.enhancement_factor = d.get<double>();
+}
+
+void encode(Encoder& e, const system2::System2::State::CenterState& c) {
+    e.put(c.intensity);
+    e.put(c.objective_weight);
+    e.put(c.identity_strength);
+}
+
+void decode(Decoder& d, system2::System2::State::CenterState& c) {
+    c.intensity = d.get<double>();
+    c.objective_weight = d.get<double>();
+    c.identity_strength = d.get<double>();
+}
+
+void encode(Encoder& e, const system2::System2::State& s) {
+    encode(e, s.universal);
+    encode(e, s.particular);
+    e.put(s.transposition_rate);
+    e.put(s.phase);
+    e.put<int32_t>(s.cycle_count);
+    e.put(s.coalescence_strength);
+    e.putBool(s.coalescence_active);
+    e.put<uint8_t>(static_cast<uint8_t>(s.mode));
+    e.put(s.time);
+}
+
+void decode(Decoder& d, system2::System2::State& s) {
+    decode(d, s.universal);
+    decode(d, s.particular);
+    s.transposition_rate = d.get<double>();
+    s.phase = d.get<double>();
+    s.cycle_count = d.get<int32_t>();
+    s.coalescence_strength = d.get<double>();
+    s.coalescence_active = d.getBool();
+    s.mode = static_cast<system2::Mode>(d.get<uint8_t>());
+    s.time = d.get<double>();
+}
+
+void encode(Encoder& e, const system2::FlashlightAnalogy::State& s) {
+    e.put<uint64_t>(s.flashlights.size());
+    for (const auto& f : s.flashlights) {
+        e.put(f.brightness);
+        e.put(f.battery_level);
+        e.put(f.recharge_rate);
+        e.putBool(f.is_on);
+    }
+    for (uint64_t word : s.rng) {
+        e.put(word);
+    }
+}
+
+void decode(Decoder& d, system2::FlashlightAnalogy::State& s) {
+    uint64_t count = d.get<uint64_t>();
+    s.flashlights.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        system2::FlashlightAnalogy::Flashlight f;
+        f.brightness = d.get<double>();
+        f.battery_level = d.get<double>();
+        f.recharge_rate = d.get<double>();
+        f.is_on = d.getBool();
+        s.flashlights.push_back(f);
+    }
+    for (auto& word : s.rng) {
+        word = d.get<uint64_t>();
+    }
+}
+
+void encode(Encoder& e, const network::System2Network::State& s) {
+    e.put<uint64_t>(s.coupling.size());
+    e.putArray(s.coupling.rowOffsets());
+    e.putArray(s.coupling.columns());
+    e.putArray(s.coupling.weights());
+    e.put(s.strength);
+    e.putArray(s.phase);
+    e.putArray(s.rate);
+    e.putArray(s.universal);
+    e.putArray(s.particular);
+    std::vector<int32_t> cycles(s.cycles.begin(), s.cycles.end());
+    e.putArray(cycles);
+    e.put(s.time);
+}
+
+void decode(Decoder& d, network::System2Network::State& s) {
+    auto nodes = static_cast<size_t>(d.get<uint64_t>());
+    auto offsets = d.getArray<uint64_t>();
+    auto columns = d.getArray<uint32_t>();
+    auto weights = d.getArray<double>();
+    try {
+        s.coupling = network::SparseCoupling(nodes, std::move(offsets), std::move(columns),
+                                             std::move(weights));
+    } catch (const std::exception& ex) {
+        throw std::runtime_error(std::string("Snapshot has invalid coupling: ") + ex.what());
+    }
+    s.strength = d.get<double>();
+    s.phase = d.getArray<double>();
+    s.rate = d.getArray<double>();
+    s.universal = d.getArray<double>();
+    s.particular = d.getArray<double>();
+    auto cycles = d.getArray<int32_t>();
+    s.cycles.assign(cycles.begin(), cycles.end());
+    s.time = d.get<double>();
+}
+
+// ----------------------------------------------------------------------------
+// Framing
+// ----------------------------------------------------------------------------
+
+std::vector<uint8_t> frame(Kind kind, uint32_t count, const std::vector<uint8_t>& payload) {
+    Encoder e;
+    e.bytes().assign(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4);
+    e.put<uint16_t>(FORMAT_VERSION);
+    e.put<uint16_t>(static_cast<uint16_t>(kind));
+    e.put<uint32_t>(count);
+    e.put<uint64_t>(payload.size());
+    e.put<uint32_t>(crc32(payload.data(), payload.size()));
+    auto& out = e.bytes();
+    out.insert(out.end(), payload.begin(), payload.end());
+    return std::move(out);
+}
+
+template<typename T>
+std::vector<uint8_t> snapshotRecords(Kind kind, const std::vector<const T*>& items) {
+    Encoder e;
+    for (const T* item : items) {
+        encode(e, item->state());
+    }
+    return frame(kind, static_cast<uint32_t>(items.size()), e.bytes());
+}
+
+template<typename T>
+std::vector<uint8_t> snapshotOne(Kind kind, const T& item) {
+    return snapshotRecords<T>(kind, {&item});
+}
+
+template<typename T>
+std::vector<uint8_t> snapshotMany(Kind kind, const std::vector<T>& items) {
+    std::vector<const T*> ptrs;
+    ptrs.reserve(items.size());
+    for (const auto& item : items) ptrs.push_back(&item);
+    return snapshotRecords<T>(kind, ptrs);
+}
+
+template<typename T>
+std::vector<typename T::State> restoreRecords(const std::vector<uint8_t>& bytes, Kind kind) {
+    Header header = inspect(bytes);
+    if (header.kind != kind) {
+        throw std::runtime_error("Snapshot holds a different kind of system");
+    }
+    if (header.count > header.payload_size) {
+        throw std::runtime_error("Snapshot record count is corrupt");
+    }
+    Decoder d(bytes.data() + HEADER_SIZE, static_cast<size_t>(header.payload_size));
+    std::vector<typename T::State> states(header.count);
+    for (auto& s : states) {
+        decode(d, s);
+    }
+    if (!d.atEnd()) {
+        throw std::runtime_error("Snapshot has trailing data");
+    }
+    return states;
+}
+
+template<typename T>
+void restoreOne(const std::vector<uint8_t>& bytes, Kind kind, T& item) {
+    auto states = restoreRecords<T>(bytes, kind);
+    if (states.size() != 1) {
+        throw std::runtime_error("Snapshot holds an ensemble, not a single system");
+    }
+    item.restore(std::move(states.front()));
+}
+
+template<typename T>
+void restoreMany(const std::vector<uint8_t>& bytes, Kind kind, std::vector<T>& items) {
+    auto states = restoreRecords<T>(bytes, kind);
+    items.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        items[i].restore(states[i]);
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Snapshot and Restore
+// ============================================================================
+
+std::vector<uint8_t> snapshot(const system1::System1& system) {
+    return snapshotOne(Kind::SYSTEM1, system);
+}
+
+std::vector<uint8_t> snapshot(const std::vector<system1::System1>& ensemble) {
+    return snapshotMany(Kind::SYSTEM1, ensemble);
+}
+
+std::vector<uint8_t> snapshot(const system1::LoonAnalogy& loon) {
+    return snapshotOne(Kind::LOON, loon);
+}
+
+std::vector<uint8_t> snapshot(const std::vector<system1::LoonAnalogy>& ensemble) {
+    return snapshotMany(Kind::LOON, ensemble);
+}
+
+std::vector<uint8_t> snapshot(const system2::System2& system) {
+    return snapshotOne(Kind::SYSTEM2, system);
+}
+
+std::vector<uint8_t> snapshot(const std::vector<system2::System2>& ensemble) {
+    return snapshotMany(Kind::SYSTEM2, ensemble);
+}
+
+std::vector<uint8_t> snapshot(const system2::FlashlightAnalogy& flashlights) {
+    return snapshotOne(Kind::FLASHLIGHT, flashlights);
+}
+
+std::vector<uint8_t> snapshot(const network::System2Network& network) {
+    return snapshotOne(Kind::NETWORK, network);
+}
+
+void restore(const std::vector<uint8_t>& bytes, system1::System1& system) {
+    restoreOne(bytes, Kind::SYSTEM1, system);
+}
+
+void restore(const std::vector<uint8_t>& bytes, std::vector<system1::System1>& ensemble) {
+    restoreMany(bytes, Kind::SYSTEM1, ensemble);
+}
+
+void restore(const std::vector<uint8_t>& bytes, system1::LoonAnalogy& loon) {
+    restoreOne(bytes, Kind::LOON, loon);
+}
+
+void restore(const std::vector<uint8_t>& bytes, std::vector<system1::LoonAnalogy>& ensemble) {
+    restoreMany(bytes, Kind::LOON, ensemble);
+}
+
+void restore(const std::vector<uint8_t>& bytes, system2::System2& system) {
+    restoreOne(bytes, Kind::SYSTEM2, system);
+}
+
+void restore(const std::vector<uint8_t>& bytes, std::vector<system2::System2>& ensemble) {
+    restoreMany(bytes, Kind::SYSTEM2, ensemble);
+}
+
+void restore(const std::vector<uint8_t>& bytes, system2::FlashlightAnalogy& flashlights) {
+    restoreOne(bytes, Kind::FLASHLIGHT, flashlights);
+}
+
+void restore(const std::vector<uint8_t>& bytes, network::System2Network& network) {
+    restoreOne(bytes, Kind::NETWORK, network);
+}
+
+Header inspect(const std::vector<uint8_t>& bytes) {
+    if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), SNAPSHOT_MAGIC, 4) != 0) {
+        throw std::runtime_error("Not a snapshot");
+    }
+    Decoder d(bytes.data() + 4, HEADER_SIZE - 4);
+    Header header;
+    header.version = d.get<uint16_t>();
+    header.kind = static_cast<Kind>(d.get<uint16_t>());
+    header.count = d.get<uint32_t>();
+    header.payload_size = d.get<uint64_t>();
+    header.checksum = d.get<uint32_t>();
+
+    if (header.version == 0 || header.version > FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version));
+    }
+    if (header.payload_size != bytes.size() - HEADER_SIZE) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    if (crc32(bytes.data() + HEADER_SIZE, bytes.size() - HEADER_SIZE) != header.checksum) {
+        throw std::runtime_error("Snapshot checksum mismatch");
+    }
+    return header;
+}
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// ============================================================================
+// Files
+// ============================================================================
+
+void save(const std::string& path, const std::vector<uint8_t>& bytes) {
+    COSMIC_TRACE_SCOPE_CAT("checkpoint::save", "simulation");
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open checkpoint file: " + temp);
+        }
+        out.write(reinterpret_cast<const char*>(bytes.data()),
+                  static_cast<std::streamsize>(bytes.size()));
+        if (!out) {
+            throw std::runtime_error("Failed to write checkpoint file: " + temp);
+        }
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        throw std::runtime_error("Cannot replace checkpoint file: " + path);
+    }
+}
+
+std::vector<uint8_t> load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+    inspect(bytes);
+    return bytes;
+}
+
+// ============================================================================
+// AsyncWriter Implementation
+// ============================================================================
+
+AsyncWriter::AsyncWriter() : thread_([this] { run(); }) {}
+
+AsyncWriter::~AsyncWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void AsyncWriter::write(std::string path, std::vector<uint8_t> bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.emplace_back(std::move(path), std::move(bytes));
+    }
+    cv_.notify_one();
+}
+
+void AsyncWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    if (error_) {
+        auto error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+size_t AsyncWriter::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + (busy_ ? 1 : 0);
+}
+
+size_t AsyncWriter::written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+void AsyncWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return;  // stopping and drained
+
+        auto job = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            save(job.first, job.second);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        busy_ = false;
+        if (error) {
+            if (!error_) error_ = error;
+        } else {
+            ++written_;
+        }
+        if (queue_.empty()) idle_cv_.notify_all();
+    }
+}
+
+} // namespace checkpoint
+} // namespace cosmic
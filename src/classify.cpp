@@ -0,0 +1,201 @@
+/**
+ * @file classify.cpp
+ * @brief Classification of parenthesis tree strings
+ */
+
+#include "cosmic/classify.hpp"
+#include "cosmic/static_trees.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace cosmic {
+namespace classify {
+
+static_assert(MAX_NODES == trees::MAX_STATIC_NODES, "Classification uses packed level sequences");
+
+namespace {
+
+constexpr uint64_t ONES = 0x0101010101010101ULL;
+constexpr uint64_t OPENS = 0x2828282828282828ULL;   // '(' in every byte
+
+/// DEPTH_ONES[n]: one in each of the top n nibbles, to add a level to a key
+constexpr std::array<uint64_t, MAX_NODES + 1> DEPTH_ONES = [] {
+    std::array<uint64_t, MAX_NODES + 1> ones{};
+    for (int n = 1; n <= MAX_NODES; ++n) {
+        ones[static_cast<size_t>(n)] = ones[static_cast<size_t>(n - 1)] | (uint64_t(1) << (64 - 4 * n));
+    }
+    return ones;
+}();
+
+int popcount(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int count = 0;
+    for (; x; x &= x - 1) ++count;
+    return count;
+#endif
+}
+
+/// Key of a canonical level sequence, most significant nibble first
+uint64_t sequenceKey(const trees::detail::Levels& levels) {
+    uint64_t key = 0;
+    for (int k = 0; k < levels.size; ++k) {
+        key |= static_cast<uint64_t>(levels.depth[k]) << (60 - 4 * k);
+    }
+    return key;
+}
+
+Catalog buildCatalog(int nodes) {
+    Catalog result;
+    result.nodes = nodes;
+    size_t count = trees::rootedTreeCount(nodes);
+    result.keys.reserve(count);
+    result.clusters.reserve(count);
+
+    // Trees of one cluster share the key rooted at their center; clusters
+    // are ranked by their largest key over all rootings, as in StaticTrees
+    std::unordered_map<uint64_t, uint32_t> by_center;
+    std::vector<uint64_t> largest;
+    auto levels = trees::detail::firstLevels(nodes);
+    do {
+        result.keys.push_back(sequenceKey(levels));
+        auto tree = trees::detail::links(levels);
+        auto inserted = by_center.emplace(trees::detail::centerKey(tree),
+                                          static_cast<uint32_t>(largest.size()));
+        if (inserted.second) largest.push_back(trees::detail::largestKey(tree));
+        result.clusters.push_back(inserted.first->second);
+    } while (trees::detail::nextLevels(levels));
+
+    std::vector<uint32_t> order(largest.size());
+    for (uint32_t c = 0; c < order.size(); ++c) order[c] = c;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return largest[a] > largest[b];
+    });
+    std::vector<uint32_t> rank(largest.size());
+    for (uint32_t r = 0; r < order.size(); ++r) rank[order[r]] = r;
+    for (auto& c : result.clusters) c = rank[c];
+    result.cluster_count = largest.size();
+    return result;
+}
+
+} // namespace
+
+const char* toString(Status status) {
+    switch (status) {
+        case Status::Ok: return "ok";
+        case Status::Empty: return "empty";
+        case Status::InvalidCharacter: return "invalid-character";
+        case Status::Unbalanced: return "unbalanced";
+        case Status::TooLarge: return "too-large";
+    }
+    return "unknown";
+}
+
+Status validate(std::string_view text, int& nodes) {
+    nodes = 0;
+    if (text.empty()) return Status::Empty;
+
+    // '(' is 0x28 and ')' is 0x29: after xor with '(' every byte must be
+    // 0 or 1, and the ones count the closes
+    size_t closes = 0;
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, text.data() + i, sizeof(word));
+        uint64_t x = word ^ OPENS;
+        if (x & ~ONES) return Status::InvalidCharacter;
+        closes += static_cast<size_t>(popcount(x));
+    }
+    for (; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == ')') ++closes;
+        else if (c != '(') return Status::InvalidCharacter;
+    }
+
+    if (2 * closes != text.size()) return Status::Unbalanced;
+    if (closes > static_cast<size_t>(MAX_NODES)) return Status::TooLarge;
+    nodes = static_cast<int>(closes);
+    return Status::Ok;
+}
+
+Result classifyTree(std::string_view text) {
+    Result result;
+    int nodes = 0;
+    result.status = validate(text, nodes);
+    if (result.status != Status::Ok) return result;
+
+    // Build the canonical key bottom-up while parsing: when a node closes,
+    // its children's keys are on the stack; sorted in decreasing order and
+    // shifted one level deeper they make its own key (as canonicalKey does)
+    uint64_t keys[MAX_NODES];
+    int sizes[MAX_NODES];
+    int first_child[MAX_NODES];
+    int entries = 0;
+    int open = 0;
+    bool done = false;
+    for (char c : text) {
+        if (c == '(') {
+            if (done) {
+                result.status = Status::Unbalanced;
+                return result;
+            }
+            first_child[open++] = entries;
+        } else {
+            if (open == 0) {
+                result.status = Status::Unbalanced;
+                return result;
+            }
+            int begin = first_child[--open];
+            for (int i = begin + 1; i < entries; ++i) {
+                uint64_t key = keys[i];
+                int size = sizes[i];
+                int j = i;
+                for (; j > begin && keys[j - 1] < key; --j) {
+                    keys[j] = keys[j - 1];
+                    sizes[j] = sizes[j - 1];
+                }
+                keys[j] = key;
+                sizes[j] = size;
+            }
+            uint64_t key = 0;
+            int length = 1;
+            for (int i = begin; i < entries; ++i) {
+                key |= (keys[i] + DEPTH_ONES[sizes[i]]) >> (4 * length);
+                length += sizes[i];
+            }
+            keys[begin] = key;
+            sizes[begin] = length;
+            entries = begin + 1;
+            done = open == 0;
+        }
+    }
+
+    const Catalog& trees_n = catalog(nodes);
+    auto it = std::lower_bound(trees_n.keys.begin(), trees_n.keys.end(), keys[0], std::greater<uint64_t>());
+    result.nodes = nodes;
+    result.id = static_cast<uint32_t>(it - trees_n.keys.begin());
+    result.cluster = trees_n.clusters[result.id];
+    return result;
+}
+
+const Catalog& catalog(int nodes) {
+    if (nodes < 1 || nodes > MAX_NODES) {
+        throw std::out_of_range("Catalog sizes are 1-16 nodes");
+    }
+    static std::array<std::once_flag, MAX_NODES + 1> built;
+    static std::array<Catalog, MAX_NODES + 1> catalogs;
+    std::call_once(built[static_cast<size_t>(nodes)], [nodes] {
+        catalogs[static_cast<size_t>(nodes)] = buildCatalog(nodes);
+    });
+    return catalogs[static_cast<size_t>(nodes)];
+}
+
+} // namespace classify
+} // namespace cosmic
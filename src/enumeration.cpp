@@ -0,0 +1,362 @@
+/**
+ * @file enumeration.cpp
+ * @brief Streaming enumeration of rooted and free trees
+ */
+
+#include "cosmic/enumeration.hpp"
+#include "cosmic/static_trees.hpp"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace cosmic {
+namespace enumeration {
+
+namespace {
+
+struct Counts {
+    std::array<uint64_t, MAX_NODES + 1> rooted{};
+    std::array<uint64_t, MAX_NODES + 1> free{};
+};
+
+const Counts& counts() {
+    static const Counts table = [] {
+        Counts c;
+        // a(n + 1) = (1/n) sum_{k=1..n} (sum_{d|k} d a(d)) a(n - k + 1)
+        auto& a = c.rooted;
+        a[1] = 1;
+        for (int n = 1; n < MAX_NODES; ++n) {
+            uint64_t sum = 0;
+            for (int k = 1; k <= n; ++k) {
+                uint64_t divisors = 0;
+                for (int d = 1; d <= k; ++d) {
+                    if (k % d == 0) divisors += static_cast<uint64_t>(d) * a[d];
+                }
+                sum += divisors * a[n - k + 1];
+            }
+            a[n + 1] = sum / static_cast<uint64_t>(n);
+        }
+        // Otter: a free tree is a rooted tree minus the rootings off its
+        // centroid, f(n) = a(n) - (sum_{i+j=n} a(i) a(j) - [n even] a(n/2)) / 2
+        c.free[0] = 1;
+        for (int n = 1; n <= MAX_NODES; ++n) {
+            uint64_t pairs = 0;
+            for (int i = 1; i < n; ++i) pairs += a[i] * a[n - i];
+            if (n % 2 == 0) pairs -= a[n / 2];
+            c.free[n] = a[n] - pairs / 2;
+        }
+        return c;
+    }();
+    return table;
+}
+
+void checkNodes(int nodes) {
+    if (nodes < 1 || nodes > MAX_NODES) {
+        throw std::invalid_argument("Tree size must be 1-32 nodes");
+    }
+}
+
+/// Index of the root's second child (levels.size if it has one child)
+int secondChild(const Levels& levels) {
+    for (int i = 2; i < levels.size; ++i) {
+        if (levels.depth[i] == 1) return i;
+    }
+    return levels.size;
+}
+
+/// Height of the root's first subtree, measured from that child
+int leftHeight(const Levels& levels, int m) {
+    int height = 0;
+    for (int i = 1; i < m; ++i) {
+        if (levels.depth[i] - 1 > height) height = levels.depth[i] - 1;
+    }
+    return height;
+}
+
+/**
+ * @brief Accept a candidate as a center-rooted free tree, or jump past the
+ *        rooted trees that cannot be one
+ *
+ * Valid when the first subtree of the root is no higher than the rest of
+ * the tree and, at equal height, no larger (and, at equal size, not
+ * lexicographically after it).
+ */
+bool nextFree(Levels& levels) {
+    int m = secondChild(levels);
+    int left_height = leftHeight(levels, m);
+    int rest_height = 0;
+    for (int i = m; i < levels.size; ++i) {
+        if (levels.depth[i] > rest_height) rest_height = levels.depth[i];
+    }
+
+    bool valid = rest_height >= left_height;
+    if (valid && rest_height == left_height) {
+        int left_size = m - 1;
+        int rest_size = levels.size - m + 1;
+        if (left_size > rest_size) {
+            valid = false;
+        } else if (left_size == rest_size) {
+            // left: depth[1..m) - 1; rest: 0, then depth[m..)
+            for (int i = 0; i < left_size; ++i) {
+                int left = levels.depth[1 + i] - 1;
+                int rest = i == 0 ? 0 : levels.depth[m + i - 1];
+                if (left != rest) {
+                    valid = left < rest;
+                    break;
+                }
+            }
+        }
+    }
+    if (valid) return true;
+
+    int p = m - 1;
+    int old = levels.depth[p];
+    if (!trees::detail::nextLevels(levels, p)) return false;
+    if (old > 2) {
+        int height = leftHeight(levels, secondChild(levels));
+        for (int k = 0; k <= height; ++k) {
+            levels.depth[levels.size - 1 - height + k] = static_cast<int8_t>(k + 1);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief A canonical rooted tree: links, subtree sizes and its key
+ *
+ * Children are linked in sequence order, which is decreasing key order.
+ * The key of the subtree below node k is the slice of the tree's key that
+ * starts at k's open bit.
+ */
+struct Tree {
+    int parent[MAX_NODES];
+    int first_child[MAX_NODES];
+    int next_sibling[MAX_NODES];
+    int size[MAX_NODES];
+    int open[MAX_NODES];
+    int nodes = 0;
+    uint64_t key = 0;
+
+    explicit Tree(const Levels& levels) : nodes(levels.size) {
+        int last[MAX_NODES];
+        int position = 0;
+        for (int k = 0; k < nodes; ++k) {
+            int d = levels.depth[k];
+            last[d] = k;
+            parent[k] = d > 0 ? last[d - 1] : -1;
+            position += (k > 0 ? levels.depth[k - 1] + 1 : 0) - d;
+            open[k] = position;
+            key |= uint64_t(1) << (63 - position);
+            ++position;
+        }
+        for (int k = nodes - 1; k >= 0; --k) {
+            first_child[k] = -1;
+            size[k] = 1;
+        }
+        for (int k = nodes - 1; k > 0; --k) {
+            // Walking backwards, prepend each node to its parent's children
+            next_sibling[k] = first_child[parent[k]];
+            first_child[parent[k]] = k;
+            size[parent[k]] += size[k];
+        }
+        next_sibling[0] = -1;
+    }
+
+    /// Key of the subtree below node k
+    uint64_t subtreeKey(int k) const {
+        int bits = 2 * size[k];
+        uint64_t mask = bits >= 64 ? ~uint64_t(0) : ~(~uint64_t(0) >> bits);
+        return (key << open[k]) & mask;
+    }
+};
+
+/**
+ * @brief Key of node v's children (except @p skip) plus one extra subtree, under v
+ *
+ * The children are already in decreasing key order, so the extra subtree
+ * (if @p extra_size > 0) is merged in at its place.
+ */
+uint64_t joinChildren(const Tree& tree, int v, int skip, uint64_t extra, int extra_size) {
+    uint64_t result = uint64_t(1) << 63;
+    int length = 1;
+    for (int u = tree.first_child[v]; u != -1; u = tree.next_sibling[u]) {
+        if (u == skip) continue;
+        uint64_t child = tree.subtreeKey(u);
+        if (extra_size > 0 && extra > child) {
+            result |= extra >> length;
+            length += 2 * extra_size;
+            extra_size = 0;
+        }
+        result |= child >> length;
+        length += 2 * tree.size[u];
+    }
+    if (extra_size > 0) result |= extra >> length;
+    return result;
+}
+
+/// Canonical key of the tree rerooted at node c
+uint64_t rerootedKey(const Tree& tree, int c) {
+    if (c == 0) return tree.key;
+    // Fold the part above c into one subtree, from the root down to c's parent
+    int path[MAX_NODES];
+    int length = 0;
+    for (int v = c; v != -1; v = tree.parent[v]) path[length++] = v;
+    uint64_t above = 0;
+    int above_size = 0;
+    for (int i = length - 1; i >= 1; --i) {
+        above = joinChildren(tree, path[i], path[i - 1], above, above_size);
+        above_size = tree.nodes - tree.size[path[i - 1]];
+    }
+    return joinChildren(tree, c, -1, above, above_size);
+}
+
+void putBytes(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+template<typename T>
+void put(std::string& out, T value) {
+    putBytes(out, &value, sizeof(value));
+}
+
+template<typename T>
+T get(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+uint64_t rootedTreeCount(int nodes) {
+    if (nodes < 0 || nodes > MAX_NODES) throw std::out_of_range("Tree size must be 0-32 nodes");
+    return counts().rooted[static_cast<size_t>(nodes)];
+}
+
+uint64_t freeTreeCount(int nodes) {
+    if (nodes < 0 || nodes > MAX_NODES) throw std::out_of_range("Tree size must be 0-32 nodes");
+    return counts().free[static_cast<size_t>(nodes)];
+}
+
+uint64_t parenthesesKey(const Levels& levels) {
+    uint64_t key = 0;
+    int position = 0;
+    int previous = -1;
+    for (int k = 0; k < levels.size; ++k) {
+        position += previous + 1 - levels.depth[k];   // closes since the last open
+        key |= uint64_t(1) << (63 - position);
+        ++position;
+        previous = levels.depth[k];
+    }
+    return key;
+}
+
+uint64_t centerKey(const Levels& levels) {
+    Tree tree(levels);
+    auto centers = trees::detail::findCenters<MAX_NODES>(tree.parent, tree.nodes);
+    uint64_t key = rerootedKey(tree, centers.first);
+    if (centers.second >= 0) {
+        uint64_t other = rerootedKey(tree, centers.second);
+        if (other > key) key = other;
+    }
+    return key;
+}
+
+std::string toParentheses(uint64_t key, int nodes) {
+    std::string result(static_cast<size_t>(2 * nodes), ')');
+    for (int i = 0; i < 2 * nodes; ++i) {
+        if ((key >> (63 - i)) & 1) result[static_cast<size_t>(i)] = '(';
+    }
+    return result;
+}
+
+// ============================================================================
+// Sequences
+// ============================================================================
+
+RootedSequence::RootedSequence(int nodes) {
+    checkNodes(nodes);
+    levels_.size = nodes;
+    for (int k = 0; k < nodes; ++k) levels_.depth[k] = static_cast<int8_t>(k);
+}
+
+bool RootedSequence::next() {
+    if (!trees::detail::nextLevels(levels_)) return false;
+    ++rank_;
+    return true;
+}
+
+uint64_t RootedSequence::skip(uint64_t count) {
+    uint64_t skipped = 0;
+    while (skipped < count && next()) ++skipped;
+    return skipped;
+}
+
+FreeSequence::FreeSequence(int nodes) {
+    checkNodes(nodes);
+    // The path, rooted at its center
+    levels_.size = nodes;
+    int k = 0;
+    for (int d = 0; d <= nodes / 2; ++d) levels_.depth[k++] = static_cast<int8_t>(d);
+    for (int d = 1; d < (nodes + 1) / 2; ++d) levels_.depth[k++] = static_cast<int8_t>(d);
+    if (nodes > 2) nextFree(levels_);
+}
+
+bool FreeSequence::next() {
+    if (levels_.size <= 2) return false;
+    Levels candidate = levels_;
+    if (!trees::detail::nextLevels(candidate) || !nextFree(candidate)) return false;
+    levels_ = candidate;
+    ++rank_;
+    return true;
+}
+
+uint64_t FreeSequence::skip(uint64_t count) {
+    uint64_t skipped = 0;
+    while (skipped < count && next()) ++skipped;
+    return skipped;
+}
+
+// ============================================================================
+// Catalog Files
+// ============================================================================
+
+size_t CatalogHeader::recordSize() const {
+    return kind == CatalogKind::ROOTED && (flags & (CLUSTER_KEYS | CLUSTER_IDS)) ? 16 : 8;
+}
+
+void appendHeader(std::string& out, const CatalogHeader& header) {
+    putBytes(out, "CGEN", 4);
+    put<uint16_t>(out, header.version);
+    put<uint8_t>(out, static_cast<uint8_t>(header.kind));
+    put<uint8_t>(out, header.flags);
+    put<uint32_t>(out, header.nodes);
+    put<uint32_t>(out, 0);
+    put<uint64_t>(out, header.first_rank);
+    put<uint64_t>(out, header.count);
+}
+
+CatalogHeader parseHeader(const uint8_t* data, size_t size) {
+    if (size < CATALOG_HEADER_SIZE || std::memcmp(data, "CGEN", 4) != 0) {
+        throw std::runtime_error("Not a tree catalog");
+    }
+    CatalogHeader header;
+    header.version = get<uint16_t>(data + 4);
+    if (header.version != CATALOG_VERSION) {
+        throw std::runtime_error("Unsupported tree catalog version");
+    }
+    uint8_t kind = data[6];
+    if (kind > static_cast<uint8_t>(CatalogKind::FREE)) {
+        throw std::runtime_error("Unknown tree catalog kind");
+    }
+    header.kind = static_cast<CatalogKind>(kind);
+    header.flags = data[7];
+    header.nodes = get<uint32_t>(data + 8);
+    header.first_rank = get<uint64_t>(data + 16);
+    header.count = get<uint64_t>(data + 24);
+    return header;
+}
+
+} // namespace enumeration
+} // namespace cosmic
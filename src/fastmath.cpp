@@ -0,0 +1,129 @@
+/**
+ * @file fastmath.cpp
+ * @brief Implementation of the batched transcendental kernels
+ *
+ * Built with -fno-math-errno (see CMakeLists.txt) so the sqrt loop compiles
+ * to packed square-root instructions.
+ */
+
+#include "cosmic/fastmath.hpp"
+#include <cmath>
+#include <cstdint>
+
+namespace cosmic {
+namespace fastmath {
+
+namespace {
+
+// π/2 split for Cody–Waite reduction: PIO2_HI has 33 significant bits, so
+// q * PIO2_HI is exact for the quadrant counts reachable below FAST_RANGE
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+constexpr double PIO2_HI = 1.57079632673412561417e+00;
+constexpr double PIO2_LO = 6.07710050650619224932e-11;
+
+// Adding and subtracting 1.5 × 2^52 rounds a double to the nearest integer
+constexpr double ROUND_MAGIC = 6755399441055744.0;
+
+// Taylor coefficients; on |r| ≤ π/4 the truncation error is below 2e-9
+constexpr double S3 = -1.0 / 6.0;
+constexpr double S5 = 1.0 / 120.0;
+constexpr double S7 = -1.0 / 5040.0;
+constexpr double S9 = 1.0 / 362880.0;
+constexpr double C2 = -1.0 / 2.0;
+constexpr double C4 = 1.0 / 24.0;
+constexpr double C6 = -1.0 / 720.0;
+constexpr double C8 = 1.0 / 40320.0;
+constexpr double C10 = -1.0 / 3628800.0;
+
+struct Reduced {
+    double sin_r;
+    double cos_r;
+    int quadrant;
+};
+
+inline Reduced reduce(double x) {
+    double q = (x * TWO_OVER_PI + ROUND_MAGIC) - ROUND_MAGIC;
+    double r = (x - q * PIO2_HI) - q * PIO2_LO;
+    double r2 = r * r;
+    Reduced red;
+    red.sin_r = r + r * r2 * (S3 + r2 * (S5 + r2 * (S7 + r2 * S9)));
+    red.cos_r = 1.0 + r2 * (C2 + r2 * (C4 + r2 * (C6 + r2 * (C8 + r2 * C10))));
+    red.quadrant = static_cast<int>(static_cast<int64_t>(q) & 3);
+    return red;
+}
+
+// Arguments outside the polynomial range (and NaN) take the exact path
+
+inline bool inRange(double x) {
+    return std::abs(x) <= FAST_RANGE;
+}
+
+inline double fastSin(double x) {
+    if (!inRange(x)) return std::sin(x);
+    Reduced red = reduce(x);
+    double v = (red.quadrant & 1) ? red.cos_r : red.sin_r;
+    return (red.quadrant & 2) ? -v : v;
+}
+
+inline double fastCos(double x) {
+    if (!inRange(x)) return std::cos(x);
+    Reduced red = reduce(x);
+    double v = (red.quadrant & 1) ? red.sin_r : red.cos_r;
+    return ((red.quadrant + 1) & 2) ? -v : v;
+}
+
+} // namespace
+
+void cos(const double* x, double* out, size_t n, Accuracy accuracy) {
+    if (accuracy == Accuracy::EXACT) {
+        for (size_t i = 0; i < n; ++i) out[i] = std::cos(x[i]);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) out[i] = fastCos(x[i]);
+}
+
+void sin(const double* x, double* out, size_t n, Accuracy accuracy) {
+    if (accuracy == Accuracy::EXACT) {
+        for (size_t i = 0; i < n; ++i) out[i] = std::sin(x[i]);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) out[i] = fastSin(x[i]);
+}
+
+void sincos(const double* x, double* s, double* c, size_t n, Accuracy accuracy) {
+    // x[i] is read once, before either output is written, so s or c may be x
+    if (accuracy == Accuracy::EXACT) {
+        for (size_t i = 0; i < n; ++i) {
+            double v = x[i];
+            s[i] = std::sin(v);
+            c[i] = std::cos(v);
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        double v = x[i];
+        if (!inRange(v)) {
+            s[i] = std::sin(v);
+            c[i] = std::cos(v);
+            continue;
+        }
+        Reduced red = reduce(v);
+        bool swap = red.quadrant & 1;
+        double sv = swap ? red.cos_r : red.sin_r;
+        double cv = swap ? red.sin_r : red.cos_r;
+        s[i] = (red.quadrant & 2) ? -sv : sv;
+        c[i] = ((red.quadrant + 1) & 2) ? -cv : cv;
+    }
+}
+
+void sqrt(const double* x, double* out, size_t n, Accuracy) {
+    for (size_t i = 0; i < n; ++i) out[i] = std::sqrt(x[i]);
+}
+
+void objectiveWeight(const double* phase, double* out, size_t n, Accuracy accuracy) {
+    cos(phase, out, n, accuracy);
+    for (size_t i = 0; i < n; ++i) out[i] = 0.5 * (1.0 + out[i]);
+}
+
+} // namespace fastmath
+} // namespace cosmic
@@ -4,6 +4,13 @@
  */
 
 #include "cosmic/geometry.hpp"
+#include "cosmic/memory.hpp"
+#include "cosmic/metrics.hpp"
+#include "cosmic/parallel.hpp"
+#include "cosmic/tracing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <sstream>
 #include <iomanip>
 
@@ -215,35 +222,99 @@ size_t NestedEnneagramGeometry::totalCount() const {
     return count;
 }
 
+std::vector<EnneagramGeometry> fractalEnneagrams(int depth, const Circle& outer_circle,
+                                                 double scale_factor,
+                                                 parallel::Executor* pool) {
+    if (depth < 0 || depth > 8) {
+        throw std::invalid_argument("Fractal enneagram depth must be 0-8");
+    }
+    
+    size_t total = 0;
+    for (size_t count = 1, k = 0; k <= static_cast<size_t>(depth); ++k, count *= 9) {
+        total += count;
+    }
+    std::vector<EnneagramGeometry> result(total);
+    result[0] = EnneagramGeometry(outer_circle);
+    
+    size_t level_begin = 0;
+    size_t level_size = 1;
+    for (int k = 0; k < depth; ++k) {
+        size_t next_begin = level_begin + level_size;
+        parallel::parallelFor(pool, 0, level_size, 64, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                const auto& parent = result[level_begin + i];
+                for (int pos = 1; pos <= 9; ++pos) {
+                    result[next_begin + 9 * i + static_cast<size_t>(pos - 1)] =
+                        parent.nestedAt(pos, scale_factor);
+                }
+            }
+        });
+        level_begin = next_begin;
+        level_size *= 9;
+    }
+    return result;
+}
+
 // ============================================================================
 // SVG Export Functions
 // ============================================================================
 
 namespace svg {
 
+namespace {
+
+// Each call counts the elements it writes itself, so fragments nested into a
+// document are counted once, by the fragment's own call
+struct SvgCall {
+    size_t elements = 0;
+
+    /// Start an element's open tag, counting the element
+    std::ostream& tag(std::ostream& out, const char* name) {
+        ++elements;
+        return out << '<' << name;
+    }
+
+    std::string finish(std::string out) const {
+        COSMIC_METRIC_COUNT("cosmic_svg_elements_total",
+                            "SVG elements emitted by the svg functions", elements);
+        return out;
+    }
+};
+
+} // namespace
+
 std::string circlePath(const Circle& circle) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("svg::circlePath", "svg");
+    COSMIC_METRIC_TIMER("svg::circlePath");
+    SvgCall call;
+    memory::OutputStream ss(memory::Subsystem::SVG);
     ss << std::fixed << std::setprecision(2);
-    ss << "<circle cx=\"" << circle.center.x 
+    call.tag(ss, "circle") << " cx=\"" << circle.center.x 
        << "\" cy=\"" << circle.center.y 
        << "\" r=\"" << circle.radius << "\"/>";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string trianglePath(const Triangle& triangle) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("svg::trianglePath", "svg");
+    COSMIC_METRIC_TIMER("svg::trianglePath");
+    SvgCall call;
+    memory::OutputStream ss(memory::Subsystem::SVG);
     ss << std::fixed << std::setprecision(2);
-    ss << "<polygon points=\"";
+    call.tag(ss, "polygon") << " points=\"";
     for (int i = 0; i < 3; ++i) {
         if (i > 0) ss << " ";
         ss << triangle.vertices[i].x << "," << triangle.vertices[i].y;
     }
     ss << "\"/>";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string enneagramPath(const EnneagramGeometry& ennea, bool include_circle) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("svg::enneagramPath", "svg");
+    COSMIC_METRIC_TIMER("svg::enneagramPath");
+    SvgCall call;
+    memory::OutputStream ss(memory::Subsystem::SVG);
     ss << std::fixed << std::setprecision(2);
     
     if (include_circle) {
@@ -253,7 +324,7 @@ std::string enneagramPath(const EnneagramGeometry& ennea, bool include_circle) {
     // Draw all lines
     auto lines = ennea.allLines();
     for (const auto& line : lines) {
-        ss << "<line x1=\"" << line.first.x 
+        call.tag(ss, "line") << " x1=\"" << line.first.x 
            << "\" y1=\"" << line.first.y
            << "\" x2=\"" << line.second.x 
            << "\" y2=\"" << line.second.y << "\"/>\n";
@@ -262,7 +333,7 @@ std::string enneagramPath(const EnneagramGeometry& ennea, bool include_circle) {
     // Draw points
     const auto& points = ennea.points();
     for (int i = 0; i < 9; ++i) {
-        ss << "<circle cx=\"" << points[i].x 
+        call.tag(ss, "circle") << " cx=\"" << points[i].x 
            << "\" cy=\"" << points[i].y 
            << "\" r=\"3\" class=\"point\"/>\n";
         
@@ -271,18 +342,21 @@ std::string enneagramPath(const EnneagramGeometry& ennea, bool include_circle) {
         double angle = PI / 2.0 - (TWO_PI * i / 9.0);
         double lx = points[i].x + label_offset * std::cos(angle);
         double ly = points[i].y - label_offset * std::sin(angle);
-        ss << "<text x=\"" << lx << "\" y=\"" << ly 
+        call.tag(ss, "text") << " x=\"" << lx << "\" y=\"" << ly 
            << "\" class=\"label\">" << (i + 1) << "</text>\n";
     }
     
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string enneagramSVG(const EnneagramGeometry& ennea, 
                          double width, double height,
                          const std::string& stroke_color,
                          const std::string& fill_color) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("svg::enneagramSVG", "svg");
+    COSMIC_METRIC_TIMER("svg::enneagramSVG");
+    SvgCall call;
+    memory::OutputStream ss(memory::Subsystem::SVG);
     ss << std::fixed << std::setprecision(2);
     
     // Calculate transform to center the enneagram
@@ -291,12 +365,12 @@ std::string enneagramSVG(const EnneagramGeometry& ennea,
     double ty = height / 2.0;
     
     ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    ss << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+    call.tag(ss, "svg") << " xmlns=\"http://www.w3.org/2000/svg\" "
        << "width=\"" << width << "\" height=\"" << height << "\" "
        << "viewBox=\"0 0 " << width << " " << height << "\">\n";
     
     // Style
-    ss << "<style>\n";
+    call.tag(ss, "style") << ">\n";
     ss << "  .enneagram { stroke: " << stroke_color << "; fill: " << fill_color << "; stroke-width: 1.5; }\n";
     ss << "  .point { fill: " << stroke_color << "; }\n";
     ss << "  .label { font-family: Arial, sans-serif; font-size: 12px; text-anchor: middle; dominant-baseline: middle; }\n";
@@ -305,17 +379,17 @@ std::string enneagramSVG(const EnneagramGeometry& ennea,
     ss << "</style>\n";
     
     // Background
-    ss << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+    call.tag(ss, "rect") << " width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
     
     // Transform group
-    ss << "<g transform=\"translate(" << tx << "," << ty << ") scale(" << scale << "," << -scale << ")\" class=\"enneagram\">\n";
+    call.tag(ss, "g") << " transform=\"translate(" << tx << "," << ty << ") scale(" << scale << "," << -scale << ")\" class=\"enneagram\">\n";
     
     // Circle
     ss << "  " << circlePath(ennea.circle()) << "\n";
     
     // Triangle (3-6-9) - thicker line
     auto tri = ennea.triangle();
-    ss << "  <polygon points=\"";
+    call.tag(ss << "  ", "polygon") << " points=\"";
     for (int i = 0; i < 3; ++i) {
         if (i > 0) ss << " ";
         ss << tri.vertices[i].x << "," << tri.vertices[i].y;
@@ -324,9 +398,9 @@ std::string enneagramSVG(const EnneagramGeometry& ennea,
     
     // Hexad lines
     auto hexad = ennea.hexadLines();
-    ss << "  <g class=\"hexad\">\n";
+    call.tag(ss << "  ", "g") << " class=\"hexad\">\n";
     for (const auto& line : hexad) {
-        ss << "    <line x1=\"" << line.first.x 
+        call.tag(ss << "    ", "line") << " x1=\"" << line.first.x 
            << "\" y1=\"" << line.first.y
            << "\" x2=\"" << line.second.x 
            << "\" y2=\"" << line.second.y << "\"/>\n";
@@ -336,7 +410,7 @@ std::string enneagramSVG(const EnneagramGeometry& ennea,
     // Points and labels (need to flip y for text)
     const auto& points = ennea.points();
     for (int i = 0; i < 9; ++i) {
-        ss << "  <circle cx=\"" << points[i].x 
+        call.tag(ss << "  ", "circle") << " cx=\"" << points[i].x 
            << "\" cy=\"" << points[i].y 
            << "\" r=\"" << (3.0 / scale) << "\" class=\"point\"/>\n";
     }
@@ -344,24 +418,27 @@ std::string enneagramSVG(const EnneagramGeometry& ennea,
     ss << "</g>\n";
     
     // Labels (outside transform to keep text upright)
-    ss << "<g class=\"label\">\n";
+    call.tag(ss, "g") << " class=\"label\">\n";
     for (int i = 0; i < 9; ++i) {
         double angle = PI / 2.0 - (TWO_PI * i / 9.0);
         double label_r = ennea.circle().radius * 1.15;
         double lx = tx + scale * label_r * std::cos(angle);
         double ly = ty - scale * label_r * std::sin(angle);
-        ss << "  <text x=\"" << lx << "\" y=\"" << ly << "\">" << (i + 1) << "</text>\n";
+        call.tag(ss << "  ", "text") << " x=\"" << lx << "\" y=\"" << ly << "\">" << (i + 1) << "</text>\n";
     }
     ss << "</g>\n";
     
     ss << "</svg>\n";
     
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string nestedEnneagramSVG(const NestedEnneagramGeometry& nested,
                                double width, double height) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("svg::nestedEnneagramSVG", "svg");
+    COSMIC_METRIC_TIMER("svg::nestedEnneagramSVG");
+    SvgCall call;
+    memory::OutputStream ss(memory::Subsystem::SVG);
     ss << std::fixed << std::setprecision(2);
     
     double scale = std::min(width, height) * 0.35 / nested.outer().circle().radius;
@@ -369,23 +446,23 @@ std::string nestedEnneagramSVG(const NestedEnneagramGeometry& nested,
     double ty = height / 2.0;
     
     ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    ss << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+    call.tag(ss, "svg") << " xmlns=\"http://www.w3.org/2000/svg\" "
        << "width=\"" << width << "\" height=\"" << height << "\">\n";
     
-    ss << "<style>\n";
+    call.tag(ss, "style") << ">\n";
     ss << "  .outer { stroke: #333; fill: none; stroke-width: 2; }\n";
     ss << "  .nested { stroke: #666; fill: none; stroke-width: 1; }\n";
     ss << "  .point { fill: #333; }\n";
     ss << "</style>\n";
     
-    ss << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+    call.tag(ss, "rect") << " width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
     
     // Outer enneagram
-    ss << "<g transform=\"translate(" << tx << "," << ty << ") scale(" << scale << "," << -scale << ")\" class=\"outer\">\n";
+    call.tag(ss, "g") << " transform=\"translate(" << tx << "," << ty << ") scale(" << scale << "," << -scale << ")\" class=\"outer\">\n";
     ss << "  " << circlePath(nested.outer().circle()) << "\n";
     auto lines = nested.outer().allLines();
     for (const auto& line : lines) {
-        ss << "  <line x1=\"" << line.first.x 
+        call.tag(ss << "  ", "line") << " x1=\"" << line.first.x 
            << "\" y1=\"" << line.first.y
            << "\" x2=\"" << line.second.x 
            << "\" y2=\"" << line.second.y << "\"/>\n";
@@ -393,12 +470,12 @@ std::string nestedEnneagramSVG(const NestedEnneagramGeometry& nested,
     ss << "</g>\n";
     
     // Nested enneagrams
-    ss << "<g transform=\"translate(" << tx << "," << ty << ") scale(" << scale << "," << -scale << ")\" class=\"nested\">\n";
+    call.tag(ss, "g") << " transform=\"translate(" << tx << "," << ty << ") scale(" << scale << "," << -scale << ")\" class=\"nested\">\n";
     for (const auto& n : nested.nested()) {
         ss << "  " << circlePath(n.circle()) << "\n";
         auto nlines = n.allLines();
         for (const auto& line : nlines) {
-            ss << "  <line x1=\"" << line.first.x 
+            call.tag(ss << "  ", "line") << " x1=\"" << line.first.x 
                << "\" y1=\"" << line.first.y
                << "\" x2=\"" << line.second.x 
                << "\" y2=\"" << line.second.y << "\"/>\n";
@@ -408,28 +485,31 @@ std::string nestedEnneagramSVG(const NestedEnneagramGeometry& nested,
     
     ss << "</svg>\n";
     
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string systemHierarchySVG(double width, double height) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("svg::systemHierarchySVG", "svg");
+    COSMIC_METRIC_TIMER("svg::systemHierarchySVG");
+    SvgCall call;
+    memory::OutputStream ss(memory::Subsystem::SVG);
     ss << std::fixed << std::setprecision(2);
     
     ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-    ss << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+    call.tag(ss, "svg") << " xmlns=\"http://www.w3.org/2000/svg\" "
        << "width=\"" << width << "\" height=\"" << height << "\">\n";
     
-    ss << "<style>\n";
+    call.tag(ss, "style") << ">\n";
     ss << "  .system { stroke: #333; fill: none; stroke-width: 1.5; }\n";
     ss << "  .filled { fill: #ccc; }\n";
     ss << "  .title { font-family: Arial, sans-serif; font-size: 14px; font-weight: bold; }\n";
     ss << "  .desc { font-family: Arial, sans-serif; font-size: 10px; }\n";
     ss << "</style>\n";
     
-    ss << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+    call.tag(ss, "rect") << " width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
     
     // Title
-    ss << "<text x=\"" << width/2 << "\" y=\"30\" text-anchor=\"middle\" class=\"title\" style=\"font-size: 16px;\">";
+    call.tag(ss, "text") << " x=\"" << width/2 << "\" y=\"30\" text-anchor=\"middle\" class=\"title\" style=\"font-size: 16px;\">";
     ss << "The Proliferation of the System</text>\n";
     
     double y_start = 60;
@@ -440,56 +520,56 @@ std::string systemHierarchySVG(double width, double height) {
     
     // System 1: Cross/Plus
     double y = y_start;
-    ss << "<g transform=\"translate(" << icon_x << "," << y << ")\">\n";
-    ss << "  <line x1=\"-15\" y1=\"0\" x2=\"15\" y2=\"0\" class=\"system\"/>\n";
-    ss << "  <line x1=\"0\" y1=\"-15\" x2=\"0\" y2=\"15\" class=\"system\"/>\n";
+    call.tag(ss, "g") << " transform=\"translate(" << icon_x << "," << y << ")\">\n";
+    call.tag(ss << "  ", "line") << " x1=\"-15\" y1=\"0\" x2=\"15\" y2=\"0\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "line") << " x1=\"0\" y1=\"-15\" x2=\"0\" y2=\"15\" class=\"system\"/>\n";
     ss << "</g>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 1</text>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">Active interface between subjective &amp; objective</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 1</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">Active interface between subjective &amp; objective</text>\n";
     
     // System 2: Double lines
     y += y_step;
-    ss << "<g transform=\"translate(" << icon_x << "," << y << ")\">\n";
-    ss << "  <line x1=\"-10\" y1=\"-15\" x2=\"-10\" y2=\"15\" class=\"system\"/>\n";
-    ss << "  <line x1=\"10\" y1=\"-15\" x2=\"10\" y2=\"15\" class=\"system\"/>\n";
-    ss << "  <line x1=\"-15\" y1=\"-5\" x2=\"-5\" y2=\"-5\" class=\"system\"/>\n";
-    ss << "  <line x1=\"5\" y1=\"5\" x2=\"15\" y2=\"5\" class=\"system\"/>\n";
+    call.tag(ss, "g") << " transform=\"translate(" << icon_x << "," << y << ")\">\n";
+    call.tag(ss << "  ", "line") << " x1=\"-10\" y1=\"-15\" x2=\"-10\" y2=\"15\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "line") << " x1=\"10\" y1=\"-15\" x2=\"10\" y2=\"15\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "line") << " x1=\"-15\" y1=\"-5\" x2=\"-5\" y2=\"-5\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "line") << " x1=\"5\" y1=\"5\" x2=\"15\" y2=\"5\" class=\"system\"/>\n";
     ss << "</g>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 2</text>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">Objective &amp; subjective modes</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 2</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">Objective &amp; subjective modes</text>\n";
     
     // System 3: Triangle
     y += y_step;
-    ss << "<g transform=\"translate(" << icon_x << "," << y << ")\">\n";
-    ss << "  <polygon points=\"0,-18 -16,12 16,12\" class=\"system\"/>\n";
+    call.tag(ss, "g") << " transform=\"translate(" << icon_x << "," << y << ")\">\n";
+    call.tag(ss << "  ", "polygon") << " points=\"0,-18 -16,12 16,12\" class=\"system\"/>\n";
     ss << "</g>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 3</text>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">The primary activity &amp; the cosmic movie</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 3</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">The primary activity &amp; the cosmic movie</text>\n";
     
     // System 4: Triangle in circle
     y += y_step;
-    ss << "<g transform=\"translate(" << icon_x << "," << y << ")\">\n";
-    ss << "  <circle cx=\"0\" cy=\"0\" r=\"20\" class=\"system\"/>\n";
-    ss << "  <polygon points=\"0,-18 -16,12 16,12\" class=\"system\"/>\n";
+    call.tag(ss, "g") << " transform=\"translate(" << icon_x << "," << y << ")\">\n";
+    call.tag(ss << "  ", "circle") << " cx=\"0\" cy=\"0\" r=\"20\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "polygon") << " points=\"0,-18 -16,12 16,12\" class=\"system\"/>\n";
     ss << "</g>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 4</text>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">The primary creative process &amp; the enneagram</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 4</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">The primary creative process &amp; the enneagram</text>\n";
     
     // System 5: Two overlapping triangles in circles
     y += y_step;
-    ss << "<g transform=\"translate(" << icon_x << "," << y << ")\">\n";
-    ss << "  <circle cx=\"-8\" cy=\"0\" r=\"18\" class=\"system\"/>\n";
-    ss << "  <polygon points=\"-8,-16 -22,10 6,10\" class=\"system\"/>\n";
-    ss << "  <circle cx=\"8\" cy=\"0\" r=\"18\" class=\"system\"/>\n";
-    ss << "  <polygon points=\"8,-16 -6,10 22,10\" class=\"system filled\"/>\n";
+    call.tag(ss, "g") << " transform=\"translate(" << icon_x << "," << y << ")\">\n";
+    call.tag(ss << "  ", "circle") << " cx=\"-8\" cy=\"0\" r=\"18\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "polygon") << " points=\"-8,-16 -22,10 6,10\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "circle") << " cx=\"8\" cy=\"0\" r=\"18\" class=\"system\"/>\n";
+    call.tag(ss << "  ", "polygon") << " points=\"8,-16 -6,10 22,10\" class=\"system filled\"/>\n";
     ss << "</g>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 5</text>\n";
-    ss << "<text x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">Complementary objective &amp; subjective enneagrams</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM 5</text>\n";
+    call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">Complementary objective &amp; subjective enneagrams</text>\n";
     
     // System 6-10: Increasingly complex nested structures
     for (int sys = 6; sys <= 10; ++sys) {
         y += y_step;
-        ss << "<g transform=\"translate(" << icon_x << "," << y << ")\">\n";
+        call.tag(ss, "g") << " transform=\"translate(" << icon_x << "," << y << ")\">\n";
         
         // Draw nested triangular structure
         double base_size = 25;
@@ -497,14 +577,14 @@ std::string systemHierarchySVG(double width, double height) {
         for (int layer = 0; layer < std::min(layers, 4); ++layer) {
             double size = base_size * (1.0 - layer * 0.25);
             double offset_y = layer * 8;
-            ss << "  <polygon points=\"0," << (-size + offset_y) 
+            call.tag(ss << "  ", "polygon") << " points=\"0," << (-size + offset_y) 
                << " " << (-size*0.866) << "," << (size*0.5 + offset_y)
                << " " << (size*0.866) << "," << (size*0.5 + offset_y) 
                << "\" class=\"system" << (layer % 2 == 1 ? " filled" : "") << "\"/>\n";
         }
         
         ss << "</g>\n";
-        ss << "<text x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM " << sys << "</text>\n";
+        call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y-5 << "\" class=\"title\">SYSTEM " << sys << "</text>\n";
         
         std::string desc;
         switch (sys) {
@@ -514,12 +594,151 @@ std::string systemHierarchySVG(double width, double height) {
             case 9: desc = "A primary activity, each term an enneagram of enneagrams"; break;
             case 10: desc = "An enneagram, each term an enneagram of enneagrams"; break;
         }
-        ss << "<text x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">" << desc << "</text>\n";
+        call.tag(ss, "text") << " x=\"" << text_x << "\" y=\"" << y+10 << "\" class=\"desc\">" << desc << "</text>\n";
     }
     
     ss << "</svg>\n";
     
-    return ss.str();
+    return call.finish(ss.str());
+}
+
+namespace {
+
+// Round a span to a 1-2-5 tick step giving about @p target ticks
+double tickStep(double span, int target) {
+    double raw = span / target;
+    double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+    double normalized = raw / magnitude;
+    double step = normalized < 1.5 ? 1.0 : normalized < 3.5 ? 2.0 : normalized < 7.5 ? 5.0 : 10.0;
+    return step * magnitude;
+}
+
+void writeEscaped(std::ostream& out, const std::string& text) {
+    for (char c : text) {
+        switch (c) {
+            case '&': out << "&amp;"; break;
+            case '<': out << "&lt;"; break;
+            case '>': out << "&gt;"; break;
+            case '"': out << "&quot;"; break;
+            default: out << c;
+        }
+    }
+}
+
+} // namespace
+
+std::string linePlot(const std::vector<PlotSeries>& series, const std::string& title,
+                     const std::string& x_label, const std::string& y_label,
+                     double width, double height) {
+    COSMIC_TRACE_SCOPE_CAT("svg::linePlot", "svg");
+    COSMIC_METRIC_TIMER("svg::linePlot");
+    SvgCall call;
+    memory::OutputStream ss(memory::Subsystem::SVG);
+    
+    double x_min = 0.0, x_max = 1.0, y_min = 0.0, y_max = 1.0;
+    bool first = true;
+    for (const auto& s : series) {
+        for (const auto& p : s.points) {
+            if (first) {
+                x_min = x_max = p.x;
+                y_max = p.y;
+                first = false;
+            }
+            x_min = std::min(x_min, p.x);
+            x_max = std::max(x_max, p.x);
+            y_min = std::min(y_min, p.y);
+            y_max = std::max(y_max, p.y);
+        }
+    }
+    if (x_max <= x_min) x_max = x_min + 1.0;
+    if (y_max <= y_min) y_max = y_min + 1.0;
+    
+    const double left = 70, right = 170, top = 40, bottom = 55;
+    const double plot_w = width - left - right;
+    const double plot_h = height - top - bottom;
+    auto px = [&](double x) { return left + (x - x_min) / (x_max - x_min) * plot_w; };
+    auto py = [&](double y) { return top + plot_h - (y - y_min) / (y_max - y_min) * plot_h; };
+    
+    ss << std::fixed << std::setprecision(2);
+    ss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    call.tag(ss, "svg") << " xmlns=\"http://www.w3.org/2000/svg\" "
+       << "width=\"" << width << "\" height=\"" << height << "\">\n";
+    call.tag(ss, "style") << ">\n";
+    ss << "  .axis { stroke: #333; stroke-width: 1; }\n";
+    ss << "  .grid { stroke: #ddd; stroke-width: 0.5; }\n";
+    ss << "  .label { font-family: Arial, sans-serif; font-size: 11px; }\n";
+    ss << "  .title { font-family: Arial, sans-serif; font-size: 14px; font-weight: bold; }\n";
+    ss << "</style>\n";
+    call.tag(ss, "rect") << " width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+    
+    call.tag(ss, "text") << " x=\"" << left + plot_w / 2 << "\" y=\"24\" text-anchor=\"middle\" class=\"title\">";
+    writeEscaped(ss, title);
+    ss << "</text>\n";
+    
+    // Grid and ticks
+    std::ostringstream tick;
+    double x_step = tickStep(x_max - x_min, 8);
+    for (double x = std::ceil(x_min / x_step) * x_step; x <= x_max + 1e-9 * x_step; x += x_step) {
+        call.tag(ss, "line") << " x1=\"" << px(x) << "\" y1=\"" << top << "\" x2=\"" << px(x)
+           << "\" y2=\"" << top + plot_h << "\" class=\"grid\"/>\n";
+        tick.str("");
+        tick << x;
+        call.tag(ss, "text") << " x=\"" << px(x) << "\" y=\"" << top + plot_h + 16
+           << "\" text-anchor=\"middle\" class=\"label\">" << tick.str() << "</text>\n";
+    }
+    double y_step = tickStep(y_max - y_min, 6);
+    for (double y = std::ceil(y_min / y_step) * y_step; y <= y_max + 1e-9 * y_step; y += y_step) {
+        call.tag(ss, "line") << " x1=\"" << left << "\" y1=\"" << py(y) << "\" x2=\"" << left + plot_w
+           << "\" y2=\"" << py(y) << "\" class=\"grid\"/>\n";
+        tick.str("");
+        tick << y;
+        call.tag(ss, "text") << " x=\"" << left - 6 << "\" y=\"" << py(y) + 4
+           << "\" text-anchor=\"end\" class=\"label\">" << tick.str() << "</text>\n";
+    }
+    call.tag(ss, "line") << " x1=\"" << left << "\" y1=\"" << top + plot_h << "\" x2=\"" << left + plot_w
+       << "\" y2=\"" << top + plot_h << "\" class=\"axis\"/>\n";
+    call.tag(ss, "line") << " x1=\"" << left << "\" y1=\"" << top << "\" x2=\"" << left
+       << "\" y2=\"" << top + plot_h << "\" class=\"axis\"/>\n";
+    
+    call.tag(ss, "text") << " x=\"" << left + plot_w / 2 << "\" y=\"" << height - 12
+       << "\" text-anchor=\"middle\" class=\"label\">";
+    writeEscaped(ss, x_label);
+    ss << "</text>\n";
+    call.tag(ss, "text") << " transform=\"translate(16," << top + plot_h / 2
+       << ") rotate(-90)\" text-anchor=\"middle\" class=\"label\">";
+    writeEscaped(ss, y_label);
+    ss << "</text>\n";
+    
+    // Series and legend
+    for (size_t i = 0; i < series.size(); ++i) {
+        const auto& s = series[i];
+        if (!s.points.empty()) {
+            call.tag(ss, "polyline") << " fill=\"none\" stroke=\"" << s.color << "\" stroke-width=\"1.5\"";
+            if (s.dashed) ss << " stroke-dasharray=\"4,3\"";
+            ss << " points=\"";
+            for (size_t j = 0; j < s.points.size(); ++j) {
+                if (j > 0) ss << " ";
+                ss << px(s.points[j].x) << "," << py(s.points[j].y);
+            }
+            ss << "\"/>\n";
+            for (const auto& p : s.points) {
+                call.tag(ss, "circle") << " cx=\"" << px(p.x) << "\" cy=\"" << py(p.y)
+                   << "\" r=\"2.5\" fill=\"" << s.color << "\"/>\n";
+            }
+        }
+        double ly = top + 10 + 18.0 * static_cast<double>(i);
+        double lx = left + plot_w + 15;
+        call.tag(ss, "line") << " x1=\"" << lx << "\" y1=\"" << ly << "\" x2=\"" << lx + 20 << "\" y2=\"" << ly
+           << "\" stroke=\"" << s.color << "\" stroke-width=\"1.5\"";
+        if (s.dashed) ss << " stroke-dasharray=\"4,3\"";
+        ss << "/>\n";
+        call.tag(ss, "text") << " x=\"" << lx + 26 << "\" y=\"" << ly + 4 << "\" class=\"label\">";
+        writeEscaped(ss, s.label);
+        ss << "</text>\n";
+    }
+    
+    ss << "</svg>\n";
+    return call.finish(ss.str());
 }
 
 } // namespace svg
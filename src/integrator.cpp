@@ -0,0 +1,232 @@
+/**
+ * @file integrator.cpp
+ * @brief Implementation of the adaptive System 1 integrator
+ */
+
+#include "cosmic/integrator.hpp"
+#include "cosmic/tracing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace cosmic {
+namespace integrator {
+
+namespace {
+
+// Dormand–Prince 5(4) tableau (Hairer, Nørsett & Wanner, DOPRI5). The
+// right-hand side depends on time only, so the stage states (and with them
+// the a_ij below the last row) drop out and each step is a quadrature.
+// Stage 2 has zero weight in the solution, error and continuous extension,
+// so it is not evaluated at all.
+constexpr double C3 = 3.0 / 10.0, C4 = 4.0 / 5.0, C5 = 8.0 / 9.0;
+constexpr double A71 = 35.0 / 384.0, A73 = 500.0 / 1113.0, A74 = 125.0 / 192.0,
+                 A75 = -2187.0 / 6784.0, A76 = 11.0 / 84.0;
+
+// Difference between the 5th- and 4th-order weights
+constexpr double E1 = 71.0 / 57600.0, E3 = -71.0 / 16695.0, E4 = 71.0 / 1920.0,
+                 E5 = -17253.0 / 339200.0, E6 = 22.0 / 525.0, E7 = -1.0 / 40.0;
+
+// Continuous extension
+constexpr double D1 = -12715105075.0 / 11282082432.0, D3 = 87487479700.0 / 32700410799.0,
+                 D4 = -10690763975.0 / 1880347072.0, D5 = 701980252875.0 / 199316789632.0,
+                 D6 = -1453857185.0 / 822651844.0, D7 = 69997945.0 / 29380423.0;
+
+// Step-size controller
+constexpr double SAFETY = 0.9;
+constexpr double FAC_MIN = 0.2;
+constexpr double FAC_MAX = 5.0;
+
+constexpr size_t DIM = 3;  // intensity, accumulated efflux, accumulated reflux
+using Vec = std::array<double, DIM>;
+
+struct Rhs {
+    const Schedules& schedules;
+    double efflux;
+    double reflux;
+    size_t evaluations = 0;
+
+    Vec operator()(double t) {
+        ++evaluations;
+        double e = schedules.efflux ? schedules.efflux(t) : efflux;
+        double r = schedules.reflux ? schedules.reflux(t) : reflux;
+        return {system1::System1::intensityRate(e, r), e, r};
+    }
+};
+
+double errorNorm(const Vec& y0, const Vec& y1, const Vec& delta, const Options& opt) {
+    double sum = 0.0;
+    for (size_t i = 0; i < DIM; ++i) {
+        double scale = opt.absolute_tolerance +
+                       opt.relative_tolerance * std::max(std::abs(y0[i]), std::abs(y1[i]));
+        double r = delta[i] / scale;
+        sum += r * r;
+    }
+    return std::sqrt(sum / static_cast<double>(DIM));
+}
+
+double initialStep(Rhs& f, double t, const Vec& y, const Vec& k1, const Options& opt) {
+    double d0 = 0.0, d1 = 0.0;
+    for (size_t i = 0; i < DIM; ++i) {
+        double scale = opt.absolute_tolerance + opt.relative_tolerance * std::abs(y[i]);
+        d0 += (y[i] / scale) * (y[i] / scale);
+        d1 += (k1[i] / scale) * (k1[i] / scale);
+    }
+    d0 = std::sqrt(d0 / DIM);
+    d1 = std::sqrt(d1 / DIM);
+    double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+
+    Vec k2 = f(t + h0);
+    double d2 = 0.0;
+    for (size_t i = 0; i < DIM; ++i) {
+        double scale = opt.absolute_tolerance + opt.relative_tolerance * std::abs(y[i]);
+        double r = (k2[i] - k1[i]) / scale;
+        d2 += r * r;
+    }
+    d2 = std::sqrt(d2 / DIM) / h0;
+    double dmax = std::max(d1, d2);
+    double h1 = dmax <= 1e-15 ? std::max(1e-6, h0 * 1e-3) : std::pow(0.01 / dmax, 0.2);
+    return std::min(100.0 * h0, h1);
+}
+
+} // namespace
+
+// ============================================================================
+// DenseOutput Implementation
+// ============================================================================
+
+double DenseOutput::startTime() const {
+    return steps_.empty() ? 0.0 : steps_.front().t;
+}
+
+double DenseOutput::endTime() const {
+    return steps_.empty() ? 0.0 : steps_.back().t + steps_.back().h;
+}
+
+double DenseOutput::intensity(double t) const {
+    if (steps_.empty() || t < startTime() || t > endTime()) {
+        throw std::out_of_range("DenseOutput: time outside the integrated interval");
+    }
+    auto it = std::upper_bound(steps_.begin(), steps_.end(), t,
+                               [](double value, const Step& s) { return value < s.t; });
+    const Step& s = *(it == steps_.begin() ? it : it - 1);
+    double theta = (t - s.t) / s.h;
+    double theta1 = 1.0 - theta;
+    const auto& c = s.c;
+    return c[0] + theta * (c[1] + theta1 * (c[2] + theta * (c[3] + theta1 * c[4])));
+}
+
+void DenseOutput::append(double t, double h, const std::array<double, 5>& coefficients) {
+    steps_.push_back({t, h, coefficients});
+}
+
+// ============================================================================
+// AdaptiveIntegrator Implementation
+// ============================================================================
+
+AdaptiveIntegrator::AdaptiveIntegrator(const Options& options) : options_(options) {
+    if (!(options.relative_tolerance > 0.0) || !(options.absolute_tolerance >= 0.0)) {
+        throw std::invalid_argument("AdaptiveIntegrator: tolerances must be positive");
+    }
+    if (!(options.min_step > 0.0) || !(options.max_step >= options.min_step)) {
+        throw std::invalid_argument("AdaptiveIntegrator: invalid step limits");
+    }
+}
+
+Result AdaptiveIntegrator::integrate(system1::System1& system, double t_end,
+                                     const Schedules& schedules) const {
+    COSMIC_TRACE_SCOPE_CAT("AdaptiveIntegrator::integrate", "simulation");
+    system1::System1::State state = system.state();
+    double t = state.time;
+    if (t_end < t) {
+        throw std::invalid_argument("AdaptiveIntegrator: end time precedes system time");
+    }
+
+    Result result;
+    Rhs f{schedules, state.efflux_rate, state.reflux_rate};
+    Vec y{state.center_intensity, state.accumulated_efflux, state.accumulated_reflux};
+
+    if (t_end > t) {
+        Vec k1 = f(t);
+        double h = options_.initial_step > 0.0 ? options_.initial_step
+                                               : initialStep(f, t, y, k1, options_);
+        double fac_max = FAC_MAX;
+
+        while (t < t_end) {
+            if (result.accepted + result.rejected >= options_.max_steps) {
+                throw std::runtime_error("AdaptiveIntegrator: maximum step count exceeded");
+            }
+            h = std::min(h, options_.max_step);
+            // Stretch the final step rather than leave a sliver
+            bool last = t + 1.01 * h >= t_end;
+            if (last) h = t_end - t;
+
+            Vec k3 = f(t + C3 * h);
+            Vec k4 = f(t + C4 * h);
+            Vec k5 = f(t + C5 * h);
+            Vec k6 = f(t + h);
+            const Vec& k7 = k6;  // f(t + h, y1) == f(t + h, ·)
+
+            Vec y1{};
+            Vec delta{};
+            for (size_t i = 0; i < DIM; ++i) {
+                y1[i] = y[i] + h * (A71 * k1[i] + A73 * k3[i] + A74 * k4[i] + A75 * k5[i] +
+                                    A76 * k6[i]);
+                delta[i] = h * (E1 * k1[i] + E3 * k3[i] + E4 * k4[i] + E5 * k5[i] +
+                                E6 * k6[i] + E7 * k7[i]);
+            }
+            double err = errorNorm(y, y1, delta, options_);
+
+            if (err <= 1.0) {
+                if (options_.dense) {
+                    double ydiff = y1[0] - y[0];
+                    double bspl = h * k1[0] - ydiff;
+                    result.dense.append(t, h, {y[0], ydiff, bspl, ydiff - h * k7[0] - bspl,
+                                               h * (D1 * k1[0] + D3 * k3[0] + D4 * k4[0] +
+                                                    D5 * k5[0] + D6 * k6[0] + D7 * k7[0])});
+                }
+                ++result.accepted;
+                result.last_step = h;
+                t = last ? t_end : t + h;
+                y = y1;
+                k1 = k7;  // first same as last
+                double fac = err > 0.0 ? SAFETY * std::pow(err, -0.2) : fac_max;
+                h *= std::clamp(fac, FAC_MIN, fac_max);
+                fac_max = FAC_MAX;
+            } else {
+                ++result.rejected;
+                h *= std::max(FAC_MIN, SAFETY * std::pow(err, -0.2));
+                fac_max = 1.0;  // no growth straight after a rejection
+            }
+            if (t < t_end && h < options_.min_step) {
+                throw std::runtime_error("AdaptiveIntegrator: step size underflow");
+            }
+        }
+    }
+    result.evaluations = f.evaluations;
+
+    state.center_intensity = y[0];
+    state.accumulated_efflux = y[1];
+    state.accumulated_reflux = y[2];
+    state.time = t_end;
+    if (schedules.efflux) state.efflux_rate = schedules.efflux(t_end);
+    if (schedules.reflux) state.reflux_rate = schedules.reflux(t_end);
+    system.restore(state);
+    return result;
+}
+
+std::vector<Result> AdaptiveIntegrator::integrate(std::vector<system1::System1>& ensemble,
+                                                  double t_end, const Schedules& schedules,
+                                                  parallel::Executor* pool) const {
+    std::vector<Result> results(ensemble.size());
+    auto advance = [&](size_t i) { results[i] = integrate(ensemble[i], t_end, schedules); };
+    if (pool) {
+        pool->run(ensemble.size(), advance);
+    } else {
+        for (size_t i = 0; i < ensemble.size(); ++i) advance(i);
+    }
+    return results;
+}
+
+} // namespace integrator
+} // namespace cosmic
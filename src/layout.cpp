@@ -0,0 +1,190 @@
+/**
+ * @file layout.cpp
+ * @brief Implementation of the implicit enneagram layout
+ */
+
+#include "cosmic/layout.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace cosmic {
+namespace layout {
+
+// ============================================================================
+// EnneagramArray Implementation
+// ============================================================================
+
+EnneagramArray::EnneagramArray(size_t depth, const std::string& name)
+    : depth_(depth), root_name_(name) {
+    if (depth > MAX_DEPTH) {
+        throw std::invalid_argument("Nesting depth must be at most " + std::to_string(MAX_DEPTH));
+    }
+    size_ = levelBegin(depth + 1);
+}
+
+EnneagramArray EnneagramArray::fromEnneagram(const Enneagram& root) {
+    EnneagramArray array(root.nestedLevel(), root.name());
+
+    // Level order visits enneagrams in address order
+    std::vector<const Enneagram*> level{&root};
+    size_t a = 0;
+    for (size_t d = 0; d <= array.depth_; ++d) {
+        std::vector<const Enneagram*> next;
+        if (d < array.depth_) next.reserve(level.size() * 9);
+        for (const Enneagram* e : level) {
+            if (a > 0) array.setName(a, e->name());
+            for (int p = 1; p <= 9; ++p) {
+                auto pos = static_cast<EnneagramPosition>(p);
+                if (auto term = e->termAt(pos)) array.setTermAt(a, p, term);
+                auto nested = e->nestedEnneagramAt(pos);
+                if (d < array.depth_) {
+                    if (!nested) {
+                        throw std::invalid_argument("Enneagram nesting is not fully populated: '" +
+                                                    e->name() + "' lacks position " +
+                                                    std::to_string(p));
+                    }
+                    next.push_back(nested.get());
+                } else if (nested) {
+                    throw std::invalid_argument("Enneagram nesting is deeper than its level: '" +
+                                                e->name() + "'");
+                }
+            }
+            ++a;
+        }
+        level = std::move(next);
+    }
+    return array;
+}
+
+Enneagram::EnneagramPtr EnneagramArray::toEnneagram() const {
+    // Deepest level first, so children exist before their parent
+    std::vector<Enneagram::EnneagramPtr> below;
+    for (size_t d = depth_ + 1; d-- > 0;) {
+        size_t begin = levelBegin(d);
+        std::vector<Enneagram::EnneagramPtr> current(levelSize(d));
+        for (size_t i = 0; i < current.size(); ++i) {
+            size_t a = begin + i;
+            auto e = Enneagram::create(name(a));
+            for (int p = 1; p <= 9; ++p) {
+                auto pos = static_cast<EnneagramPosition>(p);
+                e->setTermAt(pos, termAt(a, p));
+                if (!below.empty()) e->setNestedEnneagram(pos, below[9 * i + p - 1]);
+            }
+            current[i] = std::move(e);
+        }
+        below = std::move(current);
+    }
+    return below.front();
+}
+
+size_t EnneagramArray::level(size_t a) {
+    size_t d = 0;
+    while (a >= levelBegin(d + 1)) ++d;
+    return d;
+}
+
+size_t EnneagramArray::address(const std::vector<EnneagramPosition>& path) const {
+    if (path.size() > depth_) {
+        throw std::out_of_range("Path is deeper than the nesting");
+    }
+    size_t a = 0;
+    for (EnneagramPosition pos : path) {
+        int p = static_cast<int>(pos);
+        if (p < 1 || p > 9) {
+            throw std::out_of_range("Enneagram position must be 1-9");
+        }
+        a = child(a, p);
+    }
+    return a;
+}
+
+std::string EnneagramArray::name(size_t a) const {
+    if (!names_.empty() && !names_[a].empty()) return names_[a];
+    if (a == 0) return root_name_;
+
+    std::string suffix;
+    for (; a > 0; a = parent(a)) {
+        suffix.insert(0, 1, static_cast<char>('0' + position(a)));
+        suffix.insert(0, 1, '.');
+    }
+    return root_name_ + suffix;
+}
+
+void EnneagramArray::setName(size_t a, const std::string& name) {
+    checkAddress(a);
+    if (a == 0) {
+        root_name_ = name;
+        return;
+    }
+    if (names_.empty()) names_.resize(size_);
+    names_[a] = name;
+}
+
+void EnneagramArray::setTermAt(size_t a, int p, Term::TermPtr term) {
+    checkAddress(a);
+    if (p < 1 || p > 9) {
+        throw std::out_of_range("Enneagram position must be 1-9");
+    }
+    if (terms_.empty()) {
+        if (!term) return;
+        terms_.resize(9 * size_);
+    }
+    terms_[9 * a + static_cast<size_t>(p) - 1] = std::move(term);
+}
+
+EnneagramView EnneagramArray::view(size_t a) {
+    checkAddress(a);
+    return EnneagramView(this, a);
+}
+
+EnneagramView EnneagramArray::root() {
+    return EnneagramView(this, 0);
+}
+
+void EnneagramArray::checkAddress(size_t a) const {
+    if (a >= size_) {
+        throw std::out_of_range("Enneagram address out of range: " + std::to_string(a));
+    }
+}
+
+// ============================================================================
+// EnneagramView Implementation
+// ============================================================================
+
+int EnneagramView::index(EnneagramPosition pos) {
+    int p = static_cast<int>(pos);
+    if (p < 1 || p > 9) {
+        throw std::out_of_range("Enneagram position must be 1-9");
+    }
+    return p;
+}
+
+std::array<Term::TermPtr, 3> EnneagramView::triad() const {
+    return {array_->termAt(address_, 3), array_->termAt(address_, 6), array_->termAt(address_, 9)};
+}
+
+std::array<Term::TermPtr, 6> EnneagramView::process() const {
+    return {array_->termAt(address_, 1), array_->termAt(address_, 2), array_->termAt(address_, 4),
+            array_->termAt(address_, 5), array_->termAt(address_, 7), array_->termAt(address_, 8)};
+}
+
+std::array<Term::TermPtr, 9> EnneagramView::terms() const {
+    std::array<Term::TermPtr, 9> all;
+    for (int p = 1; p <= 9; ++p) all[p - 1] = array_->termAt(address_, p);
+    return all;
+}
+
+EnneagramView EnneagramView::nestedEnneagramAt(EnneagramPosition pos) const {
+    int p = index(pos);
+    if (!isNested()) return EnneagramView();
+    return EnneagramView(array_, EnneagramArray::child(address_, p));
+}
+
+EnneagramView EnneagramView::parent() const {
+    if (address_ == 0) return EnneagramView();
+    return EnneagramView(array_, EnneagramArray::parent(address_));
+}
+
+} // namespace layout
+} // namespace cosmic
@@ -0,0 +1,177 @@
+/**
+ * @file memory.cpp
+ * @brief Implementation of allocation accounting and subsystem resources
+ */
+
+#include "cosmic/memory.hpp"
+#include <array>
+#include <cstdio>
+#include <new>
+
+namespace cosmic {
+namespace memory {
+
+namespace {
+
+// Leaked on purpose: objects may be freed during static destruction
+std::array<CountingResource, SUBSYSTEM_COUNT>& globalResources() {
+    static auto* resources = new std::array<CountingResource, SUBSYSTEM_COUNT>();
+    return *resources;
+}
+
+CountingResource& global(Subsystem subsystem) {
+    return globalResources()[static_cast<size_t>(subsystem)];
+}
+
+thread_local std::array<std::pmr::memory_resource*, SUBSYSTEM_COUNT> tls_scoped = {};
+
+} // namespace
+
+const char* toString(Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::TERMS: return "terms";
+        case Subsystem::ENNEAGRAMS: return "enneagrams";
+        case Subsystem::TREES: return "trees";
+        case Subsystem::SERIALIZER: return "serializer";
+        case Subsystem::SVG: return "svg";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// CountingResource Implementation
+// ============================================================================
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream, CountingResource* parent)
+    : upstream_(upstream)
+    , parent_(parent) {}
+
+void CountingResource::charge(uint64_t bytes) {
+    uint64_t cap = limit_.load(std::memory_order_relaxed);
+    uint64_t live = live_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (cap != 0 && live > cap) {
+        live_.fetch_sub(bytes, std::memory_order_relaxed);
+        throw std::bad_alloc();
+    }
+    if (parent_) {
+        try {
+            parent_->charge(bytes);
+        } catch (...) {
+            live_.fetch_sub(bytes, std::memory_order_relaxed);
+            throw;
+        }
+    }
+    uint64_t peak = peak_.load(std::memory_order_relaxed);
+    while (live > peak && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void CountingResource::release(uint64_t bytes) noexcept {
+    live_.fetch_sub(bytes, std::memory_order_relaxed);
+    deallocations_.fetch_add(1, std::memory_order_relaxed);
+    bytes_deallocated_.fetch_add(bytes, std::memory_order_relaxed);
+    if (parent_) parent_->release(bytes);
+}
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    charge(bytes);
+    try {
+        return upstream_->allocate(bytes, alignment);
+    } catch (...) {
+        release(bytes);
+        throw;
+    }
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    upstream_->deallocate(p, bytes, alignment);
+    release(bytes);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+AllocationStats CountingResource::stats() const {
+    AllocationStats s;
+    s.allocations = allocations_.load(std::memory_order_relaxed);
+    s.deallocations = deallocations_.load(std::memory_order_relaxed);
+    s.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+    s.bytes_deallocated = bytes_deallocated_.load(std::memory_order_relaxed);
+    s.live_bytes = live_.load(std::memory_order_relaxed);
+    s.peak_bytes = peak_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void CountingResource::resetStats() {
+    allocations_.store(0, std::memory_order_relaxed);
+    deallocations_.store(0, std::memory_order_relaxed);
+    bytes_allocated_.store(0, std::memory_order_relaxed);
+    bytes_deallocated_.store(0, std::memory_order_relaxed);
+    peak_.store(live_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Subsystem Resources
+// ============================================================================
+
+std::pmr::memory_resource* resource(Subsystem subsystem) {
+    std::pmr::memory_resource* scoped = tls_scoped[static_cast<size_t>(subsystem)];
+    return scoped ? scoped : &global(subsystem);
+}
+
+AllocationStats stats(Subsystem subsystem) {
+    return global(subsystem).stats();
+}
+
+void resetStats() {
+    for (auto& r : globalResources()) r.resetStats();
+}
+
+void setLimit(Subsystem subsystem, uint64_t bytes) {
+    global(subsystem).setLimit(bytes);
+}
+
+void writeReport(std::ostream& out) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-12s %12s %12s %14s %12s %12s\n",
+                  "subsystem", "allocs", "frees", "bytes", "live", "peak");
+    out << line;
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        auto subsystem = static_cast<Subsystem>(i);
+        AllocationStats s = stats(subsystem);
+        std::snprintf(line, sizeof(line), "%-12s %12llu %12llu %14llu %12llu %12llu\n",
+                      toString(subsystem),
+                      static_cast<unsigned long long>(s.allocations),
+                      static_cast<unsigned long long>(s.deallocations),
+                      static_cast<unsigned long long>(s.bytes_allocated),
+                      static_cast<unsigned long long>(s.live_bytes),
+                      static_cast<unsigned long long>(s.peak_bytes));
+        out << line;
+    }
+}
+
+ResourceScope::ResourceScope(Subsystem subsystem, std::pmr::memory_resource* upstream)
+    : subsystem_(subsystem)
+    , counter_(upstream ? upstream : std::pmr::new_delete_resource(), &global(subsystem))
+    , previous_(tls_scoped[static_cast<size_t>(subsystem)]) {
+    tls_scoped[static_cast<size_t>(subsystem)] = upstream ? &counter_ : nullptr;
+}
+
+ResourceScope::~ResourceScope() {
+    tls_scoped[static_cast<size_t>(subsystem_)] = previous_;
+}
+
+// ============================================================================
+// OutputStream Implementation
+// ============================================================================
+
+OutputStream::OutputStream(Subsystem subsystem)
+    : std::ostream(nullptr)
+    , buffer_(resource(subsystem)) {
+    rdbuf(&buffer_);
+}
+
+} // namespace memory
+} // namespace cosmic
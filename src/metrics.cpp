@@ -0,0 +1,262 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of counters, histograms and the metrics registry
+ */
+
+#include "cosmic/metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace cosmic {
+namespace metrics {
+
+namespace {
+
+bool validName(const std::string& name) {
+    if (name.empty()) return false;
+    for (size_t i = 0; i < name.size(); ++i) {
+        char c = name[i];
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+        bool digit = c >= '0' && c <= '9';
+        if (!alpha && !(digit && i > 0)) return false;
+    }
+    return true;
+}
+
+// Join a series' labels with an extra label, in exposition syntax
+std::string labelSet(const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) return "";
+    if (labels.empty()) return "{" + extra + "}";
+    if (extra.empty()) return "{" + labels + "}";
+    return "{" + labels + "," + extra + "}";
+}
+
+void writeHelp(std::ostream& out, const std::string& name, const std::string& help,
+               const char* type) {
+    if (!help.empty()) {
+        out << "# HELP " << name << " ";
+        for (char c : help) {
+            if (c == '\\') out << "\\\\";
+            else if (c == '\n') out << "\\n";
+            else out << c;
+        }
+        out << "\n";
+    }
+    out << "# TYPE " << name << " " << type << "\n";
+}
+
+} // namespace
+
+// ============================================================================
+// Counter Implementation
+// ============================================================================
+
+uint64_t Counter::value() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::reset() noexcept {
+    for (auto& shard : shards_) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+// ============================================================================
+// Histogram Implementation
+// ============================================================================
+
+double HistogramSnapshot::mean() const {
+    if (count == 0) return 0.0;
+    return static_cast<double>(sum) / static_cast<double>(count);
+}
+
+uint64_t HistogramSnapshot::quantile(double q) const {
+    if (count == 0) return 0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (const auto& bucket : buckets) {
+        seen += bucket.count;
+        if (seen >= rank) {
+            return std::min(std::max(bucket.upper, min), max);
+        }
+    }
+    return max;
+}
+
+Histogram::Histogram()
+    : buckets_(new std::atomic<uint64_t>[BUCKETS])
+    , min_(std::numeric_limits<uint64_t>::max()) {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Histogram::bucketLower(size_t index) noexcept {
+    if (index < 2 * SUB_BUCKETS) return index;
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    uint64_t mantissa = index - shift * SUB_BUCKETS;
+    return mantissa << shift;
+}
+
+uint64_t Histogram::bucketUpper(size_t index) noexcept {
+    if (index < 2 * SUB_BUCKETS) return index;
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    uint64_t mantissa = index - shift * SUB_BUCKETS;
+    // Wraps to the maximum for the last bucket
+    return ((mantissa + 1) << shift) - 1;
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot result;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+        if (n == 0) continue;
+        result.buckets.push_back({bucketLower(i), bucketUpper(i), n});
+        result.count += n;
+    }
+    if (result.count > 0) {
+        result.sum = sum_.load(std::memory_order_relaxed);
+        result.min = min_.load(std::memory_order_relaxed);
+        result.max = max_.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void Histogram::reset() noexcept {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Snapshot Implementation
+// ============================================================================
+
+uint64_t Snapshot::counter(const std::string& name, const std::string& labels) const {
+    for (const auto& sample : counters) {
+        if (sample.name == name && sample.labels == labels) return sample.value;
+    }
+    return 0;
+}
+
+const HistogramSnapshot* Snapshot::histogram(const std::string& name,
+                                             const std::string& labels) const {
+    for (const auto& sample : histograms) {
+        if (sample.name == name && sample.labels == labels) return &sample.data;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Registry Implementation
+// ============================================================================
+
+Registry::Family& Registry::family(const std::string& name, const std::string& help, Kind kind) {
+    if (!validName(name)) {
+        throw std::invalid_argument("Invalid metric name: " + name);
+    }
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        it = families_.emplace(name, Family{kind, help, {}, {}}).first;
+    } else if (it->second.kind != kind) {
+        throw std::logic_error("Metric " + name + " is registered with another type");
+    }
+    return it->second;
+}
+
+Counter& Registry::counter(const std::string& name, const std::string& help,
+                           const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, help, Kind::COUNTER).counters[labels];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Histogram& Registry::histogram(const std::string& name, const std::string& help,
+                               const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, help, Kind::HISTOGRAM).histograms[labels];
+    if (!slot) slot = std::make_unique<Histogram>();
+    return *slot;
+}
+
+Snapshot Registry::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Snapshot result;
+    for (const auto& [name, fam] : families_) {
+        for (const auto& [labels, counter] : fam.counters) {
+            result.counters.push_back({name, labels, fam.help, counter->value()});
+        }
+        for (const auto& [labels, histogram] : fam.histograms) {
+            result.histograms.push_back({name, labels, fam.help, histogram->snapshot()});
+        }
+    }
+    return result;
+}
+
+void Registry::writeText(std::ostream& out) const {
+    Snapshot snap = snapshot();
+
+    const std::string* last = nullptr;
+    for (const auto& sample : snap.counters) {
+        if (!last || *last != sample.name) {
+            writeHelp(out, sample.name, sample.help, "counter");
+            last = &sample.name;
+        }
+        out << sample.name << labelSet(sample.labels) << " " << sample.value << "\n";
+    }
+
+    last = nullptr;
+    for (const auto& sample : snap.histograms) {
+        if (!last || *last != sample.name) {
+            writeHelp(out, sample.name, sample.help, "histogram");
+            last = &sample.name;
+        }
+        uint64_t cumulative = 0;
+        for (const auto& bucket : sample.data.buckets) {
+            cumulative += bucket.count;
+            out << sample.name << "_bucket"
+                << labelSet(sample.labels, "le=\"" + std::to_string(bucket.upper) + "\"")
+                << " " << cumulative << "\n";
+        }
+        out << sample.name << "_bucket" << labelSet(sample.labels, "le=\"+Inf\"")
+            << " " << sample.data.count << "\n";
+        out << sample.name << "_sum" << labelSet(sample.labels) << " " << sample.data.sum << "\n";
+        out << sample.name << "_count" << labelSet(sample.labels) << " " << sample.data.count << "\n";
+    }
+}
+
+std::string Registry::text() const {
+    std::ostringstream ss;
+    writeText(ss);
+    return ss.str();
+}
+
+void Registry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [name, fam] : families_) {
+        for (auto& [labels, counter] : fam.counters) counter->reset();
+        for (auto& [labels, histogram] : fam.histograms) histogram->reset();
+    }
+}
+
+// Leaked on purpose: call sites keep references past static destruction
+Registry& registry() {
+    static Registry* r = new Registry;
+    return *r;
+}
+
+} // namespace metrics
+} // namespace cosmic
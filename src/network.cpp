@@ -0,0 +1,384 @@
+/**
+ * @file network.cpp
+ * @brief Implementation of coupled System 2 networks
+ */
+
+#include "cosmic/network.hpp"
+#include "cosmic/tracing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace cosmic {
+namespace network {
+
+namespace {
+
+constexpr double TWO_PI = 2.0 * M_PI;
+
+// Rows per chunk for sparse products; fixed so results are thread-count independent
+constexpr size_t SPMV_GRAIN = 4096;
+
+} // namespace
+
+// ============================================================================
+// SparseCoupling Implementation
+// ============================================================================
+
+SparseCoupling::SparseCoupling(size_t nodes, std::vector<uint64_t> row_offsets,
+                               std::vector<uint32_t> columns, std::vector<double> weights)
+    : nodes_(nodes)
+    , row_offsets_(std::move(row_offsets))
+    , columns_(std::move(columns))
+    , weights_(std::move(weights)) {
+    if (nodes_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("SparseCoupling: too many nodes");
+    }
+    if (row_offsets_.size() != nodes_ + 1 || row_offsets_.front() != 0) {
+        throw std::invalid_argument("SparseCoupling: row offsets do not match node count");
+    }
+    if (columns_.size() != weights_.size() || row_offsets_.back() != columns_.size()) {
+        throw std::invalid_argument("SparseCoupling: column and weight arrays do not match");
+    }
+    for (size_t i = 0; i < nodes_; ++i) {
+        if (row_offsets_[i] > row_offsets_[i + 1]) {
+            throw std::invalid_argument("SparseCoupling: row offsets must be non-decreasing");
+        }
+    }
+    for (uint32_t c : columns_) {
+        if (c >= nodes_) {
+            throw std::out_of_range("SparseCoupling: column index out of range");
+        }
+    }
+}
+
+SparseCoupling SparseCoupling::fromEdges(size_t nodes, const std::vector<Edge>& edges,
+                                         bool symmetric) {
+    if (nodes > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("SparseCoupling: too many nodes");
+    }
+
+    // Count entries per row
+    std::vector<uint64_t> offsets(nodes + 1, 0);
+    for (const auto& e : edges) {
+        if (e.to >= nodes || e.from >= nodes) {
+            throw std::out_of_range("SparseCoupling: edge endpoint out of range");
+        }
+        offsets[e.to + 1]++;
+        if (symmetric && e.to != e.from) offsets[e.from + 1]++;
+    }
+    for (size_t i = 0; i < nodes; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // Scatter into rows
+    std::vector<uint32_t> columns(offsets.back());
+    std::vector<double> weights(offsets.back());
+    std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+    for (const auto& e : edges) {
+        uint64_t k = fill[e.to]++;
+        columns[k] = static_cast<uint32_t>(e.from);
+        weights[k] = e.weight;
+        if (symmetric && e.to != e.from) {
+            k = fill[e.from]++;
+            columns[k] = static_cast<uint32_t>(e.to);
+            weights[k] = e.weight;
+        }
+    }
+
+    // Sort each row by column and merge duplicates
+    std::vector<uint64_t> merged_offsets(nodes + 1, 0);
+    std::vector<std::pair<uint32_t, double>> row;
+    uint64_t out = 0;
+    for (size_t i = 0; i < nodes; ++i) {
+        row.clear();
+        for (uint64_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+            row.emplace_back(columns[k], weights[k]);
+        }
+        std::stable_sort(row.begin(), row.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (size_t k = 0; k < row.size(); ++k) {
+            if (k > 0 && row[k].first == columns[out - 1]) {
+                weights[out - 1] += row[k].second;
+            } else {
+                columns[out] = row[k].first;
+                weights[out] = row[k].second;
+                ++out;
+            }
+        }
+        merged_offsets[i + 1] = out;
+    }
+    columns.resize(out);
+    weights.resize(out);
+
+    return SparseCoupling(nodes, std::move(merged_offsets), std::move(columns), std::move(weights));
+}
+
+SparseCoupling SparseCoupling::ring(size_t nodes, size_t neighbors, double weight) {
+    std::vector<Edge> edges;
+    if (nodes > 1) {
+        neighbors = std::min(neighbors, (nodes - 1) / 2);
+        edges.reserve(nodes * neighbors);
+        for (size_t i = 0; i < nodes; ++i) {
+            for (size_t k = 1; k <= neighbors; ++k) {
+                edges.push_back({i, (i + k) % nodes, weight});
+            }
+        }
+    }
+    return fromEdges(nodes, edges, true);
+}
+
+SparseCoupling SparseCoupling::random(size_t nodes, double mean_degree, uint64_t seed,
+                                      double weight) {
+    if (mean_degree < 0.0) {
+        throw std::invalid_argument("SparseCoupling: mean degree must be non-negative");
+    }
+    std::vector<Edge> edges;
+    if (nodes > 1) {
+        // mt19937_64's output sequence is fixed by the standard, so the graph
+        // is reproducible across platforms (distributions are not)
+        std::mt19937_64 rng(seed);
+        size_t count = static_cast<size_t>(std::llround(0.5 * mean_degree * static_cast<double>(nodes)));
+        edges.reserve(count);
+        while (edges.size() < count) {
+            size_t a = static_cast<size_t>(rng() % nodes);
+            size_t b = static_cast<size_t>(rng() % nodes);
+            if (a != b) edges.push_back({a, b, weight});
+        }
+    }
+    return fromEdges(nodes, edges, true);
+}
+
+void SparseCoupling::normalizeRows() {
+    for (size_t i = 0; i < nodes_; ++i) {
+        size_t d = degree(i);
+        if (d == 0) continue;
+        double inv = 1.0 / static_cast<double>(d);
+        for (uint64_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+            weights_[k] *= inv;
+        }
+    }
+}
+
+void SparseCoupling::multiply(const double* x, double* y, parallel::Executor* pool) const {
+    parallel::parallelFor(pool, 0, nodes_, SPMV_GRAIN, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            double sum = 0.0;
+            for (uint64_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+                sum += weights_[k] * x[columns_[k]];
+            }
+            y[i] = sum;
+        }
+    });
+}
+
+void SparseCoupling::multiply2(const double* x1, const double* x2, double* y1, double* y2,
+                               parallel::Executor* pool) const {
+    parallel::parallelFor(pool, 0, nodes_, SPMV_GRAIN, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            double sum1 = 0.0;
+            double sum2 = 0.0;
+            for (uint64_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k) {
+                uint32_t j = columns_[k];
+                sum1 += weights_[k] * x1[j];
+                sum2 += weights_[k] * x2[j];
+            }
+            y1[i] = sum1;
+            y2[i] = sum2;
+        }
+    });
+}
+
+// ============================================================================
+// System2Network Implementation
+// ============================================================================
+
+System2Network::System2Network(SparseCoupling coupling, double strength)
+    : coupling_(std::move(coupling))
+    , strength_(strength)
+    , phase_(coupling_.size(), 0.0)
+    , rate_(coupling_.size(), 0.1)
+    , universal_(coupling_.size(), 0.5)
+    , particular_(coupling_.size(), 0.5)
+    , cycles_(coupling_.size(), 0)
+    , sin_(coupling_.size(), 0.0)
+    , cos_(coupling_.size(), 1.0)
+    , sum_sin_(coupling_.size(), 0.0)
+    , sum_cos_(coupling_.size(), 0.0) {}
+
+System2Network System2Network::fromSystems(const std::vector<system2::System2>& systems,
+                                           SparseCoupling coupling, double strength) {
+    if (systems.size() != coupling.size()) {
+        throw std::invalid_argument("System2Network: system count does not match coupling size");
+    }
+    System2Network net(std::move(coupling), strength);
+    for (size_t i = 0; i < systems.size(); ++i) {
+        const auto& sys = systems[i];
+        net.rate_[i] = sys.transposition().rate();
+        net.phase_[i] = sys.transposition().phase();
+        net.cycles_[i] = sys.transposition().cycleCount();
+        net.universal_[i] = sys.universalCenter().intensity();
+        net.particular_[i] = sys.particularCenter().intensity();
+    }
+    net.refreshTrig(0, net.size());
+    return net;
+}
+
+void System2Network::setPhase(size_t i, double phase) {
+    if (i >= size()) {
+        throw std::out_of_range("System2Network: dyad index out of range");
+    }
+    phase = std::fmod(phase, TWO_PI);
+    if (phase < 0.0) phase += TWO_PI;
+    phase_[i] = phase;
+    refreshTrig(i, i + 1);
+}
+
+void System2Network::setIntensities(size_t i, double universal, double particular) {
+    if (i >= size()) {
+        throw std::out_of_range("System2Network: dyad index out of range");
+    }
+    universal = std::clamp(universal, 0.0, 1.0);
+    particular = std::clamp(particular, 0.0, 1.0);
+    double total = universal + particular;
+    if (total > 1e-10) {
+        universal /= total;
+        particular /= total;
+    }
+    universal_[i] = universal;
+    particular_[i] = particular;
+}
+
+double System2Network::coalescence(size_t i) const {
+    if (mode(i) != system2::Mode::SUBJECTIVE) return 0.0;
+    return std::sqrt(universal_[i] * particular_[i]);
+}
+
+void System2Network::refreshTrig(size_t lo, size_t hi) {
+    if (hi > lo) {
+        fastmath::sincos(phase_.data() + lo, sin_.data() + lo, cos_.data() + lo, hi - lo,
+                         accuracy_);
+    }
+}
+
+void System2Network::step(double dt) {
+    COSMIC_TRACE_SCOPE_CAT("System2Network::step", "simulation");
+    const size_t n = size();
+    const bool coupled = strength_ != 0.0 && coupling_.nonZeros() > 0;
+
+    // Neighbour sums S = A sin θ and C = A cos θ from the pre-step phases
+    if (coupled) {
+        coupling_.multiply2(sin_.data(), cos_.data(), sum_sin_.data(), sum_cos_.data(), pool_);
+    }
+
+    parallel::parallelFor(pool_, 0, n, GRAIN, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            double velocity = rate_[i];
+            if (coupled) {
+                // Σⱼ wᵢⱼ sin(θⱼ − θᵢ) = cos θᵢ Sᵢ − sin θᵢ Cᵢ
+                velocity += strength_ * (cos_[i] * sum_sin_[i] - sin_[i] * sum_cos_[i]);
+            }
+            double phase = phase_[i] + velocity * dt;
+            while (phase >= TWO_PI) {
+                phase -= TWO_PI;
+                cycles_[i]++;
+            }
+            while (phase < 0.0) {
+                phase += TWO_PI;
+                cycles_[i]--;
+            }
+            phase_[i] = phase;
+        }
+        fastmath::sincos(phase_.data() + lo, sin_.data() + lo, cos_.data() + lo, hi - lo,
+                         accuracy_);
+    });
+
+    time_ += dt;
+}
+
+OrderParameters System2Network::orderParameters() const {
+    OrderParameters result;
+    const size_t n = size();
+    if (n == 0) return result;
+
+    struct Partial {
+        double sum_cos = 0.0;
+        double sum_sin = 0.0;
+        double sum_coalescence = 0.0;
+        size_t objective = 0;
+    };
+
+    Partial total = parallel::parallelReduce(
+        pool_, 0, n, GRAIN, Partial{},
+        [this](size_t lo, size_t hi) {
+            Partial p;
+            for (size_t i = lo; i < hi; ++i) {
+                p.sum_cos += cos_[i];
+                p.sum_sin += sin_[i];
+                if (mode(i) == system2::Mode::OBJECTIVE) {
+                    p.objective++;
+                } else {
+                    p.sum_coalescence += std::sqrt(universal_[i] * particular_[i]);
+                }
+            }
+            return p;
+        },
+        [](const Partial& a, const Partial& b) {
+            Partial c;
+            c.sum_cos = a.sum_cos + b.sum_cos;
+            c.sum_sin = a.sum_sin + b.sum_sin;
+            c.sum_coalescence = a.sum_coalescence + b.sum_coalescence;
+            c.objective = a.objective + b.objective;
+            return c;
+        });
+
+    double inv_n = 1.0 / static_cast<double>(n);
+    double mean_cos = total.sum_cos * inv_n;
+    double mean_sin = total.sum_sin * inv_n;
+    result.coherence = std::sqrt(mean_cos * mean_cos + mean_sin * mean_sin);
+    result.mean_phase = std::atan2(mean_sin, mean_cos);
+    result.objective_fraction = static_cast<double>(total.objective) * inv_n;
+    result.mode_synchrony = std::max(result.objective_fraction, 1.0 - result.objective_fraction);
+    result.mean_objective_weight = 0.5 * (1.0 + mean_cos);
+    result.mean_coalescence = total.sum_coalescence * inv_n;
+    return result;
+}
+
+System2Network::State System2Network::state() const {
+    State s;
+    s.coupling = coupling_;
+    s.strength = strength_;
+    s.phase = phase_;
+    s.rate = rate_;
+    s.universal = universal_;
+    s.particular = particular_;
+    s.cycles = cycles_;
+    s.time = time_;
+    return s;
+}
+
+void System2Network::restore(State s) {
+    const size_t n = s.coupling.size();
+    if (s.phase.size() != n || s.rate.size() != n || s.universal.size() != n ||
+        s.particular.size() != n || s.cycles.size() != n) {
+        throw std::invalid_argument("System2Network: state arrays do not match coupling size");
+    }
+    coupling_ = std::move(s.coupling);
+    strength_ = s.strength;
+    phase_ = std::move(s.phase);
+    rate_ = std::move(s.rate);
+    universal_ = std::move(s.universal);
+    particular_ = std::move(s.particular);
+    cycles_ = std::move(s.cycles);
+    time_ = s.time;
+    sin_.assign(n, 0.0);
+    cos_.assign(n, 0.0);
+    sum_sin_.assign(n, 0.0);
+    sum_cos_.assign(n, 0.0);
+    refreshTrig(0, n);
+}
+
+} // namespace network
+} // namespace cosmic
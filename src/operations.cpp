@@ -4,6 +4,9 @@
  */
 
 #include "cosmic/operations.hpp"
+#include "cosmic/memory.hpp"
+#include "cosmic/metrics.hpp"
+#include "cosmic/tracing.hpp"
 #include <sstream>
 #include <algorithm>
 #include <cmath>
@@ -549,8 +552,31 @@ std::string CreativeProcess::stateDescription() const {
 // Serializer Implementation
 // ============================================================================
 
+namespace {
+
+// Serializers call each other; output is counted once, by the outermost call
+thread_local int serializer_depth = 0;
+
+struct SerializerCall {
+    SerializerCall() { ++serializer_depth; }
+    ~SerializerCall() { --serializer_depth; }
+
+    std::string finish(std::string out) const {
+        if (serializer_depth == 1) {
+            COSMIC_METRIC_COUNT("cosmic_serialized_bytes_total",
+                                "Bytes of JSON and DOT produced by the Serializer", out.size());
+        }
+        return out;
+    }
+};
+
+} // namespace
+
 std::string Serializer::toJSON(const System& system) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("Serializer::toJSON(System)", "serializer");
+    COSMIC_METRIC_TIMER("Serializer::toJSON(System)");
+    SerializerCall call;
+    memory::OutputStream ss(memory::Subsystem::SERIALIZER);
     ss << "{\n";
     ss << "  \"level\": " << system.level() << ",\n";
     ss << "  \"name\": \"" << system.name() << "\",\n";
@@ -572,11 +598,14 @@ std::string Serializer::toJSON(const System& system) {
     }
     
     ss << "\n}";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string Serializer::toJSON(const Term& term) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("Serializer::toJSON(Term)", "serializer");
+    COSMIC_METRIC_TIMER("Serializer::toJSON(Term)");
+    SerializerCall call;
+    memory::OutputStream ss(memory::Subsystem::SERIALIZER);
     ss << "{\n";
     ss << "  \"name\": \"" << term.name() << "\"";
     
@@ -599,11 +628,14 @@ std::string Serializer::toJSON(const Term& term) {
     }
     
     ss << "\n}";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string Serializer::toJSON(const Enneagram& ennea) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("Serializer::toJSON(Enneagram)", "serializer");
+    COSMIC_METRIC_TIMER("Serializer::toJSON(Enneagram)");
+    SerializerCall call;
+    memory::OutputStream ss(memory::Subsystem::SERIALIZER);
     ss << "{\n";
     ss << "  \"name\": \"" << ennea.name() << "\",\n";
     ss << "  \"positions\": {\n";
@@ -622,13 +654,16 @@ std::string Serializer::toJSON(const Enneagram& ennea) {
     }
     
     ss << "  }\n}";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string Serializer::hierarchyToJSON(SystemPtr root) {
+    COSMIC_TRACE_SCOPE_CAT("Serializer::hierarchyToJSON", "serializer");
+    COSMIC_METRIC_TIMER("Serializer::hierarchyToJSON");
+    SerializerCall call;
     if (!root) return "null";
     
-    std::ostringstream ss;
+    memory::OutputStream ss(memory::Subsystem::SERIALIZER);
     ss << "{\n";
     ss << "  \"system\": " << toJSON(*root);
     
@@ -643,11 +678,14 @@ std::string Serializer::hierarchyToJSON(SystemPtr root) {
     }
     
     ss << "\n}";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string Serializer::toDOT(const System& system) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("Serializer::toDOT(System)", "serializer");
+    COSMIC_METRIC_TIMER("Serializer::toDOT(System)");
+    SerializerCall call;
+    memory::OutputStream ss(memory::Subsystem::SERIALIZER);
     ss << "digraph System" << system.level() << " {\n";
     ss << "  label=\"" << system.name() << "\";\n";
     ss << "  node [shape=ellipse];\n";
@@ -673,11 +711,14 @@ std::string Serializer::toDOT(const System& system) {
     }
     
     ss << "}\n";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string Serializer::toDOT(const Enneagram& ennea) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("Serializer::toDOT(Enneagram)", "serializer");
+    COSMIC_METRIC_TIMER("Serializer::toDOT(Enneagram)");
+    SerializerCall call;
+    memory::OutputStream ss(memory::Subsystem::SERIALIZER);
     ss << "digraph Enneagram {\n";
     ss << "  label=\"" << ennea.name() << "\";\n";
     ss << "  node [shape=circle];\n";
@@ -704,11 +745,14 @@ std::string Serializer::toDOT(const Enneagram& ennea) {
     ss << "  p7 -> p1 [color=blue];\n";
     
     ss << "}\n";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 std::string Serializer::hierarchyToDOT(SystemPtr root) {
-    std::ostringstream ss;
+    COSMIC_TRACE_SCOPE_CAT("Serializer::hierarchyToDOT", "serializer");
+    COSMIC_METRIC_TIMER("Serializer::hierarchyToDOT");
+    SerializerCall call;
+    memory::OutputStream ss(memory::Subsystem::SERIALIZER);
     ss << "digraph SystemHierarchy {\n";
     ss << "  rankdir=TB;\n";
     ss << "  node [shape=box];\n";
@@ -733,7 +777,7 @@ std::string Serializer::hierarchyToDOT(SystemPtr root) {
     addEdges(root);
     
     ss << "}\n";
-    return ss.str();
+    return call.finish(ss.str());
 }
 
 } // namespace ops
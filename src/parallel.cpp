@@ -0,0 +1,265 @@
+/**
+ * @file parallel.cpp
+ * @brief Implementation of the executor interface, thread pool and task groups
+ */
+
+#include "cosmic/parallel.hpp"
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+namespace cosmic {
+namespace parallel {
+
+// ============================================================================
+// Executor Implementation
+// ============================================================================
+
+void Executor::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    // Helpers that are dequeued after the loop has finished only touch the
+    // shared counters, which they keep alive; they never call the task.
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::exception_ptr error;
+    };
+    auto shared = std::make_shared<Shared>();
+    const auto* body = &task;
+
+    auto drain = [shared, body, count] {
+        size_t finished = 0;
+        for (size_t i = shared->next.fetch_add(1); i < count; i = shared->next.fetch_add(1)) {
+            try {
+                (*body)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                if (!shared->error) shared->error = std::current_exception();
+            }
+            ++finished;
+        }
+        if (finished > 0 && shared->done.fetch_add(finished) + finished == count) {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            shared->cv.notify_all();
+        }
+    };
+
+    size_t helpers = std::min(concurrency(), count - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(drain);
+    }
+    drain();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->cv.wait(lock, [&shared, count] { return shared->done.load() == count; });
+    if (shared->error) {
+        std::rethrow_exception(shared->error);
+    }
+}
+
+// ============================================================================
+// ThreadPool Implementation
+// ============================================================================
+
+namespace {
+
+// Identifies the pool and worker the current thread belongs to
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+    }
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t index = current_pool == this
+        ? current_worker
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.fetch_add(1);
+    }
+    cv_.notify_one();
+}
+
+bool ThreadPool::take(size_t index, std::function<void()>& task) {
+    // Own deque first, newest task
+    {
+        WorkQueue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    // Steal the oldest task from another worker
+    for (size_t k = 1; k < queues_.size(); ++k) {
+        WorkQueue& victim = *queues_[(index + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending_.fetch_sub(1);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    if (pending_.load() <= 0) return false;
+    // A worker starts from its own deque; any other thread steals
+    size_t index = current_pool == this ? current_worker : 0;
+    std::function<void()> task;
+    if (!take(index, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    current_pool = this;
+    current_worker = index;
+    for (;;) {
+        std::function<void()> task;
+        if (take(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() <= 0) return;
+    }
+}
+
+// ============================================================================
+// TaskGroup Implementation
+// ============================================================================
+
+struct TaskGroup::State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t outstanding = 0;
+    std::exception_ptr error;
+};
+
+TaskGroup::TaskGroup(Executor* executor)
+    : executor_(executor), state_(std::make_shared<State>()) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // Reported only through an explicit wait()
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    if (!executor_) {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (!state_->error) state_->error = std::current_exception();
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        ++state_->outstanding;
+    }
+    auto state = state_;
+    executor_->submit([state, task = std::move(task)] {
+        std::exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (error && !state->error) state->error = error;
+        if (--state->outstanding == 0) state->cv.notify_all();
+    });
+}
+
+void TaskGroup::wait() {
+    if (executor_) {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                if (state_->outstanding == 0) break;
+            }
+            // Nothing left to help with: the group's tasks are all running
+            if (!executor_->runPendingTask()) {
+                std::unique_lock<std::mutex> lock(state_->mutex);
+                state_->cv.wait(lock, [this] { return state_->outstanding == 0; });
+                break;
+            }
+        }
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        std::swap(error, state_->error);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+// ============================================================================
+// Default Executor
+// ============================================================================
+
+namespace {
+
+std::atomic<Executor*> installed_executor{nullptr};
+
+} // namespace
+
+Executor& defaultExecutor() {
+    if (Executor* installed = installed_executor.load(std::memory_order_acquire)) {
+        return *installed;
+    }
+    // Leaked on purpose: workers must not be joined during static destruction
+    static ThreadPool* builtin = new ThreadPool();
+    return *builtin;
+}
+
+void setDefaultExecutor(Executor* executor) {
+    installed_executor.store(executor, std::memory_order_release);
+}
+
+} // namespace parallel
+} // namespace cosmic
@@ -0,0 +1,195 @@
+/**
+ * @file population.cpp
+ * @brief Implementation of batched loon populations
+ */
+
+#include "cosmic/population.hpp"
+#include "cosmic/tracing.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace cosmic {
+namespace population {
+
+namespace {
+
+// Independent partial sums per lane shorten the reduction's dependency
+// chain while fixing its order (and therefore its result)
+constexpr size_t LANES = 4;
+
+struct Flow {
+    double efflux = 0.0;
+    double reflux = 0.0;
+};
+
+} // namespace
+
+// ============================================================================
+// LoonPopulation Implementation
+// ============================================================================
+
+LoonPopulation::LoonPopulation(size_t count, double enhancement_factor) {
+    system1::LoonAnalogy prototype;
+    prototype.setEnhancementFactor(enhancement_factor);
+    auto s = prototype.state();
+    intensity_.assign(count, s.system.center_intensity);
+    efflux_.assign(count, s.system.efflux_rate);
+    reflux_.assign(count, s.system.reflux_rate);
+    factor_.assign(count, s.enhancement_factor);
+    accumulated_efflux_.assign(count, s.system.accumulated_efflux);
+    accumulated_reflux_.assign(count, s.system.accumulated_reflux);
+}
+
+LoonPopulation LoonPopulation::fromLoons(const std::vector<system1::LoonAnalogy>& loons) {
+    LoonPopulation population(loons.size());
+    for (size_t i = 0; i < loons.size(); ++i) {
+        auto s = loons[i].state();
+        if (i == 0) {
+            population.time_ = s.system.time;
+        } else if (s.system.time != population.time_) {
+            throw std::invalid_argument("LoonPopulation: loons are at different times");
+        }
+        population.intensity_[i] = s.system.center_intensity;
+        population.efflux_[i] = s.system.efflux_rate;
+        population.reflux_[i] = s.system.reflux_rate;
+        population.factor_[i] = s.enhancement_factor;
+        population.accumulated_efflux_[i] = s.system.accumulated_efflux;
+        population.accumulated_reflux_[i] = s.system.accumulated_reflux;
+    }
+    return population;
+}
+
+void LoonPopulation::setBaseRefluxRate(size_t i, double rate) {
+    reflux_.at(i) = rate;
+}
+
+void LoonPopulation::setEnhancementFactor(size_t i, double factor) {
+    factor_.at(i) = factor;
+}
+
+double LoonPopulation::skyFeed() const {
+    if (intensity_.empty()) return 0.0;
+    return coupling_ * sky_ / static_cast<double>(intensity_.size());
+}
+
+double LoonPopulation::communicativeBalance(size_t i) const {
+    double e = efflux_[i];
+    double r = refluxRate(i);
+    if (e + r < 1e-10) return 0.0;
+    return (e - r) / (e + r);
+}
+
+system1::LoonAnalogy LoonPopulation::loon(size_t i) const {
+    system1::LoonAnalogy analogy;
+    auto s = analogy.state();
+    s.system.center_intensity = intensity_.at(i);
+    s.system.efflux_rate = efflux_[i];
+    s.system.reflux_rate = reflux_[i];
+    s.system.accumulated_efflux = accumulated_efflux_[i];
+    s.system.accumulated_reflux = accumulated_reflux_[i];
+    s.system.time = time_;
+    s.enhancement_factor = factor_[i];
+    analogy.restore(s);
+    return analogy;
+}
+
+void LoonPopulation::communicate(double dt) {
+    COSMIC_TRACE_SCOPE_CAT("LoonPopulation::communicate", "simulation");
+    const size_t n = size();
+    const double feed = skyFeed();
+    const double transfer = system1::System1::TRANSFER_COEFFICIENT;
+
+    double* intensity = intensity_.data();
+    double* efflux = efflux_.data();
+    const double* base = reflux_.data();
+    const double* factor = factor_.data();
+    double* acc_efflux = accumulated_efflux_.data();
+    double* acc_reflux = accumulated_reflux_.data();
+
+    // Same arithmetic, in the same order, as LoonAnalogy::communicate()
+    // followed by System1::step(); feed is exactly 0 without coupling. The
+    // update loop is element-wise and vectorizes; the flow into the sky is
+    // summed afterwards in fixed lane order.
+    Flow flow = parallel::parallelReduce(
+        pool_, 0, n, GRAIN, Flow{},
+        [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                double r = base[i] + feed;
+                double e = (r * dt) * factor[i];
+                double out = e * dt;
+                double in = r * dt;
+                acc_efflux[i] += out;
+                acc_reflux[i] += in;
+                double change = (out - in) * transfer;
+                intensity[i] -= std::abs(e - r) < 1e-10 ? 0.0 : change;
+                efflux[i] = e;
+            }
+
+            double sum_e[LANES] = {};
+            double sum_r[LANES] = {};
+            size_t i = lo;
+            for (; i + LANES <= hi; i += LANES) {
+                for (size_t l = 0; l < LANES; ++l) {
+                    sum_e[l] += efflux[i + l] * dt;
+                    sum_r[l] += (base[i + l] + feed) * dt;
+                }
+            }
+            for (; i < hi; ++i) {
+                sum_e[(i - lo) % LANES] += efflux[i] * dt;
+                sum_r[(i - lo) % LANES] += (base[i] + feed) * dt;
+            }
+            Flow f;
+            for (size_t l = 0; l < LANES; ++l) {
+                f.efflux += sum_e[l];
+                f.reflux += sum_r[l];
+            }
+            return f;
+        },
+        [](const Flow& a, const Flow& b) {
+            return Flow{a.efflux + b.efflux, a.reflux + b.reflux};
+        });
+
+    sky_ += (flow.efflux - flow.reflux) - dissipation_ * sky_ * dt;
+    time_ += dt;
+}
+
+Totals LoonPopulation::totals() const {
+    Totals result;
+    const size_t n = size();
+    if (n == 0) return result;
+
+    const double feed = skyFeed();
+    struct Partial {
+        double intensity = 0.0;
+        double efflux = 0.0;
+        double reflux = 0.0;
+        double balance = 0.0;
+    };
+    Partial total = parallel::parallelReduce(
+        pool_, 0, n, GRAIN, Partial{},
+        [&](size_t lo, size_t hi) {
+            Partial p;
+            for (size_t i = lo; i < hi; ++i) {
+                double e = efflux_[i];
+                double r = reflux_[i] + feed;
+                p.intensity += intensity_[i];
+                p.efflux += e;
+                p.reflux += r;
+                p.balance += e + r < 1e-10 ? 0.0 : (e - r) / (e + r);
+            }
+            return p;
+        },
+        [](const Partial& a, const Partial& b) {
+            return Partial{a.intensity + b.intensity, a.efflux + b.efflux,
+                           a.reflux + b.reflux, a.balance + b.balance};
+        });
+
+    result.intensity = total.intensity;
+    result.efflux = total.efflux;
+    result.reflux = total.reflux;
+    result.mean_balance = total.balance / static_cast<double>(n);
+    return result;
+}
+
+} // namespace population
+} // namespace cosmic
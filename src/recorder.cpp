@@ -0,0 +1,813 @@
+/**
+ * @file recorder.cpp
+ * @brief Implementation of the columnar trace recorder
+ */
+
+#include "cosmic/recorder.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cosmic {
+namespace recorder {
+
+namespace {
+
+constexpr char FILE_MAGIC[4] = {'C', 'S', 'T', 'R'};
+constexpr uint32_t FILE_VERSION = 1;
+constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843;  // "CHNK"
+
+uint64_t toBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int leadingZeros(uint64_t x) {
+    int n = 0;
+    for (uint64_t mask = 1ULL << 63; mask && !(x & mask); mask >>= 1) ++n;
+    return n;
+}
+
+int trailingZeros(uint64_t x) {
+    int n = 0;
+    for (uint64_t mask = 1; mask && !(x & mask); mask <<= 1) ++n;
+    return n;
+}
+
+uint64_t zigzag(uint64_t v) {
+    return (v << 1) ^ (0 - (v >> 63));
+}
+
+uint64_t unzigzag(uint64_t v) {
+    return (v >> 1) ^ (0 - (v & 1));
+}
+
+template<typename T>
+void put(std::vector<uint8_t>& out, T value) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+T get(const uint8_t* data, size_t size, size_t& pos) {
+    if (pos + sizeof(T) > size) {
+        throw std::runtime_error("Trace file is truncated");
+    }
+    T value;
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+std::vector<uint8_t> encodeHeader(const std::vector<ColumnSpec>& columns, size_t rows_per_chunk) {
+    std::vector<uint8_t> out(FILE_MAGIC, FILE_MAGIC + 4);
+    put<uint32_t>(out, FILE_VERSION);
+    put<uint32_t>(out, static_cast<uint32_t>(columns.size()));
+    put<uint32_t>(out, static_cast<uint32_t>(rows_per_chunk));
+    for (const auto& col : columns) {
+        if (col.name.size() > 255) {
+            throw std::invalid_argument("Column names are limited to 255 bytes");
+        }
+        out.push_back(static_cast<uint8_t>(col.encoding));
+        out.push_back(static_cast<uint8_t>(col.name.size()));
+        out.insert(out.end(), col.name.begin(), col.name.end());
+    }
+    return out;
+}
+
+std::vector<ColumnSpec> decodeHeader(const uint8_t* data, size_t size, size_t& pos) {
+    if (size < 4 || std::memcmp(data, FILE_MAGIC, 4) != 0) {
+        throw std::runtime_error("Not a cosmic trace file");
+    }
+    pos = 4;
+    if (get<uint32_t>(data, size, pos) != FILE_VERSION) {
+        throw std::runtime_error("Unsupported trace file version");
+    }
+    uint32_t count = get<uint32_t>(data, size, pos);
+    get<uint32_t>(data, size, pos);  // rows per chunk (informational)
+    std::vector<ColumnSpec> columns;
+    for (uint32_t i = 0; i < count; ++i) {
+        ColumnSpec col;
+        col.encoding = static_cast<Encoding>(get<uint8_t>(data, size, pos));
+        uint8_t len = get<uint8_t>(data, size, pos);
+        if (pos + len > size) {
+            throw std::runtime_error("Trace file is truncated");
+        }
+        col.name.assign(reinterpret_cast<const char*>(data + pos), len);
+        pos += len;
+        columns.push_back(col);
+    }
+    return columns;
+}
+
+/// Parse the row group starting at @p pos and advance past it
+ChunkView decodeChunk(const uint8_t* data, size_t size, size_t& pos, size_t column_count) {
+    if (get<uint32_t>(data, size, pos) != CHUNK_MAGIC) {
+        throw std::runtime_error("Corrupt trace file (bad row group marker)");
+    }
+    ChunkView view;
+    view.rows = get<uint32_t>(data, size, pos);
+    view.t_min = get<double>(data, size, pos);
+    view.t_max = get<double>(data, size, pos);
+    for (size_t c = 0; c < column_count; ++c) {
+        view.sizes.push_back(get<uint32_t>(data, size, pos));
+    }
+    for (size_t c = 0; c < column_count; ++c) {
+        if (pos + view.sizes[c] > size) {
+            throw std::runtime_error("Trace file is truncated");
+        }
+        view.columns.push_back(data + pos);
+        pos += view.sizes[c];
+    }
+    return view;
+}
+
+size_t findColumn(const std::vector<ColumnSpec>& columns, const std::string& name) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].name == name) return i;
+    }
+    throw std::out_of_range("Unknown trace column: " + name);
+}
+
+bool sameSchema(const std::vector<ColumnSpec>& a, const std::vector<ColumnSpec>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].name != b[i].name || a[i].encoding != b[i].encoding) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Bit-level Encoders
+// ============================================================================
+
+void BitWriter::write(uint64_t value, int count) {
+    while (count > 0) {
+        if (free_bits_ == 0) {
+            out_.push_back(0);
+            free_bits_ = 8;
+        }
+        int take = std::min(count, free_bits_);
+        uint8_t part = static_cast<uint8_t>((value >> (count - take)) & ((1u << take) - 1));
+        out_.back() |= static_cast<uint8_t>(part << (free_bits_ - take));
+        free_bits_ -= take;
+        count -= take;
+    }
+}
+
+uint64_t BitReader::read(int count) {
+    uint64_t value = 0;
+    while (count > 0) {
+        size_t byte = bit_pos_ >> 3;
+        if (byte >= size_) {
+            throw std::out_of_range("Read past the end of an encoded column");
+        }
+        int offset = static_cast<int>(bit_pos_ & 7);
+        int avail = 8 - offset;
+        int take = std::min(count, avail);
+        uint64_t part = (data_[byte] >> (avail - take)) & ((1u << take) - 1);
+        value = (value << take) | part;
+        bit_pos_ += take;
+        count -= take;
+    }
+    return value;
+}
+
+void XorEncoder::append(double value) {
+    uint64_t bits = toBits(value);
+    if (first_) {
+        bits_.write(bits, 64);
+        prev_ = bits;
+        first_ = false;
+        return;
+    }
+
+    uint64_t x = bits ^ prev_;
+    if (x == 0) {
+        bits_.writeBit(false);
+    } else {
+        bits_.writeBit(true);
+        int leading = leadingZeros(x);
+        int trailing = trailingZeros(x);
+        if (prev_leading_ >= 0 && leading >= prev_leading_ && trailing >= prev_trailing_) {
+            // Meaningful bits fit in the previous window
+            bits_.writeBit(false);
+            bits_.write(x >> prev_trailing_, 64 - prev_leading_ - prev_trailing_);
+        } else {
+            int significant = 64 - leading - trailing;
+            bits_.writeBit(true);
+            bits_.write(static_cast<uint64_t>(leading), 6);
+            bits_.write(static_cast<uint64_t>(significant - 1), 6);
+            bits_.write(x >> trailing, significant);
+            prev_leading_ = leading;
+            prev_trailing_ = trailing;
+        }
+    }
+    prev_ = bits;
+}
+
+double XorDecoder::next() {
+    if (first_) {
+        prev_ = bits_.read(64);
+        first_ = false;
+        return fromBits(prev_);
+    }
+
+    if (bits_.readBit()) {
+        if (bits_.readBit()) {
+            prev_leading_ = static_cast<int>(bits_.read(6));
+            int significant = static_cast<int>(bits_.read(6)) + 1;
+            prev_trailing_ = 64 - prev_leading_ - significant;
+        }
+        int significant = 64 - prev_leading_ - prev_trailing_;
+        prev_ ^= bits_.read(significant) << prev_trailing_;
+    }
+    return fromBits(prev_);
+}
+
+void DeltaEncoder::append(double value) {
+    uint64_t bits = toBits(value);
+    if (count_++ == 0) {
+        bits_.write(bits, 64);
+        prev_ = bits;
+        return;
+    }
+
+    uint64_t delta = bits - prev_;
+    uint64_t zz = zigzag(delta - prev_delta_);
+    if (zz == 0) {
+        bits_.write(0b0, 1);
+    } else if (zz < (1ULL << 7)) {
+        bits_.write(0b10, 2);
+        bits_.write(zz, 7);
+    } else if (zz < (1ULL << 14)) {
+        bits_.write(0b110, 3);
+        bits_.write(zz, 14);
+    } else if (zz < (1ULL << 24)) {
+        bits_.write(0b1110, 4);
+        bits_.write(zz, 24);
+    } else {
+        bits_.write(0b1111, 4);
+        bits_.write(zz, 64);
+    }
+    prev_delta_ = delta;
+    prev_ = bits;
+}
+
+double DeltaDecoder::next() {
+    if (count_++ == 0) {
+        prev_ = bits_.read(64);
+        return fromBits(prev_);
+    }
+
+    uint64_t zz = 0;
+    if (bits_.readBit()) {
+        if (!bits_.readBit()) {
+            zz = bits_.read(7);
+        } else if (!bits_.readBit()) {
+            zz = bits_.read(14);
+        } else if (!bits_.readBit()) {
+            zz = bits_.read(24);
+        } else {
+            zz = bits_.read(64);
+        }
+    }
+    prev_delta_ += unzigzag(zz);
+    prev_ += prev_delta_;
+    return fromBits(prev_);
+}
+
+// ============================================================================
+// TraceRecorder Implementation
+// ============================================================================
+
+TraceRecorder::TraceRecorder(std::vector<ColumnSpec> columns, size_t rows_per_chunk)
+    : columns_(std::move(columns)), rows_per_chunk_(rows_per_chunk) {
+    if (columns_.empty() || columns_[0].name != "time") {
+        throw std::invalid_argument("The first trace column must be \"time\"");
+    }
+    if (rows_per_chunk_ == 0) {
+        throw std::invalid_argument("Rows per chunk must be positive");
+    }
+    if (sameSchema(columns_, system1Columns())) {
+        schema_ = Schema::System1;
+    } else if (sameSchema(columns_, system2Columns())) {
+        schema_ = Schema::System2;
+    }
+    pending_.resize(columns_.size());
+    for (auto& col : pending_) {
+        col.reserve(rows_per_chunk_);
+    }
+}
+
+TraceRecorder::~TraceRecorder() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; an unwritable file loses the tail
+    }
+}
+
+TraceRecorder::TraceRecorder(TraceRecorder&&) noexcept = default;
+
+TraceRecorder& TraceRecorder::operator=(TraceRecorder&& other) noexcept {
+    if (this == &other) return *this;
+    // Finish this recorder's file before taking over the other one's
+    try {
+        close();
+    } catch (...) {
+        // As in the destructor, an unwritable file loses the tail
+    }
+    columns_ = std::move(other.columns_);
+    schema_ = other.schema_;
+    rows_per_chunk_ = other.rows_per_chunk_;
+    pending_ = std::move(other.pending_);
+    chunks_ = std::move(other.chunks_);
+    file_ = std::move(other.file_);
+    row_count_ = other.row_count_;
+    compressed_bytes_ = other.compressed_bytes_;
+    return *this;
+}
+
+std::vector<ColumnSpec> TraceRecorder::system1Columns() {
+    return {
+        {"time", Encoding::DeltaOfDelta},
+        {"center_intensity", Encoding::Xor},
+        {"net_flow", Encoding::Xor},
+        {"accumulated_efflux", Encoding::Xor},
+        {"accumulated_reflux", Encoding::Xor},
+        {"communicative_balance", Encoding::Xor}
+    };
+}
+
+std::vector<ColumnSpec> TraceRecorder::system2Columns() {
+    return {
+        {"time", Encoding::DeltaOfDelta},
+        {"universal_intensity", Encoding::Xor},
+        {"particular_intensity", Encoding::Xor},
+        {"polarity", Encoding::Xor},
+        {"mode_polarity", Encoding::Xor},
+        {"coalescence", Encoding::Xor},
+        {"mode", Encoding::DeltaOfDelta},
+        {"cycle_count", Encoding::DeltaOfDelta}
+    };
+}
+
+TraceRecorder TraceRecorder::forSystem1(size_t rows_per_chunk) {
+    return TraceRecorder(system1Columns(), rows_per_chunk);
+}
+
+TraceRecorder TraceRecorder::forSystem2(size_t rows_per_chunk) {
+    return TraceRecorder(system2Columns(), rows_per_chunk);
+}
+
+size_t TraceRecorder::columnIndex(const std::string& name) const {
+    return findColumn(columns_, name);
+}
+
+void TraceRecorder::append(const double* values) {
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        pending_[c].push_back(values[c]);
+    }
+    ++row_count_;
+    if (pending_[0].size() >= rows_per_chunk_) {
+        seal();
+    }
+}
+
+void TraceRecorder::append(const std::vector<double>& values) {
+    if (values.size() != columns_.size()) {
+        throw std::invalid_argument("Row width does not match the trace schema");
+    }
+    append(values.data());
+}
+
+void TraceRecorder::record(const system1::System1& system) {
+    if (schema_ != Schema::System1) {
+        throw std::logic_error("Recorder was not created with the System 1 schema");
+    }
+    const auto& iface = system.interface();
+    const double row[] = {
+        system.time(),
+        system.center().intensity(),
+        iface.netFlow(),
+        iface.accumulatedEfflux(),
+        iface.accumulatedReflux(),
+        iface.communicativeBalance()
+    };
+    append(row);
+}
+
+void TraceRecorder::record(const system2::System2& system) {
+    if (schema_ != Schema::System2) {
+        throw std::logic_error("Recorder was not created with the System 2 schema");
+    }
+    const double row[] = {
+        system.time(),
+        system.universalCenter().intensity(),
+        system.particularCenter().intensity(),
+        system.polarity(),
+        system.modePolarity(),
+        system.coalescence().strength(),
+        system.currentMode() == system2::Mode::OBJECTIVE ? 0.0 : 1.0,
+        static_cast<double>(system.transposition().cycleCount())
+    };
+    append(row);
+}
+
+void TraceRecorder::seal() {
+    size_t rows = pending_[0].size();
+    if (rows == 0) return;
+
+    const auto& times = pending_[0];
+    auto bounds = std::minmax_element(times.begin(), times.end());
+
+    MemoryChunk chunk;
+    chunk.rows = rows;
+    chunk.t_min = *bounds.first;
+    chunk.t_max = *bounds.second;
+    chunk.columns.resize(columns_.size());
+
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        auto& out = chunk.columns[c];
+        if (columns_[c].encoding == Encoding::Xor) {
+            XorEncoder enc(out);
+            for (double v : pending_[c]) enc.append(v);
+        } else {
+            DeltaEncoder enc(out);
+            for (double v : pending_[c]) enc.append(v);
+        }
+        compressed_bytes_ += out.size();
+        pending_[c].clear();
+    }
+
+    if (file_) {
+        file_->writeChunk(chunk.rows, chunk.t_min, chunk.t_max, chunk.columns);
+    } else {
+        chunks_.push_back(std::move(chunk));
+    }
+}
+
+void TraceRecorder::flush() {
+    seal();
+}
+
+void TraceRecorder::open(const std::string& path) {
+    if (file_) {
+        throw std::logic_error("A trace file is already open");
+    }
+    file_ = std::make_unique<TraceFileWriter>(path, columns_, rows_per_chunk_);
+    for (const auto& chunk : chunks_) {
+        file_->writeChunk(chunk.rows, chunk.t_min, chunk.t_max, chunk.columns);
+    }
+    chunks_.clear();
+}
+
+void TraceRecorder::close() {
+    if (!file_) return;
+    seal();
+    file_->close();
+    file_.reset();
+}
+
+size_t TraceRecorder::chunkCount() const {
+    return chunks_.size() + (file_ ? file_->views().size() : 0);
+}
+
+std::vector<ChunkView> TraceRecorder::sealedViews() const {
+    std::vector<ChunkView> views = file_ ? file_->views() : std::vector<ChunkView>{};
+    for (const auto& chunk : chunks_) {
+        ChunkView view;
+        view.rows = chunk.rows;
+        view.t_min = chunk.t_min;
+        view.t_max = chunk.t_max;
+        for (const auto& col : chunk.columns) {
+            view.columns.push_back(col.data());
+            view.sizes.push_back(col.size());
+        }
+        views.push_back(std::move(view));
+    }
+    return views;
+}
+
+std::vector<Sample> TraceRecorder::pendingSamples(size_t column, double t0, double t1) const {
+    std::vector<Sample> result;
+    const auto& times = pending_[0];
+    for (size_t i = 0; i < times.size(); ++i) {
+        if (times[i] >= t0 && times[i] <= t1) {
+            result.push_back({times[i], pending_[column][i]});
+        }
+    }
+    return result;
+}
+
+std::vector<Sample> TraceRecorder::scan(const std::string& column, double t0, double t1) const {
+    size_t idx = columnIndex(column);
+    auto result = util::scanChunks(sealedViews(), columns_, idx, t0, t1);
+    auto tail = pendingSamples(idx, t0, t1);
+    result.insert(result.end(), tail.begin(), tail.end());
+    return result;
+}
+
+std::vector<Bucket> TraceRecorder::downsample(const std::string& column, double t0, double t1,
+                                              size_t buckets) const {
+    return util::bucketize(scan(column, t0, t1), t0, t1, buckets);
+}
+
+// ============================================================================
+// TraceFileWriter Implementation
+// ============================================================================
+
+TraceFileWriter::TraceFileWriter(const std::string& path, const std::vector<ColumnSpec>& columns,
+                                 size_t rows_per_chunk)
+    : path_(path), column_count_(columns.size()) {
+    auto header = encodeHeader(columns, rows_per_chunk);
+#ifndef _WIN32
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+#endif
+    reserve(header.size());
+    std::memcpy(data_, header.data(), header.size());
+    size_ = header.size();
+}
+
+TraceFileWriter::~TraceFileWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void TraceFileWriter::reserve(size_t bytes) {
+    if (size_ + bytes <= capacity_) return;
+    size_t capacity = std::max({capacity_ * 2, size_ + bytes, size_t(1) << 20});
+#ifndef _WIN32
+    if (::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+        throw std::runtime_error("Cannot grow trace file: " + path_);
+    }
+    if (data_) {
+        ::munmap(data_, capacity_);
+    }
+    void* mapped = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapped == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("Cannot map trace file: " + path_);
+    }
+    data_ = static_cast<uint8_t*>(mapped);
+#else
+    auto* grown = new uint8_t[capacity];
+    if (data_) {
+        std::memcpy(grown, data_, size_);
+        delete[] data_;
+    }
+    data_ = grown;
+#endif
+    capacity_ = capacity;
+}
+
+void TraceFileWriter::writeChunk(size_t rows, double t_min, double t_max,
+                                 const std::vector<std::vector<uint8_t>>& columns) {
+    std::vector<uint8_t> header;
+    put<uint32_t>(header, CHUNK_MAGIC);
+    put<uint32_t>(header, static_cast<uint32_t>(rows));
+    put<double>(header, t_min);
+    put<double>(header, t_max);
+    size_t payload = 0;
+    for (const auto& col : columns) {
+        put<uint32_t>(header, static_cast<uint32_t>(col.size()));
+        payload += col.size();
+    }
+
+    reserve(header.size() + payload);
+    chunk_offsets_.push_back(size_);
+    std::memcpy(data_ + size_, header.data(), header.size());
+    size_ += header.size();
+    for (const auto& col : columns) {
+        if (!col.empty()) {
+            std::memcpy(data_ + size_, col.data(), col.size());
+        }
+        size_ += col.size();
+    }
+}
+
+std::vector<ChunkView> TraceFileWriter::views() const {
+    std::vector<ChunkView> result;
+    result.reserve(chunk_offsets_.size());
+    for (size_t offset : chunk_offsets_) {
+        size_t pos = offset;
+        result.push_back(decodeChunk(data_, size_, pos, column_count_));
+    }
+    return result;
+}
+
+void TraceFileWriter::close() {
+    if (!data_) return;
+#ifndef _WIN32
+    ::munmap(data_, capacity_);
+    data_ = nullptr;
+    int rc = ::ftruncate(fd_, static_cast<off_t>(size_));
+    ::close(fd_);
+    fd_ = -1;
+    if (rc != 0) {
+        throw std::runtime_error("Cannot finalize trace file: " + path_);
+    }
+#else
+    std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data_), static_cast<std::streamsize>(size_));
+    delete[] data_;
+    data_ = nullptr;
+    if (!out) {
+        throw std::runtime_error("Cannot write trace file: " + path_);
+    }
+#endif
+    chunk_offsets_.clear();
+}
+
+// ============================================================================
+// TraceReader Implementation
+// ============================================================================
+
+TraceReader::TraceReader(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat trace file: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map trace file: " + path);
+        }
+        data_ = static_cast<const uint8_t*>(mapped);
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+#endif
+
+    try {
+        size_t pos = 0;
+        columns_ = decodeHeader(data_, size_, pos);
+        while (pos < size_) {
+            chunks_.push_back(decodeChunk(data_, size_, pos, columns_.size()));
+            row_count_ += chunks_.back().rows;
+        }
+    } catch (...) {
+#ifndef _WIN32
+        if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        throw;
+    }
+}
+
+TraceReader::~TraceReader() {
+#ifndef _WIN32
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+}
+
+size_t TraceReader::columnIndex(const std::string& name) const {
+    return findColumn(columns_, name);
+}
+
+std::vector<Sample> TraceReader::scan(const std::string& column, double t0, double t1) const {
+    return util::scanChunks(chunks_, columns_, columnIndex(column), t0, t1);
+}
+
+std::vector<Bucket> TraceReader::downsample(const std::string& column, double t0, double t1,
+                                            size_t buckets) const {
+    return util::bucketize(scan(column, t0, t1), t0, t1, buckets);
+}
+
+// ============================================================================
+// Utility Functions
+// ============================================================================
+
+namespace util {
+
+std::vector<double> decodeColumn(const uint8_t* data, size_t size, size_t rows,
+                                 Encoding encoding) {
+    std::vector<double> values;
+    values.reserve(rows);
+    if (encoding == Encoding::Xor) {
+        XorDecoder dec(data, size);
+        for (size_t i = 0; i < rows; ++i) values.push_back(dec.next());
+    } else {
+        DeltaDecoder dec(data, size);
+        for (size_t i = 0; i < rows; ++i) values.push_back(dec.next());
+    }
+    return values;
+}
+
+std::vector<Sample> scanChunks(const std::vector<ChunkView>& chunks,
+                               const std::vector<ColumnSpec>& columns,
+                               size_t column, double t0, double t1) {
+    std::vector<Sample> result;
+    if (t1 < t0) return result;
+
+    // Traces recorded with a monotone clock have ordered, disjoint row groups:
+    // binary-search the first candidate and stop at the first group past t1.
+    bool ordered = true;
+    for (size_t i = 1; i < chunks.size() && ordered; ++i) {
+        ordered = chunks[i - 1].t_max <= chunks[i].t_min;
+    }
+
+    size_t begin = 0;
+    if (ordered) {
+        auto it = std::lower_bound(chunks.begin(), chunks.end(), t0,
+            [](const ChunkView& c, double t) { return c.t_max < t; });
+        begin = static_cast<size_t>(it - chunks.begin());
+    }
+
+    for (size_t i = begin; i < chunks.size(); ++i) {
+        const auto& chunk = chunks[i];
+        if (chunk.t_min > t1) {
+            if (ordered) break;
+            continue;
+        }
+        if (chunk.t_max < t0 || chunk.rows == 0) continue;
+
+        auto times = decodeColumn(chunk.columns[0], chunk.sizes[0], chunk.rows,
+                                  columns[0].encoding);
+        auto values = column == 0 ? times
+            : decodeColumn(chunk.columns[column], chunk.sizes[column], chunk.rows,
+                           columns[column].encoding);
+        for (size_t r = 0; r < chunk.rows; ++r) {
+            if (times[r] >= t0 && times[r] <= t1) {
+                result.push_back({times[r], values[r]});
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<Bucket> bucketize(const std::vector<Sample>& samples,
+                              double t0, double t1, size_t buckets) {
+    std::vector<Bucket> result;
+    if (buckets == 0 || t1 < t0) return result;
+
+    double width = (t1 - t0) / static_cast<double>(buckets);
+    result.resize(buckets);
+    for (size_t b = 0; b < buckets; ++b) {
+        result[b].begin = t0 + width * static_cast<double>(b);
+        result[b].end = (b + 1 == buckets) ? t1 : t0 + width * static_cast<double>(b + 1);
+    }
+
+    for (const auto& s : samples) {
+        if (s.time < t0 || s.time > t1) continue;
+        size_t b = width > 0.0 ? static_cast<size_t>((s.time - t0) / width) : 0;
+        b = std::min(b, buckets - 1);
+        auto& bucket = result[b];
+        bucket.min = std::min(bucket.min, s.value);
+        bucket.max = std::max(bucket.max, s.value);
+        bucket.mean += s.value;
+        ++bucket.count;
+    }
+
+    for (auto& bucket : result) {
+        if (bucket.count > 0) {
+            bucket.mean /= static_cast<double>(bucket.count);
+        }
+    }
+    return result;
+}
+
+} // namespace util
+
+} // namespace recorder
+} // namespace cosmic
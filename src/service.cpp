@@ -0,0 +1,768 @@
+/**
+ * @file service.cpp
+ * @brief Term lookup service: protocol, index, epoll server and client
+ */
+
+#include "cosmic/service.hpp"
+#include "cosmic/classify.hpp"
+#include "cosmic/metrics.hpp"
+#include "cosmic/trees.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define COSMIC_HAVE_UNIX_SOCKETS 1
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#define COSMIC_HAVE_EPOLL 1
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace cosmic {
+namespace service {
+
+namespace {
+
+/// Stop reading from a connection while this much output is unsent
+constexpr size_t MAX_PENDING_OUTPUT = 16u << 20;
+
+/// Bytes read per read() call
+constexpr size_t READ_SIZE = 64u << 10;
+
+/// Most input read from one connection before its requests are answered;
+/// the rest waits for the next turn of the event loop
+constexpr size_t MAX_BATCH_INPUT = 4 * READ_SIZE;
+
+/// How long accepting stays paused after running out of descriptors, if no
+/// connection closes first
+constexpr int ACCEPT_RETRY_MS = 100;
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/// Drop the consumed front of a buffer once it is worth the copy
+void compact(std::string& buffer, size_t& offset) {
+    if (offset == buffer.size()) {
+        buffer.clear();
+        offset = 0;
+    } else if (offset > READ_SIZE && offset * 2 > buffer.size()) {
+        buffer.erase(0, offset);
+        offset = 0;
+    }
+}
+
+#ifdef COSMIC_HAVE_UNIX_SOCKETS
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path must be 1-" +
+                                    std::to_string(sizeof(address.sun_path) - 1) + " bytes");
+    }
+    std::memcpy(address.sun_path, path.data(), path.size());
+    return address;
+}
+#endif
+
+#ifdef COSMIC_HAVE_EPOLL
+/// Whether a server accepts connections at @p address (a full backlog counts)
+bool listening(const sockaddr_un& address) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw systemError("socket");
+    bool live = ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0 ||
+                errno == EAGAIN;
+    ::close(fd);
+    return live;
+}
+
+/**
+ * @brief Remove a socket file left behind by a server that has exited
+ * @throws std::runtime_error if @p path is not a socket or a server answers on it
+ */
+void removeStaleSocket(const std::string& path, const sockaddr_un& address) {
+    struct stat info;
+    if (::lstat(path.c_str(), &info) != 0) {
+        if (errno == ENOENT) return;
+        throw systemError("lstat " + path);
+    }
+    if (!S_ISSOCK(info.st_mode)) throw std::runtime_error(path + " exists and is not a socket");
+    if (listening(address)) throw std::runtime_error("A server is already listening on " + path);
+    if (::unlink(path.c_str()) != 0 && errno != ENOENT) throw systemError("unlink " + path);
+}
+#endif
+
+} // namespace
+
+const char* toString(Status status) {
+    switch (status) {
+        case Status::OK: return "ok";
+        case Status::BAD_REQUEST: return "bad-request";
+        case Status::NOT_FOUND: return "not-found";
+        case Status::UNKNOWN_OP: return "unknown-op";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Payload Encoding
+// ============================================================================
+
+void Writer::address(const Address& address) {
+    u8(static_cast<uint8_t>(address.level));
+    u8(static_cast<uint8_t>(address.path.size()));
+    for (uint8_t index : address.path) u8(index);
+}
+
+void Reader::need(size_t bytes) const {
+    if (size_ - offset_ < bytes) throw std::runtime_error("Truncated payload");
+}
+
+uint8_t Reader::u8() {
+    need(1);
+    return static_cast<uint8_t>(data_[offset_++]);
+}
+
+uint32_t Reader::u32() {
+    need(sizeof(uint32_t));
+    uint32_t value;
+    std::memcpy(&value, data_ + offset_, sizeof(value));
+    offset_ += sizeof(value);
+    return value;
+}
+
+std::string Reader::string() {
+    uint32_t size = u32();
+    need(size);
+    std::string value(data_ + offset_, size);
+    offset_ += size;
+    return value;
+}
+
+Address Reader::address() {
+    Address address;
+    address.level = u8();
+    uint8_t count = u8();
+    need(count);
+    address.path.assign(data_ + offset_, data_ + offset_ + count);
+    offset_ += count;
+    return address;
+}
+
+void appendFrame(std::string& out, const Message& message) {
+    uint32_t size = static_cast<uint32_t>(FRAME_HEADER_SIZE - sizeof(uint32_t) + message.payload.size());
+    out.reserve(out.size() + sizeof(uint32_t) + size);
+    out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.append(reinterpret_cast<const char*>(&message.id), sizeof(message.id));
+    out.push_back(static_cast<char>(message.code));
+    out.append(message.payload);
+}
+
+bool takeFrame(std::string& buffer, size_t& offset, Message& message) {
+    size_t available = buffer.size() - offset;
+    if (available < sizeof(uint32_t)) return false;
+    uint32_t size;
+    std::memcpy(&size, buffer.data() + offset, sizeof(size));
+    if (size > MAX_FRAME_SIZE) throw std::runtime_error("Frame too large");
+    if (size < FRAME_HEADER_SIZE - sizeof(uint32_t)) throw std::runtime_error("Frame too small");
+    if (available - sizeof(uint32_t) < size) return false;
+
+    const char* body = buffer.data() + offset + sizeof(uint32_t);
+    std::memcpy(&message.id, body, sizeof(message.id));
+    message.code = static_cast<uint8_t>(body[sizeof(message.id)]);
+    size_t header = FRAME_HEADER_SIZE - sizeof(uint32_t);
+    message.payload.assign(body + header, size - header);
+    offset += sizeof(uint32_t) + size;
+    return true;
+}
+
+// ============================================================================
+// Index
+// ============================================================================
+
+Index::Index(parallel::Executor* pool, int levels)
+    : root_(System::createHierarchy(pool, levels)),
+      systems_(static_cast<size_t>(levels) + 1),
+      levels_(11) {
+    for (int level = 1; level <= levels; ++level) {
+        systems_[level] = System::getSystem(root_, level);
+    }
+
+    // Trees of Systems 0-10 (1-11 nodes), in SystemTreeMapping order. Sizes
+    // the embedded tables lack come from RootedTreeGenerator; generate them
+    // all here first, so each level below is a cache hit
+    int max_nodes = static_cast<int>(levels_.size());
+    if (!trees::tables::find(max_nodes)) trees::RootedTreeGenerator::generate(max_nodes, pool);
+    parallel::parallelFor(pool, 0, levels_.size(), 1, [&](size_t lo, size_t hi) {
+        for (size_t level = lo; level < hi; ++level) {
+            auto& entry = levels_[level];
+            int system_level = static_cast<int>(level);
+
+            std::unordered_map<std::string, uint32_t> cluster_of;
+            auto clusters = trees::SystemTreeMapping::getSystemClusters(system_level);
+            for (size_t c = 0; c < clusters.size(); ++c) {
+                for (const auto& tree : clusters[c]) {
+                    cluster_of.emplace(tree.canonical(), static_cast<uint32_t>(c));
+                }
+            }
+
+            auto trees = trees::SystemTreeMapping::getSystemTrees(system_level);
+            entry.rank_of_id.resize(trees.size());
+            for (size_t rank = 0; rank < trees.size(); ++rank) {
+                std::string canonical = trees[rank].canonical();
+                auto found = cluster_of.find(canonical);
+                uint32_t cluster = found != cluster_of.end() ? found->second : 0;
+                entry.cluster.push_back(cluster);
+                entry.cluster_size.push_back(static_cast<uint32_t>(clusters[cluster].size()));
+                entry.rank_of_id[classify::classifyTree(canonical).id] = static_cast<uint32_t>(rank);
+                entry.trees.push_back(std::move(canonical));
+            }
+        }
+    });
+
+    for (int level = 1; level <= levels; ++level) {
+        levels_[level].terms = systems_[level]->allTerms();
+    }
+}
+
+System::SystemPtr Index::system(int level) const {
+    if (level < 1 || level >= static_cast<int>(systems_.size())) return nullptr;
+    return systems_[level];
+}
+
+System::TermPtr Index::term(const Address& address) const {
+    if (!system(address.level) || address.path.empty()) return nullptr;
+    const auto& terms = levels_[address.level].terms;
+    if (address.path[0] >= terms.size()) return nullptr;
+    System::TermPtr term = terms[address.path[0]];
+    for (size_t i = 1; i < address.path.size(); ++i) {
+        const auto& sub = term->subTerms();
+        if (address.path[i] >= sub.size()) return nullptr;
+        term = sub[address.path[i]];
+    }
+    return term;
+}
+
+std::optional<TreeInfo> Index::treeByRank(int level, uint32_t rank) const {
+    if (level < 0 || level >= static_cast<int>(levels_.size())) return std::nullopt;
+    const auto& entry = levels_[level];
+    if (rank >= entry.trees.size()) return std::nullopt;
+    return TreeInfo{level, rank, entry.trees[rank], entry.cluster[rank], entry.cluster_size[rank]};
+}
+
+std::optional<TreeInfo> Index::treeOf(std::string_view parens) const {
+    auto result = classify::classifyTree(parens);
+    if (result.status != classify::Status::Ok) return std::nullopt;
+    int level = result.nodes - 1;
+    if (level >= static_cast<int>(levels_.size())) return std::nullopt;
+    return treeByRank(level, levels_[level].rank_of_id[result.id]);
+}
+
+Status Index::handle(Op op, Reader& payload, std::string& out) const {
+    Writer writer(out);
+    auto writeTree = [&](const std::optional<TreeInfo>& tree) {
+        if (!tree) return Status::NOT_FOUND;
+        writer.u8(static_cast<uint8_t>(tree->level));
+        writer.u32(tree->rank);
+        writer.string(tree->tree);
+        writer.u32(tree->cluster);
+        writer.u32(tree->cluster_size);
+        return Status::OK;
+    };
+
+    switch (op) {
+        case Op::PING:
+            writer.u32(PROTOCOL_VERSION);
+            return Status::OK;
+
+        case Op::TERM: {
+            auto term = this->term(payload.address());
+            if (!term) return Status::NOT_FOUND;
+            writer.string(term->name());
+            writer.string(term->description());
+            auto type = term->triadicType();
+            writer.u8(type ? static_cast<uint8_t>(static_cast<int>(*type) + 1) : 0);
+            writer.u32(static_cast<uint32_t>(term->subTerms().size()));
+            writer.u32(static_cast<uint32_t>(term->depth()));
+            writer.u32(static_cast<uint32_t>(term->totalTermCount()));
+            return Status::OK;
+        }
+
+        case Op::TERM_BY_RANK: {
+            int level = payload.u8();
+            uint32_t rank = payload.u32();
+            return writeTree(treeByRank(level, rank));
+        }
+
+        case Op::CLUSTER_OF_TREE:
+            return writeTree(treeOf(payload.string()));
+
+        case Op::RELATIONS: {
+            auto a = system(payload.u8());
+            auto b = system(payload.u8());
+            if (!a || !b) return Status::NOT_FOUND;
+            uint32_t mask = 0;
+            for (auto type : ops::Relationships::getRelations(*a, *b)) {
+                mask |= 1u << static_cast<int>(type);
+            }
+            writer.u32(mask);
+            return Status::OK;
+        }
+
+        case Op::CONNECTION: {
+            int pos1 = payload.u8();
+            int pos2 = payload.u8();
+            auto type = ops::Relationships::connectionType(pos1, pos2);
+            writer.u8(type ? static_cast<uint8_t>(static_cast<int>(*type) + 1) : 0);
+            return Status::OK;
+        }
+
+        case Op::SUBTREE: {
+            auto address = payload.address();
+            if (address.path.empty()) {
+                auto sys = system(address.level);
+                if (!sys) return Status::NOT_FOUND;
+                writer.string(ops::Serializer::toJSON(*sys));
+                return Status::OK;
+            }
+            auto term = this->term(address);
+            if (!term) return Status::NOT_FOUND;
+            writer.string(ops::Serializer::toJSON(*term));
+            return Status::OK;
+        }
+    }
+    return Status::UNKNOWN_OP;
+}
+
+Message Index::handle(const Message& request) const {
+    Message response;
+    response.id = request.id;
+    Status status;
+    try {
+        Reader payload(request.payload);
+        status = handle(static_cast<Op>(request.code), payload, response.payload);
+        if (status == Status::OK && !payload.done()) status = Status::BAD_REQUEST;
+    } catch (const std::exception&) {
+        status = Status::BAD_REQUEST;
+    }
+    if (status != Status::OK) response.payload.clear();
+    response.code = static_cast<uint8_t>(status);
+    return response;
+}
+
+// ============================================================================
+// Server
+// ============================================================================
+
+#ifdef COSMIC_HAVE_EPOLL
+
+Server::Server(const Index& index, const std::string& path) : index_(index), path_(path) {
+    sockaddr_un address = socketAddress(path);
+    removeStaleSocket(path, address);
+    bool bound = false;
+    try {
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) throw systemError("socket");
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            throw systemError("bind " + path);
+        }
+        bound = true;
+        if (::listen(listen_fd_, SOMAXCONN) != 0) throw systemError("listen");
+
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) throw systemError("epoll_create1");
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) throw systemError("eventfd");
+
+        for (int fd : {listen_fd_, wake_fd_}) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) throw systemError("epoll_ctl");
+        }
+    } catch (...) {
+        for (int fd : {listen_fd_, epoll_fd_, wake_fd_}) {
+            if (fd >= 0) ::close(fd);
+        }
+        if (bound) ::unlink(path.c_str());
+        throw;
+    }
+}
+
+Server::~Server() {
+    for (auto& entry : connections_) ::close(entry.first);
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+    ::close(listen_fd_);
+    ::unlink(path_.c_str());
+}
+
+void Server::stop() {
+    uint64_t one = 1;
+    ssize_t written = ::write(wake_fd_, &one, sizeof(one));
+    static_cast<void>(written);
+}
+
+void Server::run() {
+    epoll_event events[64];
+    for (;;) {
+        int ready = ::epoll_wait(epoll_fd_, events, 64, accepting_ ? -1 : ACCEPT_RETRY_MS);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("epoll_wait");
+        }
+        if (ready == 0) resumeAccepting();
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t count;
+                ssize_t drained = ::read(wake_fd_, &count, sizeof(count));
+                static_cast<void>(drained);
+                return;
+            }
+            if (fd == listen_fd_) {
+                accept();
+                continue;
+            }
+            auto found = connections_.find(fd);
+            if (found == connections_.end()) continue;
+            auto& connection = found->second;
+            bool open = true;
+            if (!connection.eof && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                open = readFrom(fd, connection);
+            }
+            if (open && (events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR))) open = writeTo(fd, connection);
+            // A half-closed connection stays open until its responses are sent
+            if (open && connection.eof && connection.out_offset == connection.out.size()) open = false;
+            if (open) watch(fd, connection);
+            else close(fd);
+        }
+    }
+}
+
+void Server::accept() {
+    for (;;) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                // The pending connection stays queued and the listener stays
+                // readable; stop watching it rather than spin on the error
+                ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, listen_fd_, nullptr);
+                accepting_ = false;
+            }
+            return;
+        }
+        auto& connection = connections_[fd];
+        watch(fd, connection);
+    }
+}
+
+bool Server::readFrom(int fd, Connection& connection) {
+    // Read what is available now (up to the input and output limits) ...
+    size_t taken = 0;
+    while (taken < MAX_BATCH_INPUT &&
+           connection.out.size() - connection.out_offset < MAX_PENDING_OUTPUT) {
+        size_t used = connection.in.size();
+        connection.in.resize(used + READ_SIZE);
+        ssize_t n = ::read(fd, &connection.in[used], READ_SIZE);
+        connection.in.resize(used + static_cast<size_t>(std::max<ssize_t>(n, 0)));
+        if (n > 0) {
+            taken += static_cast<size_t>(n);
+            if (static_cast<size_t>(n) < READ_SIZE) break;
+            continue;
+        }
+        if (n == 0) connection.eof = true;
+        else if (errno == EINTR) continue;
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+        break;
+    }
+
+    // ... answer every complete request in it as one batch ...
+    size_t answered = 0;
+    Message request;
+    try {
+        while (takeFrame(connection.in, connection.in_offset, request)) {
+            appendFrame(connection.out, index_.handle(request));
+            ++answered;
+        }
+    } catch (const std::exception&) {
+        return false;  // Malformed framing: the stream cannot be resynchronised
+    }
+    compact(connection.in, connection.in_offset);
+    if (answered > 0) {
+        requests_.fetch_add(answered, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        COSMIC_METRIC_COUNT("cosmic_service_requests_total", "Requests answered by the service", answered);
+    }
+
+    // ... and send the responses in one write
+    return writeTo(fd, connection);
+}
+
+bool Server::writeTo(int fd, Connection& connection) {
+    while (connection.out_offset < connection.out.size()) {
+        ssize_t n = ::send(fd, connection.out.data() + connection.out_offset,
+                           connection.out.size() - connection.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.out_offset += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    compact(connection.out, connection.out_offset);
+    return true;
+}
+
+void Server::watch(int fd, Connection& connection) {
+    size_t pending = connection.out.size() - connection.out_offset;
+    uint32_t events = 0;
+    if (pending < MAX_PENDING_OUTPUT && !connection.eof) events |= EPOLLIN;
+    if (pending > 0) events |= EPOLLOUT;
+    if (events == connection.events) return;
+
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    int op = connection.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    if (::epoll_ctl(epoll_fd_, op, fd, &event) != 0) throw systemError("epoll_ctl");
+    connection.events = events;
+}
+
+void Server::close(int fd) {
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections_.erase(fd);
+    resumeAccepting();
+}
+
+void Server::resumeAccepting() {
+    if (accepting_) return;
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd_;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event) != 0) throw systemError("epoll_ctl");
+    accepting_ = true;
+}
+
+#else
+
+Server::Server(const Index& index, const std::string& path) : index_(index), path_(path) {
+    throw std::runtime_error("service::Server requires Linux (epoll)");
+}
+
+Server::~Server() = default;
+void Server::run() {}
+void Server::stop() {}
+
+#endif
+
+// ============================================================================
+// Client
+// ============================================================================
+
+#ifdef COSMIC_HAVE_UNIX_SOCKETS
+
+Client::Client(const std::string& path) {
+    sockaddr_un address = socketAddress(path);
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) throw systemError("socket");
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        auto error = systemError("connect " + path);
+        ::close(fd_);
+        throw error;
+    }
+}
+
+Client::~Client() {
+    ::close(fd_);
+}
+
+void Client::sendAll(const std::string& bytes) {
+    // Keep reading while writing, so a large pipeline cannot stall the
+    // server on its output limit while both sides wait to write
+    size_t sent = 0;
+    while (sent < bytes.size()) {
+        pollfd poll_fd{fd_, static_cast<short>(POLLIN | POLLOUT), 0};
+        if (::poll(&poll_fd, 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("poll");
+        }
+        if (poll_fd.revents & POLLIN) {
+            char chunk[READ_SIZE];
+            ssize_t n = ::recv(fd_, chunk, sizeof(chunk), MSG_DONTWAIT);
+            if (n == 0) throw std::runtime_error("Server closed the connection");
+            if (n > 0) buffer_.append(chunk, static_cast<size_t>(n));
+            else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) throw systemError("recv");
+        }
+        if (poll_fd.revents & (POLLOUT | POLLERR | POLLHUP)) {
+            ssize_t n = ::send(fd_, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n > 0) sent += static_cast<size_t>(n);
+            else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) throw systemError("send");
+        }
+    }
+}
+
+Message Client::receive() {
+    Message message;
+    while (!takeFrame(buffer_, offset_, message)) {
+        compact(buffer_, offset_);
+        char chunk[READ_SIZE];
+        ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n == 0) throw std::runtime_error("Server closed the connection");
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("recv");
+        }
+        buffer_.append(chunk, static_cast<size_t>(n));
+    }
+    compact(buffer_, offset_);
+    return message;
+}
+
+#else
+
+Client::Client(const std::string&) {
+    throw std::runtime_error("service::Client requires Unix domain sockets");
+}
+
+Client::~Client() = default;
+void Client::sendAll(const std::string&) {}
+Message Client::receive() { return {}; }
+
+#endif
+
+std::vector<Message> Client::pipeline(const std::vector<Message>& requests) {
+    std::string bytes;
+    uint32_t first_id = next_id_;
+    for (const auto& request : requests) {
+        Message framed = request;
+        framed.id = next_id_++;
+        appendFrame(bytes, framed);
+    }
+    sendAll(bytes);
+
+    std::vector<Message> responses;
+    responses.reserve(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        responses.push_back(receive());
+        if (responses.back().id != first_id + i) throw std::runtime_error("Response out of order");
+    }
+    return responses;
+}
+
+Message Client::call(const Message& request) {
+    Message response = std::move(pipeline({request}).front());
+    auto status = static_cast<Status>(response.code);
+    if (status != Status::OK) {
+        throw std::runtime_error(std::string("Request failed: ") + toString(status));
+    }
+    return response;
+}
+
+uint32_t Client::ping() {
+    auto response = call({0, static_cast<uint8_t>(Op::PING), {}});
+    return Reader(response.payload).u32();
+}
+
+Message Client::termRequest(const Address& address) {
+    Message request{0, static_cast<uint8_t>(Op::TERM), {}};
+    Writer(request.payload).address(address);
+    return request;
+}
+
+Message Client::termByRankRequest(int level, uint32_t rank) {
+    Message request{0, static_cast<uint8_t>(Op::TERM_BY_RANK), {}};
+    Writer writer(request.payload);
+    writer.u8(static_cast<uint8_t>(level));
+    writer.u32(rank);
+    return request;
+}
+
+Message Client::clusterOfTreeRequest(std::string_view parens) {
+    Message request{0, static_cast<uint8_t>(Op::CLUSTER_OF_TREE), {}};
+    Writer(request.payload).string(parens);
+    return request;
+}
+
+TermInfo Client::decodeTerm(const Message& response) {
+    Reader reader(response.payload);
+    TermInfo info;
+    info.name = reader.string();
+    info.description = reader.string();
+    uint8_t type = reader.u8();
+    if (type > 0) info.type = static_cast<TriadicTerm>(type - 1);
+    info.sub_terms = reader.u32();
+    info.depth = reader.u32();
+    info.total_terms = reader.u32();
+    return info;
+}
+
+TreeInfo Client::decodeTree(const Message& response) {
+    Reader reader(response.payload);
+    TreeInfo info;
+    info.level = reader.u8();
+    info.rank = reader.u32();
+    info.tree = reader.string();
+    info.cluster = reader.u32();
+    info.cluster_size = reader.u32();
+    return info;
+}
+
+TermInfo Client::term(const Address& address) {
+    return decodeTerm(call(termRequest(address)));
+}
+
+TreeInfo Client::termByRank(int level, uint32_t rank) {
+    return decodeTree(call(termByRankRequest(level, rank)));
+}
+
+TreeInfo Client::clusterOfTree(std::string_view parens) {
+    return decodeTree(call(clusterOfTreeRequest(parens)));
+}
+
+uint32_t Client::relations(int level_a, int level_b) {
+    Message request{0, static_cast<uint8_t>(Op::RELATIONS), {}};
+    Writer writer(request.payload);
+    writer.u8(static_cast<uint8_t>(level_a));
+    writer.u8(static_cast<uint8_t>(level_b));
+    return Reader(call(request).payload).u32();
+}
+
+std::optional<ops::Relationships::RelationType> Client::connection(int pos1, int pos2) {
+    Message request{0, static_cast<uint8_t>(Op::CONNECTION), {}};
+    Writer writer(request.payload);
+    writer.u8(static_cast<uint8_t>(pos1));
+    writer.u8(static_cast<uint8_t>(pos2));
+    uint8_t type = Reader(call(request).payload).u8();
+    if (type == 0) return std::nullopt;
+    return static_cast<ops::Relationships::RelationType>(type - 1);
+}
+
+std::string Client::subtree(const Address& address) {
+    Message request{0, static_cast<uint8_t>(Op::SUBTREE), {}};
+    Writer(request.payload).address(address);
+    return Reader(call(request).payload).string();
+}
+
+} // namespace service
+} // namespace cosmic
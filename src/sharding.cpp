@@ -0,0 +1,364 @@
+/**
+ * @file sharding.cpp
+ * @brief Shard files and the k-way merge into a global catalog
+ */
+
+#include "cosmic/sharding.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+
+namespace cosmic {
+namespace sharding {
+
+namespace {
+
+using enumeration::CatalogHeader;
+using enumeration::CatalogKind;
+
+/// Output is written in pieces of about this many bytes
+constexpr size_t WRITE_SIZE = 1 << 20;
+
+/// Words read from a shard at a time
+constexpr size_t READ_WORDS = 1 << 14;
+
+/// Deduplicate a worker's cluster keys once this many have collected
+constexpr size_t COMPACT_KEYS = 1 << 22;
+
+CatalogHeader readHeader(std::istream& in, const std::string& path) {
+    uint8_t bytes[enumeration::CATALOG_HEADER_SIZE];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+        throw std::runtime_error("Truncated catalog " + path);
+    }
+    return enumeration::parseHeader(bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Records of one section of a catalog file, read in blocks
+ */
+class SectionReader {
+public:
+    /// Open section @p section (0 or 1) of @p path
+    SectionReader(const std::string& path, int section) : path_(path), in_(path, std::ios::binary) {
+        if (!in_) throw std::runtime_error("Cannot open " + path);
+        header_ = readHeader(in_, path);
+        if (section == 1) {
+            in_.seekg(static_cast<std::streamoff>(header_.count * header_.recordSize()), std::ios::cur);
+            header_ = readHeader(in_, path);
+        }
+        words_ = header_.recordSize() / sizeof(uint64_t);
+        remaining_ = header_.count;
+    }
+
+    const CatalogHeader& header() const { return header_; }
+
+    /// Read the next record into @p record; false at the end of the section
+    bool next(uint64_t* record) {
+        if (remaining_ == 0) return false;
+        if (position_ == buffer_.size()) refill();
+        for (size_t w = 0; w < words_; ++w) record[w] = buffer_[position_++];
+        --remaining_;
+        return true;
+    }
+
+private:
+    void refill() {
+        size_t words = static_cast<size_t>(std::min<uint64_t>(remaining_ * words_, READ_WORDS));
+        buffer_.resize(words);
+        if (!in_.read(reinterpret_cast<char*>(buffer_.data()),
+                      static_cast<std::streamsize>(words * sizeof(uint64_t)))) {
+            throw std::runtime_error("Truncated catalog " + path_);
+        }
+        position_ = 0;
+    }
+
+    std::string path_;
+    std::ifstream in_;
+    CatalogHeader header_;
+    size_t words_ = 1;
+    uint64_t remaining_ = 0;
+    std::vector<uint64_t> buffer_;
+    size_t position_ = 0;
+};
+
+using Readers = std::vector<std::unique_ptr<SectionReader>>;
+
+/**
+ * @brief Visit the records of all @p readers in decreasing key order
+ *
+ * Equal keys are visited in reader order, so the result does not depend
+ * on timing.
+ */
+template<typename Visit>
+void kWayMerge(Readers& readers, Visit visit) {
+    struct Head {
+        uint64_t record[2];
+        size_t reader;
+    };
+    auto lower = [](const Head& a, const Head& b) {
+        return a.record[0] != b.record[0] ? a.record[0] < b.record[0] : a.reader > b.reader;
+    };
+    std::priority_queue<Head, std::vector<Head>, decltype(lower)> heap(lower);
+    for (size_t r = 0; r < readers.size(); ++r) {
+        Head head{{0, 0}, r};
+        if (readers[r]->next(head.record)) heap.push(head);
+    }
+    while (!heap.empty()) {
+        Head head = heap.top();
+        heap.pop();
+        visit(head.record);
+        if (readers[head.reader]->next(head.record)) heap.push(head);
+    }
+}
+
+/// A file written under a temporary name and renamed by commit()
+class AtomicFile {
+public:
+    explicit AtomicFile(const std::string& path) : path_(path), temp_(path + ".tmp") {
+        file_ = std::fopen(temp_.c_str(), "wb");
+        if (!file_) throw std::runtime_error("Cannot write " + temp_);
+    }
+
+    ~AtomicFile() {
+        if (file_) {
+            std::fclose(file_);
+            std::remove(temp_.c_str());
+        }
+    }
+
+    AtomicFile(const AtomicFile&) = delete;
+    AtomicFile& operator=(const AtomicFile&) = delete;
+
+    /// Write @p buffer out once it holds at least @p threshold bytes, and clear it
+    void write(std::string& buffer, size_t threshold = 0) {
+        if (buffer.size() < threshold || buffer.empty()) return;
+        if (std::fwrite(buffer.data(), 1, buffer.size(), file_) != buffer.size()) {
+            throw std::runtime_error("Write error on " + temp_);
+        }
+        buffer.clear();
+    }
+
+    void commit() {
+        std::FILE* file = file_;
+        file_ = nullptr;
+        if (std::fclose(file) != 0) {
+            std::remove(temp_.c_str());
+            throw std::runtime_error("Write error on " + temp_);
+        }
+        std::remove(path_.c_str());
+        if (std::rename(temp_.c_str(), path_.c_str()) != 0) {
+            throw std::runtime_error("Cannot rename " + temp_ + " to " + path_);
+        }
+    }
+
+private:
+    std::string path_;
+    std::string temp_;
+    std::FILE* file_ = nullptr;
+};
+
+void appendWord(std::string& out, uint64_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/// Sort keys in decreasing order and drop repeats
+void sortUnique(std::vector<uint64_t>& keys) {
+    std::sort(keys.begin(), keys.end(), std::greater<uint64_t>());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+} // namespace
+
+std::vector<Shard> plan(int nodes, int shards) {
+    if (nodes < 1 || nodes > enumeration::MAX_NODES) {
+        throw std::invalid_argument("Shard plans need 1-" + std::to_string(enumeration::MAX_NODES) + " nodes");
+    }
+    if (shards < 1) throw std::invalid_argument("Shard plans need at least one shard");
+
+    uint64_t total = enumeration::rootedTreeCount(nodes);
+    uint64_t count = std::min<uint64_t>(static_cast<uint64_t>(shards), total);
+    std::vector<Shard> result;
+    uint64_t first = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        Shard shard;
+        shard.nodes = nodes;
+        shard.index = static_cast<int>(i);
+        shard.total = static_cast<int>(count);
+        shard.first_rank = first;
+        shard.count = total / count + (i < total % count ? 1 : 0);
+        first += shard.count;
+        result.push_back(shard);
+    }
+    return result;
+}
+
+std::string shardPath(const std::string& directory, const Shard& shard) {
+    return directory + "/n" + std::to_string(shard.nodes) + "-shard" + std::to_string(shard.index) +
+           "-of" + std::to_string(shard.total) + ".bin";
+}
+
+bool shardComplete(const std::string& path, const Shard& shard) {
+    try {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        CatalogHeader trees = readHeader(in, path);
+        if (trees.kind != CatalogKind::ROOTED || trees.flags != enumeration::CLUSTER_KEYS ||
+            trees.nodes != static_cast<uint32_t>(shard.nodes) || trees.first_rank != shard.first_rank ||
+            trees.count != shard.count) {
+            return false;
+        }
+        in.seekg(static_cast<std::streamoff>(trees.count * trees.recordSize()), std::ios::cur);
+        CatalogHeader clusters = readHeader(in, path);
+        if (clusters.kind != CatalogKind::FREE || clusters.nodes != trees.nodes ||
+            clusters.count > trees.count) {
+            return false;
+        }
+        in.seekg(0, std::ios::end);
+        uint64_t expected = 2 * enumeration::CATALOG_HEADER_SIZE + trees.count * trees.recordSize() +
+                            clusters.count * clusters.recordSize();
+        return static_cast<uint64_t>(in.tellg()) == expected;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+Stats writeShard(const Shard& shard, const std::string& path) {
+    enumeration::RootedSequence trees(shard.nodes);
+    if (trees.skip(shard.first_rank) != shard.first_rank) {
+        throw std::invalid_argument("Shard starts past the last tree");
+    }
+
+    AtomicFile file(path);
+    CatalogHeader header;
+    header.kind = CatalogKind::ROOTED;
+    header.flags = enumeration::CLUSTER_KEYS;
+    header.nodes = static_cast<uint32_t>(shard.nodes);
+    header.first_rank = shard.first_rank;
+    header.count = shard.count;
+    std::string buffer;
+    buffer.reserve(WRITE_SIZE + header.recordSize());
+    enumeration::appendHeader(buffer, header);
+
+    // Trees, already in decreasing key order, and their cluster keys
+    std::vector<uint64_t> clusters;
+    size_t compact_at = COMPACT_KEYS;
+    for (uint64_t i = 0; i < shard.count; ++i) {
+        uint64_t cluster = enumeration::centerKey(trees.levels());
+        appendWord(buffer, trees.key());
+        appendWord(buffer, cluster);
+        file.write(buffer, WRITE_SIZE);
+
+        clusters.push_back(cluster);
+        if (clusters.size() >= compact_at) {
+            sortUnique(clusters);
+            compact_at = std::max(compact_at, 2 * clusters.size());
+        }
+        if (i + 1 < shard.count && !trees.next()) {
+            throw std::invalid_argument("Shard ends past the last tree");
+        }
+    }
+
+    // Distinct cluster keys of the range, decreasing
+    sortUnique(clusters);
+    header.kind = CatalogKind::FREE;
+    header.flags = 0;
+    header.first_rank = 0;
+    header.count = clusters.size();
+    enumeration::appendHeader(buffer, header);
+    for (uint64_t key : clusters) {
+        appendWord(buffer, key);
+        file.write(buffer, WRITE_SIZE);
+    }
+    file.write(buffer);
+    file.commit();
+    return {shard.count, clusters.size()};
+}
+
+Stats merge(int nodes, const std::vector<std::string>& shards, const std::string& output) {
+    if (nodes < 1 || nodes > enumeration::MAX_NODES) {
+        throw std::invalid_argument("Catalogs need 1-" + std::to_string(enumeration::MAX_NODES) + " nodes");
+    }
+    auto open = [&](int section, CatalogKind kind) {
+        Readers readers;
+        for (const auto& path : shards) {
+            readers.push_back(std::make_unique<SectionReader>(path, section));
+            const auto& header = readers.back()->header();
+            if (header.kind != kind || header.nodes != static_cast<uint32_t>(nodes) ||
+                (kind == CatalogKind::ROOTED && header.flags != enumeration::CLUSTER_KEYS)) {
+                throw std::runtime_error(path + " is not a shard of " + std::to_string(nodes) + " nodes");
+            }
+        }
+        return readers;
+    };
+
+    // Every cluster key, decreasing; a cluster's id is its index
+    std::vector<uint64_t> clusters;
+    {
+        Readers readers = open(1, CatalogKind::FREE);
+        kWayMerge(readers, [&](const uint64_t* record) {
+            if (!clusters.empty() && record[0] >= clusters.back()) {
+                if (record[0] == clusters.back()) return;
+                throw std::runtime_error("Shard cluster keys are not sorted");
+            }
+            clusters.push_back(record[0]);
+        });
+    }
+    if (clusters.size() != enumeration::freeTreeCount(nodes)) {
+        throw std::runtime_error("Shards hold " + std::to_string(clusters.size()) + " clusters, expected " +
+                                 std::to_string(enumeration::freeTreeCount(nodes)));
+    }
+
+    Readers readers = open(0, CatalogKind::ROOTED);
+    uint64_t total = 0;
+    for (const auto& reader : readers) total += reader->header().count;
+    if (total != enumeration::rootedTreeCount(nodes)) {
+        throw std::runtime_error("Shards hold " + std::to_string(total) + " trees, expected " +
+                                 std::to_string(enumeration::rootedTreeCount(nodes)));
+    }
+
+    AtomicFile file(output);
+    std::string buffer;
+    buffer.reserve(WRITE_SIZE + 16);
+    CatalogHeader header;
+    header.kind = CatalogKind::FREE;
+    header.nodes = static_cast<uint32_t>(nodes);
+    header.count = clusters.size();
+    enumeration::appendHeader(buffer, header);
+    for (uint64_t key : clusters) {
+        appendWord(buffer, key);
+        file.write(buffer, WRITE_SIZE);
+    }
+
+    // Trees in decreasing key order; strictly decreasing means no tree twice
+    header.kind = CatalogKind::ROOTED;
+    header.flags = enumeration::CLUSTER_IDS;
+    header.count = total;
+    enumeration::appendHeader(buffer, header);
+    uint64_t written = 0;
+    uint64_t previous = 0;
+    kWayMerge(readers, [&](const uint64_t* record) {
+        if (written > 0 && record[0] >= previous) {
+            throw std::runtime_error("Shards overlap or are not sorted");
+        }
+        auto cluster = std::lower_bound(clusters.begin(), clusters.end(), record[1], std::greater<uint64_t>());
+        if (cluster == clusters.end() || *cluster != record[1]) {
+            throw std::runtime_error("Tree cluster missing from the shard clusters");
+        }
+        appendWord(buffer, record[0]);
+        appendWord(buffer, static_cast<uint64_t>(cluster - clusters.begin()));
+        file.write(buffer, WRITE_SIZE);
+        previous = record[0];
+        ++written;
+    });
+    file.write(buffer);
+    file.commit();
+    return {written, clusters.size()};
+}
+
+} // namespace sharding
+} // namespace cosmic
@@ -0,0 +1,437 @@
+/**
+ * @file spectral.cpp
+ * @brief Implementation of spectral analysis
+ */
+
+#include "cosmic/spectral.hpp"
+#include "cosmic/tracing.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace cosmic {
+namespace spectral {
+
+namespace {
+
+constexpr double TWO_PI = 6.283185307179586476925;
+
+// Generic butterflies up to this radix use stack scratch
+constexpr size_t STACK_RADIX = 32;
+
+inline Complex twiddle(const std::vector<Complex>& table, size_t k, bool inverse) {
+    return inverse ? std::conj(table[k]) : table[k];
+}
+
+// Multiply by -i (forward) or +i (inverse)
+inline Complex rotate(Complex z, bool inverse) {
+    return inverse ? Complex(-z.imag(), z.real()) : Complex(z.imag(), -z.real());
+}
+
+} // namespace
+
+// ============================================================================
+// FFT Implementation
+// ============================================================================
+
+FFT::FFT(size_t n) : n_(n) {
+    if (n == 0) {
+        throw std::invalid_argument("FFT: length must be positive");
+    }
+    twiddles_.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        double angle = -TWO_PI * static_cast<double>(k) / static_cast<double>(n);
+        twiddles_[k] = Complex(std::cos(angle), std::sin(angle));
+    }
+
+    // Factor: 4s, then 2s, then odd factors in increasing order
+    size_t remaining = n;
+    auto push = [&](size_t radix) {
+        remaining /= radix;
+        stages_.push_back({radix, remaining});
+    };
+    while (remaining % 4 == 0) push(4);
+    while (remaining % 2 == 0) push(2);
+    for (size_t f = 3; f * f <= remaining; f += 2) {
+        while (remaining % f == 0) push(f);
+    }
+    if (remaining > 1) push(remaining);
+}
+
+void FFT::forward(const Complex* in, Complex* out) const {
+    transform(in, out, false);
+}
+
+void FFT::inverse(const Complex* in, Complex* out) const {
+    transform(in, out, true);
+    double scale = 1.0 / static_cast<double>(n_);
+    for (size_t i = 0; i < n_; ++i) out[i] *= scale;
+}
+
+std::vector<Complex> FFT::forward(const std::vector<Complex>& in) const {
+    if (in.size() != n_) {
+        throw std::invalid_argument("FFT: input length does not match plan");
+    }
+    std::vector<Complex> out(n_);
+    forward(in.data(), out.data());
+    return out;
+}
+
+std::vector<Complex> FFT::inverse(const std::vector<Complex>& in) const {
+    if (in.size() != n_) {
+        throw std::invalid_argument("FFT: input length does not match plan");
+    }
+    std::vector<Complex> out(n_);
+    inverse(in.data(), out.data());
+    return out;
+}
+
+void FFT::transform(const Complex* in, Complex* out, bool inverse) const {
+    if (stages_.empty()) {  // n == 1
+        out[0] = in[0];
+        return;
+    }
+    work(out, in, 1, 0, inverse);
+}
+
+void FFT::work(Complex* out, const Complex* in, size_t fstride, size_t stage,
+               bool inverse) const {
+    // Decimation in time: transform the radix interleaved subsequences into
+    // consecutive blocks of out, then combine them with one butterfly pass
+    size_t radix = stages_[stage].radix;
+    size_t span = stages_[stage].span;
+    if (span == 1) {
+        for (size_t j = 0; j < radix; ++j) out[j] = in[j * fstride];
+    } else {
+        for (size_t j = 0; j < radix; ++j) {
+            work(out + j * span, in + j * fstride, fstride * radix, stage + 1, inverse);
+        }
+    }
+    butterfly(out, fstride, stage, inverse);
+}
+
+void FFT::butterfly(Complex* out, size_t fstride, size_t stage, bool inverse) const {
+    size_t radix = stages_[stage].radix;
+    size_t m = stages_[stage].span;
+
+    if (radix == 2) {
+        for (size_t q = 0; q < m; ++q) {
+            Complex t = out[q + m] * twiddle(twiddles_, q * fstride, inverse);
+            out[q + m] = out[q] - t;
+            out[q] += t;
+        }
+        return;
+    }
+
+    if (radix == 4) {
+        for (size_t q = 0; q < m; ++q) {
+            Complex a0 = out[q];
+            Complex a1 = out[q + m] * twiddle(twiddles_, q * fstride, inverse);
+            Complex a2 = out[q + 2 * m] * twiddle(twiddles_, 2 * q * fstride, inverse);
+            Complex a3 = out[q + 3 * m] * twiddle(twiddles_, 3 * q * fstride, inverse);
+            Complex s02 = a0 + a2;
+            Complex d02 = a0 - a2;
+            Complex s13 = a1 + a3;
+            Complex d13 = rotate(a1 - a3, inverse);
+            out[q] = s02 + s13;
+            out[q + m] = d02 + d13;
+            out[q + 2 * m] = s02 - s13;
+            out[q + 3 * m] = d02 - d13;
+        }
+        return;
+    }
+
+    // Generic radix: direct DFT of the radix points
+    std::array<Complex, STACK_RADIX> stack;
+    std::vector<Complex> heap;
+    Complex* t = stack.data();
+    if (radix > STACK_RADIX) {
+        heap.resize(radix);
+        t = heap.data();
+    }
+    size_t step = fstride * m;  // W_radix = twiddles_[step]
+    for (size_t q = 0; q < m; ++q) {
+        for (size_t r = 0; r < radix; ++r) {
+            t[r] = out[r * m + q] * twiddle(twiddles_, r * q * fstride, inverse);
+        }
+        for (size_t j = 0; j < radix; ++j) {
+            Complex sum = t[0];
+            for (size_t r = 1; r < radix; ++r) {
+                sum += t[r] * twiddle(twiddles_, (r * j * step) % n_, inverse);
+            }
+            out[j * m + q] = sum;
+        }
+    }
+}
+
+// ============================================================================
+// RealFFT Implementation
+// ============================================================================
+
+RealFFT::RealFFT(size_t n)
+    : n_(n)
+    , half_(n % 2 == 0 && n > 0 ? n / 2 : std::max<size_t>(n, 1)) {
+    if (n == 0) {
+        throw std::invalid_argument("RealFFT: length must be positive");
+    }
+    size_t work = half_.size();
+    work_in_.resize(work);
+    work_out_.resize(work);
+    if (n % 2 == 0) {
+        twiddles_.resize(n / 2 + 1);
+        for (size_t k = 0; k <= n / 2; ++k) {
+            double angle = -TWO_PI * static_cast<double>(k) / static_cast<double>(n);
+            twiddles_[k] = Complex(std::cos(angle), std::sin(angle));
+        }
+    }
+}
+
+void RealFFT::forward(const double* in, Complex* out) {
+    if (n_ % 2 != 0) {
+        for (size_t i = 0; i < n_; ++i) work_in_[i] = Complex(in[i], 0.0);
+        half_.forward(work_in_.data(), work_out_.data());
+        std::copy(work_out_.begin(), work_out_.begin() + static_cast<std::ptrdiff_t>(bins()), out);
+        return;
+    }
+
+    // Pack even/odd samples as one complex signal of half the length, then
+    // split its transform into the even and odd sub-spectra
+    size_t h = n_ / 2;
+    for (size_t k = 0; k < h; ++k) work_in_[k] = Complex(in[2 * k], in[2 * k + 1]);
+    half_.forward(work_in_.data(), work_out_.data());
+    const Complex* z = work_out_.data();
+    for (size_t k = 0; k <= h; ++k) {
+        Complex zk = z[k % h];
+        Complex zc = std::conj(z[(h - k) % h]);
+        Complex even = 0.5 * (zk + zc);
+        Complex odd = Complex(0.0, -0.5) * (zk - zc);
+        out[k] = even + twiddles_[k] * odd;
+    }
+}
+
+void RealFFT::inverse(const Complex* in, double* out) {
+    if (n_ % 2 != 0) {
+        // Rebuild the full Hermitian spectrum
+        for (size_t k = 0; k < bins(); ++k) work_in_[k] = in[k];
+        for (size_t k = bins(); k < n_; ++k) work_in_[k] = std::conj(in[n_ - k]);
+        half_.inverse(work_in_.data(), work_out_.data());
+        for (size_t i = 0; i < n_; ++i) out[i] = work_out_[i].real();
+        return;
+    }
+
+    size_t h = n_ / 2;
+    for (size_t k = 0; k < h; ++k) {
+        Complex xc = std::conj(in[h - k]);
+        Complex even = 0.5 * (in[k] + xc);
+        Complex odd = 0.5 * (in[k] - xc) * std::conj(twiddles_[k]);
+        work_in_[k] = even + Complex(0.0, 1.0) * odd;
+    }
+    half_.inverse(work_in_.data(), work_out_.data());
+    for (size_t k = 0; k < h; ++k) {
+        out[2 * k] = work_out_[k].real();
+        out[2 * k + 1] = work_out_[k].imag();
+    }
+}
+
+// ============================================================================
+// Windows
+// ============================================================================
+
+std::vector<double> window(Window type, size_t n) {
+    std::vector<double> w(n, 1.0);
+    double denom = static_cast<double>(n);
+    for (size_t i = 0; i < n; ++i) {
+        double x = TWO_PI * static_cast<double>(i) / denom;
+        switch (type) {
+            case Window::RECTANGULAR:
+                break;
+            case Window::HANN:
+                w[i] = 0.5 - 0.5 * std::cos(x);
+                break;
+            case Window::HAMMING:
+                w[i] = 0.54 - 0.46 * std::cos(x);
+                break;
+            case Window::BLACKMAN:
+                w[i] = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+                break;
+        }
+    }
+    return w;
+}
+
+// ============================================================================
+// Spectrum Implementation
+// ============================================================================
+
+double Spectrum::peakFrequency() const {
+    if (power.size() < 2) return 0.0;
+    auto peak = std::max_element(power.begin() + 1, power.end());
+    return frequencies[static_cast<size_t>(peak - power.begin())];
+}
+
+double Spectrum::totalPower() const {
+    if (frequencies.size() < 2) return 0.0;
+    double df = frequencies[1] - frequencies[0];
+    double total = 0.0;
+    for (double p : power) total += p;
+    return total * df;
+}
+
+// ============================================================================
+// WelchEstimator Implementation
+// ============================================================================
+
+namespace {
+
+const WelchOptions& validate(const WelchOptions& options) {
+    if (options.segment < 2) {
+        throw std::invalid_argument("Welch: segment must hold at least 2 samples");
+    }
+    if (options.overlap >= options.segment) {
+        throw std::invalid_argument("Welch: overlap must be smaller than the segment");
+    }
+    if (!(options.sample_rate > 0.0)) {
+        throw std::invalid_argument("Welch: sample rate must be positive");
+    }
+    return options;
+}
+
+} // namespace
+
+WelchEstimator::WelchEstimator(const WelchOptions& options)
+    : options_(validate(options))
+    , fft_(options.segment)
+    , window_(window(options.window, options.segment))
+    , buffer_(options.segment)
+    , segment_(options.segment)
+    , bins_(fft_.bins())
+    , sum_(fft_.bins(), 0.0) {
+    double energy = 0.0;
+    for (double w : window_) energy += w * w;
+    scale_ = 1.0 / (options_.sample_rate * energy);
+}
+
+void WelchEstimator::add(double sample) {
+    buffer_[filled_++] = sample;
+    ++samples_;
+    if (filled_ == options_.segment) processSegment();
+}
+
+void WelchEstimator::add(const SignalView& signal) {
+    for (size_t i = 0; i < signal.size; ++i) add(signal[i]);
+}
+
+void WelchEstimator::processSegment() {
+    size_t n = options_.segment;
+    double offset = 0.0;
+    if (options_.detrend) {
+        for (size_t i = 0; i < n; ++i) offset += buffer_[i];
+        offset /= static_cast<double>(n);
+    }
+    for (size_t i = 0; i < n; ++i) segment_[i] = (buffer_[i] - offset) * window_[i];
+    fft_.forward(segment_.data(), bins_.data());
+    for (size_t k = 0; k < bins_.size(); ++k) sum_[k] += std::norm(bins_[k]);
+    ++segments_;
+
+    // Keep the overlap for the next segment
+    size_t hop = n - options_.overlap;
+    std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(hop), buffer_.end(), buffer_.begin());
+    filled_ = options_.overlap;
+}
+
+Spectrum WelchEstimator::spectrum() const {
+    size_t n = options_.segment;
+    size_t bins = sum_.size();
+    Spectrum s;
+    s.segments = segments_;
+    s.frequencies.resize(bins);
+    s.power.assign(bins, 0.0);
+    for (size_t k = 0; k < bins; ++k) {
+        s.frequencies[k] = options_.sample_rate * static_cast<double>(k) / static_cast<double>(n);
+    }
+    if (segments_ == 0) return s;
+
+    double norm = scale_ / static_cast<double>(segments_);
+    for (size_t k = 0; k < bins; ++k) {
+        // One-sided: fold negative frequencies except at DC and Nyquist
+        bool unique = k == 0 || (n % 2 == 0 && k == n / 2);
+        s.power[k] = sum_[k] * norm * (unique ? 1.0 : 2.0);
+    }
+    return s;
+}
+
+void WelchEstimator::reset() {
+    filled_ = 0;
+    samples_ = 0;
+    segments_ = 0;
+    std::fill(sum_.begin(), sum_.end(), 0.0);
+}
+
+Spectrum welch(const SignalView& signal, const WelchOptions& options) {
+    COSMIC_TRACE_SCOPE_CAT("spectral::welchSignal", "simulation");
+    WelchEstimator estimator(options);
+    estimator.add(signal);
+    return estimator.spectrum();
+}
+
+std::vector<Spectrum> welch(const std::vector<SignalView>& signals, const WelchOptions& options,
+                            parallel::Executor* pool) {
+    COSMIC_TRACE_SCOPE_CAT("spectral::welch", "simulation");
+    validate(options);
+    std::vector<Spectrum> spectra(signals.size());
+    auto estimate = [&](size_t i) { spectra[i] = welch(signals[i], options); };
+    if (pool) {
+        pool->run(signals.size(), estimate);
+    } else {
+        for (size_t i = 0; i < signals.size(); ++i) estimate(i);
+    }
+    return spectra;
+}
+
+Spectrum mean(const std::vector<Spectrum>& spectra) {
+    Spectrum result;
+    if (spectra.empty()) return result;
+    result.frequencies = spectra.front().frequencies;
+    result.power.assign(result.frequencies.size(), 0.0);
+    for (const auto& s : spectra) {
+        if (s.power.size() != result.power.size()) {
+            throw std::invalid_argument("spectral::mean: spectra have different bins");
+        }
+        for (size_t k = 0; k < s.power.size(); ++k) {
+            result.power[k] += s.power[k] * static_cast<double>(s.segments);
+        }
+        result.segments += s.segments;
+    }
+    if (result.segments > 0) {
+        for (double& p : result.power) p /= static_cast<double>(result.segments);
+    }
+    return result;
+}
+
+// ============================================================================
+// System2Probe Implementation
+// ============================================================================
+
+System2Probe::System2Probe(const WelchOptions& options)
+    : estimators_(SIGNAL_COUNT, WelchEstimator(options)) {}
+
+void System2Probe::record(const system2::System2& system) {
+    estimators_[MODE_POLARITY].add(system.modePolarity());
+    estimators_[POLARITY].add(system.polarity());
+    estimators_[FREQUENCY].add(system.electromagneticFrequency());
+}
+
+Spectrum System2Probe::spectrum(Signal signal) const {
+    return estimator(signal).spectrum();
+}
+
+const WelchEstimator& System2Probe::estimator(Signal signal) const {
+    if (static_cast<size_t>(signal) >= SIGNAL_COUNT) {
+        throw std::out_of_range("System2Probe: unknown signal");
+    }
+    return estimators_[signal];
+}
+
+} // namespace spectral
+} // namespace cosmic
@@ -0,0 +1,455 @@
+/**
+ * @file succinct.cpp
+ * @brief Implementation of rank/select, excess search and tree catalogs
+ */
+
+#include "cosmic/succinct.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace cosmic {
+namespace succinct {
+
+namespace {
+
+// Rank directory: absolute counts per superblock, relative counts per block
+constexpr size_t BLOCK_BITS = 512;
+constexpr size_t WORDS_PER_BLOCK = BLOCK_BITS / 64;
+constexpr size_t SUPER_BITS = 4096;
+constexpr size_t BLOCKS_PER_SUPER = SUPER_BITS / BLOCK_BITS;
+
+// Excess search: one minimum per 4096 bits, scanned a byte at a time
+constexpr size_t MIN_BITS = 4096;
+constexpr int64_t NO_MIN = std::numeric_limits<int64_t>::max();
+
+inline unsigned popcount(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(w));
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<unsigned>((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/// Position of the k-th set bit of w (k < popcount(w))
+inline size_t selectInWord(uint64_t w, size_t k) {
+    for (size_t i = 0; i < k; ++i) w &= w - 1;
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(w));
+#else
+    size_t pos = 0;
+    while (!(w & 1)) { w >>= 1; ++pos; }
+    return pos;
+#endif
+}
+
+/**
+ * Per-byte excess tables: the total excess of the 8 bits (LSB first), the
+ * minimum excess after each of the first 1..8 bits, and the minimum before
+ * each of the 8 bits (0..7 bits consumed).
+ */
+struct ByteTables {
+    std::array<int8_t, 256> excess;
+    std::array<int8_t, 256> min_after;
+    std::array<int8_t, 256> min_before;
+
+    ByteTables() {
+        for (int b = 0; b < 256; ++b) {
+            int e = 0;
+            int after = 8;
+            int before = 0;
+            for (int i = 0; i < 8; ++i) {
+                before = std::min(before, e);
+                e += (b >> i) & 1 ? 1 : -1;
+                after = std::min(after, e);
+            }
+            excess[b] = static_cast<int8_t>(e);
+            min_after[b] = static_cast<int8_t>(after);
+            min_before[b] = static_cast<int8_t>(before);
+        }
+    }
+};
+
+const ByteTables& byteTables() {
+    static const ByteTables tables;
+    return tables;
+}
+
+inline unsigned byteAt(const std::vector<uint64_t>& words, size_t bit) {
+    return static_cast<unsigned>((words[bit / 64] >> (bit % 64)) & 0xff);
+}
+
+} // namespace
+
+// ============================================================================
+// BitVector Implementation
+// ============================================================================
+
+void BitVector::appendParentheses(const std::string& parens) {
+    reserve(size_ + parens.size());
+    for (char c : parens) {
+        if (c == '(') {
+            push_back(true);
+        } else if (c == ')') {
+            push_back(false);
+        } else {
+            throw std::invalid_argument(std::string("Not a parenthesis: '") + c + "'");
+        }
+    }
+}
+
+// ============================================================================
+// RankSelect Implementation
+// ============================================================================
+
+RankSelect::RankSelect(const BitVector& bits) : bits_(&bits) {
+    const auto& words = bits.words();
+    size_t blocks = (words.size() + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK;
+    blocks_.reserve(blocks);
+    super_.reserve(blocks / BLOCKS_PER_SUPER + 2);
+    uint64_t ones = 0;
+    for (size_t w = 0; w < words.size(); ++w) {
+        if (w % WORDS_PER_BLOCK == 0) {
+            size_t block = w / WORDS_PER_BLOCK;
+            if (block % BLOCKS_PER_SUPER == 0) super_.push_back(ones);
+            blocks_.push_back(static_cast<uint16_t>(ones - super_.back()));
+        }
+        ones += popcount(words[w]);
+    }
+    super_.push_back(ones);
+}
+
+size_t RankSelect::rank1(size_t i) const {
+    if (i >= bits_->size()) return super_.back();
+    const auto& words = bits_->words();
+    size_t block = i / BLOCK_BITS;
+    size_t count = super_[i / SUPER_BITS] + blocks_[block];
+    size_t last = i / 64;
+    for (size_t w = block * WORDS_PER_BLOCK; w < last; ++w) {
+        count += popcount(words[w]);
+    }
+    if (i % 64) {
+        count += popcount(words[last] & ((uint64_t(1) << (i % 64)) - 1));
+    }
+    return count;
+}
+
+size_t RankSelect::select1(size_t k) const {
+    if (super_.empty() || k >= super_.back()) return NONE;
+    const auto& words = bits_->words();
+    // Last superblock, then last block, starting with at most k ones before it
+    size_t super = static_cast<size_t>(
+        std::upper_bound(super_.begin(), super_.end() - 1, k) - super_.begin()) - 1;
+    k -= super_[super];
+    size_t block = super * BLOCKS_PER_SUPER;
+    size_t block_end = std::min(blocks_.size(), block + BLOCKS_PER_SUPER);
+    while (block + 1 < block_end && blocks_[block + 1] <= k) ++block;
+    k -= blocks_[block];
+    for (size_t w = block * WORDS_PER_BLOCK; w < words.size(); ++w) {
+        size_t ones = popcount(words[w]);
+        if (k < ones) return w * 64 + selectInWord(words[w], k);
+        k -= ones;
+    }
+    return NONE;
+}
+
+size_t RankSelect::select0(size_t k) const {
+    size_t size = bits_ ? bits_->size() : 0;
+    if (super_.empty() || k >= size - super_.back()) return NONE;
+    const auto& words = bits_->words();
+    // Zeros before superblock s and before block b
+    auto superZeros = [&](size_t s) { return s * SUPER_BITS - super_[s]; };
+    auto blockZeros = [&](size_t b) { return (b % BLOCKS_PER_SUPER) * BLOCK_BITS - blocks_[b]; };
+    size_t lo = 0;
+    size_t hi = super_.size() - 1;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (superZeros(mid) <= k) lo = mid;
+        else hi = mid;
+    }
+    k -= superZeros(lo);
+    size_t block = lo * BLOCKS_PER_SUPER;
+    size_t block_end = std::min(blocks_.size(), block + BLOCKS_PER_SUPER);
+    while (block + 1 < block_end && blockZeros(block + 1) <= k) ++block;
+    k -= blockZeros(block);
+    for (size_t w = block * WORDS_PER_BLOCK; w < words.size(); ++w) {
+        size_t valid = std::min<size_t>(64, size - w * 64);
+        uint64_t zeros_word = ~words[w];
+        if (valid < 64) zeros_word &= (uint64_t(1) << valid) - 1;
+        size_t zeros = popcount(zeros_word);
+        if (k < zeros) return w * 64 + selectInWord(zeros_word, k);
+        k -= zeros;
+    }
+    return NONE;
+}
+
+// ============================================================================
+// BalancedParentheses Implementation
+// ============================================================================
+
+BalancedParentheses::BalancedParentheses() : BalancedParentheses(BitVector()) {}
+
+BalancedParentheses::BalancedParentheses(BitVector bits) : bits_(std::move(bits)) {
+    bits_.shrinkToFit();
+    rank_ = RankSelect(bits_);
+
+    const auto& tables = byteTables();
+    const auto& words = bits_.words();
+    size_t n = bits_.size();
+    size_t blocks = (n + MIN_BITS - 1) / MIN_BITS;
+
+    leaves_ = 1;
+    while (leaves_ < blocks) leaves_ *= 2;
+    min_tree_.assign(2 * leaves_, NO_MIN);
+
+    // Minimum excess after each bit, block by block
+    int64_t excess = 0;
+    int64_t lowest = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        size_t end = std::min(n, (b + 1) * MIN_BITS);
+        int64_t block_min = NO_MIN;
+        size_t i = b * MIN_BITS;
+        for (; i + 8 <= end; i += 8) {
+            unsigned byte = byteAt(words, i);
+            block_min = std::min(block_min, excess + tables.min_after[byte]);
+            excess += tables.excess[byte];
+        }
+        for (; i < end; ++i) {
+            excess += bits_[i] ? 1 : -1;
+            block_min = std::min(block_min, excess);
+        }
+        min_tree_[leaves_ + b] = block_min;
+        lowest = std::min(lowest, block_min);
+    }
+    if (lowest < 0 || excess != 0) {
+        throw std::invalid_argument("Parentheses are not balanced");
+    }
+    for (size_t node = leaves_ - 1; node > 0; --node) {
+        min_tree_[node] = std::min(min_tree_[2 * node], min_tree_[2 * node + 1]);
+    }
+}
+
+BalancedParentheses::BalancedParentheses(const BalancedParentheses& other)
+    : bits_(other.bits_), rank_(other.rank_), leaves_(other.leaves_), min_tree_(other.min_tree_) {
+    rank_.bits_ = &bits_;
+}
+
+BalancedParentheses& BalancedParentheses::operator=(const BalancedParentheses& other) {
+    if (this != &other) {
+        bits_ = other.bits_;
+        rank_ = other.rank_;
+        rank_.bits_ = &bits_;
+        leaves_ = other.leaves_;
+        min_tree_ = other.min_tree_;
+    }
+    return *this;
+}
+
+BalancedParentheses::BalancedParentheses(BalancedParentheses&& other) noexcept
+    : bits_(std::move(other.bits_)), rank_(std::move(other.rank_)),
+      leaves_(other.leaves_), min_tree_(std::move(other.min_tree_)) {
+    rank_.bits_ = &bits_;
+}
+
+BalancedParentheses& BalancedParentheses::operator=(BalancedParentheses&& other) noexcept {
+    bits_ = std::move(other.bits_);
+    rank_ = std::move(other.rank_);
+    rank_.bits_ = &bits_;
+    leaves_ = other.leaves_;
+    min_tree_ = std::move(other.min_tree_);
+    return *this;
+}
+
+size_t BalancedParentheses::firstBlockAtMost(size_t node, size_t lo, size_t hi, size_t from,
+                                             int64_t target) const {
+    if (hi <= from || min_tree_[node] > target) return NONE;
+    if (hi - lo == 1) return lo;
+    size_t mid = (lo + hi) / 2;
+    size_t found = firstBlockAtMost(2 * node, lo, mid, from, target);
+    if (found != NONE) return found;
+    return firstBlockAtMost(2 * node + 1, mid, hi, from, target);
+}
+
+size_t BalancedParentheses::lastBlockAtMost(size_t node, size_t lo, size_t hi, size_t to,
+                                            int64_t target) const {
+    if (lo > to || min_tree_[node] > target) return NONE;
+    if (hi - lo == 1) return lo;
+    size_t mid = (lo + hi) / 2;
+    size_t found = lastBlockAtMost(2 * node + 1, mid, hi, to, target);
+    if (found != NONE) return found;
+    return lastBlockAtMost(2 * node, lo, mid, to, target);
+}
+
+size_t BalancedParentheses::forwardSearch(size_t from, int64_t target) const {
+    size_t n = bits_.size();
+    if (from > n) return NONE;
+    int64_t excess = this->excess(from);
+    if (excess <= target) return from;
+    if (from == n) return NONE;
+
+    // Rest of the block holding bit `from`; excess(i + 1) follows bit i
+    const auto& tables = byteTables();
+    const auto& words = bits_.words();
+    size_t block = from / MIN_BITS;
+    size_t i = from;
+    for (;;) {
+        size_t end = std::min(n, (block + 1) * MIN_BITS);
+        while (i < end) {
+            if (i % 8 == 0 && i + 8 <= end) {
+                unsigned byte = byteAt(words, i);
+                if (excess + tables.min_after[byte] > target) {
+                    excess += tables.excess[byte];
+                    i += 8;
+                    continue;
+                }
+            }
+            excess += bits_[i] ? 1 : -1;
+            ++i;
+            if (excess <= target) return i;
+        }
+        if (i >= n) return NONE;
+
+        // Jump to the first later block that reaches the target
+        block = firstBlockAtMost(1, 0, leaves_, block + 1, target);
+        if (block == NONE) return NONE;
+        i = block * MIN_BITS;
+        excess = this->excess(i);
+    }
+}
+
+size_t BalancedParentheses::backwardSearch(size_t from, int64_t target) const {
+    size_t n = bits_.size();
+    if (from > n) from = n;
+    int64_t excess = this->excess(from);
+    if (excess <= target) return from;
+
+    // excess(k) for k in (b * MIN_BITS, (b + 1) * MIN_BITS] belongs to block b
+    const auto& tables = byteTables();
+    const auto& words = bits_.words();
+    size_t k = from;
+    while (k > 0) {
+        size_t block = (k - 1) / MIN_BITS;
+        size_t start = block * MIN_BITS;
+        while (k > start + 1) {
+            if (k % 8 == 0 && k - 8 > start) {
+                // excess(k - 8 .. k - 1) all stay above the target: skip the byte
+                unsigned byte = byteAt(words, k - 8);
+                int64_t base = excess - tables.excess[byte];
+                if (base + tables.min_before[byte] > target) {
+                    excess = base;
+                    k -= 8;
+                    continue;
+                }
+            }
+            excess -= bits_[k - 1] ? 1 : -1;
+            --k;
+            if (excess <= target) return k;
+        }
+        if (block == 0) break;
+
+        // Jump to the last earlier block that reaches the target
+        size_t found = lastBlockAtMost(1, 0, leaves_, block - 1, target);
+        if (found == NONE) break;
+        k = std::min(n, (found + 1) * MIN_BITS);
+        excess = this->excess(k);
+        if (excess <= target) return k;
+    }
+    return target >= 0 ? 0 : NONE;
+}
+
+size_t BalancedParentheses::findClose(size_t i) const {
+    size_t k = forwardSearch(i + 1, excess(i));
+    return k == NONE ? NONE : k - 1;
+}
+
+size_t BalancedParentheses::findOpen(size_t i) const {
+    return backwardSearch(i, excess(i + 1));
+}
+
+size_t BalancedParentheses::enclose(size_t i) const {
+    int64_t depth = excess(i);
+    if (depth == 0) return NONE;
+    return backwardSearch(i - 1, depth - 1);
+}
+
+size_t BalancedParentheses::memoryBytes() const {
+    return bits_.memoryBytes() + rank_.memoryBytes() + min_tree_.capacity() * sizeof(int64_t);
+}
+
+// ============================================================================
+// TreeCatalog Implementation
+// ============================================================================
+
+TreeCatalog::TreeCatalog(const std::vector<trees::RootedTree>& trees) {
+    BitVector bits;
+    for (const auto& tree : trees) {
+        bits.appendParentheses(tree.canonical());
+    }
+    bp_ = BalancedParentheses(std::move(bits));
+    index();
+}
+
+TreeCatalog::TreeCatalog(BitVector parens) : bp_(std::move(parens)) {
+    index();
+}
+
+void TreeCatalog::index() {
+    tree_count_ = 0;
+    samples_.clear();
+    for (size_t r = 0; r < bp_.size(); r = bp_.findClose(r) + 1) {
+        if (tree_count_ % 64 == 0) samples_.push_back(r);
+        ++tree_count_;
+    }
+    samples_.shrink_to_fit();
+}
+
+size_t TreeCatalog::root(size_t i) const {
+    if (i >= tree_count_) {
+        throw std::out_of_range("Tree index out of range: " + std::to_string(i));
+    }
+    size_t r = samples_[i / 64];
+    for (size_t k = 0; k < i % 64; ++k) {
+        r = bp_.findClose(r) + 1;
+    }
+    return r;
+}
+
+size_t TreeCatalog::nextSibling(size_t v) const {
+    if (bp_.excess(v) == 0) return NONE;
+    size_t close = bp_.findClose(v);
+    return bp_.isOpen(close + 1) ? close + 1 : NONE;
+}
+
+size_t TreeCatalog::degree(size_t v) const {
+    size_t count = 0;
+    for (size_t c = firstChild(v); c != NONE; c = nextSibling(c)) ++count;
+    return count;
+}
+
+std::string TreeCatalog::canonical(size_t i) const {
+    size_t r = root(i);
+    size_t close = bp_.findClose(r);
+    std::string out;
+    out.reserve(close - r + 1);
+    for (size_t k = r; k <= close; ++k) {
+        out += bp_.isOpen(k) ? '(' : ')';
+    }
+    return out;
+}
+
+trees::RootedTree TreeCatalog::tree(size_t i) const {
+    return trees::RootedTree::fromCanonical(canonical(i));
+}
+
+size_t TreeCatalog::memoryBytes() const {
+    return bp_.memoryBytes() + samples_.capacity() * sizeof(uint64_t);
+}
+
+} // namespace succinct
+} // namespace cosmic
@@ -0,0 +1,340 @@
+/**
+ * @file sweep.cpp
+ * @brief Implementation of parameter sweeps
+ */
+
+#include "cosmic/sweep.hpp"
+#include "cosmic/random.hpp"
+#include "cosmic/system1.hpp"
+#include "cosmic/system2.hpp"
+#include "cosmic/tracing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace cosmic {
+namespace sweep {
+
+// ============================================================================
+// Design Implementation
+// ============================================================================
+
+Design::Design(std::vector<std::string> names, std::vector<std::vector<double>> points)
+    : names_(std::move(names))
+    , points_(std::move(points)) {
+    for (const auto& p : points_) {
+        if (p.size() != names_.size()) {
+            throw std::invalid_argument("Design: point size does not match parameter count");
+        }
+    }
+}
+
+Design Design::grid(const std::vector<Parameter>& parameters) {
+    std::vector<std::string> names;
+    size_t total = 1;
+    for (const auto& p : parameters) {
+        if (p.values.empty()) {
+            throw std::invalid_argument("Design: parameter '" + p.name + "' has no values");
+        }
+        names.push_back(p.name);
+        total *= p.values.size();
+    }
+    if (parameters.empty()) total = 0;
+
+    std::vector<std::vector<double>> points;
+    points.reserve(total);
+    std::vector<size_t> digits(parameters.size(), 0);
+    for (size_t n = 0; n < total; ++n) {
+        std::vector<double> point(parameters.size());
+        for (size_t k = 0; k < parameters.size(); ++k) {
+            point[k] = parameters[k].values[digits[k]];
+        }
+        points.push_back(std::move(point));
+        // Odometer increment, last parameter fastest
+        for (size_t k = parameters.size(); k-- > 0;) {
+            if (++digits[k] < parameters[k].values.size()) break;
+            digits[k] = 0;
+        }
+    }
+    return Design(std::move(names), std::move(points));
+}
+
+Design Design::random(const std::vector<Range>& ranges, size_t count, uint64_t seed) {
+    std::vector<std::string> names;
+    for (const auto& r : ranges) {
+        if (!(r.lo <= r.hi)) {
+            throw std::invalid_argument("Design: range '" + r.name + "' is empty");
+        }
+        names.push_back(r.name);
+    }
+    random::Rng rng(seed);
+    std::vector<std::vector<double>> points(count, std::vector<double>(ranges.size()));
+    for (auto& point : points) {
+        for (size_t k = 0; k < ranges.size(); ++k) {
+            point[k] = rng.uniform(ranges[k].lo, ranges[k].hi);
+        }
+    }
+    return Design(std::move(names), std::move(points));
+}
+
+double Point::get(const std::string& name) const {
+    for (size_t i = 0; i < names->size(); ++i) {
+        if ((*names)[i] == name) return (*values)[i];
+    }
+    throw std::out_of_range("Sweep point has no parameter '" + name + "'");
+}
+
+uint64_t pointSeed(uint64_t sweep_seed, size_t index) {
+    uint64_t state = sweep_seed ^ (0xD1B54A32D192ED03ULL * (static_cast<uint64_t>(index) + 1));
+    return random::splitmix64(state);
+}
+
+// ============================================================================
+// RunningStats Implementation
+// ============================================================================
+
+void RunningStats::add(double value) {
+    ++count_;
+    double delta = value - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (value - mean_);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count_ == 0) return;
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    double n1 = static_cast<double>(count_);
+    double n2 = static_cast<double>(other.count_);
+    double delta = other.mean_ - mean_;
+    double n = n1 + n2;
+    mean_ += delta * n2 / n;
+    m2_ += other.m2_ + delta * delta * n1 * n2 / n;
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+// ============================================================================
+// Aggregator Implementation
+// ============================================================================
+
+Aggregator::Aggregator(std::vector<std::string> parameter_names)
+    : parameter_names_(std::move(parameter_names)) {}
+
+Aggregator::Aggregator(Aggregator&& other) {
+    *this = std::move(other);
+}
+
+Aggregator& Aggregator::operator=(Aggregator&& other) {
+    if (this != &other) {
+        std::scoped_lock lock(mutex_, other.mutex_);
+        parameter_names_ = std::move(other.parameter_names_);
+        rows_ = std::move(other.rows_);
+        metric_names_ = std::move(other.metric_names_);
+    }
+    return *this;
+}
+
+void Aggregator::add(const Point& point, Metrics metrics) {
+    Row row{point.index, point.seed, *point.values, std::move(metrics)};
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : row.metrics) {
+        metric_names_.insert(entry.first);
+    }
+    rows_.push_back(std::move(row));
+}
+
+size_t Aggregator::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rows_.size();
+}
+
+RunningStats Aggregator::summary(const std::string& metric) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (metric_names_.count(metric) == 0) {
+            throw std::out_of_range("Aggregator: unknown metric '" + metric + "'");
+        }
+    }
+    // Accumulate in point order so the result does not depend on completion order
+    RunningStats stats;
+    for (const auto& row : rows()) {
+        auto it = row.metrics.find(metric);
+        if (it != row.metrics.end()) stats.add(it->second);
+    }
+    return stats;
+}
+
+std::map<double, RunningStats> Aggregator::summaryBy(const std::string& metric,
+                                                      const std::string& parameter) const {
+    auto pos = std::find(parameter_names_.begin(), parameter_names_.end(), parameter);
+    if (pos == parameter_names_.end()) {
+        throw std::out_of_range("Aggregator: unknown parameter '" + parameter + "'");
+    }
+    size_t k = static_cast<size_t>(pos - parameter_names_.begin());
+
+    std::map<double, RunningStats> groups;
+    for (const auto& row : rows()) {
+        auto it = row.metrics.find(metric);
+        if (it != row.metrics.end()) {
+            groups[row.parameters[k]].add(it->second);
+        }
+    }
+    return groups;
+}
+
+std::vector<Aggregator::Row> Aggregator::rows() const {
+    std::vector<Row> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sorted = rows_;
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Row& a, const Row& b) { return a.index < b.index; });
+    return sorted;
+}
+
+std::vector<std::string> Aggregator::metricNames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<std::string>(metric_names_.begin(), metric_names_.end());
+}
+
+void Aggregator::writeCSV(std::ostream& out) const {
+    auto metrics = metricNames();
+    auto table = rows();
+
+    out << "index,seed";
+    for (const auto& name : parameter_names_) out << "," << name;
+    for (const auto& name : metrics) out << "," << name;
+    out << "\n";
+
+    auto old_precision = out.precision(17);
+    for (const auto& row : table) {
+        out << row.index << "," << row.seed;
+        for (double v : row.parameters) out << "," << v;
+        for (const auto& name : metrics) {
+            out << ",";
+            auto it = row.metrics.find(name);
+            if (it != row.metrics.end()) out << it->second;
+        }
+        out << "\n";
+    }
+    out.precision(old_precision);
+}
+
+void Aggregator::saveCSV(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open sweep result file: " + path);
+    }
+    writeCSV(out);
+}
+
+// ============================================================================
+// Running
+// ============================================================================
+
+Aggregator run(const Design& design, const Task& task, parallel::Executor* pool,
+               uint64_t seed) {
+    COSMIC_TRACE_SCOPE_CAT("sweep::run", "simulation");
+    Aggregator results(design.names());
+    auto evaluate = [&](size_t i) {
+        COSMIC_TRACE_SCOPE_CAT("sweep::point", "simulation");
+        Point point{i, pointSeed(seed, i), &design.names(), &design.point(i)};
+        results.add(point, task(point));
+    };
+    if (pool) {
+        pool->run(design.size(), evaluate);
+    } else {
+        for (size_t i = 0; i < design.size(); ++i) evaluate(i);
+    }
+    return results;
+}
+
+// ============================================================================
+// Built-in Tasks
+// ============================================================================
+
+namespace tasks {
+
+namespace {
+
+double paramOr(const Point& point, const std::string& name, double fallback) {
+    for (size_t i = 0; i < point.names->size(); ++i) {
+        if ((*point.names)[i] == name) return (*point.values)[i];
+    }
+    return fallback;
+}
+
+} // namespace
+
+Task system2(size_t steps, double dt) {
+    return [steps, dt](const Point& point) {
+        double universal = paramOr(point, "universal", 0.5);
+        double particular = paramOr(point, "particular", 1.0 - universal);
+        system2::System2 sys(universal, particular, paramOr(point, "rate", 0.1));
+
+        RunningStats polarity;
+        RunningStats coalescence;
+        size_t subjective = 0;
+        for (size_t s = 0; s < steps; ++s) {
+            sys.step(dt);
+            polarity.add(sys.modePolarity());
+            coalescence.add(sys.coalescence().strength());
+            if (sys.currentMode() == system2::Mode::SUBJECTIVE) ++subjective;
+        }
+        return Metrics{
+            {"mean_mode_polarity", polarity.mean()},
+            {"mean_coalescence", coalescence.mean()},
+            {"subjective_fraction", steps ? static_cast<double>(subjective) / steps : 0.0},
+            {"cycles", static_cast<double>(sys.transposition().cycleCount())}};
+    };
+}
+
+Task loon(size_t steps, double dt) {
+    return [steps, dt](const Point& point) {
+        system1::LoonAnalogy loon;
+        loon.setEnhancementFactor(paramOr(point, "enhancement_factor", 1.1));
+        RunningStats balance;
+        for (size_t s = 0; s < steps; ++s) {
+            loon.communicate(dt);
+            balance.add(loon.communicativeBalance());
+        }
+        return Metrics{
+            {"final_intensity", loon.system().center().intensity()},
+            {"mean_balance", balance.mean()},
+            {"accumulated_efflux", loon.system().interface().accumulatedEfflux()}};
+    };
+}
+
+Task flashlight(size_t steps, double dt) {
+    return [steps, dt](const Point& point) {
+        int count = static_cast<int>(std::llround(paramOr(point, "count", 100.0)));
+        system2::FlashlightAnalogy lights(std::max(count, 1), point.seed);
+        RunningStats output;
+        for (size_t s = 0; s < steps; ++s) {
+            lights.step(dt);
+            output.add(lights.totalLightOutput());
+        }
+        return Metrics{
+            {"mean_output", output.mean()},
+            {"output_stddev", output.stddev()},
+            {"min_output", output.min()},
+            {"max_output", output.max()}};
+    };
+}
+
+} // namespace tasks
+
+} // namespace sweep
+} // namespace cosmic
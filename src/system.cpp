@@ -4,6 +4,9 @@
  */
 
 #include "cosmic/system.hpp"
+#include "cosmic/metrics.hpp"
+#include "cosmic/parallel.hpp"
+#include "cosmic/tracing.hpp"
 #include <stdexcept>
 #include <algorithm>
 #include <sstream>
@@ -32,6 +35,11 @@ Term::Term(const std::string& name) : name_(name) {}
 Term::Term(const std::string& name, TriadicTerm type)
     : name_(name), triadic_type_(type) {}
 
+Term::Term(const Term& other)
+    : name_(other.name_), description_(other.description_), triadic_type_(other.triadic_type_),
+      sub_terms_(other.sub_terms_, memory::resource(memory::Subsystem::TERMS)),
+      parent_(other.parent_) {}
+
 void Term::addSubTerm(TermPtr term) {
     term->parent_ = this;
     sub_terms_.push_back(term);
@@ -142,54 +150,9 @@ System::System(int level) : level_(level) {
         throw std::invalid_argument("System level must be between 0 and 10");
     }
     
-    // Set system names and descriptions based on level
     // Term counts follow OEIS A000081(n+1), clusters follow OEIS A000055(n+1)
-    switch (level) {
-        case 0:
-            name_ = "System 0";
-            description_ = "The Void - root only, primordial unity before differentiation (1 term, 1 cluster)";
-            break;
-        case 1:
-            name_ = "System 1";
-            description_ = "Universal Wholeness - active interface between inside and outside (1 term, 1 cluster)";
-            break;
-        case 2:
-            name_ = "System 2";
-            description_ = "The Fundamental Dyad - objective and subjective modes (2 terms, 1 cluster)";
-            break;
-        case 3:
-            name_ = "System 3";
-            description_ = "The Primary Activity - four terms in two clusters (4 terms, 2 clusters)";
-            break;
-        case 4:
-            name_ = "System 4";
-            description_ = "The Enneagram - nine terms in three clusters (9 terms, 3 clusters)";
-            break;
-        case 5:
-            name_ = "System 5";
-            description_ = "Complementary Structures - twenty terms in six clusters (20 terms, 6 clusters)";
-            break;
-        case 6:
-            name_ = "System 6";
-            description_ = "Primary Activity of Enneagrams - 48 terms in 11 clusters";
-            break;
-        case 7:
-            name_ = "System 7";
-            description_ = "Enneagram of Enneagrams - 115 terms in 23 clusters";
-            break;
-        case 8:
-            name_ = "System 8";
-            description_ = "Nested Complementarity - 286 terms in 47 clusters";
-            break;
-        case 9:
-            name_ = "System 9";
-            description_ = "Deep Nesting - 719 terms in 106 clusters";
-            break;
-        case 10:
-            name_ = "System 10";
-            description_ = "Full Recursive Elaboration - 1842 terms in 235 clusters";
-            break;
-    }
+    name_ = std::string(util::SYSTEM_NAMES[level]);
+    description_ = std::string(util::SYSTEM_DESCRIPTIONS[level]);
 }
 
 std::optional<Interface> System::secondaryInterface() const {
@@ -241,6 +204,7 @@ size_t System::nodeCount() const {
 }
 
 void System::build() {
+    COSMIC_METRIC_TIMER("System::build");
     switch (level_) {
         case 0: buildSystem0(); break;
         case 1: buildSystem1(); break;
@@ -254,6 +218,8 @@ void System::build() {
         case 9: buildSystem9(); break;
         case 10: buildSystem10(); break;
     }
+    COSMIC_METRIC_COUNT_LABELED("cosmic_terms_built_total", "Terms built by System::build",
+                                "level=\"" + std::to_string(level_) + "\"", allTerms().size());
 }
 
 void System::buildSystem0() {
@@ -288,9 +254,9 @@ void System::buildSystem3() {
     
     // Each triadic term contains nested Idea/Routine/Form
     for (auto& term : triadic_terms_) {
-        auto idea = std::make_shared<Term>("Idea", TriadicTerm::Idea);
-        auto routine = std::make_shared<Term>("Routine", TriadicTerm::Routine);
-        auto form = std::make_shared<Term>("Form", TriadicTerm::Form);
+        auto idea = Term::create("Idea", TriadicTerm::Idea);
+        auto routine = Term::create("Routine", TriadicTerm::Routine);
+        auto form = Term::create("Form", TriadicTerm::Form);
         
         term->addSubTerm(idea);
         term->addSubTerm(routine);
@@ -411,32 +377,32 @@ void System::buildSystem10() {
 
 Term::TermPtr System::createTriadicTerm(TriadicTerm type, const std::string& context) {
     std::string name = util::triadicTermName(type, context);
-    return std::make_shared<Term>(name, type);
+    return Term::create(name, type);
 }
 
 Enneagram::EnneagramPtr System::createEnneagram(const std::string& name, bool withSubTerms) {
-    auto ennea = std::make_shared<Enneagram>(name);
+    auto ennea = Enneagram::create(name);
     
     // Create terms for each position
     for (int i = 1; i <= 9; ++i) {
         auto pos = static_cast<EnneagramPosition>(i);
         std::string term_name = "Term " + std::to_string(i);
-        auto term = std::make_shared<Term>(term_name);
+        auto term = Term::create(term_name);
         
         // Positions 3, 6, 9 are the triadic positions
         if (i == 3) {
-            term = std::make_shared<Term>("Idea", TriadicTerm::Idea);
+            term = Term::create("Idea", TriadicTerm::Idea);
         } else if (i == 6) {
-            term = std::make_shared<Term>("Routine", TriadicTerm::Routine);
+            term = Term::create("Routine", TriadicTerm::Routine);
         } else if (i == 9) {
-            term = std::make_shared<Term>("Form", TriadicTerm::Form);
+            term = Term::create("Form", TriadicTerm::Form);
         }
         
         if (withSubTerms) {
             // Add nested triadic structure
-            term->addSubTerm(std::make_shared<Term>("Sub-Idea", TriadicTerm::Idea));
-            term->addSubTerm(std::make_shared<Term>("Sub-Routine", TriadicTerm::Routine));
-            term->addSubTerm(std::make_shared<Term>("Sub-Form", TriadicTerm::Form));
+            term->addSubTerm(Term::create("Sub-Idea", TriadicTerm::Idea));
+            term->addSubTerm(Term::create("Sub-Routine", TriadicTerm::Routine));
+            term->addSubTerm(Term::create("Sub-Form", TriadicTerm::Form));
         }
         
         ennea->setTermAt(pos, term);
@@ -461,22 +427,41 @@ Enneagram::EnneagramPtr System::createNestedEnneagram(const std::string& name, i
 }
 
 System::SystemPtr System::createHierarchy() {
-    // Create all 10 systems
-    std::vector<SystemPtr> systems;
-    for (int i = 1; i <= 10; ++i) {
-        auto sys = std::make_shared<System>(i);
-        sys->build();
-        systems.push_back(sys);
+    return createHierarchy(nullptr);
+}
+
+System::SystemPtr System::createHierarchy(parallel::Executor* pool, int levels) {
+    COSMIC_TRACE_SCOPE_CAT("System::createHierarchy", "system");
+    COSMIC_METRIC_TIMER("System::createHierarchy");
+    if (levels < 1 || levels > 10) {
+        throw std::invalid_argument("Hierarchy levels must be 1-10");
     }
     
+    // Create the systems; each build is independent of the others
+    std::vector<SystemPtr> systems(static_cast<size_t>(levels));
+    parallel::parallelFor(pool, 0, systems.size(), 1, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            COSMIC_TRACE_SCOPE_CAT("System::build", "system");
+            auto sys = std::make_shared<System>(static_cast<int>(i) + 1);
+            sys->build();
+            systems[i] = sys;
+        }
+    });
+    
+    return linkHierarchy(systems);
+}
+
+System::SystemPtr System::linkHierarchy(const std::vector<SystemPtr>& systems) {
+    if (systems.empty()) return nullptr;
+    
     // Link parent-child relationships
     // Lower systems transcend and subsume higher systems
-    for (int i = 0; i < 9; ++i) {
+    for (size_t i = 0; i + 1 < systems.size(); ++i) {
         systems[i]->children_.push_back(systems[i + 1]);
         systems[i + 1]->parent_ = systems[i];
     }
     
-    return systems[0];  // Return System 1 as root
+    return systems[0];  // Return the lowest system as root
 }
 
 System::SystemPtr System::getSystem(SystemPtr root, int level) {
@@ -581,61 +566,16 @@ size_t nodeCountForLevel(int level) {
 }
 
 std::map<std::string, std::string> cosmicMovieDescriptions() {
-    return {
-        {"galaxy_idea", 
-         "The integrating idea of a galaxy must retain synchronicity with the "
-         "universal projection of hydrogen. This is done via black holes in their "
-         "centers. This singular condition common to all galaxies links them by "
-         "quantum forces. Integration regulates relative angular and linear motions."},
-        
-        {"galaxy_routine",
-         "Routine cyclic motions in galaxies cause dissynchronicity with the primary "
-         "projection of hydrogen. This space-time contraction in galactic interiors is "
-         "partly offset by spatial contraction of hydrogen into heavy atoms by nuclear "
-         "fusion in centers of stars. Space frame skipping leaves a central black hole."},
-        
-        {"galaxy_form",
-         "Galactic integration, via angular momentum, winds up nuclear fusion in "
-         "stars, as gravitational unit forms synchronous with the whole. Stars contract "
-         "in clouds ejected from galactic centers, move out, then recycle back to the "
-         "center, drawn by spatial contraction through maturing into heavy atoms."},
-        
-        {"sun_idea",
-         "The integrating idea of stars retains synchronicity with the universal "
-         "projection of hydrogen by contracting space into heavier elements. This "
-         "partly offsets the skipping of space frames due to galactic rotation. Solar "
-         "system momentum is likewise directed by quantum forces through reflux."},
-        
-        {"sun_routine",
-         "Routines altering momentum in stars and planets adjust for spatial gaps due "
-         "to atomic fusion in suns, radioactive decay in planets, & galactic motions. "
-         "This maintains synchronous integrity in solar systems, always monitored by "
-         "electromagnetic factors linked direct to the primary projection of hydrogen."},
-        
-        {"sun_form",
-         "The patterned form of cyclic motions and electromagnetic order in suns and "
-         "planets introduces less pronounced contractions in space & time. The "
-         "cascading focus shifts to exploring many synchronous forms of molecular "
-         "chemistry in widely varied planets and moons. Atoms marry up."},
-        
-        {"planet_idea",
-         "The electromagnetic and gravitational form of the sun relates via cyclic "
-         "routines to events in planets and moons, all linked to galactic order. This "
-         "directs the chemical integration of planets as synchronous ideas consistent "
-         "with the primary projection of hydrogen in the cosmic movie."},
-        
-        {"planet_routine",
-         "Planets are bathed in solar electromagnetic energy, modulated in patterns by "
-         "cyclic routines of rotation & lunar and solar revolutions. Cyclic routines, "
-         "electromagnetic fields, core currents, and plate tectonics, are adjusted by "
-         "reflux on a planetary scale to maintain synchronicity via quantum forces."},
-        
-        {"planet_form",
-         "The diverse chemical integration of planets, via galactic, solar & planet "
-         "routines, fosters biospheric evolution of life if possible. It is probably "
-         "seeded by spores from an interstellar gene pool, eternally linked to the "
-         "galaxy. Life evolves to transcending awareness of the eternal cosmic order."}
+    static const char* const KEYS[] = {
+        "galaxy_idea", "galaxy_routine", "galaxy_form",
+        "sun_idea", "sun_routine", "sun_form",
+        "planet_idea", "planet_routine", "planet_form"
     };
+    std::map<std::string, std::string> descriptions;
+    for (size_t i = 0; i < COSMIC_MOVIE.size(); ++i) {
+        descriptions[KEYS[i]] = std::string(COSMIC_MOVIE[i]);
+    }
+    return descriptions;
 }
 
 std::map<std::string, std::string> biologicalHierarchyDescriptions() {
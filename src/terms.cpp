@@ -7,6 +7,7 @@
  */
 
 #include "cosmic/terms.hpp"
+#include "cosmic/static_trees.hpp"
 #include <sstream>
 #include <algorithm>
 
@@ -223,6 +224,43 @@ public:
 // Verification Functions
 // ============================================================================
 
+// The hand-written tables, checked against the constexpr enumeration
+
+constexpr bool countsMatchEnumeration() {
+    for (int n = 1; n < static_cast<int>(A000081.size()); ++n) {
+        if (A000081[n] != trees::rootedTreeCount(n)) return false;
+    }
+    return true;
+}
+static_assert(countsMatchEnumeration(), "A000081 table disagrees with tree enumeration");
+
+static_assert(A000055[1] == trees::STATIC_TREES<1>.clusterCount() &&
+              A000055[2] == trees::STATIC_TREES<2>.clusterCount() &&
+              A000055[3] == trees::STATIC_TREES<3>.clusterCount() &&
+              A000055[4] == trees::STATIC_TREES<4>.clusterCount() &&
+              A000055[5] == trees::STATIC_TREES<5>.clusterCount() &&
+              A000055[6] == trees::STATIC_TREES<6>.clusterCount() &&
+              A000055[7] == trees::STATIC_TREES<7>.clusterCount() &&
+              A000055[8] == trees::STATIC_TREES<8>.clusterCount() &&
+              A000055[9] == trees::STATIC_TREES<9>.clusterCount(),
+              "A000055 table disagrees with tree enumeration");
+
+/// Every System 5 term is a distinct canonical 6-node tree in its own cluster
+constexpr bool system5TermsMatchEnumeration() {
+    constexpr const auto& trees6 = trees::STATIC_TREES<6>;
+    bool used[trees6.count()] = {};
+    for (const auto& term : SYSTEM5_TERMS) {
+        if (trees::parenthesesSize(term.treeStructure) != 6) return false;
+        if (!trees::isCanonicalParentheses(term.treeStructure)) return false;
+        size_t i = trees6.find(trees::packParentheses(term.treeStructure));
+        if (i == trees6.count() || used[i]) return false;
+        used[i] = true;
+        if (trees6.cluster(i) != static_cast<uint32_t>(term.cluster)) return false;
+    }
+    return true;
+}
+static_assert(system5TermsMatchEnumeration(), "System 5 term trees disagree with tree enumeration");
+
 /**
  * @brief Verify that term counts match OEIS A000081
  */
@@ -0,0 +1,270 @@
+/**
+ * @file tracing.cpp
+ * @brief Implementation of tracing spans and Chrome trace-event export
+ */
+
+#include "cosmic/tracing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace cosmic {
+namespace tracing {
+
+namespace detail {
+std::atomic<bool> recording{false};
+} // namespace detail
+
+namespace {
+
+constexpr size_t CHUNK_EVENTS = 4096;
+
+/**
+ * Append-only chunk list written by one thread. The owner publishes each
+ * event with a release store of the chunk count, so readers never lock.
+ */
+struct Chunk {
+    Event events[CHUNK_EVENTS];
+    std::atomic<size_t> count{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer {
+    uint32_t id = 0;
+    std::string name;                    // Guarded by the registry mutex
+    std::atomic<uint64_t> generation{0};
+    Chunk head;
+    Chunk* tail = &head;                 // Owner only
+
+    ~ThreadBuffer() { release(); }
+
+    void release() {
+        Chunk* c = head.next.load(std::memory_order_acquire);
+        while (c) {
+            Chunk* next = c->next.load(std::memory_order_acquire);
+            delete c;
+            c = next;
+        }
+        head.next.store(nullptr, std::memory_order_release);
+    }
+
+    // Owner only: drop events of an earlier session
+    void reset(uint64_t gen) {
+        release();
+        head.count.store(0, std::memory_order_release);
+        tail = &head;
+        generation.store(gen, std::memory_order_release);
+    }
+
+    // Owner only
+    void append(const Event& e) {
+        size_t n = tail->count.load(std::memory_order_relaxed);
+        if (n == CHUNK_EVENTS) {
+            Chunk* fresh = new Chunk;
+            tail->next.store(fresh, std::memory_order_release);
+            tail = fresh;
+            n = 0;
+        }
+        tail->events[n] = e;
+        tail->count.store(n + 1, std::memory_order_release);
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<uint64_t> generation{1};
+    std::atomic<int64_t> epoch_ns{0};
+};
+
+// Leaked on purpose: threads may still close spans during static destruction
+Registry& registry() {
+    static Registry* r = new Registry;
+    return *r;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> tls_buffer;
+thread_local uint32_t tls_depth = 0;
+
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ThreadBuffer& localBuffer() {
+    if (!tls_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer->id = static_cast<uint32_t>(r.buffers.size());
+        buffer->generation.store(r.generation.load(), std::memory_order_relaxed);
+        r.buffers.push_back(buffer);
+        tls_buffer = std::move(buffer);
+    }
+    return *tls_buffer;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (const char* p = text; *p; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                } else {
+                    out << *p;
+                }
+        }
+    }
+}
+
+void writeMicros(std::ostream& out, uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%03u",
+                  static_cast<unsigned long long>(ns / 1000),
+                  static_cast<unsigned>(ns % 1000));
+    out << buf;
+}
+
+} // namespace
+
+// ============================================================================
+// Span Recording
+// ============================================================================
+
+namespace detail {
+
+uint64_t now() {
+    int64_t elapsed = steadyNanos() - registry().epoch_ns.load(std::memory_order_relaxed);
+    return elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+}
+
+uint32_t enter() {
+    return tls_depth++;
+}
+
+void leave(const char* name, const char* category, uint64_t start, uint32_t depth) {
+    uint64_t end = now();
+    --tls_depth;
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t gen = registry().generation.load(std::memory_order_acquire);
+    if (buffer.generation.load(std::memory_order_relaxed) != gen) buffer.reset(gen);
+    buffer.append(Event{name, category, start, end > start ? end - start : 0, buffer.id, depth});
+}
+
+} // namespace detail
+
+// ============================================================================
+// Sessions
+// ============================================================================
+
+void start() {
+    Registry& r = registry();
+    r.epoch_ns.store(steadyNanos(), std::memory_order_relaxed);
+    r.generation.fetch_add(1, std::memory_order_acq_rel);
+    detail::recording.store(true, std::memory_order_release);
+}
+
+void stop() {
+    detail::recording.store(false, std::memory_order_release);
+}
+
+void clear() {
+    // Buffers notice the new generation and reset themselves on their next
+    // span; stale buffers are skipped by readers
+    registry().generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+std::vector<Event> events() {
+    Registry& r = registry();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffers = r.buffers;
+    }
+    uint64_t gen = r.generation.load(std::memory_order_acquire);
+
+    std::vector<Event> result;
+    for (const auto& buffer : buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) != gen) continue;
+        for (const Chunk* c = &buffer->head; c; c = c->next.load(std::memory_order_acquire)) {
+            size_t n = c->count.load(std::memory_order_acquire);
+            result.insert(result.end(), c->events, c->events + n);
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), [](const Event& a, const Event& b) {
+        if (a.thread != b.thread) return a.thread < b.thread;
+        return a.start_ns < b.start_ns;
+    });
+    return result;
+}
+
+// ============================================================================
+// Chrome Trace-Event Export
+// ============================================================================
+
+void writeChromeJSON(std::ostream& out) {
+    auto spans = events();
+    std::vector<std::pair<uint32_t, std::string>> names;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const auto& buffer : r.buffers) {
+            if (!buffer->name.empty()) names.emplace_back(buffer->id, buffer->name);
+        }
+    }
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+    for (const auto& entry : names) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << entry.first
+            << ",\"args\":{\"name\":\"";
+        writeEscaped(out, entry.second.c_str());
+        out << "\"}}";
+    }
+    for (const auto& e : spans) {
+        separator();
+        out << "{\"name\":\"";
+        writeEscaped(out, e.name);
+        out << "\",\"cat\":\"";
+        writeEscaped(out, e.category);
+        out << "\",\"ph\":\"X\",\"ts\":";
+        writeMicros(out, e.start_ns);
+        out << ",\"dur\":";
+        writeMicros(out, e.duration_ns);
+        out << ",\"pid\":1,\"tid\":" << e.thread << ",\"args\":{\"depth\":" << e.depth << "}}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void saveChromeJSON(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    writeChromeJSON(out);
+}
+
+} // namespace tracing
+} // namespace cosmic
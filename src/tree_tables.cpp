@@ -0,0 +1,25 @@
+/**
+ * @file tree_tables.cpp
+ * @brief Empty tree tables, used when COSMIC_EMBED_TREE_TABLES is off
+ *
+ * With the option on, this file is replaced by the one cosmic_tree_tables
+ * generates.
+ */
+
+#include "cosmic/tree_tables.hpp"
+
+namespace cosmic {
+namespace trees {
+namespace tables {
+
+const Table* find(int) {
+    return nullptr;
+}
+
+int maxNodes() {
+    return 0;
+}
+
+} // namespace tables
+} // namespace trees
+} // namespace cosmic
@@ -0,0 +1,20 @@
+# Check that the cosmic_gen lines in PARALLEL (n = 9 from rank 100) match
+# the same lines of the complete serial run in SERIAL.
+file(STRINGS ${SERIAL} serial_lines)
+file(STRINGS ${PARALLEL} parallel_lines)
+
+set(expected)
+foreach(line IN LISTS serial_lines)
+    if(line MATCHES "^9\t([0-9]+)\t" AND CMAKE_MATCH_1 GREATER_EQUAL 100)
+        list(APPEND expected "${line}")
+    endif()
+endforeach()
+
+list(LENGTH expected expected_count)
+list(LENGTH parallel_lines parallel_count)
+if(NOT expected_count EQUAL 186 OR NOT parallel_count EQUAL expected_count)
+    message(FATAL_ERROR "expected 186 lines, got ${expected_count} and ${parallel_count}")
+endif()
+if(NOT expected STREQUAL parallel_lines)
+    message(FATAL_ERROR "parallel output differs from serial output")
+endif()
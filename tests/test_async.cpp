@@ -0,0 +1,169 @@
+/**
+ * @file test_async.cpp
+ * @brief Tests for the C++20 coroutine API (built with COSMIC_ENABLE_COROUTINES)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cosmic/cosmic.hpp"
+
+using namespace cosmic;
+
+void test_task_basics() {
+    std::cout << "Testing tasks and syncWait..." << std::endl;
+
+    // Tasks are lazy, compose with co_await, and pass exceptions up
+    bool started = false;
+    auto answer = [&]() -> async::Task<int> {
+        started = true;
+        co_return 42;
+    };
+    auto doubled = [&]() -> async::Task<int> {
+        int value = co_await answer();
+        co_return 2 * value;
+    }();
+    assert(!started);
+    assert(async::syncWait(std::move(doubled)) == 84);
+    assert(started);
+
+    auto failing = []() -> async::Task<> {
+        throw std::runtime_error("boom");
+        co_return;
+    };
+    bool threw = false;
+    try { async::syncWait(failing()); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    // resumeOn moves the coroutine onto the executor
+    parallel::ThreadPool pool(2);
+    auto caller = std::this_thread::get_id();
+    auto hop = [&]() -> async::Task<std::thread::id> {
+        co_await async::resumeOn(&pool);
+        co_return std::this_thread::get_id();
+    };
+    assert(async::syncWait(hop()) != caller);
+
+    // runAll finishes every call, on the pool or inline
+    for (parallel::Executor* executor : {static_cast<parallel::Executor*>(&pool),
+                                         static_cast<parallel::Executor*>(nullptr)}) {
+        std::vector<int> squares(100);
+        auto fill = [&]() -> async::Task<> {
+            co_await async::runAll(executor, squares.size(), [&](size_t i) {
+                squares[i] = static_cast<int>(i * i);
+            });
+        };
+        async::syncWait(fill());
+        for (size_t i = 0; i < squares.size(); ++i) assert(squares[i] == static_cast<int>(i * i));
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_async_trees() {
+    std::cout << "Testing async tree generation..." << std::endl;
+
+    parallel::ThreadPool pool(2);
+    std::atomic<uint64_t> reported{0};
+    async::Context context{&pool, {}, [&](uint64_t done, uint64_t total) {
+        assert(done <= total);
+        reported = done;
+    }};
+
+    // Streaming trees: the canonical-sorted set of generate(n)
+    auto streamed = async::syncWait(async::collect(async::rootedTrees(9, context, 50)));
+    auto generated = trees::RootedTreeGenerator::generate(9);
+    assert(streamed.size() == generated.size());
+    assert(reported == generated.size());
+    std::vector<std::string> expected;
+    for (const auto& tree : generated) expected.push_back(tree.canonical());
+    std::sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < streamed.size(); ++i) assert(streamed[i].canonical() == expected[i]);
+
+    // The task version matches generate() exactly
+    auto task_trees = async::syncWait(async::generateTrees(9, context));
+    assert(task_trees.size() == generated.size());
+    for (size_t i = 0; i < generated.size(); ++i) assert(task_trees[i].canonical() == generated[i].canonical());
+
+    // Cancelling part way stops the stream with Cancelled
+    async::CancellationSource cancel;
+    async::Context cancellable{&pool, cancel.token(), {}};
+    size_t received = 0;
+    auto consume = [&]() -> async::Task<> {
+        auto stream = async::rootedTrees(12, cancellable, 100);
+        while (auto tree = co_await stream.next()) {
+            if (++received == 250) cancel.cancel();
+        }
+    };
+    bool cancelled = false;
+    try { async::syncWait(consume()); } catch (const async::Cancelled&) { cancelled = true; }
+    assert(cancelled && received == 250);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_async_hierarchy_and_export() {
+    std::cout << "Testing async hierarchy and export..." << std::endl;
+
+    parallel::ThreadPool pool(3);
+    std::atomic<uint64_t> systems_built{0};
+    async::Context context{&pool, {}, [&](uint64_t, uint64_t) { ++systems_built; }};
+
+    auto root = async::syncWait(async::createHierarchy(context));
+    assert(systems_built == 10);
+    auto reference = System::createHierarchy();
+    assert(System::getSystem(root, 10) && System::getSystem(root, 10)->parent());
+    std::string expected = ops::Serializer::hierarchyToJSON(reference);
+
+    // The chunked JSON joins into exactly hierarchyToJSON
+    async::Context plain{&pool, {}, {}};
+    assert(async::syncWait(async::hierarchyToJSON(root, plain)) == expected);
+    size_t pieces = 0;
+    auto count = [&]() -> async::Task<> {
+        auto chunks = async::hierarchyJSON(root, plain);
+        while (co_await chunks.next()) ++pieces;
+    };
+    async::syncWait(count());
+    assert(pieces == 11);  // One per System, and the closing brackets
+    assert(async::syncWait(async::hierarchyToJSON(nullptr, plain)) == "null");
+
+    bool threw = false;
+    try { async::syncWait(async::createHierarchy(plain, 11)); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // A cancelled token stops the build before any System is made
+    async::CancellationSource cancel;
+    cancel.cancel();
+    threw = false;
+    try {
+        async::syncWait(async::createHierarchy({&pool, cancel.token(), {}}));
+    } catch (const async::Cancelled&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // SVG, whole and in chunks
+    geometry::NestedEnneagramGeometry nested(1);
+    std::string svg = geometry::svg::nestedEnneagramSVG(nested, 600, 600);
+    assert(async::syncWait(async::nestedEnneagramSVG(nested, 600, 600, plain)) == svg);
+    auto joined = async::syncWait(async::concat(async::nestedEnneagramSVGChunks(nested, 600, 600, plain, 256)));
+    assert(joined == svg);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Async Tests ===" << std::endl;
+
+    test_task_basics();
+    test_async_trees();
+    test_async_hierarchy_and_export();
+
+    std::cout << "\nAll tests PASSED!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,356 @@
+/**
+ * @file test_service.cpp
+ * @brief Tests for the lookup service and sharded enumeration
+ */
+
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cosmic/cosmic.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace cosmic;
+
+void test_service() {
+    std::cout << "Testing the lookup service..." << std::endl;
+
+    parallel::ThreadPool pool(4);
+    service::Index pooled(&pool, 4);
+    service::Index index(nullptr, 4);
+    auto system3 = index.system(3);
+    assert(system3 && !index.system(5) && !index.system(0));
+
+    // Requests are answered in-process the same way the server answers them
+    auto ask = [&](service::Message request) {
+        request.id = 7;
+        auto response = index.handle(request);
+        assert(response.id == 7);
+        return response;
+    };
+    auto term = ask(service::Client::termRequest({3, {0}}));
+    assert(static_cast<service::Status>(term.code) == service::Status::OK);
+    auto info = service::Client::decodeTerm(term);
+    assert(info.name == system3->allTerms()[0]->name());
+    assert(info.type == system3->allTerms()[0]->triadicType());
+    assert(static_cast<service::Status>(ask(service::Client::termRequest({3, {99}})).code) ==
+           service::Status::NOT_FOUND);
+    assert(static_cast<service::Status>(ask(service::Client::termRequest({9, {0}})).code) ==
+           service::Status::NOT_FOUND);
+
+    // Ranks follow SystemTreeMapping, for all of Systems 0-10
+    auto system_trees = trees::SystemTreeMapping::getSystemTrees(6);
+    auto tree = index.treeByRank(6, 17);
+    assert(tree && tree->tree == system_trees[17].canonical());
+    assert(!index.treeByRank(6, static_cast<uint32_t>(system_trees.size())));
+    for (uint32_t rank = 0; rank < system_trees.size(); ++rank) {
+        auto found = index.treeOf(system_trees[rank].canonical());
+        assert(found && found->level == 6 && found->rank == rank);
+    }
+    auto clusters = trees::SystemTreeMapping::getSystemClusters(6);
+    assert(clusters[tree->cluster].size() == tree->cluster_size);
+    assert(!index.treeOf("(()"));
+    assert(!index.treeOf("(((((((((((())))))))))))"));  // 12 nodes: past System 10
+
+    // Built on a pool, the catalogs match (ServiceTestsGenerated runs this
+    // without embedded tables, so that index generates every level's trees)
+    for (int level = 0; level <= 10; ++level) {
+        auto expected = trees::SystemTreeMapping::getSystemTrees(level);
+        for (uint32_t rank = 0; rank < expected.size(); ++rank) {
+            auto built = pooled.treeByRank(level, rank);
+            assert(built && built->tree == expected[rank].canonical());
+            assert(built->cluster == index.treeByRank(level, rank)->cluster);
+        }
+        assert(!pooled.treeByRank(level, static_cast<uint32_t>(expected.size())));
+    }
+
+    // Malformed payloads and unknown ops
+    service::Message truncated{1, static_cast<uint8_t>(service::Op::TERM_BY_RANK), "x"};
+    assert(static_cast<service::Status>(index.handle(truncated).code) == service::Status::BAD_REQUEST);
+    service::Message unknown{1, 200, {}};
+    assert(static_cast<service::Status>(index.handle(unknown).code) == service::Status::UNKNOWN_OP);
+
+    // Frames split anywhere are reassembled
+    std::string stream;
+    service::appendFrame(stream, service::Client::clusterOfTreeRequest("(()())"));
+    service::appendFrame(stream, service::Client::termByRankRequest(2, 1));
+    std::string buffer;
+    size_t offset = 0;
+    service::Message message;
+    std::vector<service::Message> frames;
+    for (char c : stream) {
+        buffer += c;
+        while (service::takeFrame(buffer, offset, message)) frames.push_back(message);
+    }
+    assert(frames.size() == 2 && frames[1].payload.size() == 5);
+
+#ifdef __linux__
+    // A server on a thread, with pipelined requests from two clients
+    std::string path = "/tmp/cosmic_test_" + std::to_string(::getpid()) + ".sock";
+    service::Server server(index, path);
+    std::thread loop([&server] { server.run(); });
+    {
+        service::Client client(path);
+        assert(client.ping() == service::PROTOCOL_VERSION);
+        assert(client.term({3, {0}}).name == info.name);
+        assert(client.termByRank(6, 17).tree == tree->tree);
+        assert(client.clusterOfTree(tree->tree).rank == 17);
+
+        uint32_t mask = client.relations(1, 2);
+        uint32_t expected = 0;
+        for (auto type : ops::Relationships::getRelations(*index.system(1), *index.system(2))) {
+            expected |= 1u << static_cast<int>(type);
+        }
+        assert(mask == expected && mask != 0);
+        assert(client.connection(1, 4) == ops::Relationships::connectionType(1, 4));
+        assert(client.subtree({3, {}}) == ops::Serializer::toJSON(*system3));
+
+        bool threw = false;
+        try { client.termByRank(6, 100000); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+
+        service::Client other(path);
+        std::vector<service::Message> requests;
+        for (uint32_t rank = 0; rank < system_trees.size(); ++rank) {
+            requests.push_back(service::Client::termByRankRequest(6, rank));
+            requests.push_back(service::Client::clusterOfTreeRequest(system_trees[rank].canonical()));
+        }
+        auto responses = other.pipeline(requests);
+        assert(responses.size() == requests.size());
+        for (uint32_t rank = 0; rank < system_trees.size(); ++rank) {
+            auto by_rank = service::Client::decodeTree(responses[2 * rank]);
+            auto by_tree = service::Client::decodeTree(responses[2 * rank + 1]);
+            assert(by_rank.tree == system_trees[rank].canonical());
+            assert(by_tree.rank == rank && by_tree.cluster == by_rank.cluster);
+        }
+
+        // More input than one batch reads is answered over several turns, in order
+        uint32_t system10_trees = static_cast<uint32_t>(trees::SystemTreeMapping::getSystemTrees(10).size());
+        requests.clear();
+        for (uint32_t i = 0; i < 40000; ++i) {
+            requests.push_back(service::Client::termByRankRequest(10, i % system10_trees));
+        }
+        uint64_t batches_before = server.batches();
+        responses = other.pipeline(requests);
+        assert(responses.size() == requests.size());
+        for (uint32_t i = 0; i < requests.size(); i += 997) {
+            auto by_rank = service::Client::decodeTree(responses[i]);
+            assert(by_rank.rank == i % system10_trees);
+            assert(by_rank.tree == index.treeByRank(10, by_rank.rank)->tree);
+        }
+        assert(server.batches() - batches_before >= 3);  // 560 KB of requests
+    }
+    {
+        // A client that sends everything, shuts down its side and then reads
+        // still gets every response, though they exceed the socket buffer
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        assert(fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        std::string out;
+        const uint32_t count = 20000;
+        for (uint32_t i = 0; i < count; ++i) {
+            service::Message request{i, static_cast<uint8_t>(service::Op::SUBTREE), {}};
+            service::Writer(request.payload).address({3, {static_cast<uint8_t>(i % 3)}});
+            service::appendFrame(out, request);
+        }
+        for (size_t sent = 0; sent < out.size();) {
+            ssize_t n = ::write(fd, out.data() + sent, out.size() - sent);
+            assert(n > 0);
+            sent += static_cast<size_t>(n);
+        }
+        assert(::shutdown(fd, SHUT_WR) == 0);
+
+        std::string in;
+        char chunk[65536];
+        for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0;) in.append(chunk, static_cast<size_t>(n));
+        ::close(fd);
+        size_t offset = 0;
+        service::Message response;
+        uint32_t received = 0;
+        while (service::takeFrame(in, offset, response)) {
+            assert(response.id == received++);
+            assert(static_cast<service::Status>(response.code) == service::Status::OK);
+        }
+        assert(received == count && offset == in.size() && in.size() > (4u << 20));
+    }
+
+    // A second server leaves a live server's socket alone
+    bool refused = false;
+    try { service::Server second(index, path); } catch (const std::runtime_error&) { refused = true; }
+    assert(refused);
+    assert(service::Client(path).ping() == service::PROTOCOL_VERSION);
+
+    {
+        // Out of descriptors, the server waits for one to free up instead of
+        // spinning on accept(). The limit admits the client's socket but not
+        // the server's end of it, until the spare is closed.
+        // The server closes the connections above asynchronously, so wait
+        // until the lowest free descriptor stops moving
+        auto lowestFree = [] {
+            int fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            ::close(fd);
+            return fd;
+        };
+        for (int settled = 0, last = -1; settled < 10; ++settled) {
+            int fd = lowestFree();
+            if (fd != last) settled = 0;
+            last = fd;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        int spare = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        int probe = lowestFree();
+        assert(spare >= 0 && probe > spare);
+        rlimit limit;
+        assert(::getrlimit(RLIMIT_NOFILE, &limit) == 0);
+        rlimit lowered = limit;
+        lowered.rlim_cur = static_cast<rlim_t>(probe) + 1;
+        assert(::setrlimit(RLIMIT_NOFILE, &lowered) == 0);
+
+        service::Client starved(path);
+        std::atomic<uint32_t> version{0};
+        std::thread waiter([&] { version = starved.ping(); });
+        clockid_t server_clock;
+        assert(::pthread_getcpuclockid(loop.native_handle(), &server_clock) == 0);
+        auto cpuMicros = [server_clock] {
+            timespec now;
+            ::clock_gettime(server_clock, &now);
+            return now.tv_sec * 1000000L + now.tv_nsec / 1000;
+        };
+        long before = cpuMicros();
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        assert(version == 0);
+        assert(cpuMicros() - before < 250000);
+
+        ::close(spare);
+        waiter.join();
+        assert(version == service::PROTOCOL_VERSION);
+        assert(::setrlimit(RLIMIT_NOFILE, &limit) == 0);
+    }
+    server.stop();
+    loop.join();
+    assert(server.requests() >= 2 * system_trees.size() + 8);
+    assert(server.batches() < server.requests());
+
+    // A socket file whose server has exited is replaced; other files are not
+    std::string stale = path + ".stale";
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, stale.c_str(), sizeof(address.sun_path) - 1);
+        assert(fd >= 0 && ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        ::close(fd);
+        service::Server replacement(index, stale);
+    }
+    std::ofstream(stale) << "not a socket";
+    refused = false;
+    try { service::Server clobber(index, stale); } catch (const std::runtime_error&) { refused = true; }
+    assert(refused);
+    std::string kept;
+    std::getline(std::ifstream(stale), kept);
+    assert(kept == "not a socket");
+    std::remove(stale.c_str());
+#endif
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_sharding() {
+    std::cout << "Testing sharded enumeration..." << std::endl;
+
+    // Plans cover every rank once, in contiguous ranges
+    auto shards = sharding::plan(9, 4);
+    assert(shards.size() == 4);
+    uint64_t next = 0;
+    for (const auto& shard : shards) {
+        assert(shard.first_rank == next && shard.total == 4);
+        next += shard.count;
+    }
+    assert(next == enumeration::rootedTreeCount(9));
+    assert(sharding::plan(3, 10).size() == 2);
+
+    // Shards written out of order merge into the catalog of the whole size
+    std::string base = "/tmp/cosmic_shard_test_" + std::to_string(std::random_device{}());
+    std::vector<std::string> paths;
+    for (auto shard = shards.rbegin(); shard != shards.rend(); ++shard) {
+        paths.push_back(base + "_" + std::to_string(shard->index) + ".bin");
+        assert(!sharding::shardComplete(paths.back(), *shard));
+        auto stats = sharding::writeShard(*shard, paths.back());
+        assert(stats.trees == shard->count && stats.clusters <= stats.trees);
+        assert(sharding::shardComplete(paths.back(), *shard));
+        assert(!sharding::shardComplete(paths.back(), shards[(shard->index + 1) % 4]));
+    }
+    std::string output = base + "_catalog.bin";
+    auto stats = sharding::merge(9, paths, output);
+    assert(stats.trees == enumeration::rootedTreeCount(9));
+    assert(stats.clusters == enumeration::freeTreeCount(9));
+
+    // The catalog is the cluster keys, then every tree with its cluster id in rank order
+    std::ifstream in(output, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto header = [&](size_t offset) {
+        return enumeration::parseHeader(reinterpret_cast<const uint8_t*>(bytes.data()) + offset,
+                                        bytes.size() - offset);
+    };
+    auto word = [&](size_t offset) {
+        uint64_t value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    };
+    auto clusters = header(0);
+    assert(clusters.kind == enumeration::CatalogKind::FREE && clusters.count == stats.clusters);
+    size_t trees_at = enumeration::CATALOG_HEADER_SIZE + 8 * clusters.count;
+    auto trees = header(trees_at);
+    assert(trees.flags == enumeration::CLUSTER_IDS && trees.recordSize() == 16);
+    assert(bytes.size() == trees_at + enumeration::CATALOG_HEADER_SIZE + 16 * trees.count);
+    enumeration::RootedSequence sequence(9);
+    size_t record = trees_at + enumeration::CATALOG_HEADER_SIZE;
+    for (uint64_t rank = 0; rank < trees.count; ++rank, record += 16) {
+        assert(word(record) == sequence.key());
+        uint64_t cluster = word(record + 8);
+        assert(word(enumeration::CATALOG_HEADER_SIZE + 8 * cluster) == enumeration::centerKey(sequence.levels()));
+        sequence.next();
+    }
+
+    // A missing shard fails the totals check
+    paths.pop_back();
+    bool threw = false;
+    try { sharding::merge(9, paths, output); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    for (const auto& path : paths) std::remove(path.c_str());
+    std::remove((base + "_0.bin").c_str());
+    std::remove(output.c_str());
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Service Tests ===" << std::endl;
+
+    test_service();
+    test_sharding();
+
+    std::cout << "\nAll tests PASSED!" << std::endl;
+    return 0;
+}
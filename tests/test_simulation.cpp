@@ -0,0 +1,1437 @@
+/**
+ * @file test_simulation.cpp
+ * @brief Tests for the simulation support modules (trace recording, networks,
+ *        checkpoints, batch kernels, sweeps,
+ *        animation, spectra, adaptive integration, loon populations, tracing,
+ *        metrics, memory resources, parallel scaling paths, executors)
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include "cosmic/cosmic.hpp"
+
+using namespace cosmic;
+
+void test_bit_encoders() {
+    std::cout << "Testing XOR and delta-of-delta encoders..." << std::endl;
+
+    std::vector<double> values;
+    for (int i = 0; i < 500; ++i) {
+        values.push_back(std::sin(i * 0.05) * 0.5 + (i % 7 == 0 ? 1e-3 : 0.0));
+    }
+    values.push_back(0.0);
+    values.push_back(-0.0);
+    values.push_back(1e300);
+
+    std::vector<uint8_t> xor_bytes;
+    recorder::XorEncoder xor_enc(xor_bytes);
+    for (double v : values) xor_enc.append(v);
+
+    recorder::XorDecoder xor_dec(xor_bytes.data(), xor_bytes.size());
+    for (double v : values) {
+        double d = xor_dec.next();
+        assert(std::memcmp(&d, &v, sizeof(double)) == 0);
+    }
+
+    std::vector<uint8_t> delta_bytes;
+    recorder::DeltaEncoder delta_enc(delta_bytes);
+    for (double v : values) delta_enc.append(v);
+
+    recorder::DeltaDecoder delta_dec(delta_bytes.data(), delta_bytes.size());
+    for (double v : values) {
+        double d = delta_dec.next();
+        assert(std::memcmp(&d, &v, sizeof(double)) == 0);
+    }
+
+    // A constant series costs one bit per sample after the first value
+    std::vector<uint8_t> flat;
+    recorder::DeltaEncoder flat_enc(flat);
+    for (int i = 0; i < 800; ++i) flat_enc.append(1.0);
+    assert(flat.size() <= 8 + 100 + 1);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_trace_recorder() {
+    std::cout << "Testing TraceRecorder..." << std::endl;
+
+    auto rec = recorder::TraceRecorder::forSystem2(64);
+    system2::System2 sys(0.6, 0.4, 0.1);
+    std::vector<double> mode_polarity;
+    for (int i = 0; i < 1000; ++i) {
+        sys.step(0.1);
+        rec.record(sys);
+        mode_polarity.push_back(sys.modePolarity());
+    }
+
+    assert(rec.rowCount() == 1000);
+    assert(rec.chunkCount() == 1000 / 64);
+    assert(rec.compressedBytes() < 1000 * rec.columns().size() * sizeof(double));
+
+    // Full scan covers sealed chunks and the active chunk
+    auto all = rec.scan("mode_polarity", 0.0, 1e9);
+    assert(all.size() == 1000);
+    for (size_t i = 0; i < all.size(); ++i) {
+        assert(all[i].value == mode_polarity[i]);
+    }
+
+    // Range scan
+    auto range = rec.scan("polarity", 10.0, 20.0);
+    assert(!range.empty());
+    for (const auto& s : range) {
+        assert(s.time >= 10.0 && s.time <= 20.0);
+        assert(std::abs(s.value - 0.2) < 1e-12);
+    }
+
+    auto buckets = rec.downsample("mode_polarity", 0.0, 100.0, 10);
+    assert(buckets.size() == 10);
+    size_t total = 0;
+    for (const auto& b : buckets) {
+        assert(b.count > 0);
+        assert(b.min <= b.mean && b.mean <= b.max);
+        total += b.count;
+    }
+    assert(total == 1000);
+
+    // Schema mismatch is rejected
+    bool threw = false;
+    try {
+        rec.record(system1::System1());
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_trace_file() {
+    std::cout << "Testing trace file round trip..." << std::endl;
+
+    const std::string path = "test_simulation_trace.ctrace";
+    {
+        auto rec = recorder::TraceRecorder::forSystem1(128);
+        system1::System1 sys(1.0, 1.2, 1.0);
+        for (int i = 0; i < 300; ++i) {
+            sys.step(0.5);
+            rec.record(sys);
+        }
+        rec.open(path);
+        for (int i = 0; i < 700; ++i) {
+            sys.step(0.5);
+            rec.record(sys);
+        }
+        assert(rec.isFileBacked());
+        assert(rec.scan("center_intensity", 0.0, 1e9).size() == 1000);
+        rec.close();
+    }
+
+    recorder::TraceReader reader(path);
+    assert(reader.rowCount() == 1000);
+    assert(reader.columns().size() == recorder::TraceRecorder::system1Columns().size());
+
+    auto samples = reader.scan("center_intensity", 100.0, 150.0);
+    assert(samples.size() == 101);
+    system1::System1 check(1.0, 1.2, 1.0);
+    for (int i = 0; i < 200; ++i) check.step(0.5);
+    assert(samples.front().time == check.time());
+    assert(samples.front().value == check.center().intensity());
+
+    auto buckets = reader.downsample("accumulated_efflux", 0.0, 500.0, 5);
+    assert(buckets.size() == 5);
+    assert(buckets[0].max < buckets[4].min);
+
+    std::remove(path.c_str());
+
+    // Assigning over a file-backed recorder finishes its file first
+    {
+        auto rec = recorder::TraceRecorder::forSystem1(128);
+        rec.open(path);
+        system1::System1 sys(1.0, 1.2, 1.0);
+        for (int i = 0; i < 200; ++i) {
+            sys.step(0.5);
+            rec.record(sys);
+        }
+        rec = recorder::TraceRecorder::forSystem1(128);
+        assert(!rec.isFileBacked() && rec.rowCount() == 0);
+        assert(recorder::TraceReader(path).rowCount() == 200);
+    }
+    std::remove(path.c_str());
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_parallel_reduce() {
+    std::cout << "Testing deterministic parallel reduction..." << std::endl;
+
+    std::vector<double> values(100000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(static_cast<double>(i)) * 1e-3 + 1.0 / (1.0 + i);
+    }
+    auto sum = [&](parallel::ThreadPool* pool) {
+        return parallel::parallelReduce(pool, 0, values.size(), 1000, 0.0,
+            [&](size_t lo, size_t hi) {
+                double s = 0.0;
+                for (size_t i = lo; i < hi; ++i) s += values[i];
+                return s;
+            },
+            [](double a, double b) { return a + b; });
+    };
+
+    double serial = sum(nullptr);
+    parallel::ThreadPool pool(4);
+    assert(pool.size() == 4);
+    for (int rep = 0; rep < 5; ++rep) {
+        assert(sum(&pool) == serial);
+    }
+
+    // Exceptions propagate to the caller
+    bool threw = false;
+    try {
+        parallel::parallelFor(&pool, 0, 100, 10, [](size_t lo, size_t) {
+            if (lo == 50) throw std::runtime_error("chunk failed");
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_sparse_coupling() {
+    std::cout << "Testing SparseCoupling..." << std::endl;
+
+    auto ring = network::SparseCoupling::ring(10, 2);
+    assert(ring.size() == 10);
+    assert(ring.nonZeros() == 40);
+    for (size_t i = 0; i < 10; ++i) assert(ring.degree(i) == 4);
+
+    // Duplicate edges merge; symmetric edges appear in both rows
+    auto g = network::SparseCoupling::fromEdges(3, {{0, 1, 1.0}, {0, 1, 0.5}, {2, 1, 2.0}});
+    assert(g.nonZeros() == 4);
+    std::vector<double> x = {1.0, 10.0, 100.0};
+    std::vector<double> y(3);
+    g.multiply(x.data(), y.data());
+    assert(y[0] == 15.0);
+    assert(y[1] == 1.5 + 200.0);
+    assert(y[2] == 20.0);
+
+    auto r1 = network::SparseCoupling::random(1000, 6.0, 42);
+    auto r2 = network::SparseCoupling::random(1000, 6.0, 42);
+    assert(r1.columns() == r2.columns());
+    assert(r1.nonZeros() > 5000 && r1.nonZeros() <= 6000);
+
+    bool threw = false;
+    try {
+        network::SparseCoupling::fromEdges(2, {{0, 5, 1.0}});
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_network_uncoupled() {
+    std::cout << "Testing uncoupled network matches System2..." << std::endl;
+
+    std::vector<system2::System2> systems;
+    for (int i = 0; i < 50; ++i) {
+        systems.emplace_back(0.3 + 0.01 * i, 0.7 - 0.01 * i, 0.05 + 0.003 * i);
+    }
+    auto net = network::System2Network::fromSystems(
+        systems, network::SparseCoupling::ring(50, 3), 0.0);
+
+    for (int s = 0; s < 400; ++s) {
+        net.step(0.25);
+        for (auto& sys : systems) sys.step(0.25);
+    }
+
+    for (size_t i = 0; i < systems.size(); ++i) {
+        assert(net.phase(i) == systems[i].transposition().phase());
+        assert(net.cycleCount(i) == systems[i].transposition().cycleCount());
+        assert(net.mode(i) == systems[i].currentMode());
+        assert(std::abs(net.coalescence(i) - systems[i].coalescence().strength()) < 1e-12);
+    }
+    assert(net.time() == 100.0);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_network_synchronization() {
+    std::cout << "Testing network synchronization and determinism..." << std::endl;
+
+    const size_t n = 5000;
+    auto make = [&](double strength) {
+        auto coupling = network::SparseCoupling::random(n, 8.0, 7);
+        coupling.normalizeRows();
+        network::System2Network net(std::move(coupling), strength);
+        for (size_t i = 0; i < n; ++i) {
+            net.setPhase(i, 6.283 * static_cast<double>((i * 7919) % n) / n);
+            net.setRate(i, 0.1 + 0.01 * std::sin(static_cast<double>(i)));
+        }
+        return net;
+    };
+
+    auto free_net = make(0.0);
+    auto coupled = make(1.0);
+    double r0 = coupled.orderParameters().coherence;
+    for (int s = 0; s < 500; ++s) {
+        free_net.step(0.1);
+        coupled.step(0.1);
+    }
+    auto op = coupled.orderParameters();
+    assert(op.coherence > 0.9);
+    assert(op.coherence > free_net.orderParameters().coherence);
+    assert(op.coherence > r0);
+    assert(op.mode_synchrony >= 0.5 && op.mode_synchrony <= 1.0);
+
+    // Same trajectory with a thread pool
+    parallel::ThreadPool pool(4);
+    auto threaded = make(1.0);
+    threaded.setThreadPool(&pool);
+    for (int s = 0; s < 500; ++s) threaded.step(0.1);
+    assert(threaded.phases() == coupled.phases());
+    auto op_threaded = threaded.orderParameters();
+    assert(op_threaded.coherence == op.coherence);
+    assert(op_threaded.mean_coalescence == op.mean_coalescence);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_checkpoint_replay() {
+    std::cout << "Testing checkpoint restore and deterministic replay..." << std::endl;
+
+    // System 2 ensemble
+    std::vector<system2::System2> ensemble;
+    for (int i = 0; i < 8; ++i) ensemble.emplace_back(0.4 + 0.05 * i, 0.6, 0.07 + 0.01 * i);
+    for (int s = 0; s < 123; ++s) for (auto& sys : ensemble) sys.step(0.3);
+    auto bytes = checkpoint::snapshot(ensemble);
+    assert(checkpoint::inspect(bytes).kind == checkpoint::Kind::SYSTEM2);
+    assert(checkpoint::inspect(bytes).count == 8);
+
+    std::vector<system2::System2> restored;
+    checkpoint::restore(bytes, restored);
+    assert(restored.size() == 8);
+    for (int s = 0; s < 200; ++s) {
+        for (size_t i = 0; i < ensemble.size(); ++i) {
+            ensemble[i].step(0.3);
+            restored[i].step(0.3);
+            assert(restored[i].modePolarity() == ensemble[i].modePolarity());
+            assert(restored[i].coalescence().strength() == ensemble[i].coalescence().strength());
+            assert(restored[i].universalCenter().relationalWhole().identityStrength() ==
+                   ensemble[i].universalCenter().relationalWhole().identityStrength());
+        }
+    }
+
+    // Loon analogy
+    system1::LoonAnalogy loon;
+    loon.setEnhancementFactor(1.05);
+    for (int s = 0; s < 50; ++s) loon.communicate(0.5);
+    system1::LoonAnalogy loon2;
+    checkpoint::restore(checkpoint::snapshot(loon), loon2);
+    for (int s = 0; s < 50; ++s) {
+        loon.communicate(0.5);
+        loon2.communicate(0.5);
+    }
+    assert(loon2.system().center().intensity() == loon.system().center().intensity());
+    assert(loon2.system().interface().accumulatedEfflux() == loon.system().interface().accumulatedEfflux());
+    assert(loon2.system().time() == loon.system().time());
+
+    // Flashlights: same seed gives the same field; generator state is restored
+    system2::FlashlightAnalogy lights(200, 99);
+    assert(system2::FlashlightAnalogy(200, 99).totalLightOutput() == lights.totalLightOutput());
+    system2::FlashlightAnalogy by_count = 200;  // the count-only constructor stays implicit
+    assert(by_count.totalLightOutput() ==
+           system2::FlashlightAnalogy(200, random::Rng::DEFAULT_SEED).totalLightOutput());
+    for (int s = 0; s < 30; ++s) lights.step(0.5);
+    system2::FlashlightAnalogy lights2(1, 1);
+    checkpoint::restore(checkpoint::snapshot(lights), lights2);
+    assert(lights2.rng()() == lights.rng()());
+    for (int s = 0; s < 30; ++s) {
+        lights.step(0.5);
+        lights2.step(0.5);
+    }
+    assert(lights2.totalLightOutput() == lights.totalLightOutput());
+
+    // Network
+    network::System2Network net(network::SparseCoupling::ring(64, 2), 0.3);
+    for (size_t i = 0; i < net.size(); ++i) net.setPhase(i, 0.1 * static_cast<double>(i));
+    for (int s = 0; s < 40; ++s) net.step(0.2);
+    network::System2Network net2(network::SparseCoupling{}, 0.0);
+    checkpoint::restore(checkpoint::snapshot(net), net2);
+    assert(net2.size() == 64);
+    for (int s = 0; s < 40; ++s) {
+        net.step(0.2);
+        net2.step(0.2);
+    }
+    assert(net2.phases() == net.phases());
+
+    // Corruption and kind mismatches are detected
+    auto corrupt = bytes;
+    corrupt.back() ^= 0x01;
+    bool threw = false;
+    try {
+        checkpoint::restore(corrupt, restored);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        system1::System1 s1;
+        checkpoint::restore(bytes, s1);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_async_checkpoint_writer() {
+    std::cout << "Testing AsyncWriter..." << std::endl;
+
+    const std::string path = "test_simulation_checkpoint.csnp";
+    system1::System1 sys(1.0, 1.3, 0.9);
+    {
+        checkpoint::AsyncWriter writer;
+        for (int i = 0; i < 10; ++i) {
+            sys.step(1.0);
+            writer.write(path, checkpoint::snapshot(sys));
+        }
+        writer.flush();
+        assert(writer.pending() == 0);
+        assert(writer.written() == 10);
+
+        // Errors surface on flush
+        writer.write("no_such_directory/checkpoint.csnp", checkpoint::snapshot(sys));
+        bool threw = false;
+        try {
+            writer.flush();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    system1::System1 restored;
+    checkpoint::restore(checkpoint::load(path), restored);
+    assert(restored.time() == sys.time());
+    assert(restored.center().intensity() == sys.center().intensity());
+    std::remove(path.c_str());
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_fastmath_kernels() {
+    std::cout << "Testing batched math kernels..." << std::endl;
+
+    std::vector<double> x;
+    for (int i = -5000; i <= 5000; ++i) x.push_back(i * 0.01337);
+    x.push_back(1e7);    // outside the polynomial range
+    x.push_back(-3e8);
+    const size_t n = x.size();
+
+    std::vector<double> c(n), s(n), s2(n), c2(n);
+    fastmath::cos(x.data(), c.data(), n, fastmath::Accuracy::FAST);
+    fastmath::sin(x.data(), s.data(), n, fastmath::Accuracy::FAST);
+    fastmath::sincos(x.data(), s2.data(), c2.data(), n, fastmath::Accuracy::FAST);
+    for (size_t i = 0; i < n; ++i) {
+        assert(std::abs(c[i] - std::cos(x[i])) < fastmath::FAST_TOLERANCE);
+        assert(std::abs(s[i] - std::sin(x[i])) < fastmath::FAST_TOLERANCE);
+        assert(s2[i] == s[i] && c2[i] == c[i]);
+    }
+
+    fastmath::cos(x.data(), c.data(), n, fastmath::Accuracy::EXACT);
+    for (size_t i = 0; i < n; ++i) assert(c[i] == std::cos(x[i]));
+
+    // In place, including arguments beyond the polynomial range
+    std::vector<double> wide = x;
+    wide.insert(wide.end(), {1e15, -2.5e18, 1e300});
+    const size_t m = wide.size();
+    std::vector<double> in_cos = wide, in_sin = wide, in_s = wide, in_c = wide, other(m), other2(m);
+    fastmath::cos(in_cos.data(), in_cos.data(), m, fastmath::Accuracy::FAST);
+    fastmath::sin(in_sin.data(), in_sin.data(), m, fastmath::Accuracy::FAST);
+    fastmath::sincos(in_s.data(), in_s.data(), other.data(), m, fastmath::Accuracy::FAST);
+    fastmath::sincos(in_c.data(), other2.data(), in_c.data(), m, fastmath::Accuracy::FAST);
+    for (size_t i = 0; i < m; ++i) {
+        assert(std::abs(in_cos[i] - std::cos(wide[i])) < fastmath::FAST_TOLERANCE);
+        assert(std::abs(in_sin[i] - std::sin(wide[i])) < fastmath::FAST_TOLERANCE);
+        assert(in_s[i] == in_sin[i] && other[i] == in_cos[i]);
+        assert(other2[i] == in_sin[i] && in_c[i] == in_cos[i]);
+        if (std::abs(wide[i]) > fastmath::FAST_RANGE) {
+            assert(in_cos[i] == std::cos(wide[i]) && in_sin[i] == std::sin(wide[i]));
+        }
+    }
+
+    std::vector<double> sq(n);
+    fastmath::sqrt(c2.data(), sq.data(), n);  // negative inputs give NaN
+    for (size_t i = 0; i < n; ++i) {
+        assert(c2[i] < 0.0 ? std::isnan(sq[i]) : sq[i] == std::sqrt(c2[i]));
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_ensemble_stepper() {
+    std::cout << "Testing EnsembleStepper..." << std::endl;
+
+    std::vector<system2::System2> scalar;
+    for (int i = 0; i < 64; ++i) scalar.emplace_back(0.2 + 0.01 * i, 0.5, 0.03 + 0.002 * i);
+    auto exact = scalar;
+    auto fast = scalar;
+
+    system2::EnsembleStepper exact_stepper;
+    system2::EnsembleStepper fast_stepper(fastmath::Accuracy::FAST);
+    for (int s = 0; s < 500; ++s) {
+        for (auto& sys : scalar) sys.step(0.2);
+        exact_stepper.step(exact, 0.2);
+        fast_stepper.step(fast, 0.2);
+    }
+
+    for (size_t i = 0; i < scalar.size(); ++i) {
+        assert(exact[i].transposition().phase() == scalar[i].transposition().phase());
+        assert(exact[i].modePolarity() == scalar[i].modePolarity());
+        assert(exact[i].coalescence().strength() == scalar[i].coalescence().strength());
+        assert(exact[i].time() == scalar[i].time());
+        assert(std::abs(fast[i].modePolarity() - scalar[i].modePolarity()) < 1e-6);
+    }
+
+    // The cached objective weight tracks the phase
+    const auto& t = scalar[3].transposition();
+    assert(t.objectiveWeight() == 0.5 * (1.0 + std::cos(t.phase())));
+    assert(t.subjectiveWeight() == 1.0 - t.objectiveWeight());
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_work_stealing_pool() {
+    std::cout << "Testing work-stealing ThreadPool..." << std::endl;
+
+    parallel::ThreadPool pool(3);
+    std::atomic<int> done{0};
+    std::mutex m;
+    std::condition_variable cv;
+
+    // Tasks spawning tasks: children land on the spawning worker's deque
+    for (int i = 0; i < 8; ++i) {
+        pool.submit([&] {
+            for (int k = 0; k < 16; ++k) {
+                pool.submit([&] {
+                    if (done.fetch_add(1) + 1 == 8 * 16) {
+                        std::lock_guard<std::mutex> lock(m);
+                        cv.notify_all();
+                    }
+                });
+            }
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return done.load() == 8 * 16; });
+    }
+
+    // Nested run() from inside a task completes
+    std::atomic<int> inner{0};
+    pool.run(4, [&](size_t) {
+        pool.run(10, [&](size_t) { inner.fetch_add(1); });
+    });
+    assert(inner.load() == 40);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_parameter_sweep() {
+    std::cout << "Testing parameter sweeps..." << std::endl;
+
+    auto grid = sweep::Design::grid({{"rate", {0.05, 0.1, 0.2}}, {"universal", {0.3, 0.7}}});
+    assert(grid.size() == 6);
+    assert(grid.point(1) == (std::vector<double>{0.05, 0.7}));
+    assert(grid.point(5) == (std::vector<double>{0.2, 0.7}));
+
+    auto design = sweep::Design::random({{"count", 10, 200}}, 40, 5);
+    assert(design.size() == 40);
+    for (size_t i = 0; i < design.size(); ++i) {
+        assert(design.point(i)[0] >= 10 && design.point(i)[0] <= 200);
+    }
+
+    // Same table regardless of pool
+    auto task = sweep::tasks::flashlight(50);
+    auto serial = sweep::run(design, task, nullptr, 11);
+    parallel::ThreadPool pool(4);
+    auto threaded = sweep::run(design, task, &pool, 11);
+    std::ostringstream a, b;
+    serial.writeCSV(a);
+    threaded.writeCSV(b);
+    assert(a.str() == b.str());
+    assert(threaded.size() == 40);
+    assert(threaded.summary("mean_output").count() == 40);
+    assert(threaded.summary("mean_output").mean() == serial.summary("mean_output").mean());
+
+    // Per-point seeds differ and feed the simulation
+    auto rows = threaded.rows();
+    assert(rows[0].seed == sweep::pointSeed(11, 0));
+    assert(rows[0].seed != rows[1].seed);
+
+    auto sys2 = sweep::run(grid, sweep::tasks::system2(400, 0.1), &pool);
+    auto by_rate = sys2.summaryBy("cycles", "rate");
+    assert(by_rate.size() == 3);
+    assert(by_rate[0.05].mean() < by_rate[0.2].mean());
+
+    auto loons = sweep::run(sweep::Design::grid({{"enhancement_factor", {1.0, 1.2}}}),
+                            sweep::tasks::loon(100), &pool);
+    auto loon_rows = loons.rows();
+    assert(loon_rows[0].metrics.at("final_intensity") > loon_rows[1].metrics.at("final_intensity"));
+
+    std::istringstream csv(b.str());
+    std::string header;
+    std::getline(csv, header);
+    assert(header == "index,seed,count,max_output,mean_output,min_output,output_stddev");
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_animation_streaming() {
+    std::cout << "Testing streaming animation..." << std::endl;
+
+    // Linear reconstruction from keyframes stays within tolerance
+    animation::LinearDecimator decimator(0.01);
+    std::vector<double> ts, vs;
+    std::vector<animation::LinearDecimator::Keyframe> keys;
+    animation::LinearDecimator::Keyframe key;
+    for (int i = 0; i < 2000; ++i) {
+        double t = i * 0.01;
+        double v = std::sin(t) + (i > 1000 ? 0.5 : 0.0);
+        ts.push_back(t);
+        vs.push_back(v);
+        if (decimator.add(t, v, key)) keys.push_back(key);
+    }
+    if (decimator.finish(key)) keys.push_back(key);
+    assert(keys.size() > 2 && keys.size() < 200);
+    assert(keys.front().time == 0.0 && keys.back().time == ts.back());
+    size_t seg = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+        while (keys[seg + 1].time < ts[i]) ++seg;
+        const auto& a = keys[seg];
+        const auto& b = keys[seg + 1];
+        double v = a.value + (b.value - a.value) * (ts[i] - a.time) / (b.time - a.time);
+        assert(std::abs(v - vs[i]) <= 0.01 + 1e-9);
+    }
+
+    // A long System 2 run becomes one small document
+    std::ostringstream smil;
+    system2::System2 sys;
+    size_t frames = 10000;
+    size_t channels = 0;
+    size_t snapshot_bytes = sys.toSVG().size();
+    {
+        animation::SmilWriter writer(smil, animation::system2Scene(), 0.1);
+        channels = animation::system2Scene().channels.size();
+        for (size_t i = 0; i < frames; ++i) {
+            sys.step(0.1);
+            writer.frame(sys);
+        }
+        writer.finish();
+        assert(writer.frameCount() == frames);
+        assert(writer.keyframeCount() < frames * channels / 4);
+    }
+    std::string doc = smil.str();
+    assert(doc.rfind("<?xml", 0) == 0);
+    assert(doc.size() >= 7 && doc.compare(doc.size() - 7, 7, "</svg>\n") == 0);
+    assert(doc.find("<animate xlink:href=\"#s2-phase\"") != std::string::npos);
+    assert(doc.find("<set xlink:href=\"#s2-universal\"") != std::string::npos);
+    assert(doc.size() < frames * snapshot_bytes / 20);
+
+    // Begin and duration are fixed-point clock values, even for long runs
+    std::ostringstream long_run;
+    {
+        animation::SmilWriter writer(long_run, animation::system1Scene());
+        for (int i = 0; i < 4; ++i) {
+            double level = i % 2 ? 50.0 : 0.0;
+            writer.frame(1234567.25 * i, {level, level, level});
+        }
+        writer.finish();
+    }
+    std::string long_doc = long_run.str();
+    assert(long_doc.find("begin=\"1234567.25s\" dur=\"1234567.25s\"") != std::string::npos);
+    assert(long_doc.find("e+") == std::string::npos);
+
+    // Mismatched scenes are rejected
+    std::ostringstream sink;
+    animation::SmilWriter wrong(sink, animation::system1Scene());
+    bool threw = false;
+    try {
+        wrong.frame(sys);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Delta stream: full first frame, then only visible changes
+    std::ostringstream delta;
+    system1::System1 s1;
+    animation::DeltaStreamWriter stream(delta, animation::system1Scene());
+    for (int i = 0; i < 500; ++i) {
+        s1.step(0.1);
+        stream.frame(s1);
+    }
+    stream.finish();
+    assert(stream.frameCount() == 500);
+    assert(stream.writtenFrameCount() >= 1 && stream.writtenFrameCount() <= 500);
+
+    std::istringstream in(delta.str());
+    std::string line;
+    std::getline(in, line);
+    assert(line == "COSMIC-ANIM 1");
+    std::getline(in, line);
+    assert(line == "scene 600 300 3");
+    for (int i = 0; i < 3; ++i) {
+        std::getline(in, line);
+        assert(line.rfind("channel " + std::to_string(i) + " s1-", 0) == 0);
+    }
+    std::getline(in, line);
+    size_t svg_bytes = std::stoul(line.substr(4));
+    std::string svg(svg_bytes, '\0');
+    in.read(&svg[0], static_cast<std::streamsize>(svg_bytes));
+    assert(svg.find("id=\"s1-center\"") != std::string::npos);
+    std::getline(in, line);
+    assert(line.rfind("f ", 0) == 0 && line.find(" 2=") != std::string::npos);
+    std::string last;
+    while (std::getline(in, line)) last = line;
+    assert(last == "end 500 " + std::to_string(stream.writtenFrameCount()));
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_spectral_analysis() {
+    std::cout << "Testing spectral analysis..." << std::endl;
+
+    // Mixed-radix FFT against a direct DFT
+    for (size_t n : {1u, 2u, 8u, 12u, 30u, 64u, 97u, 1000u}) {
+        std::vector<spectral::Complex> x(n);
+        random::Rng rng(n);
+        for (auto& v : x) v = spectral::Complex(rng.uniform(-1, 1), rng.uniform(-1, 1));
+        spectral::FFT fft(n);
+        auto X = fft.forward(x);
+        for (size_t k = 0; k < n; k += std::max<size_t>(1, n / 16)) {
+            spectral::Complex sum = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                sum += x[j] * std::polar(1.0, -2.0 * M_PI * double(j * k % n) / double(n));
+            }
+            assert(std::abs(sum - X[k]) < 1e-9 * double(n));
+        }
+        auto back = fft.inverse(X);
+        for (size_t j = 0; j < n; ++j) assert(std::abs(back[j] - x[j]) < 1e-12 * double(n));
+    }
+
+    // Real FFT matches the complex transform and round-trips
+    for (size_t n : {16u, 30u, 45u}) {
+        std::vector<double> x(n);
+        std::vector<spectral::Complex> xc(n);
+        random::Rng rng(n + 1);
+        for (size_t i = 0; i < n; ++i) xc[i] = x[i] = rng.uniform(-1, 1);
+        spectral::RealFFT rfft(n);
+        std::vector<spectral::Complex> bins(rfft.bins());
+        rfft.forward(x.data(), bins.data());
+        auto full = spectral::FFT(n).forward(xc);
+        for (size_t k = 0; k < rfft.bins(); ++k) assert(std::abs(bins[k] - full[k]) < 1e-10);
+        std::vector<double> y(n);
+        rfft.inverse(bins.data(), y.data());
+        for (size_t i = 0; i < n; ++i) assert(std::abs(y[i] - x[i]) < 1e-12);
+    }
+
+    // Welch finds a tone and the white-noise level
+    std::vector<double> tone(8192), noise(8192);
+    random::Rng rng(3);
+    for (size_t i = 0; i < tone.size(); ++i) {
+        tone[i] = std::sin(2.0 * M_PI * 12.5 * double(i) / 100.0);
+        noise[i] = std::sqrt(12.0) * (rng.uniform() - 0.5);  // unit variance
+    }
+    spectral::WelchOptions opt;
+    opt.sample_rate = 100.0;
+    auto s = spectral::welch(tone, opt);
+    assert(std::abs(s.peakFrequency() - 12.5) < 100.0 / 256.0);
+    assert(std::abs(s.totalPower() - 0.5) < 0.02);
+    opt.sample_rate = 1.0;
+    auto white = spectral::welch(noise, opt);
+    assert(white.segments == 63);
+    assert(std::abs(white.totalPower() - 1.0) < 0.05);
+
+    // Strided views read interleaved data in place
+    std::vector<double> interleaved(2 * tone.size());
+    for (size_t i = 0; i < tone.size(); ++i) interleaved[2 * i + 1] = tone[i];
+    auto strided = spectral::welch(spectral::SignalView(interleaved.data() + 1, tone.size(), 2));
+    assert(strided.power == spectral::welch(tone).power);
+
+    // Batches are independent of the pool
+    std::vector<spectral::SignalView> views{tone, noise, tone, noise};
+    parallel::ThreadPool pool(3);
+    auto serial = spectral::welch(views, opt);
+    auto threaded = spectral::welch(views, opt, &pool);
+    for (size_t i = 0; i < views.size(); ++i) assert(serial[i].power == threaded[i].power);
+    auto ensemble = spectral::mean(threaded);
+    assert(ensemble.segments == 4 * 63);
+
+    // Probe on a running System 2: the mode polarity oscillates at rate/2π
+    spectral::WelchOptions probe_opt;
+    probe_opt.segment = 1024;
+    probe_opt.overlap = 512;
+    probe_opt.sample_rate = 10.0;
+    spectral::System2Probe probe(probe_opt);
+    system2::System2 sys(0.5, 0.5, 0.5);
+    for (int i = 0; i < 20000; ++i) {
+        sys.step(0.1);
+        probe.record(sys);
+    }
+    auto modes = probe.spectrum(spectral::System2Probe::MODE_POLARITY);
+    assert(modes.segments > 30);
+    assert(std::abs(modes.peakFrequency() - 0.5 / (2.0 * M_PI)) < 2.0 * probe_opt.sample_rate / 1024);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_adaptive_integrator() {
+    std::cout << "Testing adaptive integrator..." << std::endl;
+
+    // Efflux relaxes to the reflux rate; the intensity change has a closed form
+    auto efflux = [](double t) { return 1.0 + 0.5 * std::exp(-t / 5.0) * std::sin(t); };
+    auto decay = [](double t) {  // ∫0^t e^(-s/5) sin s ds
+        return (std::exp(-0.2 * t) * (-0.2 * std::sin(t) - std::cos(t)) + 1.0) / 1.04;
+    };
+    auto exact = [&](double t) {
+        return 1.0 - system1::System1::TRANSFER_COEFFICIENT * 0.5 * decay(t);
+    };
+    const double t_end = 200.0;
+
+    integrator::Schedules rates;
+    rates.efflux = efflux;
+    integrator::Options opt;
+    opt.relative_tolerance = 1e-8;
+    opt.absolute_tolerance = 1e-10;
+    integrator::AdaptiveIntegrator rk(opt);
+    system1::System1 sys;
+    auto result = rk.integrate(sys, t_end, rates);
+    double rk_error = std::abs(sys.center().intensity() - exact(t_end));
+    assert(sys.time() == t_end);
+    assert(sys.interface().effluxRate() == efflux(t_end));
+    assert(std::abs(sys.interface().accumulatedEfflux() - (t_end + 0.5 * decay(t_end))) < 1e-6 * t_end);
+    assert(std::abs(sys.interface().accumulatedReflux() - t_end) < 1e-9);
+
+    // Fixed-step Euler needs far more steps for a worse answer
+    system1::System1 euler;
+    const double dt = 0.01;
+    size_t euler_steps = static_cast<size_t>(t_end / dt);
+    for (size_t i = 0; i < euler_steps; ++i) {
+        euler.interface().setEffluxRate(efflux(i * dt));
+        euler.step(dt);
+    }
+    double euler_error = std::abs(euler.center().intensity() - exact(t_end));
+    assert(rk_error < euler_error);
+    assert(result.accepted * 20 < euler_steps);
+
+    // Steps grow as the interface settles; dense output tracks the solution
+    const auto& dense = result.dense;
+    assert(dense.size() == result.accepted);
+    assert(dense.startTime() == 0.0 && dense.endTime() == t_end);
+    assert(dense.stepSize(dense.size() - 2) > 10.0 * dense.stepSize(1));
+    for (double t : {0.0, 0.37, 3.3, 17.0, 99.9, t_end}) {
+        assert(std::abs(dense.intensity(t) - exact(t)) < 1e-7);
+    }
+
+    // Constant rates integrate in a handful of steps
+    system1::System1 steady(1.0, 1.2, 1.0);
+    auto quick = rk.integrate(steady, 1000.0);
+    assert(quick.accepted < 40);
+    assert(std::abs(steady.center().intensity() - (1.0 - 0.2 * 0.01 * 1000.0)) < 1e-9);
+
+    // Ensembles are advanced independently of the pool
+    std::vector<system1::System1> a(16), b(16);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i].interface().setRefluxRate(0.9 + 0.01 * double(i));
+        b[i].interface().setRefluxRate(0.9 + 0.01 * double(i));
+    }
+    parallel::ThreadPool pool(3);
+    rk.integrate(a, 50.0, rates);
+    rk.integrate(b, 50.0, rates, &pool);
+    for (size_t i = 0; i < a.size(); ++i) {
+        assert(a[i].center().intensity() == b[i].center().intensity());
+    }
+
+    bool threw = false;
+    try {
+        rk.integrate(sys, 10.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_loon_population() {
+    std::cout << "Testing loon populations..." << std::endl;
+
+    // Uncoupled population reproduces independent analogies exactly
+    const size_t n = 10000;
+    std::vector<system1::LoonAnalogy> loons(37);
+    for (size_t i = 0; i < loons.size(); ++i) {
+        loons[i].setEnhancementFactor(0.9 + 0.01 * double(i));
+    }
+    auto lake = population::LoonPopulation::fromLoons(loons);
+    parallel::ThreadPool pool(3);
+    lake.setThreadPool(&pool);
+    for (int s = 0; s < 200; ++s) {
+        for (auto& loon : loons) loon.communicate(0.1);
+        lake.communicate(0.1);
+    }
+    for (size_t i = 0; i < loons.size(); ++i) {
+        auto expected = loons[i].state();
+        auto actual = lake.loon(i).state();
+        assert(actual.system.center_intensity == expected.system.center_intensity);
+        assert(actual.system.accumulated_efflux == expected.system.accumulated_efflux);
+        assert(actual.system.efflux_rate == expected.system.efflux_rate);
+        assert(lake.communicativeBalance(i) == loons[i].communicativeBalance());
+    }
+    assert(lake.time() == loons[0].system().time());
+
+    // The shared sky couples the loons; results do not depend on the pool
+    population::LoonPopulation serial(n, 1.2);
+    population::LoonPopulation threaded(n, 1.2);
+    for (size_t i = 0; i < n; ++i) {
+        serial.setEnhancementFactor(i, 0.8 + 0.4 * double(i) / double(n));
+        threaded.setEnhancementFactor(i, 0.8 + 0.4 * double(i) / double(n));
+    }
+    population::LoonPopulation uncoupled = serial;
+    for (auto* p : {&serial, &threaded}) {
+        p->setCoupling(0.5);
+        p->setDissipation(0.1);
+    }
+    threaded.setThreadPool(&pool);
+    for (int s = 0; s < 50; ++s) {
+        serial.communicate(0.1);
+        threaded.communicate(0.1);
+        uncoupled.communicate(0.1);
+    }
+    assert(serial.sky() == threaded.sky());
+    assert(serial.intensities() == threaded.intensities());
+    assert(uncoupled.skyFeed() == 0.0);
+    assert(serial.sky() != 0.0);
+    assert(serial.intensity(0) != uncoupled.intensity(0));
+    assert(serial.refluxRate(0) == serial.baseRefluxRate(0) + serial.skyFeed());
+
+    auto totals = threaded.totals();
+    auto serial_totals = serial.totals();
+    assert(totals.intensity == serial_totals.intensity);
+    double sum = 0.0;
+    for (double v : threaded.intensities()) sum += v;
+    assert(std::abs(totals.intensity - sum) < 1e-9 * double(n));
+    assert(totals.mean_balance > -1.0 && totals.mean_balance < 1.0);
+
+    bool threw = false;
+    loons[0].communicate(0.1);
+    try {
+        population::LoonPopulation::fromLoons(loons);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_tracing() {
+    std::cout << "Testing tracing..." << std::endl;
+
+    // Nothing is recorded outside a session
+    tracing::clear();
+    { tracing::Scope idle("idle"); }
+    assert(tracing::events().empty());
+
+    tracing::start();
+    tracing::setThreadName("main");
+    {
+        tracing::Scope outer("outer", "test");
+        { tracing::Scope inner("inner", "test"); }
+    }
+    parallel::ThreadPool pool(2);
+    pool.run(8, [](size_t) { tracing::Scope task("task", "test"); });
+    auto hierarchy = System::createHierarchy();
+    tracing::stop();
+    { tracing::Scope late("late"); }
+
+    auto spans = tracing::events();
+    size_t tasks = 0;
+    const tracing::Event* outer = nullptr;
+    const tracing::Event* inner = nullptr;
+    bool hierarchy_traced = false;
+    for (const auto& e : spans) {
+        std::string name = e.name;
+        if (name == "task") ++tasks;
+        if (name == "outer") outer = &e;
+        if (name == "inner") inner = &e;
+        if (name == "System::createHierarchy") hierarchy_traced = true;
+        assert(name != "late" && name != "idle");
+    }
+    assert(tasks == 8);
+    assert(outer && inner);
+    assert(inner->thread == outer->thread);
+    assert(inner->depth == outer->depth + 1);
+    assert(inner->start_ns >= outer->start_ns);
+    assert(inner->start_ns + inner->duration_ns <= outer->start_ns + outer->duration_ns);
+    assert(hierarchy_traced == tracing::compiledIn());
+
+    std::ostringstream json;
+    tracing::writeChromeJSON(json);
+    std::string doc = json.str();
+    assert(doc.rfind("{\"traceEvents\":[", 0) == 0);
+    assert(doc.find("\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\"") != std::string::npos);
+    assert(doc.find("\"thread_name\"") != std::string::npos);
+
+    // A new session starts empty
+    tracing::start();
+    tracing::stop();
+    assert(tracing::events().empty());
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_metrics() {
+    std::cout << "Testing metrics..." << std::endl;
+
+    // Sharded counters sum across threads
+    metrics::Registry reg;
+    auto& hits = reg.counter("test_hits_total", "Hits");
+    parallel::ThreadPool pool(4);
+    pool.run(64, [&](size_t) {
+        for (int i = 0; i < 100; ++i) hits.add();
+    });
+    assert(hits.value() == 6400);
+    assert(&reg.counter("test_hits_total") == &hits);
+    reg.counter("test_by_level_total", "By level", "level=\"2\"").add(5);
+
+    // Bucket bounds tile the value range
+    for (size_t i = 1; i < metrics::Histogram::BUCKETS; ++i) {
+        assert(metrics::Histogram::bucketLower(i) == metrics::Histogram::bucketUpper(i - 1) + 1);
+    }
+    assert(metrics::Histogram::bucketUpper(metrics::Histogram::BUCKETS - 1) == UINT64_MAX);
+    for (uint64_t v : {uint64_t{0}, uint64_t{31}, uint64_t{32}, uint64_t{1000003}, UINT64_MAX}) {
+        size_t b = metrics::Histogram::bucketIndex(v);
+        assert(metrics::Histogram::bucketLower(b) <= v && v <= metrics::Histogram::bucketUpper(b));
+    }
+
+    // Quantiles within the bucket resolution
+    auto& latency = reg.histogram("test_latency_ns", "Latency");
+    for (uint64_t v = 1; v <= 10000; ++v) latency.record(v);
+    auto snap = reg.snapshot();
+    const auto* h = snap.histogram("test_latency_ns");
+    assert(h && h->count == 10000 && h->min == 1 && h->max == 10000);
+    assert(h->sum == 10000ull * 10001 / 2);
+    assert(std::abs(static_cast<double>(h->quantile(0.5)) - 5000.0) <= 5000.0 * 0.0625);
+    assert(std::abs(static_cast<double>(h->quantile(0.99)) - 9900.0) <= 9900.0 * 0.0625);
+    assert(h->quantile(1.0) == 10000);
+    assert(snap.counter("test_hits_total") == 6400);
+    assert(snap.counter("test_by_level_total", "level=\"2\"") == 5);
+    assert(snap.counter("test_missing_total") == 0);
+
+    // Text exposition
+    std::string text = reg.text();
+    assert(text.find("# TYPE test_hits_total counter\ntest_hits_total 6400\n") != std::string::npos);
+    assert(text.find("test_by_level_total{level=\"2\"} 5\n") != std::string::npos);
+    assert(text.find("# TYPE test_latency_ns histogram\n") != std::string::npos);
+    assert(text.find("test_latency_ns_bucket{le=\"+Inf\"} 10000\n") != std::string::npos);
+    assert(text.find("test_latency_ns_count 10000\n") != std::string::npos);
+
+    // Misuse is rejected
+    bool threw = false;
+    try { reg.histogram("test_hits_total"); } catch (const std::logic_error&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { reg.counter("1bad name"); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    reg.reset();
+    assert(hits.value() == 0 && reg.snapshot().histogram("test_latency_ns")->count == 0);
+
+    // Library instrumentation
+    auto before = metrics::registry().snapshot();
+    auto hierarchy = System::createHierarchy();
+    std::string json = ops::Serializer::hierarchyToJSON(hierarchy);
+    std::vector<std::string> svgs = {
+        geometry::svg::systemHierarchySVG(400, 400),
+        geometry::svg::enneagramSVG(geometry::EnneagramGeometry(), 300, 300),
+        geometry::svg::nestedEnneagramSVG(geometry::NestedEnneagramGeometry(1), 300, 300),
+        geometry::svg::enneagramPath(geometry::EnneagramGeometry()),
+        geometry::svg::linePlot({{"a < b", {{0, 1}, {1, 3}, {2, 2}}}, {"empty", {}}}, "t", "x", "y")};
+    auto after = metrics::registry().snapshot();
+    if (metrics::compiledIn()) {
+        uint64_t bytes = after.counter("cosmic_serialized_bytes_total") -
+                         before.counter("cosmic_serialized_bytes_total");
+        assert(bytes == json.size());
+        uint64_t elements = after.counter("cosmic_svg_elements_total") -
+                            before.counter("cosmic_svg_elements_total");
+        // Every start tag: '<' followed by a name (not '/', '?' or '!')
+        uint64_t tags = 0;
+        for (const auto& svg : svgs) {
+            for (size_t i = 0; i + 1 < svg.size(); ++i) {
+                if (svg[i] == '<' && std::isalpha(static_cast<unsigned char>(svg[i + 1]))) ++tags;
+            }
+        }
+        assert(elements == tags);
+        auto system4 = System::getSystem(hierarchy, 4);
+        uint64_t level4 = after.counter("cosmic_terms_built_total", "level=\"4\"") -
+                          before.counter("cosmic_terms_built_total", "level=\"4\"");
+        assert(level4 == system4->allTerms().size());
+        const auto* calls = after.histogram("cosmic_call_duration_ns",
+                                            "call=\"System::createHierarchy\"");
+        assert(calls && calls->count >= 1);
+    } else {
+        assert(after.counters.empty() && after.histograms.empty());
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_memory_resources() {
+    std::cout << "Testing memory resources..." << std::endl;
+
+    // Counting resource over an arena, with a parent that only counts
+    std::pmr::monotonic_buffer_resource arena(4096);
+    memory::CountingResource total;
+    memory::CountingResource counting(&arena, &total);
+    {
+        std::pmr::vector<int> v(&counting);
+        for (int i = 0; i < 100; ++i) v.push_back(i);
+        auto s = counting.stats();
+        assert(s.allocations > 0 && s.live_bytes >= 100 * sizeof(int));
+        assert(total.stats().live_bytes == s.live_bytes);
+    }
+    auto s = counting.stats();
+    assert(s.live_bytes == 0 && s.allocations == s.deallocations);
+    assert(s.bytes_allocated == s.bytes_deallocated && s.peak_bytes >= 100 * sizeof(int));
+    assert(total.stats().bytes_allocated == s.bytes_allocated);
+
+    // Limits
+    counting.setLimit(64);
+    bool threw = false;
+    try {
+        std::pmr::vector<char> big(1024, 'x', &counting);
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    assert(threw && counting.stats().live_bytes == 0);
+    counting.setLimit(0);
+
+    // Subsystem accounting through the node factories
+    auto before = memory::stats(memory::Subsystem::TERMS);
+    {
+        auto root = Term::create("Root", TriadicTerm::Idea);
+        root->addSubTerm(Term::create("Child"));
+        auto during = memory::stats(memory::Subsystem::TERMS);
+        assert(during.allocations >= before.allocations + 3);
+        assert(during.live_bytes > before.live_bytes);
+    }
+    assert(memory::stats(memory::Subsystem::TERMS).live_bytes == before.live_bytes);
+
+    // Node copies keep their lists in the subsystem resource; a bare list
+    // copy uses the default resource like any std::pmr container
+    {
+        auto root = Term::create("Root");
+        root->addSubTerm(Term::create("Child"));
+        Term copy = *root;
+        assert(copy.subTerms().size() == 1 && copy.subTerms()[0] == root->subTerms()[0]);
+        assert(copy.subTerms().get_allocator().resource() == memory::resource(memory::Subsystem::TERMS));
+        Term::TermList bare = root->subTerms();
+        assert(bare.get_allocator().resource() == std::pmr::get_default_resource());
+
+        auto node = trees::TreeNode::create(1);
+        node->addChild(trees::TreeNode::create(2));
+        trees::TreeNode node_copy = *node;
+        assert(node_copy.degree() == 1);
+        assert(node_copy.children().get_allocator().resource() ==
+               memory::resource(memory::Subsystem::TREES));
+        trees::TreeNode::ChildList bare_children = node->children();
+        assert(bare_children.get_allocator().resource() == std::pmr::get_default_resource());
+    }
+
+    // A scope sends one subsystem to a caller resource and still counts it
+    auto hierarchy = System::createHierarchy();
+    std::string expected = ops::Serializer::hierarchyToJSON(hierarchy);
+    std::pmr::monotonic_buffer_resource request(1 << 16);
+    auto serializer_before = memory::stats(memory::Subsystem::SERIALIZER);
+    {
+        memory::ResourceScope scope(memory::Subsystem::SERIALIZER, &request);
+        assert(memory::resource(memory::Subsystem::SERIALIZER) != memory::resource(memory::Subsystem::SVG));
+        std::string json = ops::Serializer::hierarchyToJSON(hierarchy);
+        assert(json == expected);
+        assert(scope.stats().allocations > 0 && scope.stats().live_bytes == 0);
+        auto serializer_after = memory::stats(memory::Subsystem::SERIALIZER);
+        assert(serializer_after.bytes_allocated - serializer_before.bytes_allocated >=
+               scope.stats().bytes_allocated);
+    }
+
+    // Trees built inside a scope, including the process-wide generation cache
+    {
+        std::pmr::monotonic_buffer_resource nodes(1 << 16);
+        memory::ResourceScope scope(memory::Subsystem::TREES, &nodes);
+        trees::RootedTree tree;
+        assert(scope.stats().allocations > 0);
+        assert(trees::RootedTreeGenerator::generate(5).size() == trees::a000081(5));
+    }
+    assert(trees::RootedTreeGenerator::generate(5).size() == trees::a000081(5));
+
+    // OutputStream matches std::ostringstream, across its put-area boundary
+    memory::OutputStream out(memory::Subsystem::SVG);
+    std::ostringstream ref;
+    std::string long_text(700, 'q');
+    for (int i = 0; i < 200; ++i) {
+        out << std::fixed << 1.5 * i << ' ' << i << (i % 50 == 0 ? long_text : "") << '\n';
+        ref << std::fixed << 1.5 * i << ' ' << i << (i % 50 == 0 ? long_text : "") << '\n';
+    }
+    assert(out.str() == ref.str());
+    assert(out.view() == ref.str());
+
+    std::ostringstream report;
+    memory::writeReport(report);
+    assert(report.str().find("serializer") != std::string::npos);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_parallel_scaling_paths() {
+    std::cout << "Testing parallel scaling paths..." << std::endl;
+
+    parallel::ThreadPool pool(3);
+
+    // Tree enumeration: same trees, same order
+    for (int n = 1; n <= 8; ++n) {
+        auto serial = trees::RootedTreeGenerator::enumerate(n);
+        auto parallel_trees = trees::RootedTreeGenerator::enumerate(n, &pool);
+        assert(serial.size() == trees::a000081(n));
+        assert(parallel_trees.size() == serial.size());
+        for (size_t i = 0; i < serial.size(); ++i) {
+            assert(parallel_trees[i].canonical() == serial[i].canonical());
+        }
+    }
+
+    // Clustering: same clusters, same order
+    auto input = trees::RootedTreeGenerator::generate(8);
+    auto serial_clusters = trees::FlipTransform::groupIntoClusters(input);
+    auto parallel_clusters = trees::FlipTransform::groupIntoClusters(input, &pool);
+    assert(parallel_clusters.size() == serial_clusters.size());
+    for (size_t c = 0; c < serial_clusters.size(); ++c) {
+        assert(parallel_clusters[c].size() == serial_clusters[c].size());
+        for (size_t i = 0; i < serial_clusters[c].size(); ++i) {
+            assert(parallel_clusters[c][i].canonical() == serial_clusters[c][i].canonical());
+        }
+    }
+
+    // Hierarchy: same levels and terms
+    auto serial_root = System::createHierarchy();
+    auto parallel_root = System::createHierarchy(&pool, 10);
+    for (int level = 1; level <= 10; ++level) {
+        auto a = System::getSystem(serial_root, level);
+        auto b = System::getSystem(parallel_root, level);
+        assert(a && b);
+        assert(a->termCount() == b->termCount());
+    }
+    auto shallow = System::createHierarchy(&pool, 4);
+    assert(System::getSystem(shallow, 4) != nullptr);
+    assert(System::getSystem(shallow, 5) == nullptr);
+    bool threw = false;
+    try { System::createHierarchy(&pool, 0); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { System::createHierarchy(nullptr, 11); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // Fractal geometry: (9^(d+1) - 1) / 8 enneagrams, identical with a pool
+    for (int depth = 0; depth <= 3; ++depth) {
+        auto serial = geometry::fractalEnneagrams(depth);
+        auto parallel_geo = geometry::fractalEnneagrams(depth, geometry::Circle({0, 0}, 1.0),
+                                                        0.25, &pool);
+        size_t expected = 1;
+        for (int k = 0, level = 1; k < depth; ++k) {
+            level *= 9;
+            expected += level;
+        }
+        assert(serial.size() == expected);
+        assert(parallel_geo.size() == expected);
+        for (size_t i = 0; i < expected; ++i) {
+            assert(std::abs(serial[i].circle().radius - parallel_geo[i].circle().radius) < 1e-12);
+            assert(std::abs(serial[i].circle().center.x - parallel_geo[i].circle().center.x) < 1e-12);
+        }
+    }
+
+    // Line plot
+    geometry::svg::PlotSeries s;
+    s.label = "n <10>";
+    s.points = {{1, 1.0}, {2, 1.8}, {4, 3.1}};
+    std::string plot = geometry::svg::linePlot({s}, "Speedup", "threads", "speedup");
+    assert(plot.find("<svg") != std::string::npos);
+    assert(plot.find("<polyline") != std::string::npos);
+    assert(plot.find("n &lt;10&gt;") != std::string::npos);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+/// Executor over a caller-owned set of threads, as an application would adapt its pool
+class CountingExecutor : public parallel::Executor {
+public:
+    explicit CountingExecutor(size_t threads) {
+        for (size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this] {
+                std::unique_lock<std::mutex> lock(mutex_);
+                for (;;) {
+                    cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                    if (tasks_.empty()) return;
+                    auto task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                    lock.unlock();
+                    task();
+                    lock.lock();
+                }
+            });
+        }
+    }
+    ~CountingExecutor() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+    void submit(std::function<void()> task) override {
+        submitted.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+    size_t concurrency() const override { return threads_.size(); }
+
+    std::atomic<size_t> submitted{0};
+
+private:
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+};
+
+long parallelFib(parallel::Executor* executor, int n) {
+    if (n < 12) {
+        long a = 0, b = 1;
+        for (int i = 0; i < n; ++i) { long c = a + b; a = b; b = c; }
+        return a;
+    }
+    long x = 0, y = 0;
+    parallel::TaskGroup group(executor);
+    group.run([&] { x = parallelFib(executor, n - 1); });
+    y = parallelFib(executor, n - 2);
+    group.wait();
+    return x + y;
+}
+
+void test_executors() {
+    std::cout << "Testing executors..." << std::endl;
+
+    // An application-owned executor drives library entry points
+    CountingExecutor external(3);
+    parallel::Executor* executor = &external;
+    auto serial = trees::RootedTreeGenerator::enumerate(8);
+    auto pooled = trees::RootedTreeGenerator::enumerate(8, executor);
+    assert(pooled.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        assert(pooled[i].canonical() == serial[i].canonical());
+    }
+    assert(external.submitted.load() > 0);
+
+    size_t before = external.submitted.load();
+    double sum = parallel::parallelReduce(executor, 0, 10000, 100, 0.0,
+        [](size_t lo, size_t hi) {
+            double s = 0.0;
+            for (size_t i = lo; i < hi; ++i) s += static_cast<double>(i);
+            return s;
+        },
+        [](double a, double b) { return a + b; });
+    assert(sum == 49995000.0);
+    assert(external.submitted.load() > before);
+
+    // Nested task groups on the work-stealing pool (waiters help run tasks)
+    parallel::ThreadPool pool(3);
+    assert(parallelFib(&pool, 24) == 46368);
+    assert(parallelFib(nullptr, 20) == 6765);
+
+    // Failures surface from wait()
+    for (parallel::Executor* e : {static_cast<parallel::Executor*>(&pool), executor,
+                                  static_cast<parallel::Executor*>(nullptr)}) {
+        parallel::TaskGroup group(e);
+        std::atomic<int> ran{0};
+        for (int i = 0; i < 8; ++i) {
+            group.run([&ran, i] {
+                ran.fetch_add(1);
+                if (i == 5) throw std::runtime_error("task failed");
+            });
+        }
+        bool threw = false;
+        try { group.wait(); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        assert(ran.load() == 8);
+        group.wait();   // error already reported
+    }
+
+    // The shared executor can be replaced and restored
+    parallel::Executor& builtin = parallel::defaultExecutor();
+    assert(builtin.concurrency() >= 1);
+    parallel::setDefaultExecutor(&external);
+    assert(&parallel::defaultExecutor() == executor);
+    auto clusters = trees::FlipTransform::groupIntoClusters(
+        trees::RootedTreeGenerator::generate(7), &parallel::defaultExecutor());
+    assert(clusters.size() == trees::a000055(7));
+    parallel::setDefaultExecutor(nullptr);
+    assert(&parallel::defaultExecutor() == &builtin);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Simulation Tests ===" << std::endl;
+
+    test_bit_encoders();
+    test_trace_recorder();
+    test_trace_file();
+    test_parallel_reduce();
+    test_sparse_coupling();
+    test_network_uncoupled();
+    test_network_synchronization();
+    test_checkpoint_replay();
+    test_async_checkpoint_writer();
+    test_fastmath_kernels();
+    test_ensemble_stepper();
+    test_work_stealing_pool();
+    test_parameter_sweep();
+    test_animation_streaming();
+    test_spectral_analysis();
+    test_adaptive_integrator();
+    test_loon_population();
+    test_tracing();
+    test_metrics();
+    test_memory_resources();
+    test_parallel_scaling_paths();
+    test_executors();
+
+    std::cout << "\nAll tests PASSED!" << std::endl;
+    return 0;
+}
@@ -5,6 +5,8 @@
 
 #include <iostream>
 #include <cassert>
+#include <stdexcept>
+#include <string>
 #include "cosmic/cosmic.hpp"
 
 using namespace cosmic;
@@ -204,6 +206,178 @@ void test_util_functions() {
     std::cout << "  PASSED" << std::endl;
 }
 
+/// Check that FixedSystem<N> holds what System(N).build() builds
+template<int N>
+void check_fixed_system() {
+    constexpr FixedSystem<N> fixed;
+    System sys(N);
+    sys.build();
+
+    assert(fixed.name() == sys.name());
+    assert(fixed.description() == sys.description());
+    assert(fixed.termCount() == sys.termCount());
+    assert(fixed.clusterCount() == sys.clusterCount());
+    assert(fixed.nodeCount() == sys.nodeCount());
+    assert(fixed.primaryInterface().name() == sys.primaryInterface().name());
+    assert(fixed.primaryInterface().isActive() == sys.primaryInterface().isActive());
+
+    if constexpr (N >= 2) {
+        assert(fixed.secondaryInterface().name() == sys.secondaryInterface()->name());
+        assert(fixed.secondaryInterface().orientation() == sys.secondaryInterface()->orientation());
+    } else {
+        assert(!sys.secondaryInterface());
+    }
+    if constexpr (N >= 3) {
+        auto triad = *sys.triad();
+        for (size_t i = 0; i < 3; ++i) {
+            assert(fixed.triad()[i].name() == triad[i]->name());
+            assert(fixed.triad()[i].triadicType() == triad[i]->triadicType());
+            for (size_t j = 0; j < 3; ++j) {
+                const auto& sub = fixed.triad()[i].subTerms()[j];
+                assert(sub.name() == triad[i]->subTerms()[j]->name());
+                assert(sub.description() == triad[i]->subTerms()[j]->description());
+            }
+        }
+    }
+    if constexpr (N >= 4) {
+        for (int p = 1; p <= 9; ++p) {
+            auto pos = static_cast<EnneagramPosition>(p);
+            const auto& term = fixed.enneagram().termAt(pos);
+            assert(term.name() == sys.enneagram()->termAt(pos)->name());
+            assert(term.triadicType() == sys.enneagram()->termAt(pos)->triadicType());
+            assert(term.totalTermCount() == sys.enneagram()->termAt(pos)->totalTermCount());
+            assert(term.subTerms()[2].name() == sys.enneagram()->termAt(pos)->subTerms()[2]->name());
+        }
+        assert(fixed.enneagram().triad()[1]->name() == "Routine");
+    } else {
+        assert(!sys.enneagram());
+    }
+    if constexpr (N >= 5) {
+        assert(fixed.complementaryEnneagram().name() == sys.complementaryEnneagram()->name());
+    } else {
+        assert(!sys.complementaryEnneagram());
+    }
+
+    auto all = sys.allTerms();
+    auto listed = fixed.allTerms();
+    assert(listed.size() == all.size());
+    for (size_t i = 0; i < all.size(); ++i) assert(listed[i]->name() == all[i]->name());
+}
+
+void test_fixed_system() {
+    std::cout << "Testing FixedSystem..." << std::endl;
+
+    // Everything is available at compile time
+    static_assert(FixedSystem<5>::termCount() == 20);
+    static_assert(FixedSystem<4>::clusterCount() == 3);
+    static_assert(FixedSystem<3>().triad()[1].name() == "Sun - Routine");
+    static_assert(FixedSystem<5>().allTerms().size() == 12);
+    static_assert(FixedSystem<2>().transcends(FixedSystem<3>()));
+
+    check_fixed_system<0>();
+    check_fixed_system<1>();
+    check_fixed_system<2>();
+    check_fixed_system<3>();
+    check_fixed_system<4>();
+    check_fixed_system<5>();
+
+    FixedSystem<2> system;
+    system.secondaryInterface().transform();
+    assert(system.secondaryInterface().orientation() == Orientation::Objective);
+    assert(system.transcends(System(4)));
+
+    bool threw = false;
+    try {
+        FixedSystem<4>().enneagram().termAt(static_cast<EnneagramPosition>(10));
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_enneagram_layout() {
+    std::cout << "Testing implicit enneagram layout..." << std::endl;
+
+    using layout::EnneagramArray;
+
+    // Address arithmetic
+    assert(EnneagramArray::levelBegin(0) == 0);
+    assert(EnneagramArray::levelBegin(1) == 1);
+    assert(EnneagramArray::levelBegin(2) == 10);
+    assert(EnneagramArray::levelBegin(3) == 91);
+    for (size_t a = 1; a < 1000; ++a) {
+        size_t p = EnneagramArray::parent(a);
+        assert(EnneagramArray::child(p, EnneagramArray::position(a)) == a);
+        assert(EnneagramArray::level(a) == EnneagramArray::level(p) + 1);
+    }
+    EnneagramArray nesting(6, "Octave");
+    assert(nesting.size() == (531441 * 9 - 1) / 8);
+    assert(nesting.size() == EnneagramArray::levelBegin(7));
+    size_t deep = nesting.address({EnneagramPosition::Three, EnneagramPosition::Seven,
+                                   EnneagramPosition::Nine, EnneagramPosition::One,
+                                   EnneagramPosition::Two, EnneagramPosition::Five});
+    assert(EnneagramArray::level(deep) == 6);
+    assert(nesting.name(deep) == "Octave.3.7.9.1.2.5");
+
+    // View behaves like an Enneagram
+    auto view = nesting.root()
+                    .nestedEnneagramAt(EnneagramPosition::Three)
+                    .nestedEnneagramAt(EnneagramPosition::Seven);
+    assert(view.name() == "Octave.3.7");
+    assert(view.nestedLevel() == 4 && view.isNested());
+    assert(view.parent().address() == nesting.address({EnneagramPosition::Three}));
+    assert(!nesting.root().parent());
+    assert(view.termAt(EnneagramPosition::One) == nullptr);
+    auto idea = Term::create("Idea");
+    view.setTermAt(EnneagramPosition::Three, idea);
+    assert(view.triad()[0] == idea);
+    assert(view.terms()[2] == idea);
+    assert(nesting.termAt(view.address(), 3) == idea);
+    assert(!nesting.view(deep).isNested());
+    assert(!nesting.view(deep).nestedEnneagramAt(EnneagramPosition::One));
+
+    bool threw = false;
+    try { view.termAt(static_cast<EnneagramPosition>(10)); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { nesting.view(nesting.size()); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { EnneagramArray too_deep(EnneagramArray::MAX_DEPTH + 1); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // Round trip through the pointer-based form
+    EnneagramArray small(2, "Small");
+    for (size_t a = 0; a < small.size(); ++a) {
+        small.setTermAt(a, static_cast<int>(a % 9) + 1, Term::create("T" + std::to_string(a)));
+    }
+    small.setName(5, "Fifth");
+    auto pointers = small.toEnneagram();
+    assert(pointers->nestedLevel() == 2);
+    auto back = EnneagramArray::fromEnneagram(*pointers);
+    assert(back.size() == small.size());
+    for (size_t a = 0; a < small.size(); ++a) {
+        assert(back.name(a) == small.name(a));
+        for (int p = 1; p <= 9; ++p) assert(back.termAt(a, p) == small.termAt(a, p));
+    }
+    assert(back.name(5) == "Fifth");
+    auto nested = pointers->nestedEnneagramAt(EnneagramPosition::Four)
+                          ->nestedEnneagramAt(EnneagramPosition::Two);
+    size_t addr = small.address({EnneagramPosition::Four, EnneagramPosition::Two});
+    assert(nested->name() == small.name(addr));
+    assert(nested->termAt(static_cast<EnneagramPosition>(addr % 9 + 1)) == small.termAt(addr, addr % 9 + 1));
+
+    // Partial nestings are rejected
+    pointers->nestedEnneagramAt(EnneagramPosition::One)->setNestedEnneagram(EnneagramPosition::Nine, nullptr);
+    threw = false;
+    try { EnneagramArray::fromEnneagram(*pointers); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
 int main() {
     std::cout << "=== System Tests ===" << std::endl;
     
@@ -215,6 +389,8 @@ int main() {
     test_term();
     test_term_count();
     test_util_functions();
+    test_fixed_system();
+    test_enneagram_layout();
     
     std::cout << "\nAll tests PASSED!" << std::endl;
     return 0;
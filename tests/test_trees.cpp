@@ -0,0 +1,410 @@
+/**
+ * @file test_trees.cpp
+ * @brief Tests for the tree catalogs (succinct trees, tree tables, static
+ *        trees, tree classification, streaming enumeration)
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "cosmic/cosmic.hpp"
+
+using namespace cosmic;
+
+void test_succinct_trees() {
+    std::cout << "Testing succinct tree catalogs..." << std::endl;
+
+    // Catalog of every rooted tree up to 9 nodes agrees with the pointer trees
+    std::vector<trees::RootedTree> all;
+    for (int n = 1; n <= 9; ++n) {
+        auto generated = trees::RootedTreeGenerator::generate(n);
+        all.insert(all.end(), generated.begin(), generated.end());
+    }
+    succinct::TreeCatalog catalog(all);
+    assert(catalog.treeCount() == all.size());
+    size_t nodes = 0;
+    for (size_t i = 0; i < all.size(); ++i) {
+        assert(catalog.canonical(i) == all[i].canonical());
+        nodes += all[i].nodeCount();
+
+        auto reference = trees::RootedTree::fromCanonical(all[i].canonical()).allNodes();
+        size_t r = catalog.root(i);
+        assert(catalog.parent(r) == succinct::NONE);
+        assert(catalog.nextSibling(r) == succinct::NONE);
+        for (size_t k = 0; k < reference.size(); ++k) {
+            size_t v = catalog.nodeAt(catalog.preorder(r) + k);
+            assert(catalog.depth(v) == reference[k]->depth());
+            assert(catalog.subtreeSize(v) == reference[k]->subtreeSize());
+            assert(catalog.degree(v) == reference[k]->degree());
+            assert(catalog.isLeaf(v) == reference[k]->isLeaf());
+            for (size_t c = catalog.firstChild(v); c != succinct::NONE; c = catalog.nextSibling(c)) {
+                assert(catalog.parent(c) == v);
+            }
+        }
+    }
+    assert(catalog.nodeCount() == nodes);
+    assert(catalog.tree(all.size() - 1).canonical() == all.back().canonical());
+
+    // A long random forest crosses many directory blocks; check against a stack
+    std::mt19937_64 rng(91);
+    succinct::BitVector bits;
+    std::vector<size_t> match;
+    std::vector<size_t> parent;
+    std::vector<size_t> stack;
+    size_t open_left = 150000;
+    while (open_left > 0 || !stack.empty()) {
+        // Occasional long climbs give deep paths and wide excess swings
+        bool open = open_left > 0 && (stack.empty() || rng() % 1000 < (stack.size() < 3000 ? 502u : 480u));
+        size_t pos = bits.size();
+        bits.push_back(open);
+        match.push_back(succinct::NONE);
+        parent.push_back(succinct::NONE);
+        if (open) {
+            parent[pos] = stack.empty() ? succinct::NONE : stack.back();
+            stack.push_back(pos);
+            --open_left;
+        } else {
+            match[pos] = stack.back();
+            match[stack.back()] = pos;
+            stack.pop_back();
+        }
+    }
+    std::vector<bool> copy;
+    for (size_t i = 0; i < bits.size(); ++i) copy.push_back(bits[i]);
+    succinct::BalancedParentheses bp(bits);
+    const auto& rs = bp.rankSelect();
+    size_t ones = 0;
+    for (size_t i = 0; i < copy.size(); ++i) {
+        assert(rs.rank1(i) == ones);
+        if (copy[i]) {
+            assert(rs.select1(ones) == i);
+            assert(bp.findClose(i) == match[i]);
+            assert(bp.enclose(i) == parent[i]);
+            ++ones;
+        } else {
+            assert(rs.select0(i - ones) == i);
+            assert(bp.findOpen(i) == match[i]);
+        }
+    }
+    assert(rs.rank1(copy.size()) == ones);
+    assert(rs.select1(ones) == succinct::NONE);
+    assert(rs.select0(copy.size() - ones) == succinct::NONE);
+    assert(bp.memoryBytes() < copy.size() / 8 * 112 / 100);
+
+    succinct::TreeCatalog forest(bits);
+    size_t roots = 0;
+    for (size_t i = 0; i < parent.size(); ++i) {
+        if (copy[i] && parent[i] == succinct::NONE) {
+            assert(forest.root(roots) == i);
+            ++roots;
+        }
+    }
+    assert(forest.treeCount() == roots);
+
+    // Copies stay valid on their own
+    succinct::TreeCatalog moved = std::move(forest);
+    succinct::TreeCatalog copied = moved;
+    assert(copied.root(roots - 1) == moved.root(roots - 1));
+
+    bool threw = false;
+    succinct::BitVector unbalanced;
+    unbalanced.appendParentheses("(()");
+    try { succinct::BalancedParentheses bad(unbalanced); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { catalog.root(all.size()); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_tree_tables() {
+    std::cout << "Testing embedded tree tables..." << std::endl;
+    using trees::RootedTree;
+    using trees::SystemTreeMapping;
+
+    // Level sequences rebuild the tree with preorder ids
+    auto tree = RootedTree::fromLevelSequence({0, 1, 2, 1});
+    assert(tree.nodeCount() == 4);
+    assert(tree.canonical() == "((())())");
+    auto nodes = tree.allNodes();
+    for (size_t i = 0; i < nodes.size(); ++i) assert(nodes[i]->id() == static_cast<int>(i));
+    bool threw = false;
+    try { RootedTree::fromLevelSequence({0, 2}); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { RootedTree::fromLevelSequence({0, 1, 0}); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // The mapping (from tables when embedded) matches the generator exactly
+    for (int level = 0; level <= 7; ++level) {
+        auto mapped = SystemTreeMapping::getSystemTrees(level);
+        auto generated = trees::RootedTreeGenerator::generate(level + 1);
+        assert(mapped.size() == generated.size());
+        for (size_t i = 0; i < mapped.size(); ++i) {
+            auto a = mapped[i].allNodes();
+            auto b = generated[i].allNodes();
+            assert(a.size() == b.size());
+            for (size_t k = 0; k < a.size(); ++k) {
+                assert(a[k]->id() == b[k]->id());
+                assert(a[k]->depth() == b[k]->depth());
+            }
+        }
+
+        auto clusters = SystemTreeMapping::getSystemClusters(level);
+        auto grouped = trees::FlipTransform::groupIntoClusters(generated);
+        assert(clusters.size() == grouped.size());
+        for (size_t c = 0; c < clusters.size(); ++c) {
+            assert(clusters[c].size() == grouped[c].size());
+            for (size_t r = 0; r < clusters[c].size(); ++r) {
+                assert(clusters[c][r].canonical() == grouped[c][r].canonical());
+            }
+        }
+
+        auto summary = SystemTreeMapping::getSummary(level);
+        assert(summary.termCount == trees::a000081(level + 1));
+        assert(summary.clusterCount == trees::a000055(level + 1));
+        for (size_t c = 0; c < clusters.size(); ++c) assert(summary.clusterSizes[c] == clusters[c].size());
+    }
+
+    if (trees::tables::maxNodes() > 0) {
+        assert(trees::tables::find(0) == nullptr);
+        assert(trees::tables::find(trees::tables::maxNodes() + 1) == nullptr);
+        const auto* table = trees::tables::find(trees::tables::maxNodes());
+        assert(table && table->nodes == trees::tables::maxNodes());
+        if (table->nodes <= 11) {
+            assert(table->tree_count == trees::a000081(table->nodes));
+            assert(table->cluster_count == trees::a000055(table->nodes));
+        }
+        for (size_t i = 0; i < table->tree_count; ++i) assert(trees::tables::depthAt(*table, i, 0) == 0);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+/// Check STATIC_TREES<N> against the runtime generator and FlipTransform
+template<int N>
+void check_static_trees() {
+    constexpr const auto& fixed = trees::STATIC_TREES<N>;
+    auto generated = trees::RootedTreeGenerator::generate(N);
+    auto clusters = trees::FlipTransform::groupIntoClusters(generated);
+    assert(fixed.count() == generated.size());
+    assert(fixed.clusterCount() == clusters.size());
+
+    std::map<std::string, size_t> cluster_of;
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        for (const auto& tree : clusters[c]) cluster_of[tree.canonical()] = c;
+    }
+    std::string previous;
+    for (size_t i = 0; i < fixed.count(); ++i) {
+        std::vector<int> levels;
+        for (int k = 0; k < N; ++k) levels.push_back(fixed.depthAt(i, k));
+        std::string canonical = trees::RootedTree::fromLevelSequence(levels).canonical();
+        assert(cluster_of.at(canonical) == fixed.cluster(i));
+        assert(i == 0 || previous < canonical);
+        assert(trees::packParentheses(canonical) == fixed.sequence(i));
+        previous = canonical;
+    }
+}
+
+void test_static_trees() {
+    std::cout << "Testing constexpr tree enumeration..." << std::endl;
+
+    static_assert(trees::STATIC_TREES<5>.count() == 9);
+    static_assert(trees::STATIC_TREES<8>.clusterCount() == 23);
+    static_assert(trees::rootedTreeCount(11) == 1842);
+    static_assert(trees::packParentheses("(()(()))") == trees::packParentheses("((())())"));
+    static_assert(trees::isCanonicalParentheses("((())())"));
+    static_assert(!trees::isCanonicalParentheses("(()(()))"));
+
+    check_static_trees<1>();
+    check_static_trees<2>();
+    check_static_trees<4>();
+    check_static_trees<6>();
+    check_static_trees<8>();
+
+    bool threw = false;
+    try { trees::packParentheses("(()"); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { trees::packParentheses("()()"); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // The System 5 table agrees with runtime clustering too
+    auto system5 = terms::getSystem5Terms();
+    auto clusters = trees::FlipTransform::groupIntoClusters(trees::RootedTreeGenerator::generate(6));
+    assert(system5.size() == 20);
+    for (const auto& term : system5) {
+        bool found = false;
+        for (const auto& tree : clusters[static_cast<size_t>(term.cluster)]) {
+            found = found || tree.canonical() == term.treeStructure;
+        }
+        assert(found);
+    }
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+template<int N>
+void check_classification() {
+    constexpr const auto& fixed = trees::STATIC_TREES<N>;
+    for (size_t i = 0; i < fixed.count(); ++i) {
+        std::vector<int> levels;
+        for (int k = 0; k < N; ++k) levels.push_back(fixed.depthAt(i, k));
+        std::string canonical = trees::RootedTree::fromLevelSequence(levels).canonical();
+        auto result = classify::classifyTree(canonical);
+        assert(result.status == classify::Status::Ok);
+        assert(result.nodes == N);
+        assert(result.id == i);
+        assert(result.cluster == fixed.cluster(i));
+    }
+}
+
+void test_classify() {
+    std::cout << "Testing tree classification..." << std::endl;
+
+    check_classification<1>();
+    check_classification<3>();
+    check_classification<5>();
+    check_classification<7>();
+    check_classification<9>();
+
+    // Child order does not matter
+    auto a = classify::classifyTree("((())())");
+    auto b = classify::classifyTree("(()(()))");
+    assert(a.status == classify::Status::Ok && a.nodes == 4);
+    assert(a.id == b.id && a.cluster == b.cluster);
+
+    // Longer than one SWAR word, with a tail
+    std::string path = std::string(13, '(') + std::string(13, ')');
+    auto deep = classify::classifyTree(path);
+    assert(deep.status == classify::Status::Ok && deep.nodes == 13 && deep.id == 0);
+
+    assert(classify::classifyTree("").status == classify::Status::Empty);
+    assert(classify::classifyTree("(x)").status == classify::Status::InvalidCharacter);
+    assert(classify::classifyTree("(((((((()x))))))").status == classify::Status::InvalidCharacter);
+    assert(classify::classifyTree("(()").status == classify::Status::Unbalanced);
+    assert(classify::classifyTree("())(").status == classify::Status::Unbalanced);
+    assert(classify::classifyTree("()()").status == classify::Status::Unbalanced);
+    std::string big = std::string(17, '(') + std::string(17, ')');
+    assert(classify::classifyTree(big).status == classify::Status::TooLarge);
+    assert(std::string(classify::toString(classify::Status::Unbalanced)) == "unbalanced");
+
+    const auto& largest = classify::catalog(classify::MAX_NODES);
+    assert(largest.keys.size() == 235381);
+    assert(std::is_sorted(largest.keys.rbegin(), largest.keys.rend()));
+    assert(largest.cluster_count == 19320);   // A000055(16)
+
+    bool threw = false;
+    try { classify::catalog(0); } catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+void test_enumeration() {
+    std::cout << "Testing streaming tree enumeration..." << std::endl;
+
+    for (int n = 0; n < 12; ++n) {
+        assert(enumeration::rootedTreeCount(n) == trees::A000081[static_cast<size_t>(n)]);
+        assert(enumeration::freeTreeCount(n) == trees::A000055[static_cast<size_t>(n)]);
+    }
+    assert(enumeration::rootedTreeCount(22) == 97055181);
+    assert(enumeration::freeTreeCount(22) == 5623756);
+    assert(enumeration::rootedTreeCount(32) == 2809934352700ULL);
+
+    // Rooted trees come in STATIC_TREES order, and center keys name the clusters
+    constexpr const auto& fixed = trees::STATIC_TREES<8>;
+    enumeration::RootedSequence rooted(8);
+    std::map<uint64_t, uint32_t> cluster_of_key;
+    std::set<uint64_t> center_keys;
+    for (size_t i = 0; i < fixed.count(); ++i) {
+        assert(rooted.rank() == i);
+        for (int k = 0; k < 8; ++k) assert(rooted.levels().depth[k] == fixed.depthAt(i, k));
+        std::string parens = enumeration::toParentheses(rooted.key(), 8);
+        assert(trees::packParentheses(parens) == fixed.sequence(i));
+
+        uint64_t center = enumeration::centerKey(rooted.levels());
+        auto inserted = cluster_of_key.emplace(center, fixed.cluster(i));
+        assert(inserted.first->second == fixed.cluster(i));
+        center_keys.insert(center);
+        assert(rooted.next() == (i + 1 < fixed.count()));
+    }
+    assert(center_keys.size() == fixed.clusterCount());
+
+    // Free trees are exactly the clusters
+    enumeration::FreeSequence free_trees(8);
+    std::set<uint64_t> free_keys;
+    do {
+        free_keys.insert(free_trees.key());
+    } while (free_trees.next());
+    assert(free_keys == center_keys);
+    for (int n = 1; n <= 14; ++n) {
+        enumeration::FreeSequence sequence(n);
+        uint64_t count = 1 + sequence.skip(UINT64_MAX);
+        assert(count == enumeration::freeTreeCount(n));
+        assert(sequence.rank() + 1 == count);
+    }
+
+    // Skipping matches stepping, and stops at the last tree
+    enumeration::RootedSequence a(12);
+    enumeration::RootedSequence b(12);
+    assert(a.skip(1000) == 1000);
+    for (int i = 0; i < 1000; ++i) b.next();
+    assert(a.key() == b.key() && a.rank() == 1000);
+    assert(a.skip(UINT64_MAX) == enumeration::rootedTreeCount(12) - 1001);
+    std::string star = "(";
+    for (int i = 0; i < 11; ++i) star += "()";
+    assert(enumeration::toParentheses(a.key(), 12) == star + ")");
+
+    // 32 nodes fill the key exactly
+    enumeration::RootedSequence path(32);
+    assert(path.key() == ~uint64_t(0) << 32);
+    assert(enumeration::centerKey(path.levels()) != 0);
+
+    bool threw = false;
+    try { enumeration::RootedSequence too_big(33); } catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // Catalog headers round-trip
+    enumeration::CatalogHeader header;
+    header.kind = enumeration::CatalogKind::ROOTED;
+    header.flags = enumeration::CLUSTER_KEYS;
+    header.nodes = 22;
+    header.first_rank = 1000;
+    header.count = 5000;
+    std::string bytes;
+    enumeration::appendHeader(bytes, header);
+    assert(bytes.size() == enumeration::CATALOG_HEADER_SIZE);
+    auto parsed = enumeration::parseHeader(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    assert(parsed.nodes == 22 && parsed.first_rank == 1000 && parsed.count == 5000);
+    assert(parsed.recordSize() == 16);
+    bytes[0] = 'X';
+    threw = false;
+    try {
+        enumeration::parseHeader(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Tree Tests ===" << std::endl;
+
+    test_succinct_trees();
+    test_tree_tables();
+    test_static_trees();
+    test_classify();
+    test_enumeration();
+
+    std::cout << "\nAll tests PASSED!" << std::endl;
+    return 0;
+}
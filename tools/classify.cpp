@@ -0,0 +1,271 @@
+/**
+ * @file classify.cpp
+ * @brief cosmic_classify: classify parenthesis tree strings in bulk
+ *
+ * Usage:
+ *   cosmic_classify [-o FILE] [--threads N] [--chunk-size BYTES] [--quiet] [INPUT]
+ *
+ * Reads one tree per line in the RootedTree::canonical() format from INPUT
+ * (default: standard input) and writes one line per input line, in order:
+ *
+ *   nodes <TAB> id <TAB> cluster      for a tree (see classify.hpp)
+ *   error <TAB> reason                otherwise (empty, invalid-character, ...)
+ *
+ * Files are memory-mapped and cut into chunks at line boundaries. Chunks
+ * are classified in parallel, a window at a time, while the previous
+ * window is written out. A summary goes to standard error unless --quiet.
+ */
+
+#include "cosmic/classify.hpp"
+#include "cosmic/parallel.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COSMIC_HAVE_MMAP 1
+#endif
+
+using namespace cosmic;
+
+namespace {
+
+// ============================================================================
+// Input
+// ============================================================================
+
+/// The whole input, memory-mapped when it is a regular file
+class Input {
+public:
+    explicit Input(const std::string& path) {
+        if (path.empty() || path == "-") {
+            readAll(stdin);
+            return;
+        }
+#ifdef COSMIC_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            size_t size = static_cast<size_t>(st.st_size);
+            void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                ::madvise(data, size, MADV_SEQUENTIAL);
+                map_ = data;
+                data_ = static_cast<const char*>(data);
+                size_ = size;
+                ::close(fd);
+                return;
+            }
+        }
+        ::close(fd);
+#endif
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) throw std::runtime_error("cannot open " + path);
+        readAll(file);
+        std::fclose(file);
+    }
+
+    ~Input() {
+#ifdef COSMIC_HAVE_MMAP
+        if (map_) ::munmap(map_, size_);
+#endif
+    }
+
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void readAll(std::FILE* file) {
+        char buffer[1 << 16];
+        size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            buffer_.insert(buffer_.end(), buffer, buffer + n);
+        }
+        if (std::ferror(file)) throw std::runtime_error("read error");
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    std::vector<char> buffer_;
+    void* map_ = nullptr;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// Chunks
+// ============================================================================
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+    std::string out;
+    size_t lines = 0;
+    size_t invalid = 0;
+};
+
+/// Cut [data, data + size) into chunks of about chunk_size bytes at line ends
+std::vector<Chunk> splitLines(const char* data, size_t size, size_t chunk_size) {
+    std::vector<Chunk> chunks;
+    const char* end = data + size;
+    const char* begin = data;
+    while (begin < end) {
+        const char* cut = begin + std::min(chunk_size, static_cast<size_t>(end - begin));
+        if (cut < end) {
+            const char* newline = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+            cut = newline ? newline + 1 : end;
+        }
+        chunks.push_back({begin, cut, {}, 0, 0});
+        begin = cut;
+    }
+    return chunks;
+}
+
+void appendNumber(std::string& out, uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+void classifyChunk(Chunk& chunk) {
+    chunk.out.reserve(static_cast<size_t>(chunk.end - chunk.begin) / 2 + 64);
+    const char* p = chunk.begin;
+    while (p < chunk.end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        const char* line_end = newline ? newline : chunk.end;
+        std::string_view line(p, static_cast<size_t>(line_end - p));
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        auto result = classify::classifyTree(line);
+        if (result.status == classify::Status::Ok) {
+            appendNumber(chunk.out, static_cast<uint64_t>(result.nodes));
+            chunk.out += '\t';
+            appendNumber(chunk.out, result.id);
+            chunk.out += '\t';
+            appendNumber(chunk.out, result.cluster);
+        } else {
+            chunk.out += "error\t";
+            chunk.out += classify::toString(result.status);
+            ++chunk.invalid;
+        }
+        chunk.out += '\n';
+        ++chunk.lines;
+        p = line_end + 1;
+    }
+}
+
+void usage(std::ostream& out) {
+    out << "usage: cosmic_classify [-o FILE] [--threads N] [--chunk-size BYTES] [--quiet] [INPUT]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        std::string input_path;
+        std::string output_path;
+        size_t threads = 0;
+        size_t chunk_size = 1 << 20;
+        bool quiet = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if ((arg == "-o" || arg == "--output") && has_value) output_path = argv[++i];
+            else if (arg == "--threads" && has_value) threads = std::stoul(argv[++i]);
+            else if (arg == "--chunk-size" && has_value) chunk_size = std::max<size_t>(std::stoul(argv[++i]), 1);
+            else if (arg == "--quiet") quiet = true;
+            else if (arg == "--help" || arg == "-h") {
+                usage(std::cout);
+                return 0;
+            } else if (input_path.empty() && (arg == "-" || arg[0] != '-')) {
+                input_path = arg;
+            } else {
+                usage(std::cerr);
+                return 2;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Input input(input_path);
+
+        std::FILE* out = stdout;
+        if (!output_path.empty()) {
+            out = std::fopen(output_path.c_str(), "wb");
+            if (!out) throw std::runtime_error("cannot write " + output_path);
+        }
+
+        // --threads 1 runs serially; otherwise a private pool or the default executor
+        std::unique_ptr<parallel::ThreadPool> pool;
+        parallel::Executor* executor = &parallel::defaultExecutor();
+        if (threads == 1) {
+            executor = nullptr;
+        } else if (threads > 1) {
+            pool = std::make_unique<parallel::ThreadPool>(threads);
+            executor = pool.get();
+        }
+        size_t window = 4 * (executor ? executor->concurrency() : 1);
+
+        // Classify window w + 1 while window w is written
+        auto chunks = splitLines(input.data(), input.size(), chunk_size);
+        size_t lines = 0;
+        size_t invalid = 0;
+        auto launch = [&](parallel::TaskGroup& group, size_t first) {
+            size_t last = std::min(first + window, chunks.size());
+            for (size_t c = first; c < last; ++c) {
+                group.run([&chunks, c] { classifyChunk(chunks[c]); });
+            }
+        };
+        auto current = std::make_unique<parallel::TaskGroup>(executor);
+        launch(*current, 0);
+        for (size_t first = 0; first < chunks.size(); first += window) {
+            current->wait();
+            auto next = std::make_unique<parallel::TaskGroup>(executor);
+            if (first + window < chunks.size()) launch(*next, first + window);
+
+            size_t last = std::min(first + window, chunks.size());
+            for (size_t c = first; c < last; ++c) {
+                auto& chunk = chunks[c];
+                if (std::fwrite(chunk.out.data(), 1, chunk.out.size(), out) != chunk.out.size()) {
+                    throw std::runtime_error("write error");
+                }
+                lines += chunk.lines;
+                invalid += chunk.invalid;
+                std::string().swap(chunk.out);
+            }
+            current = std::move(next);
+        }
+        current->wait();
+
+        if (out != stdout ? std::fclose(out) != 0 : std::fflush(out) != 0) {
+            throw std::runtime_error("write error");
+        }
+
+        if (!quiet) {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::fprintf(stderr, "cosmic_classify: %zu lines (%zu invalid) in %.3f s, %.1f MB/s\n",
+                         lines, invalid, seconds,
+                         seconds > 0 ? static_cast<double>(input.size()) / seconds / 1e6 : 0.0);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "cosmic_classify: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,106 @@
+/**
+ * @file daemon.cpp
+ * @brief cosmic_daemon: serve term lookups on a Unix domain socket
+ *
+ * Usage:
+ *   cosmic_daemon --socket PATH [--levels N] [--threads N] [--quiet]
+ *
+ * Builds Systems 1..N (default 10) and the tree catalogs of Systems 0-10
+ * once, then answers service::Client requests on PATH until SIGINT or
+ * SIGTERM (see service.hpp for the protocol). --threads sets the pool the
+ * index is built on; requests are served from a single event loop. A
+ * summary goes to standard error unless --quiet.
+ */
+
+#include "cosmic/parallel.hpp"
+#include "cosmic/service.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace cosmic;
+
+namespace {
+
+service::Server* running_server = nullptr;
+
+extern "C" void onSignal(int) {
+    if (running_server) running_server->stop();
+}
+
+void usage(std::ostream& out) {
+    out << "usage: cosmic_daemon --socket PATH [--levels N] [--threads N] [--quiet]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        std::string socket_path;
+        int levels = 10;
+        size_t threads = 0;
+        bool quiet = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--socket" && has_value) socket_path = argv[++i];
+            else if (arg == "--levels" && has_value) levels = std::stoi(argv[++i]);
+            else if (arg == "--threads" && has_value) threads = std::stoul(argv[++i]);
+            else if (arg == "--quiet") quiet = true;
+            else if (arg == "--help" || arg == "-h") {
+                usage(std::cout);
+                return 0;
+            } else {
+                usage(std::cerr);
+                return 2;
+            }
+        }
+        if (socket_path.empty()) {
+            usage(std::cerr);
+            return 2;
+        }
+
+        // --threads 1 builds serially; otherwise a private pool or the default executor
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<parallel::ThreadPool> pool;
+        parallel::Executor* executor = &parallel::defaultExecutor();
+        if (threads == 1) {
+            executor = nullptr;
+        } else if (threads > 1) {
+            pool = std::make_unique<parallel::ThreadPool>(threads);
+            executor = pool.get();
+        }
+        service::Index index(executor, levels);
+        pool.reset();
+
+        service::Server server(index, socket_path);
+        running_server = &server;
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+        if (!quiet) {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::fprintf(stderr, "cosmic_daemon: Systems 1-%d loaded in %.3f s, listening on %s\n",
+                         levels, seconds, socket_path.c_str());
+        }
+
+        server.run();
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        running_server = nullptr;
+
+        if (!quiet) {
+            std::fprintf(stderr, "cosmic_daemon: %llu requests in %llu batches\n",
+                         static_cast<unsigned long long>(server.requests()),
+                         static_cast<unsigned long long>(server.batches()));
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "cosmic_daemon: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,463 @@
+/**
+ * @file gen.cpp
+ * @brief cosmic_gen: enumerate rooted and free tree catalogs
+ *
+ * Usage:
+ *   cosmic_gen -n N[-M] [--engine serial|parallel|free] [--format text|binary]
+ *              [--sink buffered|async] [-o FILE] [--threads N] [--batch TREES]
+ *              [--start RANK] [--count TREES] [--no-clusters] [--progress] [--quiet]
+ *
+ * Engines:
+ *   serial     rooted trees (A000081) on the calling thread
+ *   parallel   rooted trees, batches encoded on the executor
+ *   free       free trees (A000055) generated directly, one per cluster
+ *
+ * Text output has one line per tree: n, rank, the canonical parenthesis
+ * string and, for rooted trees, the cluster (the free tree's string rooted
+ * at its center). Binary output is one section per n, a CatalogHeader and
+ * then fixed-size records of balanced-parentheses keys (enumeration.hpp).
+ *
+ * Ranks follow enumeration order, so a run can resume, or be split across
+ * processes, with --start and --count; concatenating the pieces gives the
+ * same output as one run. The sequence reaches each batch's first tree by
+ * stepping, which is cheap next to encoding.
+ */
+
+#include "cosmic/enumeration.hpp"
+#include "cosmic/parallel.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cosmic;
+
+namespace {
+
+struct Options {
+    int min_nodes = 0;
+    int max_nodes = 0;
+    std::string engine = "parallel";
+    bool binary = false;
+    bool async = false;
+    std::string output;
+    size_t threads = 0;
+    uint64_t batch = 1 << 16;
+    uint64_t start = 0;
+    uint64_t count = UINT64_MAX;
+    bool clusters = true;
+    bool progress = false;
+    bool quiet = false;
+};
+
+// ============================================================================
+// Sinks
+// ============================================================================
+
+/// Destination for encoded batches, written in order
+class Sink {
+public:
+    virtual ~Sink() = default;
+    virtual void write(std::string bytes) = 0;
+    /// Flush everything; rethrows the first write error
+    virtual void finish() = 0;
+};
+
+/// Writes on the calling thread through a large stdio buffer
+class BufferedSink : public Sink {
+public:
+    explicit BufferedSink(std::FILE* file) : file_(file) {
+        std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+    }
+
+    void write(std::string bytes) override {
+        if (std::fwrite(bytes.data(), 1, bytes.size(), file_) != bytes.size()) {
+            throw std::runtime_error("write error");
+        }
+    }
+
+    void finish() override {
+        if (std::fflush(file_) != 0) throw std::runtime_error("write error");
+    }
+
+private:
+    std::FILE* file_;
+};
+
+/**
+ * @brief Writes on a background thread
+ *
+ * write() queues the batch and returns, blocking only while MAX_QUEUED
+ * batches are already waiting, so encoding continues during slow I/O.
+ */
+class AsyncSink : public Sink {
+public:
+    static constexpr size_t MAX_QUEUED = 8;
+
+    explicit AsyncSink(std::FILE* file) : file_(file), thread_([this] { run(); }) {}
+
+    ~AsyncSink() override {
+        try {
+            finish();
+        } catch (...) {
+            // Reported only through an explicit finish()
+        }
+    }
+
+    void write(std::string bytes) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(lock, [this] { return queue_.size() < MAX_QUEUED || error_; });
+        if (error_) std::rethrow_exception(error_);
+        queue_.push_back(std::move(bytes));
+        cv_.notify_one();
+    }
+
+    void finish() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            cv_.notify_one();
+        }
+        if (thread_.joinable()) thread_.join();
+        if (error_) std::rethrow_exception(error_);
+        if (std::fflush(file_) != 0) throw std::runtime_error("write error");
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::string bytes;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return !queue_.empty() || stopping_; });
+                if (queue_.empty()) return;
+                bytes = std::move(queue_.front());
+                queue_.pop_front();
+                space_cv_.notify_one();
+            }
+            if (std::fwrite(bytes.data(), 1, bytes.size(), file_) != bytes.size()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::make_exception_ptr(std::runtime_error("write error"));
+                queue_.clear();
+                space_cv_.notify_all();
+                return;
+            }
+        }
+    }
+
+    std::FILE* file_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable space_cv_;
+    std::deque<std::string> queue_;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    std::thread thread_;         ///< Declared last: starts once the state above exists
+};
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+void appendNumber(std::string& out, uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+void appendParentheses(std::string& out, uint64_t key, int nodes) {
+    size_t at = out.size();
+    out.resize(at + static_cast<size_t>(2 * nodes));
+    char* p = &out[at];
+    for (int i = 0; i < 2 * nodes; ++i) {
+        p[i] = static_cast<char>(')' - ((key >> (63 - i)) & 1));
+    }
+}
+
+void appendKey(std::string& out, uint64_t key) {
+    out.append(reinterpret_cast<const char*>(&key), sizeof(key));
+}
+
+struct Encoder {
+    bool binary;
+    bool clusters;
+
+    void operator()(std::string& out, const enumeration::RootedSequence& trees) const {
+        uint64_t key = trees.key();
+        if (binary) {
+            appendKey(out, key);
+            if (clusters) appendKey(out, enumeration::centerKey(trees.levels()));
+            return;
+        }
+        appendNumber(out, static_cast<uint64_t>(trees.nodes()));
+        out += '\t';
+        appendNumber(out, trees.rank());
+        out += '\t';
+        appendParentheses(out, key, trees.nodes());
+        if (clusters) {
+            out += '\t';
+            appendParentheses(out, enumeration::centerKey(trees.levels()), trees.nodes());
+        }
+        out += '\n';
+    }
+
+    void operator()(std::string& out, const enumeration::FreeSequence& trees) const {
+        uint64_t key = trees.key();
+        if (binary) {
+            appendKey(out, key);
+            return;
+        }
+        appendNumber(out, static_cast<uint64_t>(trees.nodes()));
+        out += '\t';
+        appendNumber(out, trees.rank());
+        out += '\t';
+        appendParentheses(out, key, trees.nodes());
+        out += '\n';
+    }
+};
+
+// ============================================================================
+// Generation
+// ============================================================================
+
+class Progress {
+public:
+    Progress(bool enabled, uint64_t total) : enabled_(enabled), total_(total) {}
+
+    void add(int nodes, uint64_t trees) {
+        done_ += trees;
+        if (!enabled_) return;
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_ < std::chrono::milliseconds(500) && done_ < total_) return;
+        last_ = now;
+        std::fprintf(stderr, "\rcosmic_gen: n=%d %5.1f%% (%llu/%llu trees, %.2f M trees/s)   ",
+                     nodes, total_ ? 100.0 * static_cast<double>(done_) / static_cast<double>(total_) : 100.0,
+                     static_cast<unsigned long long>(done_), static_cast<unsigned long long>(total_),
+                     static_cast<double>(done_) / seconds() / 1e6);
+    }
+
+    void end() const {
+        if (enabled_) std::fprintf(stderr, "\n");
+    }
+
+    uint64_t done() const { return done_; }
+
+    double seconds() const {
+        return std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count(), 1e-9);
+    }
+
+private:
+    bool enabled_;
+    uint64_t total_;
+    uint64_t done_ = 0;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_{};
+};
+
+template<typename Sequence>
+struct Batch {
+    Sequence first;
+    uint64_t count;
+    std::string out;
+};
+
+/**
+ * @brief Encode @p count trees from rank @p start of @p trees into the sink
+ *
+ * Batches are cut by stepping a scout sequence; a window of them is encoded
+ * on the executor while the previous window is written.
+ */
+template<typename Sequence>
+void generate(Sequence trees, uint64_t count, const Options& options, parallel::Executor* executor,
+              const Encoder& encode, Sink& sink, Progress& progress) {
+    size_t window = 4 * (executor ? executor->concurrency() : 1);
+    uint64_t remaining = count;
+    auto cut = [&] {
+        std::vector<Batch<Sequence>> batches;
+        while (remaining > 0 && batches.size() < window) {
+            uint64_t size = std::min(options.batch, remaining);
+            batches.push_back({trees, size, {}});
+            remaining -= size;
+            if (remaining > 0) trees.skip(size);
+        }
+        return batches;
+    };
+    auto launch = [&](parallel::TaskGroup& group, std::vector<Batch<Sequence>>& batches) {
+        for (auto& batch : batches) {
+            group.run([&batch, &encode] {
+                Sequence cursor = batch.first;
+                batch.out.reserve(static_cast<size_t>(batch.count) * (4 * static_cast<size_t>(cursor.nodes()) + 24));
+                for (uint64_t i = 0; i < batch.count; ++i) {
+                    if (i > 0) cursor.next();
+                    encode(batch.out, cursor);
+                }
+            });
+        }
+    };
+
+    auto current = cut();
+    auto group = std::make_unique<parallel::TaskGroup>(executor);
+    launch(*group, current);
+    while (!current.empty()) {
+        group->wait();
+        auto next = cut();
+        auto next_group = std::make_unique<parallel::TaskGroup>(executor);
+        launch(*next_group, next);
+        for (auto& batch : current) {
+            sink.write(std::move(batch.out));
+            progress.add(trees.nodes(), batch.count);
+        }
+        current = std::move(next);
+        group = std::move(next_group);
+    }
+    group->wait();
+}
+
+/// Number of trees to generate for n, after checking the rank range
+uint64_t rangeCount(const Options& options, int nodes, bool free_trees) {
+    uint64_t total = free_trees ? enumeration::freeTreeCount(nodes) : enumeration::rootedTreeCount(nodes);
+    if (options.start > total) {
+        throw std::invalid_argument("--start is past the last tree (" + std::to_string(total) + ")");
+    }
+    return std::min(options.count, total - options.start);
+}
+
+void usage(std::ostream& out) {
+    out << "usage: cosmic_gen -n N[-M] [--engine serial|parallel|free] [--format text|binary]\n"
+           "                  [--sink buffered|async] [-o FILE] [--threads N] [--batch TREES]\n"
+           "                  [--start RANK] [--count TREES] [--no-clusters] [--progress] [--quiet]\n";
+}
+
+void parseNodes(const std::string& text, Options& options) {
+    size_t dash = text.find('-');
+    options.min_nodes = std::stoi(text.substr(0, dash));
+    options.max_nodes = dash == std::string::npos ? options.min_nodes : std::stoi(text.substr(dash + 1));
+    if (options.min_nodes < 1 || options.max_nodes > enumeration::MAX_NODES
+        || options.min_nodes > options.max_nodes) {
+        throw std::invalid_argument("-n takes sizes in 1-32");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if ((arg == "-n" || arg == "--nodes") && has_value) parseNodes(argv[++i], options);
+            else if (arg == "--engine" && has_value) options.engine = argv[++i];
+            else if (arg == "--format" && has_value) {
+                std::string format = argv[++i];
+                if (format != "text" && format != "binary") throw std::invalid_argument("unknown format " + format);
+                options.binary = format == "binary";
+            } else if (arg == "--sink" && has_value) {
+                std::string sink = argv[++i];
+                if (sink != "buffered" && sink != "async") throw std::invalid_argument("unknown sink " + sink);
+                options.async = sink == "async";
+            } else if ((arg == "-o" || arg == "--output") && has_value) options.output = argv[++i];
+            else if (arg == "--threads" && has_value) options.threads = std::stoul(argv[++i]);
+            else if (arg == "--batch" && has_value) options.batch = std::max<uint64_t>(std::stoull(argv[++i]), 1);
+            else if (arg == "--start" && has_value) options.start = std::stoull(argv[++i]);
+            else if (arg == "--count" && has_value) options.count = std::stoull(argv[++i]);
+            else if (arg == "--no-clusters") options.clusters = false;
+            else if (arg == "--progress") options.progress = true;
+            else if (arg == "--quiet") options.quiet = true;
+            else if (arg == "--help" || arg == "-h") {
+                usage(std::cout);
+                return 0;
+            } else {
+                usage(std::cerr);
+                return 2;
+            }
+        }
+        if (options.min_nodes == 0) {
+            usage(std::cerr);
+            return 2;
+        }
+        if (options.engine != "serial" && options.engine != "parallel" && options.engine != "free") {
+            throw std::invalid_argument("unknown engine " + options.engine);
+        }
+        bool ranged = options.start > 0 || options.count != UINT64_MAX;
+        if (ranged && options.min_nodes != options.max_nodes) {
+            throw std::invalid_argument("--start and --count need a single -n");
+        }
+        bool free_trees = options.engine == "free";
+        bool clusters = options.clusters && !free_trees;
+
+        std::unique_ptr<parallel::ThreadPool> pool;
+        parallel::Executor* executor = &parallel::defaultExecutor();
+        if (options.engine == "serial" || options.threads == 1) {
+            executor = nullptr;
+        } else if (options.threads > 1) {
+            pool = std::make_unique<parallel::ThreadPool>(options.threads);
+            executor = pool.get();
+        }
+
+        std::FILE* file = stdout;
+        if (!options.output.empty()) {
+            file = std::fopen(options.output.c_str(), "wb");
+            if (!file) throw std::runtime_error("cannot write " + options.output);
+        }
+        std::unique_ptr<Sink> sink;
+        if (options.async) sink = std::make_unique<AsyncSink>(file);
+        else sink = std::make_unique<BufferedSink>(file);
+
+        uint64_t total = 0;
+        for (int n = options.min_nodes; n <= options.max_nodes; ++n) total += rangeCount(options, n, free_trees);
+        Progress progress(options.progress, total);
+        Encoder encode{options.binary, clusters};
+
+        for (int n = options.min_nodes; n <= options.max_nodes; ++n) {
+            uint64_t count = rangeCount(options, n, free_trees);
+            if (options.binary) {
+                enumeration::CatalogHeader header;
+                header.kind = free_trees ? enumeration::CatalogKind::FREE : enumeration::CatalogKind::ROOTED;
+                header.flags = clusters ? enumeration::CLUSTER_KEYS : 0;
+                header.nodes = static_cast<uint32_t>(n);
+                header.first_rank = options.start;
+                header.count = count;
+                std::string bytes;
+                enumeration::appendHeader(bytes, header);
+                sink->write(std::move(bytes));
+            }
+            if (count == 0) continue;
+            if (free_trees) {
+                enumeration::FreeSequence trees(n);
+                trees.skip(options.start);
+                generate(trees, count, options, executor, encode, *sink, progress);
+            } else {
+                enumeration::RootedSequence trees(n);
+                trees.skip(options.start);
+                generate(trees, count, options, executor, encode, *sink, progress);
+            }
+        }
+        sink->finish();
+        progress.end();
+        if (file != stdout && std::fclose(file) != 0) throw std::runtime_error("write error");
+
+        if (!options.quiet) {
+            double seconds = progress.seconds();
+            std::fprintf(stderr, "cosmic_gen: %llu %s trees (n=%d-%d) in %.3f s, %.2f M trees/s\n",
+                         static_cast<unsigned long long>(progress.done()), free_trees ? "free" : "rooted",
+                         options.min_nodes, options.max_nodes, seconds,
+                         static_cast<double>(progress.done()) / seconds / 1e6);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "cosmic_gen: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file gen_tree_tables.cpp
+ * @brief cosmic_tree_tables: generate the embedded rooted tree tables
+ *
+ * Usage:
+ *   cosmic_tree_tables MAX_NODES OUTPUT.cpp
+ *
+ * Enumerates the rooted trees with 1..MAX_NODES nodes and their clusters
+ * with the library's own generator, and writes them as constexpr arrays
+ * implementing tree_tables.hpp. Runs at build time when
+ * COSMIC_EMBED_TREE_TABLES is on.
+ */
+
+#include "cosmic/tree_tables.hpp"
+#include "cosmic/trees.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cosmic;
+
+namespace {
+
+/// Pack the preorder depths of a tree, four bits per node
+uint64_t packLevels(const trees::RootedTree& tree) {
+    uint64_t packed = 0;
+    int k = 0;
+    for (const auto& node : tree.allNodes()) {
+        packed |= static_cast<uint64_t>(node->depth()) << (4 * k++);
+    }
+    return packed;
+}
+
+template<typename T>
+void writeArray(std::ostream& out, const char* type, const std::string& name,
+                const std::vector<T>& values, bool hex) {
+    out << "constexpr " << type << " " << name << "[] = {";
+    char buf[32];
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i % 8 == 0) out << "\n   ";
+        if (hex) {
+            std::snprintf(buf, sizeof(buf), " 0x%llxULL,", static_cast<unsigned long long>(values[i]));
+        } else {
+            std::snprintf(buf, sizeof(buf), " %llu,", static_cast<unsigned long long>(values[i]));
+        }
+        out << buf;
+    }
+    out << "\n};\n\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: cosmic_tree_tables MAX_NODES OUTPUT.cpp\n";
+        return 2;
+    }
+    int max_nodes = std::atoi(argv[1]);
+    if (max_nodes < 1 || max_nodes > trees::tables::MAX_PACKED_NODES) {
+        std::cerr << "cosmic_tree_tables: MAX_NODES must be 1-"
+                  << trees::tables::MAX_PACKED_NODES << "\n";
+        return 2;
+    }
+
+    std::ostringstream out;
+    out << "// Generated by cosmic_tree_tables " << max_nodes << ". Do not edit.\n\n"
+        << "#include \"cosmic/tree_tables.hpp\"\n\n"
+        << "namespace cosmic {\nnamespace trees {\nnamespace tables {\n\nnamespace {\n\n";
+
+    std::ostringstream index;
+    for (int n = 1; n <= max_nodes; ++n) {
+        auto all = trees::RootedTreeGenerator::generate(n);
+        auto clusters = trees::FlipTransform::groupIntoClusters(all);
+
+        // Clusters hold copies of the same trees, so the root identifies them
+        std::map<const trees::TreeNode*, size_t> index_of;
+        std::vector<uint64_t> sequences;
+        for (size_t i = 0; i < all.size(); ++i) {
+            index_of[all[i].root().get()] = i;
+            sequences.push_back(packLevels(all[i]));
+        }
+        std::vector<uint32_t> cluster(all.size());
+        std::vector<uint32_t> rank(all.size());
+        for (size_t c = 0; c < clusters.size(); ++c) {
+            for (size_t r = 0; r < clusters[c].size(); ++r) {
+                size_t i = index_of.at(clusters[c][r].root().get());
+                cluster[i] = static_cast<uint32_t>(c);
+                rank[i] = static_cast<uint32_t>(r);
+            }
+        }
+
+        std::string suffix = std::to_string(n);
+        writeArray(out, "uint64_t", "SEQUENCES_" + suffix, sequences, true);
+        writeArray(out, "uint32_t", "CLUSTERS_" + suffix, cluster, false);
+        writeArray(out, "uint8_t", "RANKS_" + suffix, rank, false);
+        index << "    {" << n << ", " << all.size() << ", " << clusters.size()
+              << ", SEQUENCES_" << n << ", CLUSTERS_" << n << ", RANKS_" << n << "},\n";
+    }
+
+    out << "constexpr Table TABLES[] = {\n" << index.str() << "};\n\n"
+        << "} // namespace\n\n"
+        << "const Table* find(int nodes) {\n"
+        << "    return nodes >= 1 && nodes <= " << max_nodes << " ? &TABLES[nodes - 1] : nullptr;\n"
+        << "}\n\n"
+        << "int maxNodes() {\n"
+        << "    return " << max_nodes << ";\n"
+        << "}\n\n"
+        << "} // namespace tables\n} // namespace trees\n} // namespace cosmic\n";
+
+    std::ofstream file(argv[2]);
+    if (!file || !(file << out.str())) {
+        std::cerr << "cosmic_tree_tables: cannot write " << argv[2] << "\n";
+        return 1;
+    }
+    return 0;
+}